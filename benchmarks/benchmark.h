@@ -0,0 +1,51 @@
+#pragma once
+#include <QtCore/QElapsedTimer>
+#include <algorithm>
+#include <vector>
+#include <stdio.h>
+
+#include "headless.h"
+
+// Helpers shared by the benchmark programs. Results are printed as plain text on stdout. On machines without a display
+// run them with QT_QPA_PLATFORM=offscreen, OpenGL cases still need a driver (llvmpipe works) and are skipped otherwise.
+
+// Wall clock time of the measured iterations
+struct ImGui_ImplQtBenchmark_Result
+{
+    int    Iterations;
+    double MeanMs;
+    double MedianMs;
+    double P90Ms;
+    double MinMs;
+};
+
+template<typename F>
+inline ImGui_ImplQtBenchmark_Result ImGui_ImplQtBenchmark_Measure(int warmup, int iterations, F&& body)
+{
+    for (int i = 0; i < warmup; i++)
+        body();
+    std::vector<double> samples((size_t)iterations);
+    QElapsedTimer timer;
+    for (int i = 0; i < iterations; i++)
+    {
+        timer.start();
+        body();
+        samples[(size_t)i] = (double)timer.nsecsElapsed() / 1e6;
+    }
+    std::sort(samples.begin(), samples.end());
+    ImGui_ImplQtBenchmark_Result result = {};
+    result.Iterations = iterations;
+    for (double sample : samples)
+        result.MeanMs += sample;
+    result.MeanMs /= iterations;
+    result.MedianMs = samples[samples.size() / 2];
+    result.P90Ms = samples[std::min(samples.size() - 1, samples.size() * 9 / 10)];
+    result.MinMs = samples.front();
+    return result;
+}
+
+inline void ImGui_ImplQtBenchmark_Print(const char* name, const ImGui_ImplQtBenchmark_Result& result, const char* details = "")
+{
+    printf("%-44s median %9.3f ms  p90 %9.3f ms  min %9.3f ms  %s\n", name, result.MedianMs, result.P90Ms, result.MinMs, details);
+    fflush(stdout);
+}
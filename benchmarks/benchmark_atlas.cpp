@@ -0,0 +1,119 @@
+﻿#include <vector>
+
+#include "benchmark.h"
+
+//图标网格:每个图标一个流纹理时每个图标一条绘制命令,打进图集后ImDrawList把同一页的图标合并为一条。
+//统计绘制命令数、GL绘制调用数与帧耗时,最后重建一次设备对象,确认图集图像保留并在下次使用时重新装箱
+
+namespace
+{
+    const int IconCounts[] = { 64, 256, 1024 };
+    const int IconSize = 32;
+    const int Columns = 32;
+
+    struct Icons
+    {
+        std::vector<ImGui_ImplQtOpenGL3_AtlasImage*> Images;
+        std::vector<ImGui_ImplQtOpenGL3_StreamTexture*> Textures;
+
+        //与示例相同的彩色圆点
+        void create(int count)
+        {
+            std::vector<ImU32> pixels(IconSize * IconSize);
+            for (int i = 0; i < count; i++)
+            {
+                const ImU32 col = ImColor::HSV((float)i / count, 0.7f, 0.9f);
+                for (int y = 0; y < IconSize; y++)
+                    for (int x = 0; x < IconSize; x++) {
+                        const float dx = x + 0.5f - IconSize * 0.5f, dy = y + 0.5f - IconSize * 0.5f;
+                        pixels[y * IconSize + x] = dx * dx + dy * dy < (IconSize * 0.45f) * (IconSize * 0.45f) ? col : 0;
+                    }
+                Images.push_back(ImGui_ImplQtOpenGL3_AddAtlasImage(pixels.data(), IconSize, IconSize));
+                ImGui_ImplQtOpenGL3_StreamTexture* texture = ImGui_ImplQtOpenGL3_CreateStreamTexture(IconSize, IconSize);
+                ImGui_ImplQtOpenGL3_PushStreamFrame(texture, pixels.data());
+                Textures.push_back(texture);
+            }
+        }
+
+        void destroy()
+        {
+            for (auto image : Images)
+                ImGui_ImplQtOpenGL3_RemoveAtlasImage(image);
+            for (auto texture : Textures)
+                ImGui_ImplQtOpenGL3_DestroyStreamTexture(texture);
+            Images.clear();
+            Textures.clear();
+        }
+    };
+
+    //返回图标窗口本帧的绘制命令数
+    int icon_grid(const Icons& icons, bool atlas)
+    {
+        ImGui::SetNextWindowPos(ImVec2(0.0f, 0.0f));
+        ImGui::SetNextWindowSize(ImGui::GetIO().DisplaySize);
+        ImGui::Begin("Icon grid", nullptr, ImGuiWindowFlags_NoDecoration);
+        ImDrawList* draw_list = ImGui::GetWindowDrawList();
+        const int first_command = draw_list->CmdBuffer.Size;
+        for (int i = 0; i < (int)icons.Images.size(); i++)
+        {
+            if (i % Columns)
+                ImGui::SameLine();
+            ImGui_ImplQtOpenGL3_AtlasRegion region;
+            if (atlas && ImGui_ImplQtOpenGL3_GetAtlasRegion(icons.Images[i], &region))
+                ImGui::Image(region.TextureId, region.Size, region.Uv0, region.Uv1);
+            else
+                ImGui::Image(ImGui_ImplQtOpenGL3_GetStreamTextureID(icons.Textures[i]), ImVec2((float)IconSize, (float)IconSize));
+        }
+        const int commands = draw_list->CmdBuffer.Size - first_command;
+        ImGui::End();
+        return commands;
+    }
+
+    void measure(ImGui_ImplQtFixture_Headless& headless, const Icons& icons, const char* name, bool atlas)
+    {
+        int commands = 0;
+        auto result = ImGui_ImplQtBenchmark_Measure(10, 200, [&] { headless.frame([&] { commands = icon_grid(icons, atlas); }); });
+        ImGui_ImplQtOpenGL3_FrameStats frame_stats;
+        ImGui_ImplQtOpenGL3_GetFrameStats(&frame_stats);
+        ImGui_ImplQtOpenGL3_AtlasStats atlas_stats;
+        ImGui_ImplQtOpenGL3_GetAtlasStats(&atlas_stats);
+        char label[64], details[160];
+        snprintf(label, sizeof(label), "%d icons, %s", (int)icons.Images.size(), name);
+        if (atlas)
+            snprintf(details, sizeof(details), "%d commands, %d draw calls, %d/%d images in %d pages, %d misses", commands, frame_stats.DrawCalls,
+                atlas_stats.ResidentImages, atlas_stats.Images, atlas_stats.Pages, atlas_stats.Misses);
+        else
+            snprintf(details, sizeof(details), "%d commands, %d draw calls", commands, frame_stats.DrawCalls);
+        ImGui_ImplQtBenchmark_Print(label, result, details);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    QGuiApplication app(argc, argv);
+    ImGui_ImplQtFixture_Headless headless;
+    if (!headless.create(1280, 1280))
+    {
+        printf("No OpenGL context, benchmark skipped\n");
+        return 0;
+    }
+    printf("GL_RENDERER %s\n", (const char*)headless.context()->functions()->glGetString(GL_RENDERER));
+    printf("%dx%d icons, %d per row\n", IconSize, IconSize, Columns);
+
+    for (int count : IconCounts)
+    {
+        headless.makeCurrent();
+        Icons icons;
+        icons.create(count);
+        measure(headless, icons, "stream texture per icon", false);
+        measure(headless, icons, "atlas", true);
+
+        //设备对象重建后图像仍由应用持有,第一次使用时重新装箱
+        ImGui_ImplQtOpenGL3_DestoryDeviceObjects();
+        ImGui_ImplQtOpenGL3_CreateDeviceObjects();
+        measure(headless, icons, "atlas after device rebuild", true);
+        icons.destroy();
+        fflush(stdout);
+    }
+    return 0;
+}
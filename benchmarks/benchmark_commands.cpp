@@ -0,0 +1,152 @@
+﻿#include "benchmark.h"
+#include "imgui_impl_qt_opengl3_commands.h"
+
+namespace
+{
+    //每个命令一个独立裁剪矩形的网格,超出帧缓冲的行会被剔除,每16个中有一个零面积矩形。
+    //每个窗口4000个命令,保证16位索引的顶点数不溢出
+    void command_stress(int commands)
+    {
+        const ImVec2 display = ImGui::GetIO().DisplaySize;
+        const float cell = 8.0f;
+        const int columns = (int)(display.x / cell);
+        const int per_window = 4000;
+        for (int first = 0; first < commands; first += per_window)
+        {
+            char name[32];
+            snprintf(name, sizeof(name), "##commands%d", first / per_window);
+            ImGui::SetNextWindowPos(ImVec2(0.0f, 0.0f));
+            ImGui::SetNextWindowSize(display);
+            ImGui::Begin(name, nullptr, ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoBackground | ImGuiWindowFlags_NoInputs | ImGuiWindowFlags_NoSavedSettings);
+            ImDrawList* draw_list = ImGui::GetWindowDrawList();
+            const int last = std::min(first + per_window, commands);
+            for (int i = first; i < last; i++)
+            {
+                ImVec2 p0((i % columns) * cell, (i / columns) * cell);
+                ImVec2 p1(p0.x + cell - 1.0f, p0.y + ((i % 16) == 15 ? 0.0f : cell - 1.0f));
+                draw_list->PushClipRect(p0, p1, false);
+                draw_list->AddRectFilled(p0, p1, IM_COL32(i * 7 & 255, i * 13 & 255, 160, 255));
+                draw_list->AddText(p0, IM_COL32_WHITE, "x");
+                draw_list->PopClipRect();
+            }
+            ImGui::End();
+        }
+    }
+
+    int count_commands(const ImDrawData* draw_data)
+    {
+        int count = 0;
+        for (int n = 0; n < draw_data->CmdListsCount; n++)
+            count += draw_data->CmdLists[n]->CmdBuffer.Size;
+        return count;
+    }
+
+    //改造前渲染循环里的标量投影和空矩形判断,作为对照;每个提交的命令设置裁剪、绑定纹理并绘制,共3次GL调用
+    int scalar_pass(const ImDrawData* draw_data, int fb_width, int fb_height, int* gl_calls)
+    {
+        const ImVec2 clip_off = draw_data->DisplayPos;
+        const ImVec2 clip_scale = draw_data->FramebufferScale;
+        int submitted = 0;
+        for (int n = 0; n < draw_data->CmdListsCount; n++)
+        {
+            const ImDrawList* cmd_list = draw_data->CmdLists[n];
+            for (const ImDrawCmd& cmd : cmd_list->CmdBuffer)
+            {
+                ImVec2 clip_min((cmd.ClipRect.x - clip_off.x) * clip_scale.x, (cmd.ClipRect.y - clip_off.y) * clip_scale.y);
+                ImVec2 clip_max((cmd.ClipRect.z - clip_off.x) * clip_scale.x, (cmd.ClipRect.w - clip_off.y) * clip_scale.y);
+                if (clip_max.x <= clip_min.x || clip_max.y <= clip_min.y)
+                    continue;
+                int scissor[4] = { (int)clip_min.x, (int)((float)fb_height - clip_max.y), (int)(clip_max.x - clip_min.x), (int)(clip_max.y - clip_min.y) };
+                submitted += (scissor[2] > 0 && scissor[3] > 0 && scissor[0] < fb_width) ? 1 : 0;
+            }
+        }
+        *gl_calls = submitted * 3;
+        return submitted;
+    }
+
+    //编译后只在状态变化时设置裁剪和绑定纹理
+    int compile_pass(const ImDrawData* draw_data, int fb_width, int fb_height, ImVector<ImGui_ImplQtOpenGL3_RenderCmd>* out, ImGui_ImplQtOpenGL3_CommandStats* stats, int* gl_calls)
+    {
+        const ImVec4 clip_rect(0.0f, 0.0f, (float)fb_width, (float)fb_height);
+        int submitted = 0;
+        *gl_calls = 0;
+        *stats = {};
+        for (int n = 0; n < draw_data->CmdListsCount; n++)
+        {
+            ImGui_ImplQtOpenGL3_CommandStats list_stats = {};
+            ImGui_ImplQtOpenGL3_CompileCommands(draw_data->CmdLists[n], draw_data->DisplayPos, draw_data->FramebufferScale,
+                clip_rect, ImVec2(0.0f, 0.0f), fb_height, out, &list_stats);
+            stats->Culled += list_stats.Culled;
+            stats->Merged += list_stats.Merged;
+            submitted += out->Size;
+            for (const ImGui_ImplQtOpenGL3_RenderCmd& cmd : *out)
+                *gl_calls += 1 + ((cmd.Flags & ImGui_ImplQtOpenGL3_RenderCmdFlags_SetScissor) ? 1 : 0) + ((cmd.Flags & ImGui_ImplQtOpenGL3_RenderCmdFlags_BindTexture) ? 1 : 0);
+        }
+        return submitted;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    QGuiApplication app(argc, argv);
+    const int sizes[] = { 10000, 20000, 50000 };
+    const int width = 1920;
+    const int height = 1080;
+    char details[128];
+
+    //CPU部分: 只有平台后端的上下文,构建一帧后反复编译同一份绘制数据
+    printf("Command pre-pass, %dx%d framebuffer\n", width, height);
+    ImGuiContext* context = ImGui::CreateContext();
+    ImGui::GetIO().IniFilename = nullptr;
+    ImGui::GetIO().Fonts->Build();
+    ImGui_ImplQt_InitHeadless(width, height);
+    ImVector<ImGui_ImplQtOpenGL3_RenderCmd> commands;
+    for (int size : sizes)
+    {
+        ImGui_ImplQt_NewFrame();
+        ImGui::NewFrame();
+        command_stress(size);
+        ImGui::Render();
+        const ImDrawData* draw_data = ImGui::GetDrawData();
+        const int total = count_commands(draw_data);
+
+        volatile int sink = 0;
+        int gl_calls = 0;
+        auto result = ImGui_ImplQtBenchmark_Measure(10, 200, [&] {
+            sink = scalar_pass(draw_data, width, height, &gl_calls);
+        });
+        snprintf(details, sizeof(details), "%d commands, %d GL calls", total, gl_calls);
+        ImGui_ImplQtBenchmark_Print("  scalar projection (before)", result, details);
+        ImGui_ImplQtOpenGL3_CommandStats stats = {};
+        result = ImGui_ImplQtBenchmark_Measure(10, 200, [&] {
+            sink = compile_pass(draw_data, width, height, &commands, &stats, &gl_calls);
+        });
+        snprintf(details, sizeof(details), "%d commands, %d culled, %d merged, %d GL calls", total, stats.Culled, stats.Merged, gl_calls);
+        ImGui_ImplQtBenchmark_Print("  compiled commands", result, details);
+        (void)sink;
+    }
+    ImGui_ImplQt_Shutdown();
+    ImGui::DestroyContext(context);
+
+    //GL部分: 整帧的RenderDrawData(),与未剔除时的命令数比较实际绘制调用数
+    ImGui_ImplQtFixture_Headless headless;
+    if (!headless.create(width, height))
+    {
+        printf("No OpenGL context, RenderDrawData() cases skipped\n");
+        return 0;
+    }
+    printf("RenderDrawData(), %s\n", (const char*)headless.context()->functions()->glGetString(GL_RENDERER));
+    for (int size : sizes)
+    {
+        int total = 0;
+        auto result = ImGui_ImplQtBenchmark_Measure(5, 50, [&] {
+            headless.frame([&] { command_stress(size); });
+            total = count_commands(ImGui::GetDrawData());
+        });
+        ImGui_ImplQtOpenGL3_FrameStats stats = {};
+        ImGui_ImplQtOpenGL3_GetFrameStats(&stats);
+        snprintf(details, sizeof(details), "%d commands, %d draw calls, %d culled, %d merged", total, stats.DrawCalls, stats.CommandsCulled, stats.CommandsMerged);
+        ImGui_ImplQtBenchmark_Print("  frame", result, details);
+    }
+    return 0;
+}
@@ -0,0 +1,56 @@
+﻿#include <QtCore/QCoreApplication>
+#include <QtCore/QFile>
+#include <QtCore/QThread>
+
+#include "benchmark.h"
+#include "imgui_impl_qt_fonts.h"
+
+//GetGlyphRangesChineseFull()字体图集构建耗时:imgui串行构建与并行构建在不同线程数下比较
+//字体路径取第一个参数、IMGUI_QT_CJK_FONT或系统常见中文字体
+
+static void build(const QByteArray& font, float size, int thread_count)
+{
+    ImFontAtlas atlas;
+    ImFontConfig config;
+    config.FontDataOwnedByAtlas = false;
+    atlas.AddFontFromMemoryTTF(const_cast<char*>(font.data()), font.size(), size, &config, atlas.GetGlyphRangesChineseFull());
+    if (thread_count >= 0)
+        ImGui_ImplQt_SetParallelFontBuild(&atlas, thread_count);
+    atlas.Build();
+}
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    const QString path = argc > 1 ? QString::fromLocal8Bit(argv[1]) : ImGui_ImplQtFixture_FindCjkFont();
+    QFile file(path);
+    if (path.isEmpty() || !file.open(QIODevice::ReadOnly))
+    {
+        printf("no CJK font found, pass one as argument or set IMGUI_QT_CJK_FONT\n");
+        return 0;
+    }
+    const QByteArray font = file.readAll();
+    printf("font %s, ideal thread count %d\n", qPrintable(path), QThread::idealThreadCount());
+
+    const float sizes[] = { 16.0f, 32.0f };
+    for (float size : sizes)
+    {
+        char name[64];
+        snprintf(name, sizeof(name), "ChineseFull %.0fpx serial", size);
+        const ImGui_ImplQtBenchmark_Result serial = ImGui_ImplQtBenchmark_Measure(1, 5, [&] { build(font, size, -1); });
+        ImGui_ImplQtBenchmark_Print(name, serial);
+
+        const int thread_counts[] = { 2, 4, 8, 0 };
+        for (int thread_count : thread_counts)
+        {
+            const int threads = thread_count ? thread_count : QThread::idealThreadCount();
+            snprintf(name, sizeof(name), "ChineseFull %.0fpx parallel %d threads", size, threads);
+            const ImGui_ImplQtBenchmark_Result parallel = ImGui_ImplQtBenchmark_Measure(1, 5, [&] { build(font, size, thread_count); });
+            char details[64];
+            snprintf(details, sizeof(details), "speed-up %.2fx", serial.MedianMs / parallel.MedianMs);
+            ImGui_ImplQtBenchmark_Print(name, parallel, details);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,106 @@
+﻿#include <QtWidgets/QApplication>
+#include <QtWidgets/QHBoxLayout>
+#include <QtWidgets/QOpenGLWidget>
+#include <QtGui/QMouseEvent>
+#include <QtGui/QOpenGLWindow>
+#include <QtCore/QEventLoop>
+#include <QtCore/QTimer>
+#include <string.h>
+
+#include "benchmark.h"
+#include "imgui_impl_qt_host.h"
+
+//QOpenGLWidget宿主(渲染到FBO再由顶层窗口合成)与QOpenGLWindow宿主(直接绘制到原生子窗口)比较:
+//每次交换后立即送入一个合成的鼠标移动事件,统计帧间隔、绘制耗时与输入到显示的延迟。
+//参数--no-vsync把交换间隔设为0,显示吞吐量而不是刷新率
+
+static const int Seconds = 5;
+
+static void host_frame(void*)
+{
+    ImGui::ShowDemoWindow();
+    ImGui::SetNextWindowPos(ImVec2(420, 20), ImGuiCond_Once);
+    ImGui::Begin("Rows");
+    for (int i = 0; i < 200; i++)
+        ImGui::Text("Row %d: %f", i, (float)ImGui::GetTime() * (float)i);
+    ImGui::End();
+}
+
+static void run(ImGui_ImplQt_HostType type, const char* name)
+{
+    QWidget window;
+    window.resize(1280, 720);
+    QHBoxLayout* layout = new QHBoxLayout(&window);
+    layout->setContentsMargins(0, 0, 0, 0);
+    QWidget* host = ImGui_ImplQt_CreateHost(type, nullptr, host_frame, nullptr);
+    layout->addWidget(host);
+    window.show();
+    //帧由下面的输入事件驱动
+    ImGui_ImplQt_SetHostFrameInterval(host, 0);
+
+    //输入要送到真正接收事件的对象:窗口宿主是容器里的QOpenGLWindow
+    QObject* target = host;
+    QOpenGLWindow* gl_window = nullptr;
+    if (type == ImGui_ImplQt_HostType_OpenGLWindow)
+    {
+        for (QWindow* candidate : QGuiApplication::allWindows())
+            if (QOpenGLWindow* w = qobject_cast<QOpenGLWindow*>(candidate))
+                gl_window = w;
+        if (!gl_window)
+        {
+            printf("%-44s no QOpenGLWindow found\n", name);
+            return;
+        }
+        target = gl_window;
+    }
+
+    int moves = 0;
+    auto send_move = [&]() {
+        const QPointF pos(100.0 + (moves % 400), 100.0 + (moves % 200));
+        QMouseEvent event(QEvent::MouseMove, pos, Qt::NoButton, Qt::NoButton, Qt::NoModifier);
+        QCoreApplication::sendEvent(target, &event);
+        moves++;
+    };
+    if (gl_window)
+        QObject::connect(gl_window, &QOpenGLWindow::frameSwapped, gl_window, send_move, Qt::QueuedConnection);
+    else
+        QObject::connect(qobject_cast<QOpenGLWidget*>(host), &QOpenGLWidget::frameSwapped, host, send_move, Qt::QueuedConnection);
+
+    QEventLoop loop;
+    QTimer::singleShot(Seconds * 1000, &loop, &QEventLoop::quit);
+    QTimer::singleShot(100, &loop, send_move);
+    loop.exec();
+
+    ImGui_ImplQt_HostStats stats;
+    if (!ImGui_ImplQt_GetHostStats(host, &stats) || stats.Frames == 0)
+    {
+        printf("%-44s no frames, OpenGL unavailable?\n", name);
+        return;
+    }
+    ImGuiContext* last_context = ImGui::GetCurrentContext();
+    ImGui::SetCurrentContext(ImGui_ImplQt_GetHostContext(host));
+    ImGui_ImplQt_LatencyStats latency = {};
+    ImGui_ImplQt_GetLatencyStats(&latency);
+    ImGui::SetCurrentContext(last_context);
+
+    printf("%-44s %6d frames  interval %7.3f ms  paint %7.3f ms  latency avg %7.3f p50 %7.3f p99 %7.3f ms\n",
+        name, stats.Frames, stats.FrameIntervalMs, stats.PaintMs, latency.AverageMs, latency.P50Ms, latency.P99Ms);
+    fflush(stdout);
+}
+
+int main(int argc, char* argv[])
+{
+    bool vsync = true;
+    for (int i = 1; i < argc; i++)
+        if (strcmp(argv[i], "--no-vsync") == 0)
+            vsync = false;
+    QSurfaceFormat format = QSurfaceFormat::defaultFormat();
+    format.setSwapInterval(vsync ? 1 : 0);
+    QSurfaceFormat::setDefaultFormat(format);
+
+    QApplication app(argc, argv);
+    printf("hosts for %d s each, swap interval %d\n", Seconds, vsync ? 1 : 0);
+    run(ImGui_ImplQt_HostType_OpenGLWidget, "QOpenGLWidget host");
+    run(ImGui_ImplQt_HostType_OpenGLWindow, "QOpenGLWindow host");
+    return 0;
+}
@@ -0,0 +1,160 @@
+﻿#include <QtCore/QThread>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "benchmark.h"
+
+//其他线程注入输入的吞吐量:无锁队列(ImGui_ImplQt_QueueMousePos)与每条输入一个QCoreApplication::postEvent比较。
+//1到8个生产者线程各送出固定条数的鼠标移动,GUI线程不停地处理事件并渲染空帧,直到全部输入都交给ImGuiIO。
+//队列满时生产者让出时间片后重试,重试次数单独统计
+
+static const int RecordsPerProducer = 200000;
+
+namespace
+{
+    const QEvent::Type InputEventType = (QEvent::Type)QEvent::registerEventType();
+
+    class InputEvent :public QEvent
+    {
+    public:
+        InputEvent(float x, float y) :QEvent(InputEventType), X(x), Y(y) {}
+        float X, Y;
+    };
+
+    //在GUI线程把投递来的事件转成imgui输入
+    class InputReceiver :public QObject
+    {
+    public:
+        int Received{};
+    protected:
+        bool event(QEvent* event) override
+        {
+            if (event->type() != InputEventType)
+                return QObject::event(event);
+            const InputEvent* input = static_cast<const InputEvent*>(event);
+            ImGui::GetIO().AddMousePosEvent(input->X, input->Y);
+            Received++;
+            return true;
+        }
+    };
+
+    struct Producers
+    {
+        std::vector<std::thread> Threads;
+        std::atomic<int> Finished{};
+        std::atomic<long long> ProducerNs{};    //各线程送出全部输入所花时间之和
+        std::atomic<long long> Retries{};
+
+        template<typename F>
+        void start(int count, F&& push)
+        {
+            for (int t = 0; t < count; t++)
+            {
+                Threads.emplace_back([this, t, push]() {
+                    QElapsedTimer timer;
+                    timer.start();
+                    long long retries = 0;
+                    for (int i = 0; i < RecordsPerProducer; i++)
+                    {
+                        while (!push((float)(i % 1280), (float)(t * 90 + i % 90)))
+                        {
+                            retries++;
+                            std::this_thread::yield();
+                        }
+                    }
+                    ProducerNs.fetch_add(timer.nsecsElapsed());
+                    Retries.fetch_add(retries);
+                    Finished.fetch_add(1);
+                });
+            }
+        }
+
+        void join()
+        {
+            for (std::thread& thread : Threads)
+                thread.join();
+        }
+    };
+
+    void print(const char* name, int producers, double total_ms, int frames, const Producers& state)
+    {
+        const double records = (double)producers * RecordsPerProducer;
+        char label[64];
+        snprintf(label, sizeof(label), "%s, %d producer(s)", name, producers);
+        printf("%-36s %10.2f ms  %8.2f M records/s  producer %7.1f ns/record  %6d frames  %lld retries\n", label, total_ms,
+            records / total_ms / 1000.0, (double)state.ProducerNs.load() / records, frames, state.Retries.load());
+        fflush(stdout);
+    }
+
+    void run_queue(ImGui_ImplQtFixture_Headless& headless, int producers)
+    {
+        ImGui_ImplQt_InputQueue* queue = ImGui_ImplQt_GetInputQueue();
+        ImGui_ImplQt_InputQueueStats stats;
+        ImGui_ImplQt_GetInputQueueStats(&stats);
+        const int target = stats.Drained + producers * RecordsPerProducer;
+
+        Producers state;
+        QElapsedTimer timer;
+        timer.start();
+        state.start(producers, [queue](float x, float y) { return ImGui_ImplQt_QueueMousePos(queue, x, y); });
+        int frames = 0;
+        while (stats.Drained < target)
+        {
+            //唤醒请求是投递到GUI线程的调用,一并处理掉
+            QCoreApplication::processEvents();
+            headless.frame([] {});
+            ImGui_ImplQt_GetInputQueueStats(&stats);
+            frames++;
+        }
+        const double total_ms = (double)timer.nsecsElapsed() / 1e6;
+        state.join();
+        print("lock-free queue", producers, total_ms, frames, state);
+    }
+
+    void run_post_event(ImGui_ImplQtFixture_Headless& headless, int producers)
+    {
+        InputReceiver receiver;
+        const int target = producers * RecordsPerProducer;
+
+        Producers state;
+        QElapsedTimer timer;
+        timer.start();
+        state.start(producers, [&receiver](float x, float y) {
+            QCoreApplication::postEvent(&receiver, new InputEvent(x, y));
+            return true;
+        });
+        int frames = 0;
+        while (receiver.Received < target)
+        {
+            QCoreApplication::processEvents();
+            headless.frame([] {});
+            frames++;
+        }
+        const double total_ms = (double)timer.nsecsElapsed() / 1e6;
+        state.join();
+        print("QCoreApplication::postEvent", producers, total_ms, frames, state);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    QGuiApplication app(argc, argv);
+    ImGui_ImplQtFixture_Headless headless;
+    if (!headless.create(640, 480))
+    {
+        printf("No OpenGL context, benchmark skipped\n");
+        return 0;
+    }
+    //每帧应用全部输入,不按帧逐条分摊
+    ImGui::GetIO().ConfigInputTrickleEventQueue = false;
+    printf("%d mouse moves per producer, ideal thread count %d\n", RecordsPerProducer, QThread::idealThreadCount());
+
+    const int producer_counts[] = { 1, 2, 4, 8 };
+    for (int producers : producer_counts)
+    {
+        run_queue(headless, producers);
+        run_post_event(headless, producers);
+    }
+    return 0;
+}
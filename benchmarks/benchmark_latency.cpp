@@ -0,0 +1,120 @@
+﻿#include <QtGui/QGuiApplication>
+#include <QtGui/QMouseEvent>
+#include <QtGui/QOpenGLWindow>
+#include <QtCore/QEventLoop>
+#include <QtCore/QTimer>
+#include <math.h>
+
+#include "benchmark.h"
+
+//输入到显示的延迟分位数:同一个显示中的QOpenGLWindow先关闭再打开低延迟模式。
+//按常见写法用16毫秒定时器重绘,合成的鼠标移动事件以9毫秒间隔送入(与刷新不同步),
+//背景绘制大量半透明圆增加GPU负载,让驱动队列积压
+
+static const int Seconds = 5;
+static const int InputIntervalMs = 9;
+
+namespace
+{
+    class LatencyWindow :public QOpenGLWindow
+    {
+    public:
+        ~LatencyWindow()
+        {
+            if (!m_ctx)
+                return;
+            makeCurrent();
+            ImGui::SetCurrentContext(m_ctx);
+            ImGui_ImplQtOpenGL3_Shutdown();
+            ImGui_ImplQt_Shutdown();
+            ImGui::DestroyContext(m_ctx);
+        }
+
+        bool lowLatency{};
+        int  queuedFrames{ 1 };
+
+        ImGuiContext* imgui() const { return m_ctx; }
+    protected:
+        void initializeGL() override
+        {
+            m_ctx = ImGui::CreateContext();
+            ImGui::SetCurrentContext(m_ctx);
+            ImGui::GetIO().IniFilename = nullptr;
+            ImGui_ImplQt_Init(this);
+            ImGui_ImplQtOpenGL3_Init();
+            ImGui_ImplQt_SetLowLatency(lowLatency, queuedFrames);
+        }
+
+        void paintGL() override
+        {
+            ImGui::SetCurrentContext(m_ctx);
+            ImGui_ImplQtOpenGL3_NewFrame();
+            ImGui_ImplQt_NewFrame();
+            ImGui::NewFrame();
+            ImGui::ShowDemoWindow();
+            ImDrawList* draw_list = ImGui::GetBackgroundDrawList();
+            for (int i = 0; i < 400; i++)
+                draw_list->AddCircleFilled(ImVec2(100.0f + (i % 20) * 60.0f, 100.0f + (i / 20) * 30.0f), 200.0f, IM_COL32(40 * (i % 6), 120, 200, 24), 96);
+            ImGui::Render();
+            QOpenGLFunctions* f = context()->functions();
+            f->glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+            f->glClear(GL_COLOR_BUFFER_BIT);
+            ImGui_ImplQtOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        }
+    private:
+        ImGuiContext* m_ctx{};
+    };
+}
+
+static void run(const char* name, bool low_latency, int queued_frames)
+{
+    LatencyWindow window;
+    window.lowLatency = low_latency;
+    window.queuedFrames = queued_frames;
+    window.resize(1280, 720);
+    window.show();
+
+    QTimer repaint;
+    repaint.setTimerType(Qt::PreciseTimer);
+    QObject::connect(&repaint, &QTimer::timeout, &window, [&]() { window.update(); });
+    repaint.start(16);
+
+    int moves = 0;
+    QTimer input;
+    input.setTimerType(Qt::PreciseTimer);
+    QObject::connect(&input, &QTimer::timeout, &window, [&]() {
+        const QPointF pos(640.0 + 300.0 * cos(moves * 0.05), 360.0 + 200.0 * sin(moves * 0.05));
+        QMouseEvent event(QEvent::MouseMove, pos, Qt::NoButton, Qt::NoButton, Qt::NoModifier);
+        QCoreApplication::sendEvent(&window, &event);
+        moves++;
+    });
+    input.start(InputIntervalMs);
+
+    QEventLoop loop;
+    QTimer::singleShot(Seconds * 1000, &loop, &QEventLoop::quit);
+    loop.exec();
+    input.stop();
+    repaint.stop();
+
+    if (!window.imgui())
+    {
+        printf("%-36s no OpenGL window\n", name);
+        return;
+    }
+    ImGui::SetCurrentContext(window.imgui());
+    ImGui_ImplQt_LatencyStats stats = {};
+    ImGui_ImplQt_GetLatencyStats(&stats);
+    printf("%-36s %5d samples  avg %7.2f  p50 %7.2f  p90 %7.2f  p99 %7.2f  max %7.2f ms  gpu %6.2f ms\n",
+        name, stats.Samples, stats.AverageMs, stats.P50Ms, stats.P90Ms, stats.P99Ms, stats.MaxMs, stats.GpuMs);
+    fflush(stdout);
+}
+
+int main(int argc, char* argv[])
+{
+    QGuiApplication app(argc, argv);
+    printf("Input to display latency, %d s per mode, input every %d ms, repaint timer 16 ms\n", Seconds, InputIntervalMs);
+    run("low latency off", false, 1);
+    run("low latency on, 1 queued frame", true, 1);
+    run("low latency on, 2 queued frames", true, 2);
+    return 0;
+}
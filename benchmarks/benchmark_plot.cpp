@@ -0,0 +1,166 @@
+﻿#include "benchmark.h"
+#include <algorithm>
+#include <math.h>
+#include <vector>
+
+//10^5到10^7个样本的曲线:GPU序列(环形缓冲区加最小/最大值金字塔)与CPU端两种画法比较。
+//ImGui::PlotLines每个像素列只取一个样本(会丢峰值),CPU最小/最大值包络每帧扫描全部样本,结果与GPU序列一致。
+//统计追加耗时、首次上传、静态与流式的帧耗时以及提交的顶点数
+
+namespace
+{
+    const int Counts[] = { 100000, 1000000, 10000000 };
+    const int Chunk = 4096;         //追加时每次写入的样本数
+    const int StreamChunk = 1024;   //流式场景每帧新增的样本数
+    const ImVec2 PlotSize(1200.0f, 300.0f);
+
+    //带噪声的正弦,固定种子便于复现
+    std::vector<float> make_signal(int count)
+    {
+        std::vector<float> values((size_t)count);
+        unsigned int seed = 12345;
+        for (int i = 0; i < count; i++)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            const float noise = (float)(seed >> 8) / (float)(1 << 24) - 0.5f;
+            values[(size_t)i] = sinf((float)i * 0.001f) + noise * 0.5f;
+        }
+        return values;
+    }
+
+    template<typename F>
+    void plot_window(F&& plot)
+    {
+        ImGui::SetNextWindowPos(ImVec2(0.0f, 0.0f));
+        ImGui::SetNextWindowSize(ImGui::GetIO().DisplaySize);
+        ImGui::Begin("Plot", nullptr, ImGuiWindowFlags_NoDecoration);
+        const ImVec2 p_min = ImGui::GetCursorScreenPos();
+        plot(p_min, ImVec2(p_min.x + PlotSize.x, p_min.y + PlotSize.y));
+        ImGui::End();
+    }
+
+    int total_vertices()
+    {
+        ImDrawData* draw_data = ImGui::GetDrawData();
+        return draw_data ? draw_data->TotalVtxCount : 0;
+    }
+
+    void print_gpu(const char* label, const ImGui_ImplQtBenchmark_Result& result)
+    {
+        ImGui_ImplQtOpenGL3_FrameStats stats;
+        ImGui_ImplQtOpenGL3_GetFrameStats(&stats);
+        char details[128];
+        if (stats.PlotSeriesDrawn > 0)
+            snprintf(details, sizeof(details), "%d plot vertices on the GPU, %d draw list vertices", stats.PlotVertices, total_vertices());
+        else
+            snprintf(details, sizeof(details), "GLSL 1.20 polyline fallback, %d draw list vertices", total_vertices());
+        ImGui_ImplQtBenchmark_Print(label, result, details);
+    }
+
+    void run(ImGui_ImplQtFixture_Headless& headless, int count)
+    {
+        headless.makeCurrent();
+        const std::vector<float> values = make_signal(count);
+        const int iterations = count >= 10000000 ? 30 : 100;
+        char label[64], details[96];
+
+        //追加全部样本(只写CPU侧环形缓冲区和金字塔)
+        ImGui_ImplQtOpenGL3_PlotSeries* series = ImGui_ImplQtOpenGL3_CreatePlotSeries(count);
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < count; i += Chunk)
+            ImGui_ImplQtOpenGL3_AppendPlotSamples(series, values.data() + i, std::min(Chunk, count - i));
+        const double append_ms = (double)timer.nsecsElapsed() / 1e6;
+        snprintf(label, sizeof(label), "%d append", count);
+        snprintf(details, sizeof(details), "%.2f ns per sample", append_ms * 1e6 / count);
+        printf("%-44s %10.2f ms  %s\n", label, append_ms, details);
+
+        auto gpu_plot = [&] {
+            plot_window([&](const ImVec2& p_min, const ImVec2& p_max) {
+                ImGui_ImplQtOpenGL3_AddPlotSeries(ImGui::GetWindowDrawList(), series, p_min, p_max, -1.5f, 1.5f, IM_COL32(0, 255, 0, 255));
+            });
+        };
+
+        //第一帧把整个环形缓冲区上传到GPU
+        timer.restart();
+        headless.frame(gpu_plot);
+        snprintf(label, sizeof(label), "%d first frame (upload)", count);
+        printf("%-44s %10.2f ms\n", label, (double)timer.nsecsElapsed() / 1e6);
+
+        auto result = ImGui_ImplQtBenchmark_Measure(10, iterations, [&] { headless.frame(gpu_plot); });
+        snprintf(label, sizeof(label), "%d gpu series, static", count);
+        print_gpu(label, result);
+
+        //流式:每帧追加一小段后再画,只上传新写入的槽位
+        std::vector<float> stream((size_t)StreamChunk);
+        int offset = 0;
+        result = ImGui_ImplQtBenchmark_Measure(10, iterations, [&] {
+            for (int i = 0; i < StreamChunk; i++)
+                stream[(size_t)i] = values[(size_t)((offset + i) % count)];
+            offset += StreamChunk;
+            ImGui_ImplQtOpenGL3_AppendPlotSamples(series, stream.data(), StreamChunk);
+            headless.frame(gpu_plot);
+        });
+        snprintf(label, sizeof(label), "%d gpu series, +%d per frame", count, StreamChunk);
+        print_gpu(label, result);
+        ImGui_ImplQtOpenGL3_DestroyPlotSeries(series);
+
+        //ImGui::PlotLines:每列取一个样本,与样本数几乎无关但会丢失峰值
+        result = ImGui_ImplQtBenchmark_Measure(10, iterations, [&] {
+            headless.frame([&] {
+                plot_window([&](const ImVec2&, const ImVec2&) {
+                    ImGui::PlotLines("##plot", values.data(), count, 0, nullptr, -1.5f, 1.5f, PlotSize);
+                });
+            });
+        });
+        snprintf(label, sizeof(label), "%d ImGui::PlotLines (point sampled)", count);
+        snprintf(details, sizeof(details), "%d draw list vertices", total_vertices());
+        ImGui_ImplQtBenchmark_Print(label, result, details);
+
+        //CPU最小/最大值包络:每帧扫描全部样本,每个像素列一对顶点
+        std::vector<ImVec2> points;
+        result = ImGui_ImplQtBenchmark_Measure(10, iterations, [&] {
+            headless.frame([&] {
+                plot_window([&](const ImVec2& p_min, const ImVec2& p_max) {
+                    const int columns = (int)(p_max.x - p_min.x);
+                    const float y_scale = (p_min.y - p_max.y) / 3.0f;
+                    points.clear();
+                    for (int c = 0; c < columns; c++)
+                    {
+                        const int begin = (int)((long long)count * c / columns);
+                        const int end = std::max((int)((long long)count * (c + 1) / columns), begin + 1);
+                        float v_min = values[(size_t)begin], v_max = v_min;
+                        for (int i = begin + 1; i < end; i++)
+                        {
+                            v_min = std::min(v_min, values[(size_t)i]);
+                            v_max = std::max(v_max, values[(size_t)i]);
+                        }
+                        points.push_back(ImVec2(p_min.x + (float)c, p_max.y + (v_min + 1.5f) * y_scale));
+                        points.push_back(ImVec2(p_min.x + (float)c, p_max.y + (v_max + 1.5f) * y_scale));
+                    }
+                    ImGui::GetWindowDrawList()->AddPolyline(points.data(), (int)points.size(), IM_COL32(0, 255, 0, 255), ImDrawFlags_None, 1.0f);
+                });
+            });
+        });
+        snprintf(label, sizeof(label), "%d cpu min/max envelope", count);
+        snprintf(details, sizeof(details), "%d draw list vertices", total_vertices());
+        ImGui_ImplQtBenchmark_Print(label, result, details);
+        fflush(stdout);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    QGuiApplication app(argc, argv);
+    ImGui_ImplQtFixture_Headless headless;
+    if (!headless.create(1280, 720))
+    {
+        printf("No OpenGL context, benchmark skipped\n");
+        return 0;
+    }
+    printf("GL_RENDERER %s\n", (const char*)headless.context()->functions()->glGetString(GL_RENDERER));
+    printf("Plot %.0fx%.0f px, appended in chunks of %d samples\n", PlotSize.x, PlotSize.y, Chunk);
+    for (int count : Counts)
+        run(headless, count);
+    return 0;
+}
@@ -0,0 +1,129 @@
+﻿#include "benchmark.h"
+#include "imgui_impl_qt_remote.h"
+#include <QtNetwork/QLocalServer>
+#include <QtNetwork/QLocalSocket>
+#include <math.h>
+
+namespace
+{
+    //静态界面: 只有演示窗口,大部分绘制列表逐帧不变
+    void static_ui(int)
+    {
+        ImGui::SetNextWindowPos(ImVec2(20.0f, 20.0f));
+        ImGui::SetNextWindowSize(ImVec2(560.0f, 680.0f));
+        ImGui::ShowDemoWindow();
+    }
+
+    //动态界面: 另有一条每帧滚动的曲线和一个移动的窗口
+    void animated_ui(int frame)
+    {
+        static_ui(frame);
+        float values[512];
+        for (int i = 0; i < IM_ARRAYSIZE(values); i++)
+            values[i] = sinf((i + frame) * 0.05f) * cosf((i - frame) * 0.013f);
+        ImGui::SetNextWindowPos(ImVec2(600.0f + 100.0f * sinf(frame * 0.02f), 40.0f));
+        ImGui::SetNextWindowSize(ImVec2(600.0f, 400.0f));
+        ImGui::Begin("Animated");
+        ImGui::PlotLines("Signal", values, IM_ARRAYSIZE(values), 0, nullptr, -1.0f, 1.0f, ImVec2(0.0f, 300.0f));
+        ImGui::Text("Frame %d", frame);
+        ImGui::End();
+    }
+}
+
+int main(int argc, char** argv)
+{
+    QGuiApplication app(argc, argv);
+    const int width = 1280;
+    const int height = 720;
+
+    //显示端: 回放收到的帧
+    ImGui_ImplQtFixture_Headless display;
+    if (!display.create(width, height))
+    {
+        printf("No OpenGL context, benchmark skipped\n");
+        return 0;
+    }
+
+    //应用端: 只有平台后端的无头上下文
+    ImGuiContext* app_context = ImGui::CreateContext();
+    ImGui::SetCurrentContext(app_context);
+    ImGui::GetIO().IniFilename = nullptr;
+    ImGui::GetIO().Fonts->Build();
+    ImGui_ImplQt_InitHeadless(width, height);
+
+    const QString name = QString("imgui_qt_benchmark_remote");
+    QLocalServer::removeServer(name);
+    QLocalServer server;
+    if (!server.listen(name))
+    {
+        printf("Cannot listen on %s\n", name.toStdString().c_str());
+        return 1;
+    }
+    QLocalSocket display_socket;
+    display_socket.connectToServer(name);
+    server.waitForNewConnection(5000);
+    QLocalSocket* app_socket = server.nextPendingConnection();
+    if (!app_socket || !display_socket.waitForConnected(5000))
+    {
+        printf("Loopback connection failed\n");
+        return 1;
+    }
+
+    ImGui_ImplQtRemote_Sender* sender = ImGui_ImplQtRemote_CreateSender(app_socket);
+    display.makeCurrent();
+    ImGui_ImplQtRemote_Player* player = ImGui_ImplQtRemote_CreatePlayer(&display_socket, nullptr);
+    display_socket.flush();
+    //发送端先处理Hello,之后的帧才属于播放端当前的一代
+    app_socket->waitForReadyRead(1000);
+
+    printf("Remote draw data over QLocalSocket, %dx%d\n", width, height);
+    struct Scenario { const char* Name; void (*Ui)(int); };
+    const Scenario scenarios[] = { { "  static demo window", static_ui }, { "  animated plot", animated_ui } };
+    int frame = 0;
+    for (const Scenario& scenario : scenarios)
+    {
+        double bytes = 0.0, raw_bytes = 0.0;
+        int samples = 0;
+        //每次迭代是一个完整的往返: 构建、编码发送、接收解码、渲染并等待GPU
+        auto result = ImGui_ImplQtBenchmark_Measure(30, 300, [&] {
+            ImGui::SetCurrentContext(app_context);
+            ImGui_ImplQt_NewFrame();
+            ImGui::NewFrame();
+            scenario.Ui(frame++);
+            ImGui::Render();
+            ImGui_ImplQtRemote_SendDrawData(sender, ImGui::GetDrawData());
+            app_socket->flush();
+
+            display.makeCurrent();
+            ImGui_ImplQtRemote_Stats stats;
+            ImGui_ImplQtRemote_GetPlayerStats(player, &stats);
+            const int received = stats.FramesSent;
+            while (stats.FramesSent == received && display_socket.waitForReadyRead(1000))
+                ImGui_ImplQtRemote_GetPlayerStats(player, &stats);
+            display.render(ImGui_ImplQtRemote_UpdatePlayer(player, ImVec2((float)width, (float)height), 1.0f));
+            display_socket.flush();
+
+            //确认消息回到发送端,更新其延迟统计
+            ImGui::SetCurrentContext(app_context);
+            app_socket->waitForReadyRead(0);
+            ImGui_ImplQtRemote_GetSenderStats(sender, &stats);
+            bytes += stats.FrameBytes;
+            raw_bytes += stats.FrameRawBytes;
+            samples++;
+        });
+        ImGui_ImplQtRemote_Stats stats;
+        ImGui_ImplQtRemote_GetSenderStats(sender, &stats);
+        char details[160];
+        snprintf(details, sizeof(details), "%.0f bytes/frame on the wire, %.0f raw (%.1fx), %d lists unchanged, acked latency %.3f ms",
+            bytes / samples, raw_bytes / samples, bytes > 0.0 ? raw_bytes / bytes : 0.0, stats.ListsUnchanged, stats.LatencyAverageMs);
+        ImGui_ImplQtBenchmark_Print(scenario.Name, result, details);
+    }
+
+    display.makeCurrent();
+    ImGui_ImplQtRemote_DestroyPlayer(player);
+    ImGui::SetCurrentContext(app_context);
+    ImGui_ImplQtRemote_DestroySender(sender);
+    ImGui_ImplQt_Shutdown();
+    ImGui::DestroyContext(app_context);
+    return 0;
+}
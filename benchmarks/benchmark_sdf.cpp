@@ -0,0 +1,128 @@
+﻿#include "benchmark.h"
+#include "imgui_impl_qt_fonts.h"
+#include <QtCore/QFile>
+
+//缩放文字的三种做法比较:位图图集按倍数拉伸(不重建,放大后模糊)、每个缩放级别重建位图图集(清晰,每级一次重建)、
+//距离场图集(只构建一次)。统计重建次数、构建耗时、图集显存与GL帧耗时。找到中文字体时加入常用汉字
+
+namespace
+{
+    const float BaseSize = 16.0f;
+    const float Zooms[] = { 0.5f, 0.75f, 1.0f, 1.25f, 1.5f, 2.0f, 3.0f, 4.0f };
+    QByteArray CjkFont;
+
+    void add_fonts(ImFontAtlas* atlas, float size)
+    {
+        ImFontConfig config;
+        config.SizePixels = size;
+        atlas->AddFontDefault(&config);
+        if (!CjkFont.isEmpty())
+        {
+            ImFontConfig cjk;
+            cjk.MergeMode = true;
+            cjk.FontDataOwnedByAtlas = false;
+            atlas->AddFontFromMemoryTTF(CjkFont.data(), CjkFont.size(), size, &cjk, atlas->GetGlyphRangesChineseSimplifiedCommon());
+        }
+    }
+
+    size_t texture_bytes(ImFontAtlas* atlas)
+    {
+        return (size_t)atlas->TexWidth * (size_t)atlas->TexHeight * 4;
+    }
+
+    void zoom_ui()
+    {
+        ImGui::SetNextWindowPos(ImVec2(0.0f, 0.0f));
+        ImGui::SetNextWindowSize(ImGui::GetIO().DisplaySize);
+        ImGui::Begin("Text", nullptr, ImGuiWindowFlags_NoDecoration);
+        for (int i = 0; i < 60; i++)
+            ImGui::Text(CjkFont.isEmpty() ? "Row %02d: the quick brown fox jumps over the lazy dog" : "Row %02d: the quick brown fox \xe6\xb5\x8b\xe8\xaf\x95\xe6\x96\x87\xe5\xad\x97", i);
+        ImGui::End();
+    }
+
+    //在无头上下文中换上给定的图集配置,按各缩放级别各渲染一组帧
+    void render_zooms(ImGui_ImplQtFixture_Headless& headless, const char* name, bool sdf)
+    {
+        headless.makeCurrent();
+        ImGuiIO& io = ImGui::GetIO();
+        //距离场着色器只在图集是距离场时创建,整组设备对象随图集重建
+        ImGui_ImplQtOpenGL3_DestoryDeviceObjects();
+        io.Fonts->Clear();
+        add_fonts(io.Fonts, BaseSize);
+        ImGui_ImplQt_SetFontAtlasSdf(io.Fonts, sdf);
+        io.Fonts->Build();
+        ImGui_ImplQtOpenGL3_CreateDeviceObjects();
+
+        for (float zoom : Zooms)
+        {
+            io.FontGlobalScale = zoom;
+            auto result = ImGui_ImplQtBenchmark_Measure(10, 100, [&] { headless.frame(zoom_ui); });
+            ImGui_ImplQtOpenGL3_FrameStats stats;
+            ImGui_ImplQtOpenGL3_GetFrameStats(&stats);
+            char label[64], details[96];
+            snprintf(label, sizeof(label), "%s x%.2f", name, zoom);
+            snprintf(details, sizeof(details), "%d draw calls, %d sdf, %d program switches", stats.DrawCalls, stats.SdfDrawCalls, stats.ProgramSwitches);
+            ImGui_ImplQtBenchmark_Print(label, result, details);
+        }
+        io.FontGlobalScale = 1.0f;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    QGuiApplication app(argc, argv);
+    const QString cjk_path = argc > 1 ? QString::fromLocal8Bit(argv[1]) : ImGui_ImplQtFixture_FindCjkFont();
+    QFile file(cjk_path);
+    if (!cjk_path.isEmpty() && file.open(QIODevice::ReadOnly))
+        CjkFont = file.readAll();
+    printf("Text zoom %.0f px x%.2f..x%.2f, %s\n", BaseSize, Zooms[0], Zooms[IM_ARRAYSIZE(Zooms) - 1],
+        CjkFont.isEmpty() ? "ASCII only (no CJK font found)" : "with ChineseSimplifiedCommon");
+
+    //位图:每个缩放级别重建一次
+    size_t bitmap_largest = 0, bitmap_all_levels = 0, bitmap_base = 0;
+    double bitmap_build_ms = 0.0;
+    int rebuilds = 0;
+    for (float zoom : Zooms)
+    {
+        ImFontAtlas atlas;
+        add_fonts(&atlas, BaseSize * zoom);
+        QElapsedTimer timer;
+        timer.start();
+        atlas.Build();
+        bitmap_build_ms += (double)timer.nsecsElapsed() / 1e6;
+        rebuilds++;
+        bitmap_largest = std::max(bitmap_largest, texture_bytes(&atlas));
+        bitmap_all_levels += texture_bytes(&atlas);
+        if (zoom == 1.0f)
+            bitmap_base = texture_bytes(&atlas);
+    }
+
+    //距离场:一次构建覆盖所有级别
+    ImFontAtlas sdf_atlas;
+    add_fonts(&sdf_atlas, BaseSize);
+    ImGui_ImplQt_SetFontAtlasSdf(&sdf_atlas, true);
+    QElapsedTimer timer;
+    timer.start();
+    sdf_atlas.Build();
+    const double sdf_build_ms = (double)timer.nsecsElapsed() / 1e6;
+    ImGui_ImplQt_FontAtlasSdfStats sdf_stats;
+    ImGui_ImplQt_GetFontAtlasSdfStats(&sdf_stats);
+
+    printf("%-44s rebuilds %d  build %8.2f ms  texture %8.1f KiB\n", "bitmap, scaled (blurry above x1)", 1, bitmap_build_ms / rebuilds, bitmap_base / 1024.0);
+    printf("%-44s rebuilds %d  build %8.2f ms  texture %8.1f KiB largest, %8.1f KiB all levels cached\n", "bitmap, rebuilt per zoom level",
+        rebuilds, bitmap_build_ms, bitmap_largest / 1024.0, bitmap_all_levels / 1024.0);
+    printf("%-44s rebuilds %d  build %8.2f ms  texture %8.1f KiB  glyph texels %zu (bitmap %zu)\n", "sdf", 1, sdf_build_ms,
+        texture_bytes(&sdf_atlas) / 1024.0, sdf_stats.GlyphTexels, sdf_stats.BitmapGlyphTexels);
+    fflush(stdout);
+
+    ImGui_ImplQtFixture_Headless headless;
+    if (!headless.create(1280, 1080))
+    {
+        printf("No OpenGL context, frame timings skipped\n");
+        return 0;
+    }
+    printf("GL_RENDERER %s\n", (const char*)headless.context()->functions()->glGetString(GL_RENDERER));
+    render_zooms(headless, "bitmap scaled frame", false);
+    render_zooms(headless, "sdf frame", true);
+    return 0;
+}
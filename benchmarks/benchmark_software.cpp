@@ -0,0 +1,107 @@
+﻿#include "benchmark.h"
+#include "imgui_impl_qt_software.h"
+#include <QtCore/QProcess>
+#include <QtCore/QThread>
+#include <math.h>
+
+namespace
+{
+    //两个后端渲染同样的内容: 演示窗口、大量文字控件和覆盖大面积的半透明填充
+    void benchmark_ui()
+    {
+        ImGui::SetNextWindowPos(ImVec2(20.0f, 20.0f));
+        ImGui::SetNextWindowSize(ImVec2(560.0f, 900.0f));
+        ImGui::ShowDemoWindow();
+
+        ImGui::SetNextWindowPos(ImVec2(600.0f, 20.0f));
+        ImGui::SetNextWindowSize(ImVec2(640.0f, 900.0f));
+        ImGui::Begin("Widgets");
+        static float values[256];
+        for (int i = 0; i < IM_ARRAYSIZE(values); i++)
+            values[i] = sinf(i * 0.1f);
+        ImGui::PlotLines("Lines", values, IM_ARRAYSIZE(values), 0, nullptr, -1.0f, 1.0f, ImVec2(0.0f, 120.0f));
+        for (int i = 0; i < 100; i++)
+        {
+            ImGui::Text("Row %03d: the quick brown fox jumps over the lazy dog", i);
+            ImGui::SameLine();
+            ImGui::SmallButton("Button");
+        }
+        ImGui::End();
+
+        ImDrawList* draw_list = ImGui::GetBackgroundDrawList();
+        for (int i = 0; i < 32; i++)
+            draw_list->AddCircleFilled(ImVec2(1300.0f + (i % 4) * 150.0f, 100.0f + (i / 4) * 120.0f), 90.0f, IM_COL32(40 * (i % 6), 120, 200, 96), 64);
+    }
+
+    void run_opengl(int width, int height)
+    {
+        ImGui_ImplQtFixture_Headless headless;
+        if (!headless.create(width, height))
+        {
+            printf("No OpenGL context, OpenGL case skipped\n");
+            return;
+        }
+        auto result = ImGui_ImplQtBenchmark_Measure(10, 100, [&] {
+            headless.frame(benchmark_ui);
+        });
+        char details[64];
+        snprintf(details, sizeof(details), "%d vertices", ImGui::GetDrawData()->TotalVtxCount);
+        char name[128];
+        snprintf(name, sizeof(name), "  OpenGL, %s", (const char*)headless.context()->functions()->glGetString(GL_RENDERER));
+        ImGui_ImplQtBenchmark_Print(name, result, details);
+        fflush(stdout);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    QGuiApplication app(argc, argv);
+    const int width = 1920;
+    const int height = 1080;
+    //子进程只运行OpenGL部分
+    if (QCoreApplication::arguments().contains("--opengl-only"))
+    {
+        run_opengl(width, height);
+        return 0;
+    }
+    char details[64];
+    printf("Software rasterizer against OpenGL on the same frames, %dx%d\n", width, height);
+
+    int thread_counts[] = { 1, 2, 4, QThread::idealThreadCount() };
+    for (int thread_count : thread_counts)
+    {
+        ImGuiContext* context = ImGui::CreateContext();
+        ImGui::GetIO().IniFilename = nullptr;
+        ImGui_ImplQt_InitHeadless(width, height);
+        ImGui_ImplQtSoftware_Init(thread_count);
+        auto result = ImGui_ImplQtBenchmark_Measure(10, 100, [] {
+            ImGui_ImplQtSoftware_NewFrame();
+            ImGui_ImplQt_NewFrame();
+            ImGui::NewFrame();
+            benchmark_ui();
+            ImGui::Render();
+            ImGui_ImplQtSoftware_RenderDrawData(ImGui::GetDrawData());
+        });
+        snprintf(details, sizeof(details), "%d vertices", ImGui::GetDrawData()->TotalVtxCount);
+        char name[64];
+        snprintf(name, sizeof(name), "  software, %d threads", thread_count);
+        ImGui_ImplQtBenchmark_Print(name, result, details);
+        ImGui_ImplQtSoftware_Shutdown();
+        ImGui_ImplQt_Shutdown();
+        ImGui::DestroyContext(context);
+    }
+
+    fflush(stdout);
+    run_opengl(width, height);
+
+    //驱动在进程内第一次创建上下文时选定,llvmpipe的对照在设置了LIBGL_ALWAYS_SOFTWARE=1的子进程里运行
+    QProcess process;
+    QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+    environment.insert("LIBGL_ALWAYS_SOFTWARE", "1");
+    process.setProcessEnvironment(environment);
+    process.setProcessChannelMode(QProcess::ForwardedChannels);
+    process.start(QCoreApplication::applicationFilePath(), { "--opengl-only" });
+    if (!process.waitForFinished(-1))
+        printf("LIBGL_ALWAYS_SOFTWARE=1 run failed, llvmpipe case skipped\n");
+    return 0;
+}
@@ -0,0 +1,121 @@
+#pragma once
+#include <QtGui/QGuiApplication>
+#include <QtGui/QOffscreenSurface>
+#include <QtGui/QOpenGLContext>
+#include <QtGui/QOpenGLFunctions>
+#include <QtGui/QOpenGLFramebufferObject>
+#include <QtCore/QFile>
+#include <QtCore/QString>
+#include <memory>
+
+#include "imgui.h"
+#include "imgui_impl_qt.h"
+#include "imgui_impl_qt_opengl3.h"
+
+// Fixtures shared by the benchmark and test programs
+
+// Font covering GetGlyphRangesChineseFull(): IMGUI_QT_CJK_FONT or one commonly installed with the system.
+// Returns an empty string when none is found, the font cases are skipped then.
+inline QString ImGui_ImplQtFixture_FindCjkFont()
+{
+    const QString from_env = qEnvironmentVariable("IMGUI_QT_CJK_FONT");
+    if (!from_env.isEmpty())
+        return from_env;
+    static const char* const candidates[] = {
+        "C:/Windows/Fonts/msyh.ttc",
+        "C:/Windows/Fonts/simhei.ttf",
+        "/System/Library/Fonts/PingFang.ttc",
+        "/usr/share/fonts/opentype/noto/NotoSansCJK-Regular.ttc",
+        "/usr/share/fonts/noto-cjk/NotoSansCJK-Regular.ttc",
+        "/usr/share/fonts/truetype/wqy/wqy-microhei.ttc",
+        "/usr/share/fonts/wenquanyi/wqy-microhei/wqy-microhei.ttc",
+    };
+    for (const char* candidate : candidates)
+        if (QFile::exists(QString::fromUtf8(candidate)))
+            return QString::fromUtf8(candidate);
+    return QString();
+}
+
+// ImGui context rendering into an offscreen framebuffer object with the OpenGL3 renderer,
+// see ImGui_ImplQt_Init(QOffscreenSurface*, QOpenGLFramebufferObject*).
+class ImGui_ImplQtFixture_Headless
+{
+public:
+    ~ImGui_ImplQtFixture_Headless() { destroy(); }
+
+    // Returns false when no OpenGL context can be created on this machine
+    bool create(int width, int height, const QSurfaceFormat& format = QSurfaceFormat::defaultFormat())
+    {
+        glContext.reset(new QOpenGLContext());
+        glContext->setFormat(format);
+        if (!glContext->create())
+            return false;
+        surface.reset(new QOffscreenSurface());
+        surface->setFormat(glContext->format());
+        surface->create();
+        if (!glContext->makeCurrent(surface.get()))
+            return false;
+        fbo.reset(new QOpenGLFramebufferObject(width, height, QOpenGLFramebufferObject::CombinedDepthStencil));
+
+        imguiContext = ImGui::CreateContext();
+        ImGui::SetCurrentContext(imguiContext);
+        ImGui::GetIO().IniFilename = nullptr;
+        ImGui_ImplQt_Init(surface.get(), fbo.get());
+        ImGui_ImplQtOpenGL3_Init();
+        return true;
+    }
+
+    void destroy()
+    {
+        if (!imguiContext)
+            return;
+        makeCurrent();
+        ImGui_ImplQtOpenGL3_Shutdown();
+        ImGui_ImplQt_Shutdown();
+        ImGui::DestroyContext(imguiContext);
+        imguiContext = nullptr;
+        fbo.reset();
+        glContext->doneCurrent();
+    }
+
+    void makeCurrent()
+    {
+        glContext->makeCurrent(surface.get());
+        ImGui::SetCurrentContext(imguiContext);
+    }
+
+    // One complete frame, glFinish() included so the GPU time counts
+    template<typename F>
+    void frame(F&& ui)
+    {
+        ImGui_ImplQtOpenGL3_NewFrame();
+        ImGui_ImplQt_NewFrame();
+        ImGui::NewFrame();
+        ui();
+        ImGui::Render();
+        render(ImGui::GetDrawData());
+    }
+
+    // Draws into the cleared framebuffer and waits for the GPU
+    void render(ImDrawData* draw_data)
+    {
+        fbo->bind();
+        QOpenGLFunctions* f = glContext->functions();
+        f->glViewport(0, 0, fbo->width(), fbo->height());
+        f->glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+        f->glClear(GL_COLOR_BUFFER_BIT);
+        if (draw_data)
+            ImGui_ImplQtOpenGL3_RenderDrawData(draw_data);
+        f->glFinish();
+    }
+
+    QOpenGLContext* context() const { return glContext.get(); }
+    QOffscreenSurface* offscreenSurface() const { return surface.get(); }
+    QOpenGLFramebufferObject* framebuffer() const { return fbo.get(); }
+    ImGuiContext* imgui() const { return imguiContext; }
+private:
+    std::unique_ptr<QOpenGLContext> glContext;
+    std::unique_ptr<QOffscreenSurface> surface;
+    std::unique_ptr<QOpenGLFramebufferObject> fbo;
+    ImGuiContext* imguiContext{};
+};
@@ -3,22 +3,173 @@
 #include <QtWidgets/QOpenGLWidget>
 #include <QtGui/QOpenGLWindow>
 #include <QtCore/QFile>
+#include <QtGui/QPainter>
+#include <QtWidgets/QHBoxLayout>
+#include <QtCore/QElapsedTimer>
+#include <QtGui/QMouseEvent>
+#include <vector>
+#include <thread>
+#include <math.h>
 
 #include "imgui_impl_qt.h"
 #include "imgui_impl_qt_opengl3.h"
+#include "imgui_impl_qt_software.h"
+#include "imgui_impl_qt_fonts.h"
+#include "imgui_impl_qt_host.h"
 
 namespace
 {
     struct ImDemo
     {
+        bool sdf{};
+        bool low_latency{};
+        bool quality_governor{};
+        bool software{};
+        ImGui_ImplQtOpenGL3_PlotSeries* plot_series{};
+        int  plot_size{ -1 };
+        int  plot_sample{};
+        std::vector<ImGui_ImplQtOpenGL3_AtlasImage*> icons;
+        std::vector<ImGui_ImplQtOpenGL3_StreamTexture*> icon_textures;
+        bool  icon_atlas{ true };
+        float queue_push_ns{ -1.0f };
+        float post_event_ns{};
+        float post_deliver_ns{};
+
         void initialize()
         {
-            QString font = QCoreApplication::applicationDirPath() + "/LXGWBright-Regular.ttf";
-            if (!QFile::exists(font))
-                return;
             ImGuiIO& io = ImGui::GetIO();
-            io.Fonts->AddFontFromFileTTF(font.toStdString().c_str(),
-                24.0f, nullptr, io.Fonts->GetGlyphRangesChineseFull());
+            //距离场字体只烘焙一次,缩放时不必重建图集
+            if (sdf)
+                ImGui_ImplQt_SetFontAtlasSdf(io.Fonts, true);
+            QString font = QCoreApplication::applicationDirPath() + "/LXGWBright-Regular.ttf";
+            if (QFile::exists(font))
+                io.Fonts->AddFontFromFileTTF(font.toStdString().c_str(),
+                    24.0f, nullptr, io.Fonts->GetGlyphRangesChineseFull());
+            //字号按逻辑像素给出,移到高DPI屏幕时在后台构建对应倍率的图集
+            ImGui_ImplQt_SetFontAtlasDpiVariants(io.Fonts);
+        }
+
+        //曲线基准: 10^5到10^7个点,每帧追加1000个样本,绘制列表里只有一条回调命令
+        void plot()
+        {
+            static const int sizes[] = { 100000, 1000000, 10000000 };
+            static const char* labels[] = { "10^5 points", "10^6 points", "10^7 points" };
+            ImGui::SetNextWindowSize(ImVec2(640, 320), ImGuiCond_FirstUseEver);
+            ImGui::Begin("Plot series");
+            int size = plot_size < 0 ? 0 : plot_size;
+            if (ImGui::Combo("Series", &size, labels, IM_ARRAYSIZE(labels)) || plot_size < 0)
+            {
+                ImGui_ImplQtOpenGL3_DestroyPlotSeries(plot_series);
+                plot_series = ImGui_ImplQtOpenGL3_CreatePlotSeries(sizes[size]);
+                plot_size = size;
+                plot_sample = 0;
+                append_plot_samples(sizes[size]);
+            }
+            append_plot_samples(1000);
+
+            const ImVec2 p_min = ImGui::GetCursorScreenPos();
+            const ImVec2 avail = ImGui::GetContentRegionAvail();
+            const ImVec2 p_max(p_min.x + avail.x, p_min.y + avail.y - ImGui::GetTextLineHeightWithSpacing());
+            QElapsedTimer timer;
+            timer.start();
+            ImGui_ImplQtOpenGL3_AddPlotSeries(ImGui::GetWindowDrawList(), plot_series, p_min, p_max, -1.5f, 1.5f, IM_COL32(255, 200, 60, 255));
+            const float submit_us = timer.nsecsElapsed() / 1000.0f;
+            ImGui::Dummy(ImVec2(avail.x, p_max.y - p_min.y));
+
+            ImGui_ImplQtOpenGL3_FrameStats frame_stats;
+            ImGui_ImplQtOpenGL3_GetFrameStats(&frame_stats);
+            ImGui::Text("Submit %.1f us, %d vertices on the GPU, %.3f ms/frame", submit_us, frame_stats.PlotVertices, 1000.0f / ImGui::GetIO().Framerate);
+            ImGui::End();
+        }
+
+        //图标网格基准: 256个32x32图标,各用一个纹理时每个图标一条绘制命令,打进图集后合并为一条
+        void icon_grid()
+        {
+            enum { IconCount = 256, IconSize = 32, Columns = 16 };
+            if (icons.empty())
+            {
+                std::vector<ImU32> pixels(IconSize * IconSize);
+                for (int i = 0; i < IconCount; i++)
+                {
+                    const ImU32 col = ImColor::HSV((float)i / IconCount, 0.7f, 0.9f);
+                    for (int y = 0; y < IconSize; y++)
+                        for (int x = 0; x < IconSize; x++) {
+                            const float dx = x + 0.5f - IconSize * 0.5f, dy = y + 0.5f - IconSize * 0.5f;
+                            pixels[y * IconSize + x] = dx * dx + dy * dy < (IconSize * 0.45f) * (IconSize * 0.45f) ? col : 0;
+                        }
+                    icons.push_back(ImGui_ImplQtOpenGL3_AddAtlasImage(pixels.data(), IconSize, IconSize));
+                    ImGui_ImplQtOpenGL3_StreamTexture* texture = ImGui_ImplQtOpenGL3_CreateStreamTexture(IconSize, IconSize);
+                    ImGui_ImplQtOpenGL3_PushStreamFrame(texture, pixels.data());
+                    icon_textures.push_back(texture);
+                }
+            }
+
+            ImGui::Begin("Icon grid");
+            ImGui::Checkbox("Atlas", &icon_atlas);
+            ImDrawList* draw_list = ImGui::GetWindowDrawList();
+            const int first_command = draw_list->CmdBuffer.Size;
+            for (int i = 0; i < IconCount; i++)
+            {
+                if (i % Columns)
+                    ImGui::SameLine();
+                ImGui_ImplQtOpenGL3_AtlasRegion region;
+                if (icon_atlas && ImGui_ImplQtOpenGL3_GetAtlasRegion(icons[i], &region))
+                    ImGui::Image(region.TextureId, region.Size, region.Uv0, region.Uv1);
+                else
+                    ImGui::Image(ImGui_ImplQtOpenGL3_GetStreamTextureID(icon_textures[i]), ImVec2(IconSize, IconSize));
+            }
+            const int commands = draw_list->CmdBuffer.Size - first_command;
+
+            ImGui_ImplQtOpenGL3_FrameStats frame_stats;
+            ImGui_ImplQtOpenGL3_GetFrameStats(&frame_stats);
+            ImGui_ImplQtOpenGL3_AtlasStats atlas_stats;
+            ImGui_ImplQtOpenGL3_GetAtlasStats(&atlas_stats);
+            ImGui::Text("%d draw commands for %d icons, %d draw calls in the last frame", commands, IconCount, frame_stats.DrawCalls);
+            ImGui::Text("Atlas %d/%d images in %d pages, %.0f%% occupied, %d evictions, %d defragmentations",
+                atlas_stats.ResidentImages, atlas_stats.Images, atlas_stats.Pages, atlas_stats.Occupancy * 100.0f, atlas_stats.Evictions, atlas_stats.Defragmentations);
+            ImGui::End();
+        }
+
+        void append_plot_samples(int count)
+        {
+            std::vector<float> values((size_t)count);
+            for (float& v : values) {
+                v = sinf(plot_sample * 0.0005f) + 0.3f * sinf(plot_sample * 0.37f);
+                plot_sample++;
+            }
+            ImGui_ImplQtOpenGL3_AppendPlotSamples(plot_series, values.data(), count);
+        }
+
+        //输入注入基准: 工作线程写入无锁队列与投递QMouseEvent的单条耗时,事件在GUI线程上的分发单独计时
+        void input_benchmark()
+        {
+            enum { Count = 4000 };  //小于队列容量,不会丢弃
+            if (ImGui::Button("Input injection benchmark"))
+            {
+                ImGui_ImplQt_InputQueue* queue = ImGui_ImplQt_GetInputQueue();
+                const ImVec2 pos = ImGui::GetIO().MousePos;
+                QObject sink;
+                std::thread producer([&]() {
+                    QElapsedTimer timer;
+                    timer.start();
+                    for (int i = 0; i < Count; i++)
+                        ImGui_ImplQt_QueueMousePos(queue, pos.x, pos.y);
+                    queue_push_ns = (float)timer.nsecsElapsed() / Count;
+                    timer.restart();
+                    for (int i = 0; i < Count; i++)
+                        QCoreApplication::postEvent(&sink, new QMouseEvent(QEvent::MouseMove, QPointF(pos.x, pos.y), Qt::NoButton, Qt::NoButton, Qt::NoModifier));
+                    post_event_ns = (float)timer.nsecsElapsed() / Count;
+                });
+                producer.join();
+                QElapsedTimer timer;
+                timer.start();
+                QCoreApplication::sendPostedEvents(&sink);
+                post_deliver_ns = (float)timer.nsecsElapsed() / Count;
+            }
+            ImGui_ImplQt_InputQueueStats queue_stats;
+            if (queue_push_ns >= 0.0f && ImGui_ImplQt_GetInputQueueStats(&queue_stats))
+                ImGui::Text("Queue push %.0f ns, %d drained (%d dropped); postEvent %.0f ns + delivery %.0f ns",
+                    queue_push_ns, queue_stats.Drained, queue_stats.Dropped, post_event_ns, post_deliver_ns);
         }
 
         void render()
@@ -39,14 +190,59 @@ namespace
             ImGui::Begin("Example:Fullscreen window", nullptr, flags);
             {
                 static float f = 0.0f;
+                static float zoom = 1.0f;
+                ImGui::SetWindowFontScale(zoom);
+                ImGui::SliderFloat("zoom", &zoom, 0.5f, 4.0f);
                 ImGui::Text(u8"Hello, world!");
                 ImGui::SliderFloat("float", &f, 0.0f, 1.0f);
                 ImGui::ColorEdit3("clear color", (float*)&clear_color);
                 if (ImGui::Button("ImGui Demo")) show_imgui_demo_window ^= 1;
                 ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+                ImGui_ImplQt_AllocatorStats alloc_stats;
+                if (ImGui_ImplQt_GetAllocatorStats(&alloc_stats))
+                    ImGui::Text("Heap %d allocs/frame, %.1f KB live (peak %.1f KB)", alloc_stats.AllocationsPerFrame, alloc_stats.LiveBytes / 1024.0f, alloc_stats.PeakBytes / 1024.0f);
+                ImGui_ImplQt_FontAtlasDpiStats font_stats;
+                if (ImGui_ImplQt_GetFontAtlasDpiStats(ImGui::GetIO().Fonts, &font_stats))
+                    ImGui::Text("Font atlas x%.2f, %d cached, last build %.1f ms, last swap %.2f ms", font_stats.Scale, font_stats.Variants, font_stats.LastBuildMs, font_stats.LastSwapMs);
+                ImGui_ImplQt_FontAtlasSdfStats sdf_stats;
+                ImGui_ImplQt_GetFontAtlasSdfStats(&sdf_stats);
+                if (sdf && sdf_stats.Builds > 0)
+                    ImGui::Text("SDF atlas %d builds, %.1f KB texture, glyphs %.0fk texels (bitmap %.0fk per zoom level)", sdf_stats.Builds,
+                        sdf_stats.TextureBytes / 1024.0f, sdf_stats.GlyphTexels / 1000.0f, sdf_stats.BitmapGlyphTexels / 1000.0f);
+                ImGui_ImplQtOpenGL3_MemoryStats memory_stats, total_memory_stats;
+                ImGui_ImplQtOpenGL3_GetMemoryStats(&memory_stats);
+                ImGui_ImplQtOpenGL3_GetTotalMemoryStats(&total_memory_stats);
+                ImGui::Text("GPU memory %.1f KB (peak %.1f KB), textures %.1f KB, buffers %.1f KB, all views %.1f KB",
+                    memory_stats.TotalBytes / 1024.0f, memory_stats.TotalPeakBytes / 1024.0f,
+                    memory_stats.CurrentBytes[ImGui_ImplQtOpenGL3_MemoryCategory_Textures] / 1024.0f,
+                    (memory_stats.CurrentBytes[ImGui_ImplQtOpenGL3_MemoryCategory_VertexBuffers] + memory_stats.CurrentBytes[ImGui_ImplQtOpenGL3_MemoryCategory_IndexBuffers]
+                        + memory_stats.CurrentBytes[ImGui_ImplQtOpenGL3_MemoryCategory_PixelBuffers]) / 1024.0f,
+                    total_memory_stats.TotalBytes / 1024.0f);
+                static const char* feature_levels[ImGui_ImplQtOpenGL3_FeatureLevel_COUNT] = { "GL 3.0", "GL 3.3", "GL 4.5", "ES 3.0" };
+                ImGui::Text("Renderer feature level %s", feature_levels[ImGui_ImplQtOpenGL3_GetFeatureLevel()]);
+                //低延迟模式: 输入到达后立即重绘,GPU队列最多一帧
+                if (ImGui::Checkbox("Low latency", &low_latency))
+                    ImGui_ImplQt_SetLowLatency(low_latency);
+                ImGui_ImplQt_LatencyStats latency_stats;
+                if (ImGui_ImplQt_GetLatencyStats(&latency_stats) && latency_stats.Samples > 0)
+                    ImGui::Text("Input to photon p50 %.1f ms, p90 %.1f ms, p99 %.1f ms, max %.1f ms, GPU %.2f ms, %d queued",
+                        latency_stats.P50Ms, latency_stats.P90Ms, latency_stats.P99Ms, latency_stats.MaxMs, latency_stats.GpuMs, latency_stats.QueuedFrames);
+                //帧时间超出预算时逐级降低画质
+                if (ImGui::Checkbox("Quality governor", &quality_governor))
+                    ImGui_ImplQt_SetQualityGovernor(quality_governor);
+                ImGui_ImplQt_QualityStats quality_stats;
+                if (ImGui_ImplQt_GetQualityStats(&quality_stats))
+                    ImGui::Text("Quality level %d, frame %.2f / %.2f ms, %d down, %d up, %d paints skipped",
+                        quality_stats.Level, quality_stats.FrameMs, quality_stats.BudgetMs, quality_stats.StepsDown, quality_stats.StepsUp, quality_stats.PaintsSkipped);
+                input_benchmark();
             }
             ImGui::End();
 
+            if (!software) {
+                plot();
+                icon_grid();
+            }
+
             // 2. Show another simple window, this time using an explicit Begin/End pair
             if (show_imgui_demo_window)
             {
@@ -55,6 +251,31 @@ namespace
             }
         }
     };
+
+    //同一界面分别放在两种宿主里,对比帧时间与输入延迟
+    struct HostDemo
+    {
+        ImDemo      demo{};
+        QWidget*    host{};
+        const char* name{};
+
+        static void initialize(void* user_data) { static_cast<HostDemo*>(user_data)->demo.initialize(); }
+        static void render(void* user_data)
+        {
+            HostDemo* self = static_cast<HostDemo*>(user_data);
+            self->demo.render();
+            ImGui_ImplQt_HostStats stats;
+            if (ImGui_ImplQt_GetHostStats(self->host, &stats))
+            {
+                ImGui::SetNextWindowPos(ImVec2(10, 10), ImGuiCond_FirstUseEver);
+                ImGui::Begin("Host");
+                ImGui::Text("%s", self->name);
+                ImGui::Text("Frame %.2f ms, paint %.2f ms", stats.FrameIntervalMs, stats.PaintMs);
+                ImGui::Text("Input latency %.1f ms (average %.1f ms)", stats.InputLatencyMs, stats.InputLatencyAverageMs);
+                ImGui::End();
+            }
+        }
+    };
 }
 
 
@@ -64,6 +285,7 @@ public:
     explicit ApplicationView(QWidget* parent = Q_NULLPTR, Qt::WindowFlags f = Qt::WindowFlags())
         :QOpenGLWidget(parent, f)
     {};
+    void setSdfFonts(bool enable) { demo.sdf = enable; }
     ~ApplicationView()
     {
         ImGui::SetCurrentContext(m_ctx);
@@ -73,6 +295,9 @@ public:
     }
 protected:
     void initializeGL() override {
+        //换到别的顶层窗口时会重新创建GL上下文并再次调用这里,渲染器在下一帧自行恢复
+        if (m_ctx)
+            return;
         m_ctx = ImGui::CreateContext();
         ImGui::SetCurrentContext(m_ctx);
         ImGui_ImplQt_Init(this);
@@ -109,6 +334,9 @@ public:
     }
 protected:
     void initializeGL() override {
+        //换到别的顶层窗口时会重新创建GL上下文并再次调用这里,渲染器在下一帧自行恢复
+        if (m_ctx)
+            return;
         m_ctx = ImGui::CreateContext();
         ImGui::SetCurrentContext(m_ctx);
         ImGui_ImplQt_Init(this);
@@ -133,10 +361,53 @@ private:
     ImDemo  demo{};
 };
 
+//无GPU时使用软件光栅化
+class ApplicationSoftwareView :public QWidget
+{
+public:
+    explicit ApplicationSoftwareView(QWidget* parent = Q_NULLPTR, Qt::WindowFlags f = Qt::WindowFlags())
+        :QWidget(parent, f)
+    {
+        m_ctx = ImGui::CreateContext();
+        ImGui::SetCurrentContext(m_ctx);
+        ImGui_ImplQt_Init(this);
+        ImGui_ImplQtSoftware_Init();
+
+        demo.software = true;
+        demo.initialize();
+    };
+    ~ApplicationSoftwareView()
+    {
+        ImGui::SetCurrentContext(m_ctx);
+        ImGui_ImplQtSoftware_Shutdown();
+        ImGui_ImplQt_Shutdown();
+        ImGui::DestroyContext(m_ctx);
+    }
+protected:
+    void paintEvent(QPaintEvent*) override {
+        ImGui::SetCurrentContext(m_ctx);
+        ImGui_ImplQtSoftware_NewFrame();
+        ImGui_ImplQt_NewFrame();
+        ImGui::NewFrame();
+
+        demo.render();
+
+        ImGui::Render();
+        ImGui_ImplQtSoftware_RenderDrawData(ImGui::GetDrawData());
+
+        QPainter painter(this);
+        painter.drawImage(0, 0, ImGui_ImplQtSoftware_GetImage());
+    }
+private:
+    ImGuiContext* m_ctx{};
+    ImDemo  demo{};
+};
 
 int main(int argc, char** argv)
 {
     QApplication app(argc, argv);
+    ImGui_ImplQt_EnablePoolAllocator();
+    ImGui_ImplQt_SetFontAtlasCache("");
 
     ApplicationView appView{};
     appView.setWindowTitle("ImGui Qt backend example - QOpenGLWidget");
@@ -144,7 +415,8 @@ int main(int argc, char** argv)
     appView.show();
 
     ApplicationView appView1{};
-    appView1.setWindowTitle("ImGui Qt backend example - QOpenGLWidget (other)");
+    appView1.setWindowTitle("ImGui Qt backend example - QOpenGLWidget (SDF fonts)");
+    appView1.setSdfFonts(true);
     appView1.resize(1280, 720);
     appView1.show();
 
@@ -153,10 +425,31 @@ int main(int argc, char** argv)
     appView2.resize(1280, 720);
     appView2.show();
 
+    ApplicationSoftwareView appView3{};
+    appView3.setWindowTitle("ImGui Qt backend example - Software");
+    appView3.resize(1280, 720);
+    appView3.show();
+
+    HostDemo widgetHost{};
+    HostDemo windowHost{};
+    widgetHost.name = "QOpenGLWidget";
+    windowHost.name = "QOpenGLWindow in createWindowContainer";
+    QWidget hostView{};
+    hostView.setWindowTitle("ImGui Qt backend example - host comparison");
+    hostView.resize(1280, 720);
+    QHBoxLayout* hostLayout = new QHBoxLayout(&hostView);
+    hostLayout->setContentsMargins(0, 0, 0, 0);
+    widgetHost.host = ImGui_ImplQt_CreateHost(ImGui_ImplQt_HostType_OpenGLWidget, HostDemo::initialize, HostDemo::render, &widgetHost);
+    windowHost.host = ImGui_ImplQt_CreateHost(ImGui_ImplQt_HostType_OpenGLWindow, HostDemo::initialize, HostDemo::render, &windowHost);
+    hostLayout->addWidget(widgetHost.host);
+    hostLayout->addWidget(windowHost.host);
+    hostView.show();
+
     QTimer timer;
     QObject::connect(&timer, SIGNAL(timeout()), &appView, SLOT(update()));
     QObject::connect(&timer, SIGNAL(timeout()), &appView1, SLOT(update()));
     QObject::connect(&timer, SIGNAL(timeout()), &appView2, SLOT(update()));
+    QObject::connect(&timer, SIGNAL(timeout()), &appView3, SLOT(update()));
     timer.start(16);
 
     return app.exec();
@@ -0,0 +1,7 @@
+#pragma once
+
+// imgui user config selected with IMGUI_QT_THREAD_LOCAL_CONTEXT=ON: the current context is kept per thread instead of
+// per process, so each thread can run its own headless UI after ImGui::SetCurrentContext().
+struct ImGuiContext;
+extern thread_local ImGuiContext* ImGui_ImplQt_ThreadContext;
+#define GImGui ImGui_ImplQt_ThreadContext
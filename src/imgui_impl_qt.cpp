@@ -2,6 +2,8 @@
 #include <QtCore/QObject>
 #include <QtWidgets/QOpenGLWidget>
 #include <QtGui/QOpenGLWindow>
+#include <QtGui/QOffscreenSurface>
+#include <QtGui/QOpenGLFramebufferObject>
 #include <QtGui/QGuiApplication>
 #include <QtGui/QClipboard>
 #include <QtCore/QDateTime>
@@ -9,8 +11,16 @@
 #include <QtGui/QWheelEvent>
 #include <QtGui/QKeyEvent>
 #include <QtGui/QInputMethodEvent>
+#include <QtGui/QWindow>
+#include <QtGui/QScreen>
+#include <QtCore/QPointer>
 
 #include "imgui.h"
+#include "imgui_impl_qt_allocator.h"
+#include "imgui_impl_qt_fonts.h"
+#include "imgui_impl_qt_latency.h"
+#include "imgui_impl_qt_governor.h"
+#include "imgui_impl_qt_input.h"
 #include <memory>
 
 class ImGui_ImplQt_IWindow {
@@ -23,6 +33,10 @@ public:
 
     virtual void setCursor(Qt::CursorShape shape) = 0;
     virtual void setCursorPos(const QPoint& local_pos) = 0;
+    virtual bool enablePartialUpdate() = 0;
+    virtual QWindow* windowHandle() const { return nullptr; }
+    virtual void requestUpdate() {}
+    virtual QEvent::Type paintEventType() const { return QEvent::None; }   //可以跳过而保留上一帧画面的绘制事件
 };
 
 template<typename T>
@@ -58,6 +72,10 @@ public:
     void setCursor(Qt::CursorShape shape) override {
         window->setCursor(shape);
     }
+
+    void requestUpdate() override {
+        window->update();
+    }
 protected:
     T* window{};
 };
@@ -68,6 +86,94 @@ public:
     bool  isActive() const override {
         return window->isActiveWindow();
     }
+
+    bool enablePartialUpdate() override {
+        //保留上一帧的FBO内容,不再在paintGL之前清空
+        window->setUpdateBehavior(QOpenGLWidget::PartialUpdate);
+        return true;
+    }
+
+    QWindow* windowHandle() const override {
+        return window->window()->windowHandle();
+    }
+
+    QEvent::Type paintEventType() const override {
+        //跳过时不调用paintGL,合成时继续使用FBO中的上一帧
+        return QEvent::Paint;
+    }
+};
+
+class ImGui_ImplQt_Widget final :public ImGui_ImplQt_Window<QWidget> {
+public:
+    using Super::Super;
+    bool  isActive() const override {
+        return window->isActiveWindow();
+    }
+
+    bool enablePartialUpdate() override {
+        //光栅窗口每帧重绘整幅QImage
+        return false;
+    }
+
+    QWindow* windowHandle() const override {
+        return window->window()->windowHandle();
+    }
+};
+
+//无窗口: 尺寸来自FBO与调用方给定的DPR,没有光标和焦点
+class ImGui_ImplQt_Headless final :public ImGui_ImplQt_IWindow {
+public:
+    ImGui_ImplQt_Headless(QOffscreenSurface* surface, QOpenGLFramebufferObject* fbo, float device_pixel_ratio)
+        :surface(surface), fbo(fbo), devicePixelRatio(device_pixel_ratio) {};
+
+    void setTarget(QOpenGLFramebufferObject* target, float device_pixel_ratio) {
+        fbo = target;
+        devicePixelRatio = device_pixel_ratio;
+    }
+
+    void setSize(int w, int h, float device_pixel_ratio) {
+        fbo = nullptr;
+        width = w;
+        height = h;
+        devicePixelRatio = device_pixel_ratio;
+    }
+
+    void sizeInfo(int& w, int& h, int& display_w, int& display_h) const override
+    {
+        if (!fbo) {
+            w = width;
+            h = height;
+            display_w = (int)(width * devicePixelRatio);
+            display_h = (int)(height * devicePixelRatio);
+            return;
+        }
+        display_w = fbo->width();
+        display_h = fbo->height();
+        w = (int)(display_w / devicePixelRatio);
+        h = (int)(display_h / devicePixelRatio);
+    }
+
+    bool  isActive() const override {
+        return true;
+    }
+
+    QObject* object() override {
+        return surface;
+    }
+
+    void setCursor(Qt::CursorShape) override {}
+    void setCursorPos(const QPoint&) override {}
+
+    bool enablePartialUpdate() override {
+        //FBO内容在帧之间保持不变
+        return true;
+    }
+private:
+    QOffscreenSurface* surface{};
+    QOpenGLFramebufferObject* fbo{};
+    int   width{};
+    int   height{};
+    float devicePixelRatio{ 1.0f };
 };
 
 class ImGui_ImplQt_OpenGLWindow final :public ImGui_ImplQt_Window<QOpenGLWindow> {
@@ -77,6 +183,20 @@ public:
     bool  isActive() const override {
         return window->isActive();
     }
+
+    bool enablePartialUpdate() override {
+        //QOpenGLWindow只能在构造时指定PartialUpdateBlit/PartialUpdateBlend
+        return window->updateBehavior() != QOpenGLWindow::NoPartialUpdate;
+    }
+
+    QWindow* windowHandle() const override {
+        return window;
+    }
+
+    QEvent::Type paintEventType() const override {
+        //跳过时不交换缓冲区,屏幕保持上一帧
+        return QEvent::UpdateRequest;
+    }
 };
 
 class ImGui_ImplQt :public QObject
@@ -86,13 +206,28 @@ public:
 
     double         Time{};
     bool           WantUpdateMonitors{};
+    QByteArray     ClipboardText;   //无窗口时使用私有剪贴板
+    QByteArray     ClipboardBuffer; //系统剪贴板文本,保持到下次获取
+    bool           UsePoolAllocator{};
+    QPointer<QWindow>       ScreenWindow;   //顶层窗口会随控件改变父窗口而变化
+    QMetaObject::Connection ScreenConnection;
+    ImGui_ImplQt_LatencyTracker Latency;
+    ImGui_ImplQt_QualityGovernor Governor;
+    int            LastDisplayWidth{ -1 };  //上一次NewFrame的帧缓冲尺寸,尺寸变化时不跳过绘制
+    int            LastDisplayHeight{ -1 };
+    std::unique_ptr<ImGui_ImplQt_InputQueue> InputQueue;   //其他线程注入的输入
 public:
     bool  Init(ImGuiIO& io, std::unique_ptr<ImGui_ImplQt_IWindow> window);
     void  NewFrame(ImGuiIO& io);
+    bool  ProcessEvent(QEvent* event);
+    template<typename T>
+    void  TrackSwaps(T* window);
 private:
+    static void WakeFromQueue(void* user_data);
     void  UpdateMouseData(ImGuiIO& io);
     void  UpdateCursorShape(ImGuiIO& io, ImGui_ImplQt_IWindow* window);
     bool  eventFilter(QObject* watched, QEvent* event) override;
+    void  UpdateScreen(ImGuiIO& io, ImGui_ImplQt_IWindow* window);
 private:
     ImGuiContext* Context{};
 };
@@ -102,10 +237,14 @@ static ImGui_ImplQt* ImGui_ImplQt_GetBackendData()
     return ImGui::GetCurrentContext() ? (ImGui_ImplQt*)ImGui::GetIO().BackendPlatformUserData : nullptr;
 }
 
+static bool ImGui_ImplQt_PoolAllocatorEnabled = false;
+
 static const char* ImGui_ImplQt_GetClipboardText(void* user_data)
 {
-    QByteArray buffer = QGuiApplication::clipboard()->text().toUtf8();
-    return (const char*)buffer.data();
+    //返回的指针需要在下次调用前保持有效
+    QByteArray& buffer = ((ImGui_ImplQt*)user_data)->ClipboardBuffer;
+    buffer = QGuiApplication::clipboard()->text().toUtf8();
+    return buffer.constData();
 }
 
 static void ImGui_ImplQt_SetClipboardText(void* user_data, const char* text)
@@ -113,6 +252,22 @@ static void ImGui_ImplQt_SetClipboardText(void* user_data, const char* text)
     QGuiApplication::clipboard()->setText(text);
 }
 
+static const char* ImGui_ImplQt_GetPrivateClipboardText(void* user_data)
+{
+    return ((ImGui_ImplQt*)user_data)->ClipboardText.constData();
+}
+
+static void ImGui_ImplQt_SetPrivateClipboardText(void* user_data, const char* text)
+{
+    ((ImGui_ImplQt*)user_data)->ClipboardText = QByteArray(text);
+}
+
+template<typename T>
+void ImGui_ImplQt::TrackSwaps(T* window)
+{
+    QObject::connect(window, &T::frameSwapped, this, [this]() { Latency.Swapped(); });
+}
+
 bool ImGui_ImplQt_Init(QOpenGLWidget* window)
 {
     ImGuiIO& io = ImGui::GetIO();
@@ -120,6 +275,7 @@ bool ImGui_ImplQt_Init(QOpenGLWidget* window)
     ImGui_ImplQt* bd = IM_NEW(ImGui_ImplQt)();
     if (bd->Init(io, std::make_unique<ImGui_ImplQt_OpenGLWidget>(window))) {
         window->installEventFilter(bd);
+        bd->TrackSwaps(window);
         //设置为接收输入消息，鼠标追踪开启以正确更新鼠标位置
         window->setAttribute(Qt::WA_InputMethodEnabled);
         window->setMouseTracking(true);
@@ -128,6 +284,76 @@ bool ImGui_ImplQt_Init(QOpenGLWidget* window)
     return false;
 }
 
+bool ImGui_ImplQt_Init(QWidget* window)
+{
+    ImGuiIO& io = ImGui::GetIO();
+    IM_ASSERT(io.BackendPlatformUserData == nullptr && "Already initialized a platform backend!");
+    ImGui_ImplQt* bd = IM_NEW(ImGui_ImplQt)();
+    if (bd->Init(io, std::make_unique<ImGui_ImplQt_Widget>(window))) {
+        window->installEventFilter(bd);
+        //设置为接收输入消息，鼠标追踪开启以正确更新鼠标位置
+        window->setAttribute(Qt::WA_InputMethodEnabled);
+        window->setMouseTracking(true);
+        return true;
+    }
+    return false;
+}
+
+static bool ImGui_ImplQt_InitHeadless(std::unique_ptr<ImGui_ImplQt_Headless> window)
+{
+    ImGuiIO& io = ImGui::GetIO();
+    IM_ASSERT(io.BackendPlatformUserData == nullptr && "Already initialized a platform backend!");
+    ImGui_ImplQt* bd = IM_NEW(ImGui_ImplQt)();
+    if (bd->Init(io, std::move(window))) {
+        //没有事件过滤器,输入由调用方通过ImGuiIO注入;不使用系统光标、剪贴板和多视口
+        io.BackendFlags &= ~(ImGuiBackendFlags_HasMouseCursors | ImGuiBackendFlags_HasSetMousePos | ImGuiBackendFlags_PlatformHasViewports);
+        io.SetClipboardTextFn = ImGui_ImplQt_SetPrivateClipboardText;
+        io.GetClipboardTextFn = ImGui_ImplQt_GetPrivateClipboardText;
+        io.ClipboardUserData = bd;
+        return true;
+    }
+    return false;
+}
+
+bool ImGui_ImplQt_Init(QOffscreenSurface* surface, QOpenGLFramebufferObject* fbo, float device_pixel_ratio)
+{
+    IM_ASSERT(device_pixel_ratio > 0.0f);
+    return ImGui_ImplQt_InitHeadless(std::make_unique<ImGui_ImplQt_Headless>(surface, fbo, device_pixel_ratio));
+}
+
+bool ImGui_ImplQt_InitHeadless(int width, int height, float device_pixel_ratio)
+{
+    IM_ASSERT(device_pixel_ratio > 0.0f);
+    auto window = std::make_unique<ImGui_ImplQt_Headless>(nullptr, nullptr, device_pixel_ratio);
+    window->setSize(width, height, device_pixel_ratio);
+    return ImGui_ImplQt_InitHeadless(std::move(window));
+}
+
+void ImGui_ImplQt_SetHeadlessTarget(QOpenGLFramebufferObject* fbo, float device_pixel_ratio)
+{
+    ImGui_ImplQt* bd = ImGui_ImplQt_GetBackendData();
+    IM_ASSERT(bd != nullptr && "Did you call ImGui_ImplQt_Init()?");
+    IM_ASSERT(device_pixel_ratio > 0.0f);
+    if (auto headless = dynamic_cast<ImGui_ImplQt_Headless*>(bd->Window.get()))
+        headless->setTarget(fbo, device_pixel_ratio);
+}
+
+void ImGui_ImplQt_SetHeadlessSize(int width, int height, float device_pixel_ratio)
+{
+    ImGui_ImplQt* bd = ImGui_ImplQt_GetBackendData();
+    IM_ASSERT(bd != nullptr && "Did you call ImGui_ImplQt_Init()?");
+    IM_ASSERT(device_pixel_ratio > 0.0f);
+    if (auto headless = dynamic_cast<ImGui_ImplQt_Headless*>(bd->Window.get()))
+        headless->setSize(width, height, device_pixel_ratio);
+}
+
+bool ImGui_ImplQt_ProcessEvent(QEvent* event)
+{
+    ImGui_ImplQt* bd = ImGui_ImplQt_GetBackendData();
+    IM_ASSERT(bd != nullptr && "Did you call ImGui_ImplQt_Init()?");
+    return event && bd->ProcessEvent(event);
+}
+
 bool ImGui_ImplQt_Init(QOpenGLWindow* window)
 {
     ImGuiIO& io = ImGui::GetIO();
@@ -135,6 +361,7 @@ bool ImGui_ImplQt_Init(QOpenGLWindow* window)
     ImGui_ImplQt* bd = IM_NEW(ImGui_ImplQt)();
     if (bd->Init(io, std::make_unique<ImGui_ImplQt_OpenGLWindow>(window))) {
         window->installEventFilter(bd);
+        bd->TrackSwaps(window);
         //设置为接收输入消息，鼠标追踪开启以正确更新鼠标位置
         //window->setAttribute(Qt::WA_InputMethodEnabled);
         //window->setMouseTracking(true);
@@ -151,10 +378,100 @@ void ImGui_ImplQt_Shutdown()
     ImGuiIO& io = ImGui::GetIO();
 
     //ImGui_ImplQt_ShutdownPlatformInterface();
+    QObject::disconnect(bd->ScreenConnection);
+    bd->Latency.Detach();
+    bd->Governor.Detach(ImGui::GetStyle());
+    ImGui_ImplQt_SetFontAtlasDpiVariants(io.Fonts, 0);
 
     io.BackendPlatformName = nullptr;
     io.BackendPlatformUserData = nullptr;
+    const bool use_pool_allocator = bd->UsePoolAllocator;
     IM_DELETE(bd);
+    //上下文的内存在DestroyContext中释放完后arena才会归还
+    if (use_pool_allocator) {
+        ImGui_ImplQt_PoolAllocator::Instance().Detach(ImGui::GetCurrentContext());
+    }
+}
+
+bool ImGui_ImplQt_GetLatencyStats(ImGui_ImplQt_LatencyStats* stats)
+{
+    ImGui_ImplQt* bd = ImGui_ImplQt_GetBackendData();
+    IM_ASSERT(bd != nullptr && "Did you call ImGui_ImplQt_Init()?");
+    if (!stats)
+        return false;
+    bd->Latency.GetStats(stats);
+    return true;
+}
+
+void ImGui_ImplQt_SetLowLatency(bool enable, int max_queued_frames)
+{
+    ImGui_ImplQt* bd = ImGui_ImplQt_GetBackendData();
+    IM_ASSERT(bd != nullptr && "Did you call ImGui_ImplQt_Init()?");
+    bd->Latency.LowLatency = enable;
+    bd->Latency.MaxQueuedFrames = max_queued_frames > 1 ? max_queued_frames : 1;
+}
+
+void ImGui_ImplQt_SetQualityGovernor(bool enable, float budget_ms, ImGui_ImplQt_QualityCallback callback, void* user_data)
+{
+    ImGui_ImplQt* bd = ImGui_ImplQt_GetBackendData();
+    IM_ASSERT(bd != nullptr && "Did you call ImGui_ImplQt_Init()?");
+    if (!enable && bd->Governor.Enabled) {
+        //恢复应用原本的样式
+        bd->Governor.Disable(ImGui::GetStyle());
+    }
+    bd->Governor.Enabled = enable;
+    bd->Governor.Stats.BudgetMs = budget_ms > 0.0f ? budget_ms : 1000.0f / 60.0f;
+    bd->Governor.Callback = callback;
+    bd->Governor.UserData = user_data;
+}
+
+bool ImGui_ImplQt_GetQualityStats(ImGui_ImplQt_QualityStats* stats)
+{
+    ImGui_ImplQt* bd = ImGui_ImplQt_GetBackendData();
+    IM_ASSERT(bd != nullptr && "Did you call ImGui_ImplQt_Init()?");
+    if (!stats)
+        return false;
+    *stats = bd->Governor.Stats;
+    return bd->Governor.Enabled;
+}
+
+ImGui_ImplQt_InputQueue* ImGui_ImplQt_GetInputQueue()
+{
+    ImGui_ImplQt* bd = ImGui_ImplQt_GetBackendData();
+    IM_ASSERT(bd != nullptr && "Did you call ImGui_ImplQt_Init()?");
+    return bd->InputQueue.get();
+}
+
+bool ImGui_ImplQt_GetInputQueueStats(ImGui_ImplQt_InputQueueStats* stats)
+{
+    ImGui_ImplQt* bd = ImGui_ImplQt_GetBackendData();
+    IM_ASSERT(bd != nullptr && "Did you call ImGui_ImplQt_Init()?");
+    if (!stats || !bd->InputQueue)
+        return false;
+    stats->Queued = bd->InputQueue->Queued.load(std::memory_order_relaxed);
+    stats->Drained = bd->InputQueue->Drained;
+    stats->Dropped = bd->InputQueue->Dropped.load(std::memory_order_relaxed);
+    stats->LastBatch = bd->InputQueue->LastBatch;
+    return true;
+}
+
+void ImGui_ImplQt_EnablePoolAllocator(bool enable)
+{
+    ImGui_ImplQt_PoolAllocatorEnabled = enable;
+}
+
+bool ImGui_ImplQt_GetAllocatorStats(ImGui_ImplQt_AllocatorStats* stats)
+{
+    ImGui_ImplQt* bd = ImGui_ImplQt_GetBackendData();
+    IM_ASSERT(bd != nullptr && "Did you call ImGui_ImplQt_Init()?");
+    return bd->UsePoolAllocator && stats && ImGui_ImplQt_PoolAllocator::Instance().GetStats(ImGui::GetCurrentContext(), stats);
+}
+
+bool ImGui_ImplQt_EnablePartialUpdate()
+{
+    ImGui_ImplQt* bd = ImGui_ImplQt_GetBackendData();
+    IM_ASSERT(bd != nullptr && "Did you call ImGui_ImplQt_Init()?");
+    return bd->Window ? bd->Window->enablePartialUpdate() : false;
 }
 
 void ImGui_ImplQt_NewFrame()
@@ -162,6 +479,9 @@ void ImGui_ImplQt_NewFrame()
     ImGui_ImplQt* bd = ImGui_ImplQt_GetBackendData();
     IM_ASSERT(bd != nullptr && "Did you call ImGui_ImplQt_Init()?");
     ImGuiIO& io = ImGui::GetIO();
+    if (bd->UsePoolAllocator) {
+        ImGui_ImplQt_PoolAllocator::Instance().NewFrame(ImGui::GetCurrentContext());
+    }
     bd->NewFrame(io);
 }
 
@@ -181,9 +501,21 @@ bool ImGui_ImplQt::Init(ImGuiIO& io, std::unique_ptr<ImGui_ImplQt_IWindow> windo
     Time = 0.0;
     WantUpdateMonitors = true;
 
+    Latency.Attach(Context);
+    Governor.Attach(Context);
+
+    InputQueue.reset(new ImGui_ImplQt_InputQueue());
+    InputQueue->Wake = WakeFromQueue;
+    InputQueue->WakeUserData = this;
+
     io.SetClipboardTextFn = ImGui_ImplQt_SetClipboardText;
     io.GetClipboardTextFn = ImGui_ImplQt_GetClipboardText;
-    io.ClipboardUserData = Window.get();
+    io.ClipboardUserData = this;
+
+    UsePoolAllocator = ImGui_ImplQt_PoolAllocatorEnabled;
+    if (UsePoolAllocator) {
+        ImGui_ImplQt_PoolAllocator::Instance().Attach(Context);
+    }
 
     // Set platform dependent data in viewport
     ImGuiViewport* main_viewport = ImGui::GetMainViewport();
@@ -206,8 +538,11 @@ void ImGui_ImplQt::NewFrame(ImGuiIO& io)
         window->sizeInfo(w, h, display_w, display_h);
     }
     io.DisplaySize = ImVec2((float)w, (float)h);
+    LastDisplayWidth = display_w;
+    LastDisplayHeight = display_h;
     if (w > 0 && h > 0)
         io.DisplayFramebufferScale = ImVec2((float)display_w / (float)w, (float)display_h / (float)h);
+    UpdateScreen(io, window);
 
     //if (bd->WantUpdateMonitors)
     //    ImGui_ImplQt_UpdateMonitors();
@@ -218,6 +553,13 @@ void ImGui_ImplQt::NewFrame(ImGuiIO& io)
         io.DeltaTime = 0.00001f;
     }
     bd->Time = current_time;
+    //其他线程注入的输入在宿主自己的光标状态之前提交
+    qint64 queued_ns = -1;
+    if (InputQueue && InputQueue->Drain(io, &queued_ns) > 0)
+        bd->Latency.Input(queued_ns);
+    bd->Latency.NewFrame();
+    //在ImGui::NewFrame()之前调整样式
+    bd->Governor.NewFrame(ImGui::GetStyle());
 
     //设置光标位置
     UpdateMouseData(io);
@@ -226,6 +568,42 @@ void ImGui_ImplQt::NewFrame(ImGuiIO& io)
     UpdateCursorShape(io, window);
 }
 
+void ImGui_ImplQt::WakeFromQueue(void* user_data)
+{
+    //在生产者线程调用,转到GUI线程请求重绘;后端销毁时Qt会丢弃尚未执行的调用
+    ImGui_ImplQt* bd = (ImGui_ImplQt*)user_data;
+    QMetaObject::invokeMethod(bd, [bd]() {
+        if (bd->Window)
+            bd->Window->requestUpdate();
+    }, Qt::QueuedConnection);
+}
+
+// Font atlas variants follow the device pixel ratio. The ratio of the new screen is requested as soon as the window
+// moves there, the variant is usually built by the time the window is painted with it.
+void ImGui_ImplQt::UpdateScreen(ImGuiIO& io, ImGui_ImplQt_IWindow* window)
+{
+    auto bd = this;
+    QWindow* handle = window ? window->windowHandle() : nullptr;
+    if (handle != bd->ScreenWindow)
+    {
+        QObject::disconnect(bd->ScreenConnection);
+        bd->ScreenWindow = handle;
+        if (handle) {
+            bd->ScreenConnection = QObject::connect(handle, &QWindow::screenChanged, this, [this](QScreen* screen) {
+                if (screen == nullptr)
+                    return;
+                ImGuiContext* last_context = ImGui::GetCurrentContext();
+                ImGui::SetCurrentContext(Context);
+                ImGui_ImplQt_RequestFontAtlasScale(ImGui::GetIO().Fonts, (float)screen->devicePixelRatio());
+                ImGui::SetCurrentContext(last_context);
+            });
+        }
+    }
+    //屏幕不变时DPR也可能变化(系统缩放设置),每帧按实际帧缓冲比例请求
+    if (io.DisplaySize.x > 0.0f && io.DisplaySize.y > 0.0f)
+        ImGui_ImplQt_RequestFontAtlasScale(io.Fonts, io.DisplayFramebufferScale.x);
+}
+
 void ImGui_ImplQt::UpdateMouseData(ImGuiIO& io)
 {
     ImGuiPlatformIO& platform_io = ImGui::GetPlatformIO();
@@ -301,164 +679,186 @@ bool ImGui_ImplQt::eventFilter(QObject* watched, QEvent* event)
     if (Window) {
         flag = (Window->object() == watched);
     }
+    if (flag && event->type() != QEvent::None && event->type() == Window->paintEventType())
+    {
+        int w{}, h{}, display_w{}, display_h{};
+        Window->sizeInfo(w, h, display_w, display_h);
+        const bool resized = display_w != LastDisplayWidth || display_h != LastDisplayHeight;
+        if (!resized && Governor.SkipPaint(Window->isActive()))
+            return true;
+    }
     if (flag)
     {
-        ImGui::SetCurrentContext(Context);
-        ImGuiIO& io = ImGui::GetIO();
-
-        switch (event->type())
+        const qint64 arrival = ImGui_ImplQt_LatencyTracker::Now();
+        if (ProcessEvent(event) && event->type() != QEvent::FocusIn && event->type() != QEvent::FocusOut)
         {
-        case QEvent::MouseButtonDblClick:
-        case QEvent::MouseButtonPress:
-        case QEvent::MouseButtonRelease:
+            Latency.Input(arrival);
+            //低延迟模式下不等下一次定时器,事件循环空闲时立即重绘(多个请求会被Qt合并)
+            if (Latency.LowLatency)
+                Window->requestUpdate();
+        }
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+bool ImGui_ImplQt::ProcessEvent(QEvent* event)
+{
+    ImGui::SetCurrentContext(Context);
+    ImGuiIO& io = ImGui::GetIO();
+    bool handled = true;
+    switch (event->type())
+    {
+    case QEvent::MouseButtonDblClick:
+    case QEvent::MouseButtonPress:
+    case QEvent::MouseButtonRelease:
+    {
+        if (auto e = dynamic_cast<QMouseEvent*>(event))
         {
-            if (auto e = dynamic_cast<QMouseEvent*>(event))
-            {
-                io.AddKeyEvent(ImGuiKey_ModCtrl,
-                    e->modifiers().testFlag(
-                        Qt::KeyboardModifier::ControlModifier));
-                io.AddKeyEvent(ImGuiKey_ModShift,
-                    e->modifiers().testFlag(
-                        Qt::KeyboardModifier::ShiftModifier));
-                io.AddKeyEvent(ImGuiKey_ModAlt,
-                    e->modifiers().testFlag(
-                        Qt::KeyboardModifier::AltModifier));
-                io.AddKeyEvent(ImGuiKey_ModSuper,
-                    e->modifiers().testFlag(
-                        Qt::KeyboardModifier::MetaModifier));
-
-                io.AddMouseButtonEvent(
-                    ImGuiMouseButton_Left,
-                    e->buttons().testFlag(
-                        Qt::MouseButton::LeftButton)
-                );
-                io.AddMouseButtonEvent(
-                    ImGuiMouseButton_Right,
-                    e->buttons().testFlag(
-                        Qt::MouseButton::RightButton)
-                );
-                io.AddMouseButtonEvent(
-                    ImGuiMouseButton_Middle,
-                    e->buttons().testFlag(
-                        Qt::MouseButton::MiddleButton)
-                );
-            }
+            io.AddKeyEvent(ImGuiKey_ModCtrl,
+                e->modifiers().testFlag(
+                    Qt::KeyboardModifier::ControlModifier));
+            io.AddKeyEvent(ImGuiKey_ModShift,
+                e->modifiers().testFlag(
+                    Qt::KeyboardModifier::ShiftModifier));
+            io.AddKeyEvent(ImGuiKey_ModAlt,
+                e->modifiers().testFlag(
+                    Qt::KeyboardModifier::AltModifier));
+            io.AddKeyEvent(ImGuiKey_ModSuper,
+                e->modifiers().testFlag(
+                    Qt::KeyboardModifier::MetaModifier));
+
+            io.AddMouseButtonEvent(
+                ImGuiMouseButton_Left,
+                e->buttons().testFlag(
+                    Qt::MouseButton::LeftButton)
+            );
+            io.AddMouseButtonEvent(
+                ImGuiMouseButton_Right,
+                e->buttons().testFlag(
+                    Qt::MouseButton::RightButton)
+            );
+            io.AddMouseButtonEvent(
+                ImGuiMouseButton_Middle,
+                e->buttons().testFlag(
+                    Qt::MouseButton::MiddleButton)
+            );
         }
-        break;
-        case QEvent::Wheel:
+    }
+    break;
+    case QEvent::Wheel:
+    {
+        if (auto e = dynamic_cast<QWheelEvent*>(event))
         {
-            if (auto e = dynamic_cast<QWheelEvent*>(event))
-            {
-                float x{};
-                float y{};
-                // Handle horizontal component
-                if (e->pixelDelta().x() != 0) {
-                    x = e->pixelDelta().x() / (ImGui::GetTextLineHeight());
-                }
-                else {
-                    // Magic number of 120 comes from Qt doc on QWheelEvent::pixelDelta()
-                    x = e->angleDelta().x() / 120.0f;
-                }
+            float x{};
+            float y{};
+            // Handle horizontal component
+            if (e->pixelDelta().x() != 0) {
+                x = e->pixelDelta().x() / (ImGui::GetTextLineHeight());
+            }
+            else {
+                // Magic number of 120 comes from Qt doc on QWheelEvent::pixelDelta()
+                x = e->angleDelta().x() / 120.0f;
+            }
 
-                // Handle vertical component
-                if (e->pixelDelta().y() != 0) {
-                    // 5 lines per unit
-                    y = e->pixelDelta().y() / (5.0 * ImGui::GetTextLineHeight());
-                }
-                else {
-                    // Magic number of 120 comes from Qt doc on QWheelEvent::pixelDelta()
-                    y = e->angleDelta().y() / 120.0f;
-                }
-                io.AddMouseWheelEvent(x, y);
+            // Handle vertical component
+            if (e->pixelDelta().y() != 0) {
+                // 5 lines per unit
+                y = e->pixelDelta().y() / (5.0 * ImGui::GetTextLineHeight());
+            }
+            else {
+                // Magic number of 120 comes from Qt doc on QWheelEvent::pixelDelta()
+                y = e->angleDelta().y() / 120.0f;
             }
+            io.AddMouseWheelEvent(x, y);
         }
-        break;
-        case QEvent::KeyPress:
-        case QEvent::KeyRelease:
+    }
+    break;
+    case QEvent::KeyPress:
+    case QEvent::KeyRelease:
+    {
+        if (auto e = dynamic_cast<QKeyEvent*>(event))
         {
-            if (auto e = dynamic_cast<QKeyEvent*>(event))
+            io.AddKeyEvent(ImGuiKey_ModCtrl,
+                e->modifiers().testFlag(
+                    Qt::KeyboardModifier::ControlModifier));
+            io.AddKeyEvent(ImGuiKey_ModShift,
+                e->modifiers().testFlag(
+                    Qt::KeyboardModifier::ShiftModifier));
+            io.AddKeyEvent(ImGuiKey_ModAlt,
+                e->modifiers().testFlag(
+                    Qt::KeyboardModifier::AltModifier));
+            io.AddKeyEvent(ImGuiKey_ModSuper,
+                e->modifiers().testFlag(
+                    Qt::KeyboardModifier::MetaModifier));
+
+            const bool key_pressed = (event->type() == QEvent::KeyPress);
+            static std::vector<std::pair<Qt::Key, ImGuiKey>> map
+            {
+                { Qt::Key_Tab, ImGuiKey_Tab },
+                { Qt::Key_Left, ImGuiKey_LeftArrow },
+                { Qt::Key_Right, ImGuiKey_RightArrow },
+                { Qt::Key_Up, ImGuiKey_UpArrow },
+                { Qt::Key_Down, ImGuiKey_DownArrow },
+                { Qt::Key_PageUp, ImGuiKey_PageUp },
+                { Qt::Key_PageDown, ImGuiKey_PageDown },
+                { Qt::Key_Home, ImGuiKey_Home },
+                { Qt::Key_End, ImGuiKey_End },
+                { Qt::Key_Insert, ImGuiKey_Insert },
+                { Qt::Key_Delete, ImGuiKey_Delete },
+                { Qt::Key_Backspace, ImGuiKey_Backspace },
+                { Qt::Key_Space, ImGuiKey_Space },
+                { Qt::Key_Enter, ImGuiKey_Enter },
+                { Qt::Key_Return, ImGuiKey_Enter },
+                { Qt::Key_Escape, ImGuiKey_Escape },
+                { Qt::Key_A, ImGuiKey_A },
+                { Qt::Key_C, ImGuiKey_C },
+                { Qt::Key_V, ImGuiKey_V },
+                { Qt::Key_X, ImGuiKey_X },
+                { Qt::Key_Y, ImGuiKey_Y },
+                { Qt::Key_Z, ImGuiKey_Z }
+            };
+            for (auto& obj : map)
             {
-                io.AddKeyEvent(ImGuiKey_ModCtrl,
-                    e->modifiers().testFlag(
-                        Qt::KeyboardModifier::ControlModifier));
-                io.AddKeyEvent(ImGuiKey_ModShift,
-                    e->modifiers().testFlag(
-                        Qt::KeyboardModifier::ShiftModifier));
-                io.AddKeyEvent(ImGuiKey_ModAlt,
-                    e->modifiers().testFlag(
-                        Qt::KeyboardModifier::AltModifier));
-                io.AddKeyEvent(ImGuiKey_ModSuper,
-                    e->modifiers().testFlag(
-                        Qt::KeyboardModifier::MetaModifier));
-
-                const bool key_pressed = (event->type() == QEvent::KeyPress);
-                static std::vector<std::pair<Qt::Key, ImGuiKey>> map
-                {
-                    { Qt::Key_Tab, ImGuiKey_Tab },
-                    { Qt::Key_Left, ImGuiKey_LeftArrow },
-                    { Qt::Key_Right, ImGuiKey_RightArrow },
-                    { Qt::Key_Up, ImGuiKey_UpArrow },
-                    { Qt::Key_Down, ImGuiKey_DownArrow },
-                    { Qt::Key_PageUp, ImGuiKey_PageUp },
-                    { Qt::Key_PageDown, ImGuiKey_PageDown },
-                    { Qt::Key_Home, ImGuiKey_Home },
-                    { Qt::Key_End, ImGuiKey_End },
-                    { Qt::Key_Insert, ImGuiKey_Insert },
-                    { Qt::Key_Delete, ImGuiKey_Delete },
-                    { Qt::Key_Backspace, ImGuiKey_Backspace },
-                    { Qt::Key_Space, ImGuiKey_Space },
-                    { Qt::Key_Enter, ImGuiKey_Enter },
-                    { Qt::Key_Return, ImGuiKey_Enter },
-                    { Qt::Key_Escape, ImGuiKey_Escape },
-                    { Qt::Key_A, ImGuiKey_A },
-                    { Qt::Key_C, ImGuiKey_C },
-                    { Qt::Key_V, ImGuiKey_V },
-                    { Qt::Key_X, ImGuiKey_X },
-                    { Qt::Key_Y, ImGuiKey_Y },
-                    { Qt::Key_Z, ImGuiKey_Z }
-                };
-                for (auto& obj : map)
-                {
-                    if (obj.first == e->key()) {
-                        io.AddKeyEvent(obj.second, key_pressed);
-                    }
+                if (obj.first == e->key()) {
+                    io.AddKeyEvent(obj.second, key_pressed);
                 }
-                if (key_pressed) {
-                    const QString text = e->text();
-                    if (text.size() == 1) {
-                        io.AddInputCharacter(text.at(0).unicode());
-                    }
+            }
+            if (key_pressed) {
+                const QString text = e->text();
+                if (text.size() == 1) {
+                    io.AddInputCharacter(text.at(0).unicode());
                 }
             }
         }
-        break;
-        case QEvent::InputMethod:
-            if (auto e = dynamic_cast<QInputMethodEvent*>(event))
-            {
-                auto&& input = e->commitString();
-                io.AddInputCharactersUTF8(input.toStdString().c_str());
-            }
-            break;
-        case QEvent::FocusIn:
-        case QEvent::FocusOut:
+    }
+    break;
+    case QEvent::InputMethod:
+        if (auto e = dynamic_cast<QInputMethodEvent*>(event))
         {
-            if (auto e = dynamic_cast<QFocusEvent*>(event)) {
-                io.AddFocusEvent(e->gotFocus());
-            }
+            auto&& input = e->commitString();
+            io.AddInputCharactersUTF8(input.toUtf8().constData());
         }
         break;
-        case QEvent::MouseMove:
-        {
-            //注意要开启鼠标追踪
-            if (auto e = dynamic_cast<QMouseEvent*>(event)) {
-                const QPoint pos = e->pos();
-                io.AddMousePosEvent(pos.x(), pos.y());
-            }
+    case QEvent::FocusIn:
+    case QEvent::FocusOut:
+    {
+        if (auto e = dynamic_cast<QFocusEvent*>(event)) {
+            io.AddFocusEvent(e->gotFocus());
         }
-        break;
-        default:
-            break;
-        };
     }
-    return QObject::eventFilter(watched, event);
+    break;
+    case QEvent::MouseMove:
+    {
+        //注意要开启鼠标追踪
+        if (auto e = dynamic_cast<QMouseEvent*>(event)) {
+            const QPoint pos = e->pos();
+            io.AddMousePosEvent(pos.x(), pos.y());
+        }
+    }
+    break;
+    default:
+        handled = false;
+        break;
+    };
+    return handled;
 }
@@ -1,9 +1,98 @@
 #pragma once
 #include "imgui.h"
 
+class QWidget;
 class QOpenGLWidget;
 class QOpenGLWindow;
+class QOffscreenSurface;
+class QOpenGLFramebufferObject;
 IMGUI_IMPL_API bool     ImGui_ImplQt_Init(QOpenGLWidget* window);
 IMGUI_IMPL_API bool     ImGui_ImplQt_Init(QOpenGLWindow* window);
+IMGUI_IMPL_API bool     ImGui_ImplQt_Init(QWidget* window);        // Raster widget, for imgui_impl_qt_software.h
+
+// Headless host: no input events, one context per thread needs IMGUI_QT_THREAD_LOCAL_CONTEXT=ON
+IMGUI_IMPL_API bool     ImGui_ImplQt_Init(QOffscreenSurface* surface, QOpenGLFramebufferObject* fbo, float device_pixel_ratio = 1.0f);    // Bind the FBO before rendering
+IMGUI_IMPL_API void     ImGui_ImplQt_SetHeadlessTarget(QOpenGLFramebufferObject* fbo, float device_pixel_ratio = 1.0f);    // After resizing
+// Headless host without a render target of its own (e.g. the application side of imgui_impl_qt_remote.h)
+IMGUI_IMPL_API bool     ImGui_ImplQt_InitHeadless(int width, int height, float device_pixel_ratio = 1.0f);
+IMGUI_IMPL_API void     ImGui_ImplQt_SetHeadlessSize(int width, int height, float device_pixel_ratio = 1.0f);
 IMGUI_IMPL_API void     ImGui_ImplQt_Shutdown();
 IMGUI_IMPL_API void     ImGui_ImplQt_NewFrame();
+
+class QEvent;
+IMGUI_IMPL_API bool     ImGui_ImplQt_ProcessEvent(QEvent* event);      // As if sent to the host, false for event types that are not translated
+
+IMGUI_IMPL_API bool     ImGui_ImplQt_EnablePartialUpdate();    // For ImGui_ImplQtOpenGL3_SetPartialRedraw(), false for a QOpenGLWindow without PartialUpdateBlit/Blend
+
+// Input latency: from the input event to the swap of the first frame built after it, once the GPU passed its fence
+struct ImGui_ImplQt_LatencyStats
+{
+    int   Samples;                  // Since Init(), percentiles cover the last 256, raster and headless hosts have none
+    float LastMs;
+    float AverageMs;
+    float P50Ms;
+    float P90Ms;
+    float P99Ms;
+    float MaxMs;
+    float GpuMs;                    // From RenderDrawData() to GL_TIMESTAMP, without timer queries (ES, GL < 3.3) an upper bound up to one frame late
+    int   QueuedFrames;             // Fenced frames the GPU has not finished yet
+};
+IMGUI_IMPL_API bool     ImGui_ImplQt_GetLatencyStats(ImGui_ImplQt_LatencyStats* stats);
+IMGUI_IMPL_API void     ImGui_ImplQt_SetLowLatency(bool enable, int max_queued_frames = 1);    // Repaint on input, wait for the GPU beyond max_queued_frames
+
+// Quality governor: one level down after 10 frames over budget_ms, up after 120 frames under 70% of it, levels are cumulative
+enum ImGui_ImplQt_QualityLevel
+{
+    ImGui_ImplQt_QualityLevel_Full,
+    ImGui_ImplQt_QualityLevel_ThrottleUnfocused,    // The OpenGL host of this context paints every 4th update while its window is not active
+    ImGui_ImplQt_QualityLevel_CoarseCurves,         // CurveTessellationTol and CircleTessellationMaxError doubled
+    ImGui_ImplQt_QualityLevel_NoMultisample,        // The OpenGL renderer rasterizes without GL_MULTISAMPLE (desktop GL)
+    ImGui_ImplQt_QualityLevel_NoAntiAliasedFill,
+    ImGui_ImplQt_QualityLevel_NoAntiAliasedLines,
+    ImGui_ImplQt_QualityLevel_COUNT
+};
+struct ImGui_ImplQt_QualityStats
+{
+    int   Level;                    // ImGui_ImplQt_QualityLevel
+    float FrameMs;                  // Smoothed frame time, restarts after each level change
+    float BudgetMs;
+    int   StepsDown;                // Transitions since Init()
+    int   StepsUp;
+    int   PaintsSkipped;            // Unfocused paints skipped by this context
+};
+typedef void (*ImGui_ImplQt_QualityCallback)(int old_level, int new_level, float frame_ms, void* user_data);
+IMGUI_IMPL_API void     ImGui_ImplQt_SetQualityGovernor(bool enable, float budget_ms = 1000.0f / 60.0f, ImGui_ImplQt_QualityCallback callback = nullptr, void* user_data = nullptr);
+IMGUI_IMPL_API bool     ImGui_ImplQt_GetQualityStats(ImGui_ImplQt_QualityStats* stats);
+
+// Input injection from any thread: Queue*() never blocks and returns false when full or invalid, applied by ImGui_ImplQt_NewFrame()
+struct ImGui_ImplQt_InputQueue;
+struct ImGui_ImplQt_InputQueueStats
+{
+    int   Queued;                   // Since Init()
+    int   Drained;
+    int   Dropped;                  // Rejected because the queue was full
+    int   LastBatch;                // Applied by the last ImGui_ImplQt_NewFrame()
+};
+IMGUI_IMPL_API ImGui_ImplQt_InputQueue* ImGui_ImplQt_GetInputQueue();     // GUI thread, valid until ImGui_ImplQt_Shutdown()
+IMGUI_IMPL_API bool     ImGui_ImplQt_GetInputQueueStats(ImGui_ImplQt_InputQueueStats* stats);
+IMGUI_IMPL_API bool     ImGui_ImplQt_QueueMousePos(ImGui_ImplQt_InputQueue* queue, float x, float y);
+IMGUI_IMPL_API bool     ImGui_ImplQt_QueueMouseButton(ImGui_ImplQt_InputQueue* queue, int button, bool down);
+IMGUI_IMPL_API bool     ImGui_ImplQt_QueueMouseWheel(ImGui_ImplQt_InputQueue* queue, float wheel_x, float wheel_y);
+IMGUI_IMPL_API bool     ImGui_ImplQt_QueueKey(ImGui_ImplQt_InputQueue* queue, ImGuiKey key, bool down);
+IMGUI_IMPL_API bool     ImGui_ImplQt_QueueChar(ImGui_ImplQt_InputQueue* queue, unsigned int c);
+IMGUI_IMPL_API bool     ImGui_ImplQt_QueueFocus(ImGui_ImplQt_InputQueue* queue, bool focused);
+
+// Opt-in pool allocator for ImGui::MemAlloc(), one arena per context
+struct ImGui_ImplQt_AllocatorStats
+{
+    size_t LiveBytes;               // Rounded up to the size classes
+    size_t PeakBytes;
+    size_t ReservedBytes;           // Slabs and large blocks held by the arena
+    int    LiveAllocations;
+    int    LargeAllocations;        // Live blocks above the largest size class
+    int    AllocationsPerFrame;     // Between the last two ImGui_ImplQt_NewFrame(), zero in a steady-state UI
+    int    FreesPerFrame;
+    int    UnpooledAllocations;     // Made while the current context had no arena (all contexts)
+};
+IMGUI_IMPL_API void     ImGui_ImplQt_EnablePoolAllocator(bool enable = true);     // Before ImGui_ImplQt_Init()
+IMGUI_IMPL_API bool     ImGui_ImplQt_GetAllocatorStats(ImGui_ImplQt_AllocatorStats* stats);    // false if the context has no arena
@@ -0,0 +1,229 @@
+﻿#include "imgui_impl_qt_allocator.h"
+#include <algorithm>
+#include <stdlib.h>
+
+ImGui_ImplQt_PoolAllocator& ImGui_ImplQt_PoolAllocator::Instance()
+{
+    //不析构,静态对象销毁后仍可能有上下文释放内存
+    static ImGui_ImplQt_PoolAllocator* instance = new ImGui_ImplQt_PoolAllocator();
+    return *instance;
+}
+
+ImGui_ImplQt_PoolAllocator::ImGui_ImplQt_PoolAllocator()
+{
+    //128字节以下按16字节递增,之后每个2的幂之间分4档,浪费不超过25%
+    for (size_t size = 16; size <= 128; size += 16)
+        ClassSizes.push_back(size);
+    for (size_t base = 128; base < MaxClassSize; base *= 2)
+        for (size_t step = 1; step <= 4; step++)
+            ClassSizes.push_back(base + base / 4 * step);
+}
+
+void* ImGui_ImplQt_PoolAllocator::MemAlloc(size_t size, void* user_data)
+{
+    return ((ImGui_ImplQt_PoolAllocator*)user_data)->Alloc(size);
+}
+
+void ImGui_ImplQt_PoolAllocator::MemFree(void* ptr, void* user_data)
+{
+    ((ImGui_ImplQt_PoolAllocator*)user_data)->Free(ptr);
+}
+
+void ImGui_ImplQt_PoolAllocator::Attach(ImGuiContext* context)
+{
+    std::lock_guard<std::mutex> lock(Mutex);
+    if (FindArena(context))
+        return;
+    auto arena = new ImGui_ImplQt_Arena();
+    arena->Context = context;
+    arena->FreeLists.resize(ClassSizes.size());
+    arena->Current.resize(ClassSizes.size());
+    Arenas.push_back(arena);
+    //分配函数是全局的,只需安装一次;安装前分配的内存由Free按地址识别后交给free()。
+    //在锁内判断,并发的Init()不会重复安装
+    if (!Installed) {
+        ImGui::SetAllocatorFunctions(&ImGui_ImplQt_PoolAllocator::MemAlloc, &ImGui_ImplQt_PoolAllocator::MemFree, this);
+        Installed = true;
+    }
+}
+
+void ImGui_ImplQt_PoolAllocator::Detach(ImGuiContext* context)
+{
+    std::lock_guard<std::mutex> lock(Mutex);
+    ImGui_ImplQt_Arena* arena = FindArena(context);
+    if (!arena)
+        return;
+    //上下文销毁前还会释放大量内存,空了之后再归还
+    arena->Context = nullptr;
+    if (arena->Stats.LiveAllocations == 0)
+        ReleaseArena(arena);
+}
+
+void ImGui_ImplQt_PoolAllocator::NewFrame(ImGuiContext* context)
+{
+    std::lock_guard<std::mutex> lock(Mutex);
+    if (ImGui_ImplQt_Arena* arena = FindArena(context)) {
+        arena->Stats.AllocationsPerFrame = arena->AllocationsThisFrame;
+        arena->Stats.FreesPerFrame = arena->FreesThisFrame;
+        arena->AllocationsThisFrame = 0;
+        arena->FreesThisFrame = 0;
+    }
+}
+
+bool ImGui_ImplQt_PoolAllocator::GetStats(ImGuiContext* context, ImGui_ImplQt_AllocatorStats* stats)
+{
+    std::lock_guard<std::mutex> lock(Mutex);
+    ImGui_ImplQt_Arena* arena = FindArena(context);
+    if (!arena)
+        return false;
+    *stats = arena->Stats;
+    stats->UnpooledAllocations = UnpooledAllocations;
+    return true;
+}
+
+ImGui_ImplQt_Arena* ImGui_ImplQt_PoolAllocator::FindArena(ImGuiContext* context) const
+{
+    if (!context)
+        return nullptr;
+    for (ImGui_ImplQt_Arena* arena : Arenas)
+        if (arena->Context == context)
+            return arena;
+    return nullptr;
+}
+
+ImGui_ImplQt_Slab* ImGui_ImplQt_PoolAllocator::FindSlab(void* ptr) const
+{
+    auto it = std::upper_bound(Slabs.begin(), Slabs.end(), (char*)ptr,
+        [](char* p, const ImGui_ImplQt_Slab* slab) { return p < slab->Begin; });
+    if (it == Slabs.begin())
+        return nullptr;
+    ImGui_ImplQt_Slab* slab = *(it - 1);
+    return (char*)ptr < slab->End ? slab : nullptr;
+}
+
+ImGui_ImplQt_Slab* ImGui_ImplQt_PoolAllocator::CreateSlab(ImGui_ImplQt_Arena* arena, int size_class, size_t size)
+{
+    char* memory = (char*)malloc(size);
+    if (!memory)
+        return nullptr;
+    auto slab = new ImGui_ImplQt_Slab();
+    slab->Begin = slab->Bump = memory;
+    slab->End = memory + size;
+    slab->Class = size_class;
+    slab->Owner = arena;
+    auto it = std::upper_bound(Slabs.begin(), Slabs.end(), slab->Begin,
+        [](char* p, const ImGui_ImplQt_Slab* other) { return p < other->Begin; });
+    Slabs.insert(it, slab);
+    arena->Stats.ReservedBytes += size;
+    return slab;
+}
+
+void ImGui_ImplQt_PoolAllocator::DestroySlab(ImGui_ImplQt_Slab* slab)
+{
+    auto it = std::lower_bound(Slabs.begin(), Slabs.end(), slab->Begin,
+        [](const ImGui_ImplQt_Slab* other, char* p) { return other->Begin < p; });
+    IM_ASSERT(it != Slabs.end() && *it == slab);
+    Slabs.erase(it);
+    slab->Owner->Stats.ReservedBytes -= (size_t)(slab->End - slab->Begin);
+    free(slab->Begin);
+    delete slab;
+}
+
+void ImGui_ImplQt_PoolAllocator::ReleaseArena(ImGui_ImplQt_Arena* arena)
+{
+    Slabs.erase(std::remove_if(Slabs.begin(), Slabs.end(), [arena](ImGui_ImplQt_Slab* slab) {
+        if (slab->Owner != arena)
+            return false;
+        free(slab->Begin);
+        delete slab;
+        return true;
+    }), Slabs.end());
+    Arenas.erase(std::find(Arenas.begin(), Arenas.end(), arena));
+    delete arena;
+}
+
+void* ImGui_ImplQt_PoolAllocator::Alloc(size_t size)
+{
+    std::unique_lock<std::mutex> lock(Mutex);
+    ImGui_ImplQt_Arena* arena = FindArena(ImGui::GetCurrentContext());
+    if (!arena) {
+        UnpooledAllocations++;
+        lock.unlock();
+        return malloc(size);
+    }
+
+    void* ptr = nullptr;
+    size_t block_size = size;
+    if (size > MaxClassSize)
+    {
+        ImGui_ImplQt_Slab* slab = CreateSlab(arena, -1, size);
+        if (!slab)
+            return nullptr;
+        ptr = slab->Begin;
+        arena->Stats.LargeAllocations++;
+    }
+    else
+    {
+        const int size_class = (int)(std::lower_bound(ClassSizes.begin(), ClassSizes.end(), std::max(size, (size_t)1)) - ClassSizes.begin());
+        block_size = ClassSizes[size_class];
+        void*& free_list = arena->FreeLists[size_class];
+        if (free_list)
+        {
+            ptr = free_list;
+            free_list = *(void**)ptr;
+        }
+        else
+        {
+            ImGui_ImplQt_Slab*& slab = arena->Current[size_class];
+            if (!slab || slab->Bump + block_size > slab->End)
+            {
+                slab = CreateSlab(arena, size_class, std::max((size_t)MinSlabSize, block_size * 4));
+                if (!slab)
+                    return nullptr;
+            }
+            ptr = slab->Bump;
+            slab->Bump += block_size;
+        }
+    }
+
+    ImGui_ImplQt_AllocatorStats& stats = arena->Stats;
+    stats.LiveBytes += block_size;
+    stats.PeakBytes = std::max(stats.PeakBytes, stats.LiveBytes);
+    stats.LiveAllocations++;
+    arena->AllocationsThisFrame++;
+    return ptr;
+}
+
+void ImGui_ImplQt_PoolAllocator::Free(void* ptr)
+{
+    if (!ptr)
+        return;
+    std::unique_lock<std::mutex> lock(Mutex);
+    ImGui_ImplQt_Slab* slab = FindSlab(ptr);
+    if (!slab) {
+        lock.unlock();
+        free(ptr);
+        return;
+    }
+
+    ImGui_ImplQt_Arena* arena = slab->Owner;
+    ImGui_ImplQt_AllocatorStats& stats = arena->Stats;
+    if (slab->Class < 0)
+    {
+        stats.LiveBytes -= (size_t)(slab->End - slab->Begin);
+        stats.LargeAllocations--;
+        DestroySlab(slab);
+    }
+    else
+    {
+        //空闲块的前8字节用作链表指针
+        void*& free_list = arena->FreeLists[slab->Class];
+        *(void**)ptr = free_list;
+        free_list = ptr;
+        stats.LiveBytes -= ClassSizes[slab->Class];
+    }
+    stats.LiveAllocations--;
+    arena->FreesThisFrame++;
+    if (!arena->Context && stats.LiveAllocations == 0)
+        ReleaseArena(arena);
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <mutex>
+#include <vector>
+
+#include "imgui.h"
+#include "imgui_impl_qt.h"
+
+// Pool allocator behind ImGui::MemAlloc()/MemFree(). Requests up to MaxClassSize are rounded up to a size class
+// and served from the free list of the arena of the current ImGui context, refilled from slabs that are only
+// returned to the system when the arena is detached and empty. Blocks are found by address on free, so memory
+// allocated before the allocator was installed (or for contexts without an arena) still goes back to free().
+struct ImGui_ImplQt_Slab
+{
+    char* Begin{};
+    char* End{};
+    char* Bump{};
+    int   Class{};      // -1 for a single block above MaxClassSize
+    struct ImGui_ImplQt_Arena* Owner{};
+};
+
+struct ImGui_ImplQt_Arena
+{
+    ImGuiContext* Context{};    // nullptr once detached, released when the last block is freed
+    std::vector<void*> FreeLists;
+    std::vector<ImGui_ImplQt_Slab*> Current;
+    ImGui_ImplQt_AllocatorStats Stats{};
+    int AllocationsThisFrame{};
+    int FreesThisFrame{};
+};
+
+class ImGui_ImplQt_PoolAllocator
+{
+public:
+    enum { MinSlabSize = 64 * 1024, MaxClassSize = 64 * 1024 };
+
+    static ImGui_ImplQt_PoolAllocator& Instance();
+
+    void Attach(ImGuiContext* context);
+    void Detach(ImGuiContext* context);
+    void NewFrame(ImGuiContext* context);
+    bool GetStats(ImGuiContext* context, ImGui_ImplQt_AllocatorStats* stats);
+private:
+    ImGui_ImplQt_PoolAllocator();
+    static void* MemAlloc(size_t size, void* user_data);
+    static void  MemFree(void* ptr, void* user_data);
+    void* Alloc(size_t size);
+    void  Free(void* ptr);
+    ImGui_ImplQt_Arena* FindArena(ImGuiContext* context) const;
+    ImGui_ImplQt_Slab*  FindSlab(void* ptr) const;
+    ImGui_ImplQt_Slab*  CreateSlab(ImGui_ImplQt_Arena* arena, int size_class, size_t size);
+    void  DestroySlab(ImGui_ImplQt_Slab* slab);
+    void  ReleaseArena(ImGui_ImplQt_Arena* arena);
+private:
+    std::mutex Mutex;
+    std::vector<size_t> ClassSizes;
+    std::vector<ImGui_ImplQt_Arena*> Arenas;
+    std::vector<ImGui_ImplQt_Slab*> Slabs;      // Sorted by address
+    int  UnpooledAllocations{};
+    bool Installed{};                           // Guarded by Mutex
+};
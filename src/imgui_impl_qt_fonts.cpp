@@ -0,0 +1,367 @@
+﻿#include "imgui_impl_qt_fonts.h"
+#include "imgui_impl_qt_hash.h"
+#include <QtCore/QString>
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+#include <QtCore/QSaveFile>
+#include <QtCore/QDir>
+#include <QtCore/QMutex>
+#include <QtCore/QStandardPaths>
+#include <chrono>
+#include <climits>
+
+// Cache file layout, every section starts at a multiple of 16 bytes:
+// header, custom rects, fonts, glyphs of each font, pixels
+struct ImGui_ImplQt_FontCacheHeader
+{
+    char   Magic[8];
+    ImU32  Version;
+    ImU32  ImGuiVersion;
+    ImU32  GlyphSize;
+    ImU32  FileSize;
+    ImU64  Key;
+    ImS32  TexWidth;
+    ImS32  TexHeight;
+    ImS32  TexBytesPerPixel;        // 1: TexPixelsAlpha8, 4: TexPixelsRGBA32
+    ImS32  TexPixelsUseColors;
+    ImVec2 TexUvScale;
+    ImVec2 TexUvWhitePixel;
+    ImVec4 TexUvLines[IM_DRAWLIST_TEX_LINES_WIDTH_MAX + 1];
+    ImS32  PackIdMouseCursors;
+    ImS32  PackIdLines;
+    ImS32  FontCount;
+    ImS32  CustomRectCount;
+};
+
+struct ImGui_ImplQt_FontCacheRect
+{
+    ImU16  Width, Height;
+    ImU16  X, Y;
+    ImU32  GlyphID;
+    float  GlyphAdvanceX;
+    ImVec2 GlyphOffset;
+    ImS32  Font;                    // Index in ImFontAtlas::Fonts, -1 for none
+};
+
+struct ImGui_ImplQt_FontCacheFont
+{
+    float  FontSize;
+    float  Ascent;
+    float  Descent;
+    ImS32  MetricsTotalSurface;
+    ImS32  ConfigData;              // Index in ImFontAtlas::ConfigData
+    ImS32  ConfigDataCount;
+    ImS32  GlyphCount;
+    ImS32  Reserved;
+};
+
+static const char  ImGui_ImplQt_FontCacheMagic[8] = { 'I', 'M', 'Q', 'T', 'F', 'O', 'N', 'T' };
+static const ImU32 ImGui_ImplQt_FontCacheVersion = 1;
+
+static QMutex  ImGui_ImplQt_FontCacheMutex;
+static QString ImGui_ImplQt_FontCacheDirectory;
+static bool    ImGui_ImplQt_FontCacheEnabled = false;
+
+static double ImGui_ImplQt_FontClockMs()
+{
+    using namespace std::chrono;
+    return duration_cast<duration<double, std::milli>>(steady_clock::now().time_since_epoch()).count();
+}
+
+static qint64 ImGui_ImplQt_FontCacheAlign(qint64 offset)
+{
+    return (offset + 15) & ~15;
+}
+
+template<typename T>
+static ImU64 ImGui_ImplQt_FontCacheHashValue(const T& value, ImU64 seed)
+{
+    return ImGui_ImplQt_HashData(&value, sizeof(T), seed);
+}
+
+//影响烘焙结果的所有输入,包括字体文件内容
+static ImU64 ImGui_ImplQt_FontCacheKey(ImFontAtlas* atlas)
+{
+    ImU64 key = ImGui_ImplQt_FontCacheHashValue((ImU32)IMGUI_VERSION_NUM, 0);
+    key = ImGui_ImplQt_FontCacheHashValue(atlas->Flags, key);
+    key = ImGui_ImplQt_FontCacheHashValue(atlas->TexDesiredWidth, key);
+    key = ImGui_ImplQt_FontCacheHashValue(atlas->TexGlyphPadding, key);
+    key = ImGui_ImplQt_FontCacheHashValue(atlas->FontBuilderFlags & ~(unsigned int)ImGui_ImplQt_FontBuilderFlags_ThreadsMask, key);
+    //并行构建与stb_truetype的结果相同,可共用缓存
+    const bool custom_builder = atlas->FontBuilderIO != nullptr && atlas->FontBuilderIO != ImGui_ImplQt_GetParallelFontBuilderIO();
+    key = ImGui_ImplQt_FontCacheHashValue(custom_builder, key);
+    for (const ImFontConfig& cfg : atlas->ConfigData)
+    {
+        key = ImGui_ImplQt_HashData(cfg.FontData, (size_t)cfg.FontDataSize, key);
+        key = ImGui_ImplQt_FontCacheHashValue(cfg.FontNo, key);
+        key = ImGui_ImplQt_FontCacheHashValue(cfg.SizePixels, key);
+        key = ImGui_ImplQt_FontCacheHashValue(cfg.OversampleH, key);
+        key = ImGui_ImplQt_FontCacheHashValue(cfg.OversampleV, key);
+        key = ImGui_ImplQt_FontCacheHashValue(cfg.PixelSnapH, key);
+        key = ImGui_ImplQt_FontCacheHashValue(cfg.GlyphExtraSpacing, key);
+        key = ImGui_ImplQt_FontCacheHashValue(cfg.GlyphOffset, key);
+        key = ImGui_ImplQt_FontCacheHashValue(cfg.GlyphMinAdvanceX, key);
+        key = ImGui_ImplQt_FontCacheHashValue(cfg.GlyphMaxAdvanceX, key);
+        key = ImGui_ImplQt_FontCacheHashValue(cfg.MergeMode, key);
+        key = ImGui_ImplQt_FontCacheHashValue(cfg.FontBuilderFlags, key);
+        key = ImGui_ImplQt_FontCacheHashValue(cfg.RasterizerMultiply, key);
+        key = ImGui_ImplQt_FontCacheHashValue(cfg.EllipsisChar, key);
+        key = ImGui_ImplQt_FontCacheHashValue((ImS32)atlas->Fonts.index_from_ptr(atlas->Fonts.find(cfg.DstFont)), key);
+        const ImWchar* ranges = cfg.GlyphRanges ? cfg.GlyphRanges : atlas->GetGlyphRangesDefault();
+        int range_count = 0;
+        while (ranges[range_count])
+            range_count++;
+        key = ImGui_ImplQt_HashData(ranges, sizeof(ImWchar) * (size_t)range_count, key);
+    }
+    //默认的鼠标光标和线条矩形由Flags决定,其余为用户添加的矩形
+    for (int i = 0; i < atlas->CustomRects.Size; i++)
+    {
+        if (i == atlas->PackIdMouseCursors || i == atlas->PackIdLines)
+            continue;
+        const ImFontAtlasCustomRect& r = atlas->CustomRects[i];
+        key = ImGui_ImplQt_FontCacheHashValue(r.Width, key);
+        key = ImGui_ImplQt_FontCacheHashValue(r.Height, key);
+        key = ImGui_ImplQt_FontCacheHashValue(r.GlyphID, key);
+        key = ImGui_ImplQt_FontCacheHashValue(r.GlyphAdvanceX, key);
+        key = ImGui_ImplQt_FontCacheHashValue(r.GlyphOffset, key);
+        key = ImGui_ImplQt_FontCacheHashValue((ImS32)(r.Font ? atlas->Fonts.index_from_ptr(atlas->Fonts.find(r.Font)) : -1), key);
+    }
+    return key;
+}
+
+static bool ImGui_ImplQt_LoadFontAtlas(ImFontAtlas* atlas, const QString& path, ImU64 key, int* file_bytes)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    const qint64 size = file.size();
+    if (size < (qint64)sizeof(ImGui_ImplQt_FontCacheHeader) || size > INT_MAX)
+        return false;
+    const uchar* data = file.map(0, size);
+    if (!data)
+        return false;
+
+    ImGui_ImplQt_FontCacheHeader header;
+    memcpy(&header, data, sizeof(header));
+    const int bytes_per_pixel = header.TexBytesPerPixel;
+    bool valid = memcmp(header.Magic, ImGui_ImplQt_FontCacheMagic, sizeof(header.Magic)) == 0
+        && header.Version == ImGui_ImplQt_FontCacheVersion && header.ImGuiVersion == IMGUI_VERSION_NUM
+        && header.GlyphSize == sizeof(ImFontGlyph) && header.FileSize == (ImU32)size && header.Key == key
+        && header.FontCount == atlas->Fonts.Size && header.CustomRectCount >= 0
+        && header.TexWidth > 0 && header.TexHeight > 0 && header.TexWidth <= 0x10000 && header.TexHeight <= 0x10000 && (bytes_per_pixel == 1 || bytes_per_pixel == 4);
+
+    //先校验全部段的边界,确认可用后再修改atlas。文件内容不可信,偏移按64位计算,每段之后都检查不越过文件末尾
+    qint64 offset = ImGui_ImplQt_FontCacheAlign((qint64)sizeof(header));
+    const qint64 rects_offset = offset;
+    valid = valid && header.CustomRectCount <= 0xFFFF;
+    offset = ImGui_ImplQt_FontCacheAlign(offset + (qint64)sizeof(ImGui_ImplQt_FontCacheRect) * (valid ? header.CustomRectCount : 0));
+    valid = valid && offset <= size;
+    const qint64 fonts_offset = offset;
+    offset = ImGui_ImplQt_FontCacheAlign(offset + (qint64)sizeof(ImGui_ImplQt_FontCacheFont) * (valid ? header.FontCount : 0));
+    valid = valid && offset <= size;
+    ImVector<ImGui_ImplQt_FontCacheFont> fonts;
+    ImVector<qint64> glyphs_offsets;
+    for (int n = 0; valid && n < header.FontCount; n++)
+    {
+        ImGui_ImplQt_FontCacheFont font;
+        memcpy(&font, data + fonts_offset + n * sizeof(font), sizeof(font));
+        valid = font.GlyphCount >= 0 && font.ConfigData >= 0 && font.ConfigDataCount > 0 && font.ConfigData + font.ConfigDataCount <= atlas->ConfigData.Size;
+        fonts.push_back(font);
+        glyphs_offsets.push_back(offset);
+        offset = ImGui_ImplQt_FontCacheAlign(offset + (qint64)sizeof(ImFontGlyph) * (valid ? font.GlyphCount : 0));
+        valid = valid && offset <= size;
+    }
+    const qint64 pixels_offset = offset;
+    const qint64 pixels_size = (qint64)header.TexWidth * header.TexHeight * bytes_per_pixel;
+    valid = valid && pixels_offset + pixels_size == size;
+    if (!valid) {
+        file.unmap((uchar*)data);
+        return false;
+    }
+
+    atlas->ClearTexData();
+    void* pixels = IM_ALLOC((size_t)pixels_size);
+    memcpy(pixels, data + pixels_offset, (size_t)pixels_size);
+    if (bytes_per_pixel == 1)
+        atlas->TexPixelsAlpha8 = (unsigned char*)pixels;
+    else
+        atlas->TexPixelsRGBA32 = (unsigned int*)pixels;
+    atlas->TexPixelsUseColors = header.TexPixelsUseColors != 0;
+    atlas->TexWidth = header.TexWidth;
+    atlas->TexHeight = header.TexHeight;
+    atlas->TexUvScale = header.TexUvScale;
+    atlas->TexUvWhitePixel = header.TexUvWhitePixel;
+    memcpy(atlas->TexUvLines, header.TexUvLines, sizeof(header.TexUvLines));
+    atlas->PackIdMouseCursors = header.PackIdMouseCursors;
+    atlas->PackIdLines = header.PackIdLines;
+
+    atlas->CustomRects.resize(header.CustomRectCount);
+    for (int i = 0; i < header.CustomRectCount; i++)
+    {
+        ImGui_ImplQt_FontCacheRect src;
+        memcpy(&src, data + rects_offset + i * sizeof(src), sizeof(src));
+        ImFontAtlasCustomRect& r = atlas->CustomRects[i];
+        r.Width = src.Width;
+        r.Height = src.Height;
+        r.X = src.X;
+        r.Y = src.Y;
+        r.GlyphID = src.GlyphID;
+        r.GlyphAdvanceX = src.GlyphAdvanceX;
+        r.GlyphOffset = src.GlyphOffset;
+        r.Font = (src.Font >= 0 && src.Font < atlas->Fonts.Size) ? atlas->Fonts[src.Font] : nullptr;
+    }
+
+    for (int n = 0; n < atlas->Fonts.Size; n++)
+    {
+        const ImGui_ImplQt_FontCacheFont& src = fonts[n];
+        ImFont* font = atlas->Fonts[n];
+        font->ClearOutputData();
+        font->FontSize = src.FontSize;
+        font->Ascent = src.Ascent;
+        font->Descent = src.Descent;
+        font->MetricsTotalSurface = src.MetricsTotalSurface;
+        font->ConfigData = &atlas->ConfigData[src.ConfigData];
+        font->ConfigDataCount = (short)src.ConfigDataCount;
+        font->ContainerAtlas = atlas;
+        font->Glyphs.resize(src.GlyphCount);
+        if (src.GlyphCount > 0)
+            memcpy(font->Glyphs.Data, data + glyphs_offsets[n], sizeof(ImFontGlyph) * (size_t)src.GlyphCount);
+        font->BuildLookupTable();
+    }
+    atlas->TexReady = true;
+
+    file.unmap((uchar*)data);
+    *file_bytes = (int)size;
+    return true;
+}
+
+static bool ImGui_ImplQt_SaveFontAtlas(ImFontAtlas* atlas, const QString& path, ImU64 key, int* file_bytes)
+{
+    const int bytes_per_pixel = atlas->TexPixelsAlpha8 ? 1 : 4;
+    const void* pixels = atlas->TexPixelsAlpha8 ? (const void*)atlas->TexPixelsAlpha8 : (const void*)atlas->TexPixelsRGBA32;
+    if (!pixels)
+        return false;
+
+    QByteArray data((int)ImGui_ImplQt_FontCacheAlign((qint64)sizeof(ImGui_ImplQt_FontCacheHeader)), '\0');
+    for (const ImFontAtlasCustomRect& r : atlas->CustomRects)
+    {
+        ImGui_ImplQt_FontCacheRect dst{};
+        dst.Width = r.Width;
+        dst.Height = r.Height;
+        dst.X = r.X;
+        dst.Y = r.Y;
+        dst.GlyphID = r.GlyphID;
+        dst.GlyphAdvanceX = r.GlyphAdvanceX;
+        dst.GlyphOffset = r.GlyphOffset;
+        dst.Font = r.Font ? atlas->Fonts.index_from_ptr(atlas->Fonts.find(r.Font)) : -1;
+        data.append((const char*)&dst, (int)sizeof(dst));
+    }
+    data.append(QByteArray((int)ImGui_ImplQt_FontCacheAlign(data.size()) - data.size(), '\0'));
+    for (const ImFont* font : atlas->Fonts)
+    {
+        ImGui_ImplQt_FontCacheFont dst{};
+        dst.FontSize = font->FontSize;
+        dst.Ascent = font->Ascent;
+        dst.Descent = font->Descent;
+        dst.MetricsTotalSurface = font->MetricsTotalSurface;
+        dst.ConfigData = font->ConfigData ? (ImS32)(font->ConfigData - atlas->ConfigData.Data) : -1;
+        dst.ConfigDataCount = font->ConfigDataCount;
+        dst.GlyphCount = font->Glyphs.Size;
+        data.append((const char*)&dst, (int)sizeof(dst));
+    }
+    data.append(QByteArray((int)ImGui_ImplQt_FontCacheAlign(data.size()) - data.size(), '\0'));
+    for (const ImFont* font : atlas->Fonts)
+    {
+        data.append((const char*)font->Glyphs.Data, font->Glyphs.size_in_bytes());
+        data.append(QByteArray((int)ImGui_ImplQt_FontCacheAlign(data.size()) - data.size(), '\0'));
+    }
+    data.append((const char*)pixels, atlas->TexWidth * atlas->TexHeight * bytes_per_pixel);
+
+    ImGui_ImplQt_FontCacheHeader header{};
+    memcpy(header.Magic, ImGui_ImplQt_FontCacheMagic, sizeof(header.Magic));
+    header.Version = ImGui_ImplQt_FontCacheVersion;
+    header.ImGuiVersion = IMGUI_VERSION_NUM;
+    header.GlyphSize = sizeof(ImFontGlyph);
+    header.FileSize = (ImU32)data.size();
+    header.Key = key;
+    header.TexWidth = atlas->TexWidth;
+    header.TexHeight = atlas->TexHeight;
+    header.TexBytesPerPixel = bytes_per_pixel;
+    header.TexPixelsUseColors = atlas->TexPixelsUseColors ? 1 : 0;
+    header.TexUvScale = atlas->TexUvScale;
+    header.TexUvWhitePixel = atlas->TexUvWhitePixel;
+    memcpy(header.TexUvLines, atlas->TexUvLines, sizeof(header.TexUvLines));
+    header.PackIdMouseCursors = atlas->PackIdMouseCursors;
+    header.PackIdLines = atlas->PackIdLines;
+    header.FontCount = atlas->Fonts.Size;
+    header.CustomRectCount = atlas->CustomRects.Size;
+    memcpy(data.data(), &header, sizeof(header));
+
+    //写入临时文件后替换,其他进程不会读到写了一半的文件
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit())
+        return false;
+    *file_bytes = data.size();
+    return true;
+}
+
+void ImGui_ImplQt_SetFontAtlasCache(const char* directory)
+{
+    QMutexLocker lock(&ImGui_ImplQt_FontCacheMutex);
+    ImGui_ImplQt_FontCacheEnabled = directory != nullptr;
+    if (directory && directory[0])
+        ImGui_ImplQt_FontCacheDirectory = QString::fromUtf8(directory);
+    else if (directory)
+        ImGui_ImplQt_FontCacheDirectory = QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation)).filePath("imgui_font_atlas");
+}
+
+bool ImGui_ImplQt_BuildFontAtlas(ImFontAtlas* atlas, ImGui_ImplQt_FontAtlasStats* stats)
+{
+    IM_ASSERT(atlas != nullptr);
+    IM_ASSERT(!atlas->Locked && "Cannot modify a locked ImFontAtlas between NewFrame() and EndFrame/Render()!");
+    ImGui_ImplQt_FontAtlasStats local_stats{};
+    if (!stats)
+        stats = &local_stats;
+    *stats = ImGui_ImplQt_FontAtlasStats{};
+
+    QString directory;
+    {
+        QMutexLocker lock(&ImGui_ImplQt_FontCacheMutex);
+        if (ImGui_ImplQt_FontCacheEnabled)
+            directory = ImGui_ImplQt_FontCacheDirectory;
+    }
+    if (directory.isEmpty())
+    {
+        const double build_start = ImGui_ImplQt_FontClockMs();
+        const bool ret = atlas->Build();
+        stats->BuildMs = (float)(ImGui_ImplQt_FontClockMs() - build_start);
+        return ret;
+    }
+
+    //与ImFontAtlas::Build()一致,没有字体时使用默认字体
+    if (atlas->ConfigData.Size == 0)
+        atlas->AddFontDefault();
+
+    const double hash_start = ImGui_ImplQt_FontClockMs();
+    const ImU64 key = ImGui_ImplQt_FontCacheKey(atlas);
+    const QString path = QDir(directory).filePath(QString("%1.imfont").arg(key, 16, 16, QChar('0')));
+    const double load_start = ImGui_ImplQt_FontClockMs();
+    stats->HashMs = (float)(load_start - hash_start);
+
+    if (ImGui_ImplQt_LoadFontAtlas(atlas, path, key, &stats->FileBytes))
+    {
+        stats->CacheHit = true;
+        stats->LoadMs = (float)(ImGui_ImplQt_FontClockMs() - load_start);
+        return true;
+    }
+
+    const double build_start = ImGui_ImplQt_FontClockMs();
+    if (!atlas->Build())
+        return false;
+    const double save_start = ImGui_ImplQt_FontClockMs();
+    stats->BuildMs = (float)(save_start - build_start);
+    QDir().mkpath(directory);
+    ImGui_ImplQt_SaveFontAtlas(atlas, path, key, &stats->FileBytes);
+    stats->SaveMs = (float)(ImGui_ImplQt_FontClockMs() - save_start);
+    return true;
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include "imgui.h"
+
+// Font atlas building shared by the renderers, baked atlases are cached in files keyed by a hash of their inputs
+struct ImGui_ImplQt_FontAtlasStats
+{
+    bool  CacheHit;
+    float HashMs;       // Computing the key, includes hashing the font data
+    float LoadMs;       // Restoring from the cache file
+    float BuildMs;      // Rasterizing, on a miss or without cache
+    float SaveMs;
+    int   FileBytes;
+};
+
+IMGUI_IMPL_API void ImGui_ImplQt_SetFontAtlasCache(const char* directory);      // nullptr disables (default), "" uses QStandardPaths::CacheLocation
+IMGUI_IMPL_API bool ImGui_ImplQt_BuildFontAtlas(ImFontAtlas* atlas, ImGui_ImplQt_FontAtlasStats* stats = nullptr);     // Called by CreateFontsTexture() when the atlas has no pixels
+
+// Parallel replacement of the stb_truetype builder, packing stays serial so the atlas is identical
+IMGUI_IMPL_API void ImGui_ImplQt_SetParallelFontBuild(ImFontAtlas* atlas, int thread_count = 0);    // 0: QThread::idealThreadCount(), 1: default builder
+IMGUI_IMPL_API const ImFontBuilderIO* ImGui_ImplQt_GetParallelFontBuilderIO();
+
+// Signed distance fields: glyphs are baked once and thresholded by the OpenGL3 renderer, text stays sharp when zoomed
+enum ImGui_ImplQt_FontBuilderFlags_
+{
+    ImGui_ImplQt_FontBuilderFlags_Sdf = 1 << 16,    // In ImFontAtlas::FontBuilderFlags, part of the cache key
+    ImGui_ImplQt_FontBuilderFlags_ThreadsShift = 20,            // Parallel build thread count, not part of the cache key
+    ImGui_ImplQt_FontBuilderFlags_ThreadsMask = 0xFF << 20,
+};
+struct ImGui_ImplQt_FontAtlasSdfStats
+{
+    int    Builds;              // Distance field atlases built, from any atlas
+    float  LastBuildMs;
+    int    Glyphs;
+    size_t GlyphTexels;         // Packed glyph area of the last build
+    size_t BitmapGlyphTexels;   // Area the same glyphs take as bitmaps with the configured oversampling, at one zoom level
+    size_t TextureBytes;        // Uploaded as RGBA32
+};
+IMGUI_IMPL_API void ImGui_ImplQt_SetFontAtlasSdf(ImFontAtlas* atlas, bool enable);      // Before the atlas is built
+IMGUI_IMPL_API bool ImGui_ImplQt_IsFontAtlasSdf(const ImFontAtlas* atlas);
+IMGUI_IMPL_API void ImGui_ImplQt_GetFontAtlasSdfStats(ImGui_ImplQt_FontAtlasSdfStats* stats);
+
+// Device pixel ratio variants: built on a worker thread for the window's ratio and swapped in before ImGui::NewFrame()
+struct ImGui_ImplQt_FontAtlasDpiStats
+{
+    float Scale;            // Ratio the glyphs of the atlas are rasterized for
+    float PendingScale;     // Being built on the worker, 0 when idle
+    int   Variants;         // Atlases kept besides the live one
+    int   Builds;
+    int   Swaps;
+    float LastBuildMs;      // Worker time of the last variant, includes converting to RGBA32
+    float LastSwapMs;       // GUI thread time of the last swap, without the texture upload
+};
+IMGUI_IMPL_API void ImGui_ImplQt_SetFontAtlasDpiVariants(ImFontAtlas* atlas, int max_variants = 3);    // Attaches the current context, 0 detaches it
+IMGUI_IMPL_API bool ImGui_ImplQt_GetFontAtlasDpiStats(ImFontAtlas* atlas, ImGui_ImplQt_FontAtlasDpiStats* stats);
+// Called by the backends
+IMGUI_IMPL_API void ImGui_ImplQt_RequestFontAtlasScale(ImFontAtlas* atlas, float device_pixel_ratio);
+IMGUI_IMPL_API bool ImGui_ImplQt_ApplyFontAtlasScale(ImGuiIO& io);     // true when the atlas content changed and the font texture needs to be uploaded again
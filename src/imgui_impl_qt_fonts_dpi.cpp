@@ -0,0 +1,397 @@
+﻿#include "imgui_impl_qt_fonts.h"
+#include "imgui_impl_qt_hash.h"
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QVector>
+#include <QtCore/QThreadPool>
+#include <QtCore/QRunnable>
+#include <QtCore/QElapsedTimer>
+#include <algorithm>
+#include <atomic>
+#include <float.h>
+#include <math.h>
+#include <memory>
+#include <string.h>
+#include <vector>
+
+namespace
+{
+    struct FontVariant
+    {
+        float        Scale{};
+        ImFontAtlas* Atlas{};
+    };
+
+    //工作线程只在设置Done之前写入,GUI线程看到Done之后才读取。
+    //任务与GUI线程共同持有,GUI线程不再需要时不等待,由最后一个持有者释放图集和它引用的字体数据
+    struct FontVariantBuild
+    {
+        ~FontVariantBuild()
+        {
+            if (Atlas)
+                IM_DELETE(Atlas);
+        }
+
+        float               Scale{};
+        ImFontAtlas*        Atlas{};
+        QVector<QByteArray> FontData;
+        float               BuildMs{};
+        std::atomic<bool>   Done{};
+    };
+
+    //每个使用该图集的ImGui上下文各自记录io.FontGlobalScale对应的DPR和已上传的图集版本
+    struct FontVariantContext
+    {
+        ImGuiContext* Context{};
+        float         Scale{ 1.0f };
+        int           Generation{};
+    };
+
+    class FontVariantTask :public QRunnable
+    {
+    public:
+        explicit FontVariantTask(std::shared_ptr<FontVariantBuild> build)
+            :m_build(std::move(build)) {};
+
+        void run() override {
+            //只会与GUI线程并发修改调试用的分配计数,不触碰其它上下文状态
+            QElapsedTimer timer;
+            timer.start();
+            if (ImGui_ImplQt_BuildFontAtlas(m_build->Atlas)) {
+                unsigned char* pixels;
+                int width, height;
+                m_build->Atlas->GetTexDataAsRGBA32(&pixels, &width, &height);
+            }
+            m_build->BuildMs = (float)timer.nsecsElapsed() / 1000000.0f;
+            m_build->Done.store(true, std::memory_order_release);
+        }
+    private:
+        std::shared_ptr<FontVariantBuild> m_build;
+    };
+
+    struct FontVariants
+    {
+        ~FontVariants()
+        {
+            for (auto& variant : Cached)
+                IM_DELETE(variant.Atlas);
+        }
+
+        FontVariantContext* FindContext(ImGuiContext* context)
+        {
+            for (auto& user : Contexts) {
+                if (user.Context == context)
+                    return &user;
+            }
+            Contexts.push_back(FontVariantContext{ context, 1.0f, Generation });
+            return &Contexts.back();
+        }
+
+        int   MaxVariants{};
+        float Scale{ 1.0f };            //当前图集对应的DPR
+        float RequestedScale{ 1.0f };
+        int   Generation{};             //每次交换加一
+        ImU64 Signature{};
+        QVector<QByteArray> FontData;       //源图集字体数据的副本,变体的配置指向这里
+        std::vector<FontVariant> Cached;    //最近使用的在前
+        std::shared_ptr<FontVariantBuild> Pending;
+        std::vector<FontVariantContext> Contexts;
+        ImGui_ImplQt_FontAtlasDpiStats Stats{};
+    };
+
+    //不同线程上的无头上下文各自使用自己的图集时也会同时访问
+    QHash<ImFontAtlas*, FontVariants*> AtlasVariants;
+    QMutex AtlasVariantsMutex;
+}
+
+//字体源的配置变化后,已有的变体全部作废
+static ImU64 ImGui_ImplQt_FontConfigSignature(const ImFontAtlas* atlas)
+{
+    ImU64 hash = ImGui_ImplQt_HashData(atlas->ConfigData.Data, (size_t)atlas->ConfigData.size_in_bytes());
+    return ImGui_ImplQt_HashData(&atlas->CustomRects.Size, sizeof(atlas->CustomRects.Size), hash);
+}
+
+static inline float ImGui_ImplQt_QuantizeScale(float scale)
+{
+    return floorf(scale * 100.0f + 0.5f) / 100.0f;
+}
+
+// Same fonts and custom rects, every size in pixels multiplied by scale. The configs point into font_data,
+// a copy of the source atlas data the variant has to keep alive.
+static ImFontAtlas* ImGui_ImplQt_CreateFontVariant(const ImFontAtlas* src, float scale, const QVector<QByteArray>& font_data)
+{
+    ImFontAtlas* atlas = IM_NEW(ImFontAtlas)();
+    atlas->Flags = src->Flags;
+    atlas->TexDesiredWidth = src->TexDesiredWidth;
+    atlas->TexGlyphPadding = src->TexGlyphPadding;
+    atlas->FontBuilderIO = src->FontBuilderIO;
+    atlas->FontBuilderFlags = src->FontBuilderFlags;
+    atlas->UserData = src->UserData;
+
+    for (int i = 0; i < src->ConfigData.Size; i++)
+    {
+        ImFontConfig config = src->ConfigData[i];
+        config.DstFont = nullptr;
+        config.SizePixels *= scale;
+        config.GlyphOffset = ImVec2(config.GlyphOffset.x * scale, config.GlyphOffset.y * scale);
+        config.GlyphExtraSpacing = ImVec2(config.GlyphExtraSpacing.x * scale, config.GlyphExtraSpacing.y * scale);
+        config.GlyphMinAdvanceX *= scale;
+        if (config.GlyphMaxAdvanceX < FLT_MAX)
+            config.GlyphMaxAdvanceX *= scale;
+        atlas->AddFont(&config);
+
+        //AddFont()会复制一份字体数据,换成所有变体共享的副本,源图集的数据随时可能被应用程序释放
+        ImFontConfig& dst_config = atlas->ConfigData.back();
+        if (dst_config.FontDataOwnedByAtlas)
+            IM_FREE(dst_config.FontData);
+        dst_config.FontData = const_cast<char*>(font_data[i].constData());
+        dst_config.FontDataOwnedByAtlas = false;
+    }
+
+    //自定义矩形按相同顺序添加,下标与源图集一一对应,鼠标光标和线条纹理的位置也沿用源图集的下标
+    for (int i = 0; i < src->CustomRects.Size; i++)
+    {
+        const ImFontAtlasCustomRect& rect = src->CustomRects[i];
+        const int font_index = rect.Font ? (int)(std::find(src->Fonts.begin(), src->Fonts.end(), rect.Font) - src->Fonts.begin()) : -1;
+        if (font_index >= 0 && font_index < atlas->Fonts.Size)
+            atlas->AddCustomRectFontGlyph(atlas->Fonts[font_index], (ImWchar)rect.GlyphID, rect.Width, rect.Height, rect.GlyphAdvanceX * scale,
+                ImVec2(rect.GlyphOffset.x * scale, rect.GlyphOffset.y * scale));
+        else
+            atlas->AddCustomRectRegular(rect.Width, rect.Height);
+    }
+    atlas->PackIdMouseCursors = src->PackIdMouseCursors;
+    atlas->PackIdLines = src->PackIdLines;
+    return atlas;
+}
+
+// Custom rects have the same size at every scale, the pixels the application wrote into the live atlas are carried over
+static void ImGui_ImplQt_CopyCustomRects(const ImFontAtlas* src, ImFontAtlas* dst)
+{
+    for (int i = 0; i < src->CustomRects.Size && i < dst->CustomRects.Size; i++)
+    {
+        if (i == src->PackIdMouseCursors || i == src->PackIdLines)
+            continue;
+        const ImFontAtlasCustomRect& s = src->CustomRects[i];
+        const ImFontAtlasCustomRect& d = dst->CustomRects[i];
+        if (!s.IsPacked() || !d.IsPacked())
+            continue;
+        for (int y = 0; y < s.Height; y++)
+        {
+            if (src->TexPixelsRGBA32 && dst->TexPixelsRGBA32)
+                memcpy(dst->TexPixelsRGBA32 + (size_t)(d.Y + y) * dst->TexWidth + d.X, src->TexPixelsRGBA32 + (size_t)(s.Y + y) * src->TexWidth + s.X, (size_t)s.Width * 4);
+            if (src->TexPixelsAlpha8 && dst->TexPixelsAlpha8)
+                memcpy(dst->TexPixelsAlpha8 + (size_t)(d.Y + y) * dst->TexWidth + d.X, src->TexPixelsAlpha8 + (size_t)(s.Y + y) * src->TexWidth + s.X, (size_t)s.Width);
+        }
+    }
+}
+
+// Exchanges the glyph tables while each ImFont keeps its atlas and config, so pointers held by the application stay valid
+static void ImGui_ImplQt_SwapFont(ImFont* a, ImFont* b)
+{
+    ImFontAtlas* a_atlas = a->ContainerAtlas;
+    ImFontAtlas* b_atlas = b->ContainerAtlas;
+    const ImFontConfig* a_config = a->ConfigData;
+    const ImFontConfig* b_config = b->ConfigData;
+    const short a_config_count = a->ConfigDataCount;
+    const short b_config_count = b->ConfigDataCount;
+    const int a_fallback = a->FallbackGlyph ? (int)(a->FallbackGlyph - a->Glyphs.Data) : -1;
+    const int b_fallback = b->FallbackGlyph ? (int)(b->FallbackGlyph - b->Glyphs.Data) : -1;
+
+    ImFont tmp = *a;
+    *a = *b;
+    *b = tmp;
+
+    a->ContainerAtlas = a_atlas;
+    b->ContainerAtlas = b_atlas;
+    a->ConfigData = a_config;
+    b->ConfigData = b_config;
+    a->ConfigDataCount = a_config_count;
+    b->ConfigDataCount = b_config_count;
+    a->FallbackGlyph = b_fallback >= 0 ? &a->Glyphs[b_fallback] : nullptr;
+    b->FallbackGlyph = a_fallback >= 0 ? &b->Glyphs[a_fallback] : nullptr;
+}
+
+static void ImGui_ImplQt_SwapAtlas(ImFontAtlas* live, ImFontAtlas* variant)
+{
+    ImGui_ImplQt_CopyCustomRects(live, variant);
+    for (int i = 0; i < live->Fonts.Size && i < variant->Fonts.Size; i++)
+        ImGui_ImplQt_SwapFont(live->Fonts[i], variant->Fonts[i]);
+    for (int i = 0; i < live->CustomRects.Size && i < variant->CustomRects.Size; i++)
+    {
+        std::swap(live->CustomRects[i].X, variant->CustomRects[i].X);
+        std::swap(live->CustomRects[i].Y, variant->CustomRects[i].Y);
+    }
+    std::swap(live->TexReady, variant->TexReady);
+    std::swap(live->TexPixelsUseColors, variant->TexPixelsUseColors);
+    std::swap(live->TexPixelsAlpha8, variant->TexPixelsAlpha8);
+    std::swap(live->TexPixelsRGBA32, variant->TexPixelsRGBA32);
+    std::swap(live->TexWidth, variant->TexWidth);
+    std::swap(live->TexHeight, variant->TexHeight);
+    std::swap(live->TexUvScale, variant->TexUvScale);
+    std::swap(live->TexUvWhitePixel, variant->TexUvWhitePixel);
+    for (int i = 0; i < IM_ARRAYSIZE(live->TexUvLines); i++)
+        std::swap(live->TexUvLines[i], variant->TexUvLines[i]);
+}
+
+static void ImGui_ImplQt_StartFontVariant(ImFontAtlas* atlas, FontVariants* variants, float scale)
+{
+    //字体在本帧被重建时等ApplyFontAtlasScale()换掉整组变体后再开始
+    if (ImGui_ImplQt_FontConfigSignature(atlas) != variants->Signature)
+        return;
+    if (variants->FontData.isEmpty())
+    {
+        for (const ImFontConfig& config : atlas->ConfigData)
+            variants->FontData.push_back(QByteArray((const char*)config.FontData, config.FontDataSize));
+    }
+    variants->Pending = std::make_shared<FontVariantBuild>();
+    variants->Pending->Scale = scale;
+    variants->Pending->FontData = variants->FontData;
+    variants->Pending->Atlas = ImGui_ImplQt_CreateFontVariant(atlas, scale, variants->FontData);
+    QThreadPool::globalInstance()->start(new FontVariantTask(variants->Pending));
+}
+
+void ImGui_ImplQt_SetFontAtlasDpiVariants(ImFontAtlas* atlas, int max_variants)
+{
+    if (atlas == nullptr)
+        return;
+    QMutexLocker lock(&AtlasVariantsMutex);
+    ImGuiContext* context = ImGui::GetCurrentContext();
+    FontVariants* variants = AtlasVariants.value(atlas, nullptr);
+    if (max_variants <= 0)
+    {
+        if (variants == nullptr)
+            return;
+        //只解除当前上下文,共享图集的其它上下文仍在使用时保留变体
+        variants->Contexts.erase(std::remove_if(variants->Contexts.begin(), variants->Contexts.end(),
+            [&](const FontVariantContext& user) { return user.Context == context; }), variants->Contexts.end());
+        if (!variants->Contexts.empty())
+            return;
+        //保留当前使用的字形,io.FontGlobalScale与之匹配,不需要恢复
+        AtlasVariants.remove(atlas);
+        delete variants;
+        return;
+    }
+    if (variants == nullptr)
+    {
+        variants = new FontVariants();
+        variants->Signature = ImGui_ImplQt_FontConfigSignature(atlas);
+        AtlasVariants.insert(atlas, variants);
+    }
+    variants->MaxVariants = max_variants;
+    variants->FindContext(context);
+}
+
+bool ImGui_ImplQt_GetFontAtlasDpiStats(ImFontAtlas* atlas, ImGui_ImplQt_FontAtlasDpiStats* stats)
+{
+    QMutexLocker lock(&AtlasVariantsMutex);
+    FontVariants* variants = AtlasVariants.value(atlas, nullptr);
+    if (variants == nullptr || stats == nullptr)
+        return false;
+    *stats = variants->Stats;
+    stats->Scale = variants->Scale;
+    stats->PendingScale = variants->Pending ? variants->Pending->Scale : 0.0f;
+    stats->Variants = (int)variants->Cached.size();
+    return true;
+}
+
+void ImGui_ImplQt_RequestFontAtlasScale(ImFontAtlas* atlas, float device_pixel_ratio)
+{
+    QMutexLocker lock(&AtlasVariantsMutex);
+    FontVariants* variants = AtlasVariants.value(atlas, nullptr);
+    if (variants == nullptr || device_pixel_ratio <= 0.0f || !atlas->IsBuilt())
+        return;
+    const float scale = ImGui_ImplQt_QuantizeScale(device_pixel_ratio);
+    variants->RequestedScale = scale;
+    if (scale == variants->Scale || variants->Pending)
+        return;
+    for (const auto& variant : variants->Cached) {
+        if (variant.Scale == scale)
+            return;
+    }
+    ImGui_ImplQt_StartFontVariant(atlas, variants, scale);
+}
+
+// Swaps in the cached variant of the requested scale, or starts building it
+static void ImGui_ImplQt_SwapFontVariant(ImFontAtlas* atlas, FontVariants* variants)
+{
+    auto it = std::find_if(variants->Cached.begin(), variants->Cached.end(),
+        [&](const FontVariant& variant) { return variant.Scale == variants->RequestedScale; });
+    if (it == variants->Cached.end())
+    {
+        if (!variants->Pending)
+            ImGui_ImplQt_StartFontVariant(atlas, variants, variants->RequestedScale);
+        return;
+    }
+
+    //换入新的字形和像素,换出的一份作为旧DPR的变体留在缓存最前面
+    QElapsedTimer timer;
+    timer.start();
+    FontVariant variant = *it;
+    variants->Cached.erase(it);
+    ImGui_ImplQt_SwapAtlas(atlas, variant.Atlas);
+    std::swap(variants->Scale, variant.Scale);
+    variants->Generation++;
+    variants->Cached.insert(variants->Cached.begin(), variant);
+    while ((int)variants->Cached.size() > variants->MaxVariants)
+    {
+        IM_DELETE(variants->Cached.back().Atlas);
+        variants->Cached.pop_back();
+    }
+    variants->Stats.Swaps++;
+    variants->Stats.LastSwapMs = (float)timer.nsecsElapsed() / 1000000.0f;
+}
+
+bool ImGui_ImplQt_ApplyFontAtlasScale(ImGuiIO& io)
+{
+    QMutexLocker lock(&AtlasVariantsMutex);
+    ImFontAtlas* atlas = io.Fonts;
+    FontVariants* variants = AtlasVariants.value(atlas, nullptr);
+    if (variants == nullptr || !atlas->IsBuilt())
+        return false;
+
+    //应用程序重建了字体,图集已回到1倍尺寸;进行中的构建留给工作线程收尾后释放
+    const ImU64 signature = ImGui_ImplQt_FontConfigSignature(atlas);
+    if (signature != variants->Signature)
+    {
+        FontVariants* reset = new FontVariants();
+        reset->MaxVariants = variants->MaxVariants;
+        reset->Signature = signature;
+        reset->Contexts = variants->Contexts;
+        for (auto& user : reset->Contexts)
+            user.Generation = 0;
+        delete variants;
+        variants = reset;
+        AtlasVariants.insert(atlas, variants);
+        FontVariantContext* user = variants->FindContext(ImGui::GetCurrentContext());
+        io.FontGlobalScale *= user->Scale;
+        user->Scale = 1.0f;
+        return false;
+    }
+
+    if (variants->Pending && variants->Pending->Done.load(std::memory_order_acquire))
+    {
+        std::shared_ptr<FontVariantBuild> build = std::move(variants->Pending);
+        variants->Stats.Builds++;
+        variants->Stats.LastBuildMs = build->BuildMs;
+        if (build->Atlas->IsBuilt() && build->Scale != variants->Scale)
+        {
+            variants->Cached.insert(variants->Cached.begin(), FontVariant{ build->Scale, build->Atlas });
+            build->Atlas = nullptr;
+        }
+    }
+
+    if (variants->RequestedScale != variants->Scale)
+        ImGui_ImplQt_SwapFontVariant(atlas, variants);
+
+    //共享图集的上下文各自换算io.FontGlobalScale,图集换过之后各自重新上传字体纹理
+    FontVariantContext* user = variants->FindContext(ImGui::GetCurrentContext());
+    if (user->Scale != variants->Scale)
+    {
+        io.FontGlobalScale *= user->Scale / variants->Scale;
+        user->Scale = variants->Scale;
+    }
+    if (user->Generation == variants->Generation)
+        return false;
+    user->Generation = variants->Generation;
+    return true;
+}
@@ -0,0 +1,517 @@
+﻿#include "imgui_impl_qt_fonts.h"
+#include "imgui_internal.h"
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+#include <QtCore/QRunnable>
+#include <QtCore/QSemaphore>
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QElapsedTimer>
+#include <atomic>
+#include <functional>
+#include <stdlib.h>
+#include <string.h>
+
+//与imgui_draw.cpp使用相同的配置,保证光栅化结果一致;内存直接用malloc,工作线程不访问ImGui上下文
+#ifndef IMGUI_DISABLE_STB_RECT_PACK_IMPLEMENTATION
+#ifndef STBRP_ASSERT
+#define STBRP_ASSERT(x)     do { IM_ASSERT(x); } while (0)
+#endif
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#endif
+#ifdef IMGUI_STB_RECT_PACK_FILENAME
+#include IMGUI_STB_RECT_PACK_FILENAME
+#else
+#include "imstb_rectpack.h"
+#endif
+
+#ifndef IMGUI_DISABLE_STB_TRUETYPE_IMPLEMENTATION
+#define STBTT_malloc(x,u)   ((void)(u), malloc(x))
+#define STBTT_free(x,u)     ((void)(u), free(x))
+#define STBTT_assert(x)     do { IM_ASSERT(x); } while(0)
+#define STBTT_fmod(x,y)     ImFmod(x,y)
+#define STBTT_sqrt(x)       ImSqrt(x)
+#define STBTT_pow(x,y)      ImPow(x,y)
+#define STBTT_fabs(x)       ImFabs(x)
+#define STBTT_ifloor(x)     ((int)ImFloorSigned(x))
+#define STBTT_iceil(x)      ((int)ImCeil(x))
+#define STBTT_STATIC
+#define STB_TRUETYPE_IMPLEMENTATION
+#else
+#define STBTT_DEF extern
+#endif
+#ifdef IMGUI_STB_TRUETYPE_FILENAME
+#include IMGUI_STB_TRUETYPE_FILENAME
+#else
+#include "imstb_truetype.h"
+#endif
+
+// Same steps as ImFontAtlasBuildWithStbTruetype(), the per glyph work of steps 2, 4 and 8 is split in jobs.
+// Packing stays serial so every glyph lands at the same place as in the serial build.
+struct ImGui_ImplQt_FontBuildSrc
+{
+    stbtt_fontinfo      FontInfo;
+    stbtt_pack_range    PackRange;
+    stbrp_rect*         Rects;
+    stbtt_packedchar*   PackedChars;
+    const ImWchar*      SrcRanges;
+    int                 DstIndex;
+    int                 GlyphsHighest;
+    int                 GlyphsCount;
+    float               Scale;
+    ImBitVector         GlyphsFound;        // Codepoints present in the font, filled by the jobs
+    ImBitVector         GlyphsSet;
+    ImVector<int>       GlyphsList;
+};
+
+struct ImGui_ImplQt_FontBuildDst
+{
+    int                 SrcCount;
+    int                 GlyphsHighest;
+    int                 GlyphsCount;
+    ImBitVector         GlyphsSet;
+};
+
+struct ImGui_ImplQt_FontBuildJob
+{
+    int Src;
+    int Begin;      // Codepoint (step 2) or glyph index (steps 4 and 8)
+    int End;
+};
+
+class ImGui_ImplQt_FontBuildTask :public QRunnable
+{
+public:
+    ImGui_ImplQt_FontBuildTask(const std::function<void()>& work, QSemaphore* done)
+        :Work(work), Done(done) {}
+    void run() override {
+        Work();
+        Done->release();
+    }
+private:
+    std::function<void()> Work;
+    QSemaphore* Done;
+};
+
+//距离场在字形轮廓外延伸的像素数,字形矩形每边相应加大
+static const int ImGui_ImplQt_FontSdfSpread = 4;
+static QMutex ImGui_ImplQt_FontSdfMutex;
+static ImGui_ImplQt_FontAtlasSdfStats ImGui_ImplQt_FontSdfStats{};
+
+//调用线程也参与执行,线程池被占满时不会卡住
+static void ImGui_ImplQt_FontBuildRun(int thread_count, const ImVector<ImGui_ImplQt_FontBuildJob>& jobs, const std::function<void(const ImGui_ImplQt_FontBuildJob&)>& fn)
+{
+    if (thread_count <= 0)
+        thread_count = QThread::idealThreadCount();
+    thread_count = ImClamp(thread_count, 1, ImMax(jobs.Size, 1));
+
+    std::atomic<int> next{ 0 };
+    const std::function<void()> work = [&]() {
+        for (int i = next.fetch_add(1); i < jobs.Size; i = next.fetch_add(1))
+            fn(jobs[i]);
+    };
+    QSemaphore done;
+    for (int i = 1; i < thread_count; i++)
+    {
+        auto task = new ImGui_ImplQt_FontBuildTask(work, &done);
+        task->setAutoDelete(true);
+        QThreadPool::globalInstance()->start(task);
+    }
+    work();
+    done.acquire(thread_count - 1);
+}
+
+static void ImGui_ImplQt_FontBuildUnpackBitVector(const ImBitVector* in, ImVector<int>* out)
+{
+    const ImU32* it_begin = in->Storage.begin();
+    const ImU32* it_end = in->Storage.end();
+    for (const ImU32* it = it_begin; it < it_end; it++)
+        if (ImU32 entries_32 = *it)
+            for (ImU32 bit_n = 0; bit_n < 32; bit_n++)
+                if (entries_32 & ((ImU32)1 << bit_n))
+                    out->push_back((int)(((it - it_begin) << 5) + bit_n));
+}
+
+// Bakes the glyphs of a job as distance fields: 128 on the outline, spread pixels map to the full range.
+// The packed char gets the same fields stbtt_PackFontRangesRenderIntoRects() would fill, step 9 does not change.
+static void ImGui_ImplQt_FontBuildSdf(ImFontAtlas* atlas, ImGui_ImplQt_FontBuildSrc& src_tmp, const ImGui_ImplQt_FontBuildJob& job)
+{
+    for (int glyph_i = job.Begin; glyph_i < job.End; glyph_i++)
+    {
+        const stbrp_rect& r = src_tmp.Rects[glyph_i];
+        stbtt_packedchar& pc = src_tmp.PackedChars[glyph_i];
+        if (!r.was_packed)
+            continue;
+        const int glyph_index_in_font = stbtt_FindGlyphIndex(&src_tmp.FontInfo, src_tmp.GlyphsList[glyph_i]);
+        int advance, lsb;
+        stbtt_GetGlyphHMetrics(&src_tmp.FontInfo, glyph_index_in_font, &advance, &lsb);
+        int w = 0, h = 0, xoff = 0, yoff = 0;
+        unsigned char* field = stbtt_GetGlyphSDF(&src_tmp.FontInfo, src_tmp.Scale, glyph_index_in_font, ImGui_ImplQt_FontSdfSpread,
+            128, 128.0f / ImGui_ImplQt_FontSdfSpread, &w, &h, &xoff, &yoff);
+        if (field)
+        {
+            IM_ASSERT(w <= r.w && h <= r.h);
+            for (int y = 0; y < h; y++)
+                memcpy(atlas->TexPixelsAlpha8 + (size_t)(r.y + y) * atlas->TexWidth + r.x, field + (size_t)y * w, (size_t)w);
+            stbtt_FreeSDF(field, nullptr);
+        }
+        pc.x0 = (unsigned short)r.x;
+        pc.y0 = (unsigned short)r.y;
+        pc.x1 = (unsigned short)(r.x + w);
+        pc.y1 = (unsigned short)(r.y + h);
+        pc.xoff = (float)xoff;
+        pc.yoff = (float)yoff;
+        pc.xoff2 = (float)(xoff + w);
+        pc.yoff2 = (float)(yoff + h);
+        pc.xadvance = src_tmp.Scale * advance;
+    }
+}
+
+static bool ImGui_ImplQt_FontBuildParallel(ImFontAtlas* atlas)
+{
+    IM_ASSERT(atlas->ConfigData.Size > 0);
+
+    // Distance fields: glyphs are baked once without oversampling, the renderer thresholds them at any scale.
+    // Baked lines would be read as distances, the anti-aliased line texture cannot be used.
+    const bool sdf = (atlas->FontBuilderFlags & ImGui_ImplQt_FontBuilderFlags_Sdf) != 0;
+    if (sdf)
+        atlas->Flags |= ImFontAtlasFlags_NoBakedLines;
+    const int thread_count = (int)((atlas->FontBuilderFlags & ImGui_ImplQt_FontBuilderFlags_ThreadsMask) >> ImGui_ImplQt_FontBuilderFlags_ThreadsShift);
+    QElapsedTimer sdf_timer;
+    sdf_timer.start();
+    std::atomic<size_t> bitmap_texels{ 0 };
+
+    ImFontAtlasBuildInit(atlas);
+
+    // Clear atlas
+    atlas->TexID = (ImTextureID)NULL;
+    atlas->TexWidth = atlas->TexHeight = 0;
+    atlas->TexUvScale = ImVec2(0.0f, 0.0f);
+    atlas->TexUvWhitePixel = ImVec2(0.0f, 0.0f);
+    atlas->ClearTexData();
+
+    ImVector<ImGui_ImplQt_FontBuildSrc> src_tmp_array;
+    ImVector<ImGui_ImplQt_FontBuildDst> dst_tmp_array;
+    src_tmp_array.resize(atlas->ConfigData.Size);
+    dst_tmp_array.resize(atlas->Fonts.Size);
+    memset((void*)src_tmp_array.Data, 0, (size_t)src_tmp_array.size_in_bytes());
+    memset((void*)dst_tmp_array.Data, 0, (size_t)dst_tmp_array.size_in_bytes());
+
+    // 1. Initialize font loading structure, check font data validity
+    for (int src_i = 0; src_i < atlas->ConfigData.Size; src_i++)
+    {
+        ImGui_ImplQt_FontBuildSrc& src_tmp = src_tmp_array[src_i];
+        ImFontConfig& cfg = atlas->ConfigData[src_i];
+        IM_ASSERT(cfg.DstFont && (!cfg.DstFont->IsLoaded() || cfg.DstFont->ContainerAtlas == atlas));
+
+        src_tmp.DstIndex = -1;
+        for (int output_i = 0; output_i < atlas->Fonts.Size && src_tmp.DstIndex == -1; output_i++)
+            if (cfg.DstFont == atlas->Fonts[output_i])
+                src_tmp.DstIndex = output_i;
+        if (src_tmp.DstIndex == -1)
+        {
+            IM_ASSERT(0); // cfg.DstFont not pointing within atlas->Fonts[] array?
+            return false;
+        }
+        const int font_offset = stbtt_GetFontOffsetForIndex((unsigned char*)cfg.FontData, cfg.FontNo);
+        IM_ASSERT(font_offset >= 0 && "FontData is incorrect, or FontNo cannot be found.");
+        if (!stbtt_InitFont(&src_tmp.FontInfo, (unsigned char*)cfg.FontData, font_offset))
+            return false;
+
+        ImGui_ImplQt_FontBuildDst& dst_tmp = dst_tmp_array[src_tmp.DstIndex];
+        src_tmp.SrcRanges = cfg.GlyphRanges ? cfg.GlyphRanges : atlas->GetGlyphRangesDefault();
+        for (const ImWchar* src_range = src_tmp.SrcRanges; src_range[0] && src_range[1]; src_range += 2)
+        {
+            IM_ASSERT(src_range[0] <= src_range[1]);
+            src_tmp.GlyphsHighest = ImMax(src_tmp.GlyphsHighest, (int)src_range[1]);
+        }
+        dst_tmp.SrcCount++;
+        dst_tmp.GlyphsHighest = ImMax(dst_tmp.GlyphsHighest, src_tmp.GlyphsHighest);
+    }
+
+    // 2. Look up the requested codepoints in parallel, then resolve overlaps between source fonts in order
+    ImVector<ImGui_ImplQt_FontBuildJob> jobs;
+    const int codepoints_per_job = 32 * 64;    //按32对齐,各任务写入不同的位图字
+    for (int src_i = 0; src_i < src_tmp_array.Size; src_i++)
+    {
+        ImGui_ImplQt_FontBuildSrc& src_tmp = src_tmp_array[src_i];
+        src_tmp.GlyphsFound.Create(src_tmp.GlyphsHighest + 1);
+        for (int begin = 0; begin <= src_tmp.GlyphsHighest; begin += codepoints_per_job)
+            jobs.push_back({ src_i, begin, ImMin(begin + codepoints_per_job, src_tmp.GlyphsHighest + 1) });
+    }
+    ImGui_ImplQt_FontBuildRun(thread_count, jobs, [&](const ImGui_ImplQt_FontBuildJob& job) {
+        ImGui_ImplQt_FontBuildSrc& src_tmp = src_tmp_array[job.Src];
+        for (const ImWchar* src_range = src_tmp.SrcRanges; src_range[0] && src_range[1]; src_range += 2)
+        {
+            const int begin = ImMax((int)src_range[0], job.Begin);
+            const int end = ImMin((int)src_range[1] + 1, job.End);
+            for (int codepoint = begin; codepoint < end; codepoint++)
+                if (!src_tmp.GlyphsFound.TestBit(codepoint) && stbtt_FindGlyphIndex(&src_tmp.FontInfo, codepoint))
+                    src_tmp.GlyphsFound.SetBit(codepoint);
+        }
+    });
+
+    int total_glyphs_count = 0;
+    for (int src_i = 0; src_i < src_tmp_array.Size; src_i++)
+    {
+        ImGui_ImplQt_FontBuildSrc& src_tmp = src_tmp_array[src_i];
+        ImGui_ImplQt_FontBuildDst& dst_tmp = dst_tmp_array[src_tmp.DstIndex];
+        src_tmp.GlyphsSet.Create(src_tmp.GlyphsHighest + 1);
+        if (dst_tmp.GlyphsSet.Storage.empty())
+            dst_tmp.GlyphsSet.Create(dst_tmp.GlyphsHighest + 1);
+
+        for (const ImWchar* src_range = src_tmp.SrcRanges; src_range[0] && src_range[1]; src_range += 2)
+            for (unsigned int codepoint = src_range[0]; codepoint <= src_range[1]; codepoint++)
+            {
+                if (dst_tmp.GlyphsSet.TestBit(codepoint))
+                    continue;
+                if (!src_tmp.GlyphsFound.TestBit(codepoint))
+                    continue;
+
+                src_tmp.GlyphsCount++;
+                dst_tmp.GlyphsCount++;
+                src_tmp.GlyphsSet.SetBit(codepoint);
+                dst_tmp.GlyphsSet.SetBit(codepoint);
+                total_glyphs_count++;
+            }
+        src_tmp.GlyphsFound.Clear();
+    }
+
+    // 3. Unpack our bit map into a flat list
+    for (int src_i = 0; src_i < src_tmp_array.Size; src_i++)
+    {
+        ImGui_ImplQt_FontBuildSrc& src_tmp = src_tmp_array[src_i];
+        src_tmp.GlyphsList.reserve(src_tmp.GlyphsCount);
+        ImGui_ImplQt_FontBuildUnpackBitVector(&src_tmp.GlyphsSet, &src_tmp.GlyphsList);
+        src_tmp.GlyphsSet.Clear();
+        IM_ASSERT(src_tmp.GlyphsList.Size == src_tmp.GlyphsCount);
+    }
+    for (int dst_i = 0; dst_i < dst_tmp_array.Size; dst_i++)
+        dst_tmp_array[dst_i].GlyphsSet.Clear();
+    dst_tmp_array.clear();
+
+    ImVector<stbrp_rect> buf_rects;
+    ImVector<stbtt_packedchar> buf_packedchars;
+    buf_rects.resize(total_glyphs_count);
+    buf_packedchars.resize(total_glyphs_count);
+    memset(buf_rects.Data, 0, (size_t)buf_rects.size_in_bytes());
+    memset(buf_packedchars.Data, 0, (size_t)buf_packedchars.size_in_bytes());
+
+    // 4. Gather glyphs sizes so we can pack them in our virtual canvas.
+    const int glyphs_per_job = 256;
+    jobs.resize(0);
+    int buf_rects_out_n = 0;
+    int buf_packedchars_out_n = 0;
+    for (int src_i = 0; src_i < src_tmp_array.Size; src_i++)
+    {
+        ImGui_ImplQt_FontBuildSrc& src_tmp = src_tmp_array[src_i];
+        if (src_tmp.GlyphsCount == 0)
+            continue;
+
+        src_tmp.Rects = &buf_rects[buf_rects_out_n];
+        src_tmp.PackedChars = &buf_packedchars[buf_packedchars_out_n];
+        buf_rects_out_n += src_tmp.GlyphsCount;
+        buf_packedchars_out_n += src_tmp.GlyphsCount;
+
+        ImFontConfig& cfg = atlas->ConfigData[src_i];
+        src_tmp.PackRange.font_size = cfg.SizePixels;
+        src_tmp.PackRange.first_unicode_codepoint_in_range = 0;
+        src_tmp.PackRange.array_of_unicode_codepoints = src_tmp.GlyphsList.Data;
+        src_tmp.PackRange.num_chars = src_tmp.GlyphsList.Size;
+        src_tmp.PackRange.chardata_for_range = src_tmp.PackedChars;
+        src_tmp.PackRange.h_oversample = (unsigned char)cfg.OversampleH;
+        src_tmp.PackRange.v_oversample = (unsigned char)cfg.OversampleV;
+        src_tmp.Scale = (cfg.SizePixels > 0) ? stbtt_ScaleForPixelHeight(&src_tmp.FontInfo, cfg.SizePixels) : stbtt_ScaleForMappingEmToPixels(&src_tmp.FontInfo, -cfg.SizePixels);
+
+        for (int begin = 0; begin < src_tmp.GlyphsCount; begin += glyphs_per_job)
+            jobs.push_back({ src_i, begin, ImMin(begin + glyphs_per_job, src_tmp.GlyphsCount) });
+    }
+    const int padding = atlas->TexGlyphPadding;
+    ImGui_ImplQt_FontBuildRun(thread_count, jobs, [&](const ImGui_ImplQt_FontBuildJob& job) {
+        ImGui_ImplQt_FontBuildSrc& src_tmp = src_tmp_array[job.Src];
+        const ImFontConfig& cfg = atlas->ConfigData[job.Src];
+        size_t job_bitmap_texels = 0;
+        for (int glyph_i = job.Begin; glyph_i < job.End; glyph_i++)
+        {
+            int x0, y0, x1, y1;
+            const int glyph_index_in_font = stbtt_FindGlyphIndex(&src_tmp.FontInfo, src_tmp.GlyphsList[glyph_i]);
+            IM_ASSERT(glyph_index_in_font != 0);
+            stbtt_GetGlyphBitmapBoxSubpixel(&src_tmp.FontInfo, glyph_index_in_font, src_tmp.Scale * cfg.OversampleH, src_tmp.Scale * cfg.OversampleV, 0, 0, &x0, &y0, &x1, &y1);
+            src_tmp.Rects[glyph_i].w = (stbrp_coord)(x1 - x0 + padding + cfg.OversampleH - 1);
+            src_tmp.Rects[glyph_i].h = (stbrp_coord)(y1 - y0 + padding + cfg.OversampleV - 1);
+            if (!sdf)
+                continue;
+            //同时记下位图方式需要的面积,用于比较
+            job_bitmap_texels += (size_t)src_tmp.Rects[glyph_i].w * src_tmp.Rects[glyph_i].h;
+            stbtt_GetGlyphBitmapBoxSubpixel(&src_tmp.FontInfo, glyph_index_in_font, src_tmp.Scale, src_tmp.Scale, 0, 0, &x0, &y0, &x1, &y1);
+            const int spread = (x1 > x0 && y1 > y0) ? ImGui_ImplQt_FontSdfSpread : 0;
+            src_tmp.Rects[glyph_i].w = (stbrp_coord)(x1 - x0 + spread * 2 + padding);
+            src_tmp.Rects[glyph_i].h = (stbrp_coord)(y1 - y0 + spread * 2 + padding);
+        }
+        bitmap_texels += job_bitmap_texels;
+    });
+    int total_surface = 0;
+    for (const stbrp_rect& r : buf_rects)
+        total_surface += r.w * r.h;
+
+    const int surface_sqrt = (int)ImSqrt((float)total_surface) + 1;
+    atlas->TexHeight = 0;
+    if (atlas->TexDesiredWidth > 0)
+        atlas->TexWidth = atlas->TexDesiredWidth;
+    else
+        atlas->TexWidth = (surface_sqrt >= 4096 * 0.7f) ? 4096 : (surface_sqrt >= 2048 * 0.7f) ? 2048 : (surface_sqrt >= 1024 * 0.7f) ? 1024 : 512;
+
+    // 5. Start packing
+    const int TEX_HEIGHT_MAX = 1024 * 32;
+    stbtt_pack_context spc = {};
+    stbtt_PackBegin(&spc, NULL, atlas->TexWidth, TEX_HEIGHT_MAX, 0, atlas->TexGlyphPadding, NULL);
+    ImFontAtlasBuildPackCustomRects(atlas, spc.pack_info);
+
+    // 6. Pack each source font
+    for (int src_i = 0; src_i < src_tmp_array.Size; src_i++)
+    {
+        ImGui_ImplQt_FontBuildSrc& src_tmp = src_tmp_array[src_i];
+        if (src_tmp.GlyphsCount == 0)
+            continue;
+
+        stbrp_pack_rects((stbrp_context*)spc.pack_info, src_tmp.Rects, src_tmp.GlyphsCount);
+        for (int glyph_i = 0; glyph_i < src_tmp.GlyphsCount; glyph_i++)
+            if (src_tmp.Rects[glyph_i].was_packed)
+                atlas->TexHeight = ImMax(atlas->TexHeight, src_tmp.Rects[glyph_i].y + src_tmp.Rects[glyph_i].h);
+    }
+
+    // 7. Allocate texture
+    atlas->TexHeight = (atlas->Flags & ImFontAtlasFlags_NoPowerOfTwoHeight) ? (atlas->TexHeight + 1) : ImUpperPowerOfTwo(atlas->TexHeight);
+    atlas->TexUvScale = ImVec2(1.0f / atlas->TexWidth, 1.0f / atlas->TexHeight);
+    atlas->TexPixelsAlpha8 = (unsigned char*)IM_ALLOC(atlas->TexWidth * atlas->TexHeight);
+    memset(atlas->TexPixelsAlpha8, 0, atlas->TexWidth * atlas->TexHeight);
+    spc.pixels = atlas->TexPixelsAlpha8;
+    spc.height = atlas->TexHeight;
+
+    // 8. Rasterize, every job renders its slice of glyphs into their own rects of the atlas
+    ImGui_ImplQt_FontBuildRun(thread_count, jobs, [&](const ImGui_ImplQt_FontBuildJob& job) {
+        if (sdf)
+        {
+            ImGui_ImplQt_FontBuildSdf(atlas, src_tmp_array[job.Src], job);
+            return;
+        }
+        ImGui_ImplQt_FontBuildSrc& src_tmp = src_tmp_array[job.Src];
+        const ImFontConfig& cfg = atlas->ConfigData[job.Src];
+        //stbtt_PackFontRangesRenderIntoRects会临时修改上下文中的过采样参数,每个任务使用副本
+        stbtt_pack_context job_spc = spc;
+        stbtt_pack_range range = src_tmp.PackRange;
+        range.array_of_unicode_codepoints += job.Begin;
+        range.chardata_for_range += job.Begin;
+        range.num_chars = job.End - job.Begin;
+        stbtt_PackFontRangesRenderIntoRects(&job_spc, &src_tmp.FontInfo, &range, 1, src_tmp.Rects + job.Begin);
+
+        if (cfg.RasterizerMultiply != 1.0f)
+        {
+            unsigned char multiply_table[256];
+            ImFontAtlasBuildMultiplyCalcLookupTable(multiply_table, cfg.RasterizerMultiply);
+            for (int glyph_i = job.Begin; glyph_i < job.End; glyph_i++)
+            {
+                const stbrp_rect* r = &src_tmp.Rects[glyph_i];
+                if (r->was_packed)
+                    ImFontAtlasBuildMultiplyRectAlpha8(multiply_table, atlas->TexPixelsAlpha8, r->x, r->y, r->w, r->h, atlas->TexWidth * 1);
+            }
+        }
+    });
+    for (ImGui_ImplQt_FontBuildSrc& src_tmp : src_tmp_array)
+        src_tmp.Rects = NULL;
+
+    stbtt_PackEnd(&spc);
+    buf_rects.clear();
+
+    // 9. Setup ImFont and glyphs for runtime
+    for (int src_i = 0; src_i < src_tmp_array.Size; src_i++)
+    {
+        ImGui_ImplQt_FontBuildSrc& src_tmp = src_tmp_array[src_i];
+        ImFontConfig& cfg = atlas->ConfigData[src_i];
+        ImFont* dst_font = cfg.DstFont;
+
+        const float font_scale = stbtt_ScaleForPixelHeight(&src_tmp.FontInfo, cfg.SizePixels);
+        int unscaled_ascent, unscaled_descent, unscaled_line_gap;
+        stbtt_GetFontVMetrics(&src_tmp.FontInfo, &unscaled_ascent, &unscaled_descent, &unscaled_line_gap);
+
+        const float ascent = ImFloor(unscaled_ascent * font_scale + ((unscaled_ascent > 0.0f) ? +1 : -1));
+        const float descent = ImFloor(unscaled_descent * font_scale + ((unscaled_descent > 0.0f) ? +1 : -1));
+        ImFontAtlasBuildSetupFont(atlas, dst_font, &cfg, ascent, descent);
+        const float font_off_x = cfg.GlyphOffset.x;
+        const float font_off_y = cfg.GlyphOffset.y + IM_ROUND(dst_font->Ascent);
+
+        for (int glyph_i = 0; glyph_i < src_tmp.GlyphsCount; glyph_i++)
+        {
+            const int codepoint = src_tmp.GlyphsList[glyph_i];
+            const stbtt_packedchar& pc = src_tmp.PackedChars[glyph_i];
+            stbtt_aligned_quad q;
+            float unused_x = 0.0f, unused_y = 0.0f;
+            stbtt_GetPackedQuad(src_tmp.PackedChars, atlas->TexWidth, atlas->TexHeight, glyph_i, &unused_x, &unused_y, &q, 0);
+            dst_font->AddGlyph(&cfg, (ImWchar)codepoint, q.x0 + font_off_x, q.y0 + font_off_y, q.x1 + font_off_x, q.y1 + font_off_y, q.s0, q.t0, q.s1, q.t1, pc.xadvance);
+        }
+    }
+
+    src_tmp_array.clear_destruct();
+
+    ImFontAtlasBuildFinish(atlas);
+
+    if (sdf)
+    {
+        size_t sdf_texels = 0;
+        for (const stbtt_packedchar& pc : buf_packedchars)
+            sdf_texels += (size_t)(pc.x1 - pc.x0 + padding) * (pc.y1 - pc.y0 + padding);
+        QMutexLocker lock(&ImGui_ImplQt_FontSdfMutex);
+        ImGui_ImplQt_FontAtlasSdfStats& stats = ImGui_ImplQt_FontSdfStats;
+        stats.Builds++;
+        stats.LastBuildMs = (float)sdf_timer.nsecsElapsed() / 1000000.0f;
+        stats.Glyphs = total_glyphs_count;
+        stats.GlyphTexels = sdf_texels;
+        stats.BitmapGlyphTexels = bitmap_texels.load();
+        stats.TextureBytes = (size_t)atlas->TexWidth * atlas->TexHeight * 4;
+    }
+    return true;
+}
+
+static const ImFontBuilderIO ImGui_ImplQt_ParallelFontBuilder = { ImGui_ImplQt_FontBuildParallel };
+
+const ImFontBuilderIO* ImGui_ImplQt_GetParallelFontBuilderIO()
+{
+    return &ImGui_ImplQt_ParallelFontBuilder;
+}
+
+void ImGui_ImplQt_SetParallelFontBuild(ImFontAtlas* atlas, int thread_count)
+{
+    IM_ASSERT(atlas != nullptr);
+    //线程数保存在图集自己的标志里,各图集互不影响
+    atlas->FontBuilderFlags &= ~(unsigned int)ImGui_ImplQt_FontBuilderFlags_ThreadsMask;
+    atlas->FontBuilderFlags |= (unsigned int)ImClamp(thread_count, 0, 255) << ImGui_ImplQt_FontBuilderFlags_ThreadsShift;
+    //距离场只有并行构建器支持,单线程时也保留它
+    const bool sdf = (atlas->FontBuilderFlags & ImGui_ImplQt_FontBuilderFlags_Sdf) != 0;
+    atlas->FontBuilderIO = (thread_count == 1 && !sdf) ? nullptr : &ImGui_ImplQt_ParallelFontBuilder;
+}
+
+void ImGui_ImplQt_SetFontAtlasSdf(ImFontAtlas* atlas, bool enable)
+{
+    IM_ASSERT(atlas != nullptr);
+    IM_ASSERT(!atlas->IsBuilt() && "Call before the atlas is built, or ClearTexData() first.");
+    if (enable)
+    {
+        atlas->FontBuilderFlags |= ImGui_ImplQt_FontBuilderFlags_Sdf;
+        atlas->Flags |= ImFontAtlasFlags_NoBakedLines;
+        atlas->FontBuilderIO = &ImGui_ImplQt_ParallelFontBuilder;
+    }
+    else
+        atlas->FontBuilderFlags &= ~(unsigned int)ImGui_ImplQt_FontBuilderFlags_Sdf;
+}
+
+bool ImGui_ImplQt_IsFontAtlasSdf(const ImFontAtlas* atlas)
+{
+    return atlas && atlas->FontBuilderIO == &ImGui_ImplQt_ParallelFontBuilder && (atlas->FontBuilderFlags & ImGui_ImplQt_FontBuilderFlags_Sdf) != 0;
+}
+
+void ImGui_ImplQt_GetFontAtlasSdfStats(ImGui_ImplQt_FontAtlasSdfStats* stats)
+{
+    QMutexLocker lock(&ImGui_ImplQt_FontSdfMutex);
+    *stats = ImGui_ImplQt_FontSdfStats;
+}
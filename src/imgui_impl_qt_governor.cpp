@@ -0,0 +1,118 @@
+﻿#include "imgui_impl_qt_governor.h"
+#include "imgui_impl_qt_latency.h"
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+
+static QHash<ImGuiContext*, ImGui_ImplQt_QualityGovernor*> ImGui_ImplQt_Governors;
+static QMutex ImGui_ImplQt_GovernorsMutex;
+
+ImGui_ImplQt_QualityGovernor* ImGui_ImplQt_QualityGovernor::Find(ImGuiContext* context)
+{
+    QMutexLocker lock(&ImGui_ImplQt_GovernorsMutex);
+    return ImGui_ImplQt_Governors.value(context, nullptr);
+}
+
+void ImGui_ImplQt_QualityGovernor::Attach(ImGuiContext* context)
+{
+    Context = context;
+    QMutexLocker lock(&ImGui_ImplQt_GovernorsMutex);
+    ImGui_ImplQt_Governors.insert(context, this);
+}
+
+void ImGui_ImplQt_QualityGovernor::Detach(ImGuiStyle& style)
+{
+    //先把样式恢复成应用程序的设置,上下文可能在关闭后继续使用
+    Disable(style);
+    QMutexLocker lock(&ImGui_ImplQt_GovernorsMutex);
+    if (Context && ImGui_ImplQt_Governors.value(Context, nullptr) == this)
+        ImGui_ImplQt_Governors.remove(Context);
+    Context = nullptr;
+}
+
+void ImGui_ImplQt_QualityGovernor::NewFrame(ImGuiStyle& style)
+{
+    const qint64 now = ImGui_ImplQt_LatencyTracker::Now();
+    //没有渲染器报告时(未调用RenderDrawData)跳过这一帧
+    if (Enabled && FrameStartNs >= 0 && FrameEndNs > FrameStartNs)
+    {
+        const float frame_ms = (float)(FrameEndNs - FrameStartNs) / 1000000.0f;
+        Stats.FrameMs = Stats.FrameMs == 0.0f ? frame_ms : Stats.FrameMs * 0.9f + frame_ms * 0.1f;
+        if (Stats.FrameMs > Stats.BudgetMs) {
+            OverFrames++;
+            UnderFrames = 0;
+        }
+        else if (Stats.FrameMs < Stats.BudgetMs * Headroom) {
+            UnderFrames++;
+            OverFrames = 0;
+        }
+        else {
+            OverFrames = UnderFrames = 0;
+        }
+
+        //降级快、升级慢,两个阈值之间不动作,避免在预算附近来回切换
+        if (OverFrames >= DownFrames && Stats.Level + 1 < ImGui_ImplQt_QualityLevel_COUNT)
+            SetLevel(Stats.Level + 1, style);
+        else if (UnderFrames >= UpFrames && Stats.Level > ImGui_ImplQt_QualityLevel_Full)
+            SetLevel(Stats.Level - 1, style);
+    }
+    FrameStartNs = now;
+    FrameEndNs = -1;
+}
+
+void ImGui_ImplQt_QualityGovernor::FrameRendered()
+{
+    if (FrameStartNs >= 0)
+        FrameEndNs = ImGui_ImplQt_LatencyTracker::Now();
+}
+
+bool ImGui_ImplQt_QualityGovernor::SkipPaint(bool active)
+{
+    //只限制本上下文,其它上下文的窗口按各自的调控器绘制
+    if (active || Stats.Level < ImGui_ImplQt_QualityLevel_ThrottleUnfocused) {
+        PaintCounter = 0;
+        return false;
+    }
+    if (++PaintCounter % UnfocusedInterval == 0)
+        return false;
+    Stats.PaintsSkipped++;
+    return true;
+}
+
+void ImGui_ImplQt_QualityGovernor::Disable(ImGuiStyle& style)
+{
+    Enabled = false;
+    SetLevel(ImGui_ImplQt_QualityLevel_Full, style);
+    OverFrames = UnderFrames = 0;
+    Stats.FrameMs = 0.0f;
+}
+
+void ImGui_ImplQt_QualityGovernor::SetLevel(int level, ImGuiStyle& style)
+{
+    const int last_level = Stats.Level;
+    if (level == last_level)
+        return;
+    if (last_level == ImGui_ImplQt_QualityLevel_Full)
+    {
+        BaseAntiAliasedLines = style.AntiAliasedLines;
+        BaseAntiAliasedFill = style.AntiAliasedFill;
+        BaseCurveTessellationTol = style.CurveTessellationTol;
+        BaseCircleTessellationMaxError = style.CircleTessellationMaxError;
+    }
+    //ImGui::NewFrame()会按样式重新设置曲线与圆的细分
+    const float tessellation_scale = level >= ImGui_ImplQt_QualityLevel_CoarseCurves ? 2.0f : 1.0f;
+    style.CurveTessellationTol = BaseCurveTessellationTol * tessellation_scale;
+    style.CircleTessellationMaxError = BaseCircleTessellationMaxError * tessellation_scale;
+    style.AntiAliasedFill = BaseAntiAliasedFill && level < ImGui_ImplQt_QualityLevel_NoAntiAliasedFill;
+    style.AntiAliasedLines = BaseAntiAliasedLines && level < ImGui_ImplQt_QualityLevel_NoAntiAliasedLines;
+
+    Stats.Level = level;
+    if (level > last_level)
+        Stats.StepsDown++;
+    else
+        Stats.StepsUp++;
+    if (Callback)
+        Callback(last_level, level, Stats.FrameMs, UserData);
+    //切换后的平均值从新级别的第一帧重新开始,旧级别的耗时不再推动下一次切换
+    OverFrames = UnderFrames = 0;
+    Stats.FrameMs = 0.0f;
+}
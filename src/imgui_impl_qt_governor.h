@@ -0,0 +1,45 @@
+#pragma once
+
+#include <QtCore/QtGlobal>
+
+#include "imgui.h"
+#include "imgui_impl_qt.h"
+
+// Quality governor of one ImGui context. The platform backend measures from NewFrame(), the renderers report the end
+// of RenderDrawData() and the OpenGL renderer reads the multisample setting, both find it through the ImGui context.
+class ImGui_ImplQt_QualityGovernor
+{
+public:
+    enum { DownFrames = 10, UpFrames = 120, UnfocusedInterval = 4 };
+
+    static ImGui_ImplQt_QualityGovernor* Find(ImGuiContext* context);
+
+    void Attach(ImGuiContext* context);
+    void Detach(ImGuiStyle& style);         // Restores the style of ImGui_ImplQt_QualityLevel_Full first
+    void NewFrame(ImGuiStyle& style);       // Measures the last frame, applies the level before ImGui::NewFrame()
+    void FrameRendered();
+    bool SkipPaint(bool active);            // Throttling of unfocused surfaces
+    bool Multisample() const { return Stats.Level < ImGui_ImplQt_QualityLevel_NoMultisample; }
+    void Disable(ImGuiStyle& style);
+public:
+    bool  Enabled{};
+    float Headroom{ 0.7f };
+    ImGui_ImplQt_QualityCallback Callback{};
+    void* UserData{};
+    ImGui_ImplQt_QualityStats Stats{ 0, 0.0f, 1000.0f / 60.0f, 0, 0, 0 };
+private:
+    void SetLevel(int level, ImGuiStyle& style);
+private:
+    ImGuiContext* Context{};
+    qint64 FrameStartNs{ -1 };
+    qint64 FrameEndNs{ -1 };
+    int    OverFrames{};
+    int    UnderFrames{};
+    int    PaintCounter{};
+
+    // Style of the application at ImGui_ImplQt_QualityLevel_Full
+    bool   BaseAntiAliasedLines{};
+    bool   BaseAntiAliasedFill{};
+    float  BaseCurveTessellationTol{};
+    float  BaseCircleTessellationMaxError{};
+};
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <string.h>
+#include "imgui.h"
+
+// Fast 64-bit content hash for change detection of vertex/index/command buffers.
+// Not a cryptographic hash. The SSE2 and scalar paths produce identical values.
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define IMGUI_IMPL_QT_HASH_SSE2
+#endif
+
+namespace ImGui_ImplQt_HashDetail
+{
+    static const ImU64 Keys[8] = {
+        0xbe4ba423396cfeb8ULL, 0x1cad21f72c81017cULL, 0xdb979083e96dd4deULL, 0x1f67b3b7a4a44072ULL,
+        0x78e5c0cc4ee679cbULL, 0x2172ffcc7dd05a82ULL, 0x8e2443f7744608b8ULL, 0x4c263a81e69035e0ULL,
+    };
+
+    static inline ImU64 Avalanche(ImU64 h)
+    {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    // acc[i] += data[i ^ 1] + lo32(data[i] ^ key[i]) * hi32(data[i] ^ key[i])
+    static inline void Accumulate(ImU64 acc[8], const unsigned char* block)
+    {
+        ImU64 data[8];
+        memcpy(data, block, sizeof(data));
+        for (int i = 0; i < 8; i++)
+        {
+            const ImU64 data_key = data[i] ^ Keys[i];
+            acc[i] += data[i ^ 1] + (data_key & 0xFFFFFFFFULL) * (data_key >> 32);
+        }
+    }
+}
+
+static inline ImU64 ImGui_ImplQt_HashData(const void* data, size_t size, ImU64 seed = 0)
+{
+    using namespace ImGui_ImplQt_HashDetail;
+    const unsigned char* p = (const unsigned char*)data;
+    ImU64 acc[8];
+    for (int i = 0; i < 8; i++)
+        acc[i] = seed + Keys[(i + 3) & 7];
+
+    size_t blocks = size / 64;
+#ifdef IMGUI_IMPL_QT_HASH_SSE2
+    if (blocks > 0)
+    {
+        __m128i vacc[4], vkey[4];
+        for (int i = 0; i < 4; i++)
+        {
+            vacc[i] = _mm_loadu_si128((const __m128i*)(acc + i * 2));
+            vkey[i] = _mm_loadu_si128((const __m128i*)(Keys + i * 2));
+        }
+        for (; blocks > 0; blocks--, p += 64)
+        {
+            for (int i = 0; i < 4; i++)
+            {
+                const __m128i data_vec = _mm_loadu_si128((const __m128i*)(p + i * 16));
+                const __m128i data_key = _mm_xor_si128(data_vec, vkey[i]);
+                const __m128i data_key_hi = _mm_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1));
+                const __m128i product = _mm_mul_epu32(data_key, data_key_hi);
+                const __m128i data_swap = _mm_shuffle_epi32(data_vec, _MM_SHUFFLE(1, 0, 3, 2));
+                vacc[i] = _mm_add_epi64(vacc[i], _mm_add_epi64(data_swap, product));
+            }
+        }
+        for (int i = 0; i < 4; i++)
+            _mm_storeu_si128((__m128i*)(acc + i * 2), vacc[i]);
+    }
+#endif
+    for (; blocks > 0; blocks--, p += 64)
+        Accumulate(acc, p);
+
+    const size_t tail = size & 63;
+    if (tail)
+    {
+        unsigned char block[64] = {};
+        memcpy(block, p, tail);
+        Accumulate(acc, block);
+    }
+
+    ImU64 h = seed + (ImU64)size * 0x9e3779b185ebca87ULL;
+    for (int i = 0; i < 8; i++)
+        h = (h ^ Avalanche(acc[i])) * 0x9e3779b185ebca87ULL;
+    return Avalanche(h);
+}
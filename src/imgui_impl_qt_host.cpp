@@ -0,0 +1,253 @@
+﻿#include "imgui_impl_qt_host.h"
+#include "imgui_impl_qt.h"
+#include "imgui_impl_qt_opengl3.h"
+#include "imgui_impl_qt_latency.h"
+#include <QtCore/QHash>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QEvent>
+#include <QtCore/QTimer>
+#include <QtGui/QOpenGLContext>
+#include <QtGui/QOpenGLFunctions>
+#include <QtGui/QOpenGLWindow>
+#include <QtWidgets/QOpenGLWidget>
+#include <QtWidgets/QWidget>
+
+// State shared by both hosts, owned by the QOpenGLWidget or QOpenGLWindow
+struct ImGui_ImplQt_HostCore
+{
+    ImGui_ImplQt_HostCore(ImGui_ImplQt_HostCallback init, ImGui_ImplQt_HostCallback frame, void* user_data);
+    ~ImGui_ImplQt_HostCore();
+
+    template<typename T>
+    void Initialize(T* target);
+    void Paint();
+    void Swapped();
+    void SetInterval(int interval_ms);
+    static bool IsInput(QEvent* event);
+
+    QWidget*      Key{};                    //注册表中的宿主控件
+    ImGui_ImplQt_HostCallback InitCallback{};
+    ImGui_ImplQt_HostCallback FrameCallback{};
+    void*         UserData{};
+    ImGuiContext* Context{};
+    QTimer        Timer;                    //按固定间隔重绘,输入事件另外立即请求重绘
+    QElapsedTimer Clock;
+    qint64        LastSwapNs{ -1 };
+    ImGui_ImplQt_HostStats Stats{};
+};
+
+static QHash<QWidget*, ImGui_ImplQt_HostCore*> ImGui_ImplQt_Hosts;
+
+ImGui_ImplQt_HostCore::ImGui_ImplQt_HostCore(ImGui_ImplQt_HostCallback init, ImGui_ImplQt_HostCallback frame, void* user_data)
+    :InitCallback(init), FrameCallback(frame), UserData(user_data)
+{
+    Clock.start();
+}
+
+ImGui_ImplQt_HostCore::~ImGui_ImplQt_HostCore()
+{
+    if (Key)
+        ImGui_ImplQt_Hosts.remove(Key);
+    if (!Context)
+        return;
+    //渲染器在关闭时会自行切换到它的GL上下文
+    ImGuiContext* last_context = ImGui::GetCurrentContext();
+    ImGui::SetCurrentContext(Context);
+    ImGui_ImplQtOpenGL3_Shutdown();
+    ImGui_ImplQt_Shutdown();
+    ImGui::DestroyContext(Context);
+    ImGui::SetCurrentContext(last_context != Context ? last_context : nullptr);
+}
+
+template<typename T>
+void ImGui_ImplQt_HostCore::Initialize(T* target)
+{
+    //重新创建GL上下文时(改变顶层窗口)会再次调用,渲染器在下一帧自行恢复
+    if (Context)
+        return;
+    Context = ImGui::CreateContext();
+    ImGui::SetCurrentContext(Context);
+    ImGui_ImplQt_Init(target);
+    ImGui_ImplQtOpenGL3_Init(nullptr);
+    if (InitCallback)
+        InitCallback(UserData);
+}
+
+void ImGui_ImplQt_HostCore::Paint()
+{
+    const qint64 start = Clock.nsecsElapsed();
+
+    ImGui::SetCurrentContext(Context);
+    ImGui_ImplQtOpenGL3_NewFrame();
+    ImGui_ImplQt_NewFrame();
+    ImGui::NewFrame();
+    if (FrameCallback)
+        FrameCallback(UserData);
+    ImGui::Render();
+
+    //局部重绘时渲染器只清除变化的区域,保留下来的内容不能整体清掉
+    if (!ImGui_ImplQtOpenGL3_GetPartialRedraw())
+    {
+        QOpenGLFunctions* gl = QOpenGLContext::currentContext()->functions();
+        gl->glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+        gl->glClear(GL_COLOR_BUFFER_BIT);
+    }
+    ImGui_ImplQtOpenGL3_RenderDrawData(ImGui::GetDrawData());
+
+    const float paint_ms = (float)(Clock.nsecsElapsed() - start) / 1000000.0f;
+    Stats.PaintMs = Stats.Frames == 0 ? paint_ms : Stats.PaintMs * 0.95f + paint_ms * 0.05f;
+}
+
+void ImGui_ImplQt_HostCore::Swapped()
+{
+    const qint64 now = Clock.nsecsElapsed();
+    if (LastSwapNs >= 0)
+    {
+        const float interval = (float)(now - LastSwapNs) / 1000000.0f;
+        Stats.FrameIntervalMs = Stats.Frames <= 1 ? interval : Stats.FrameIntervalMs * 0.95f + interval * 0.05f;
+    }
+    LastSwapNs = now;
+    Stats.Frames++;
+}
+
+void ImGui_ImplQt_HostCore::SetInterval(int interval_ms)
+{
+    if (interval_ms > 0)
+        Timer.start(interval_ms);
+    else
+        Timer.stop();
+}
+
+bool ImGui_ImplQt_HostCore::IsInput(QEvent* event)
+{
+    switch (event->type())
+    {
+    case QEvent::MouseMove:
+    case QEvent::MouseButtonPress:
+    case QEvent::MouseButtonRelease:
+    case QEvent::MouseButtonDblClick:
+    case QEvent::Wheel:
+    case QEvent::KeyPress:
+    case QEvent::KeyRelease:
+    case QEvent::InputMethod:
+    case QEvent::FocusIn:
+    case QEvent::FocusOut:
+    case QEvent::Enter:
+    case QEvent::Leave:
+        return true;
+    default:
+        return false;
+    }
+}
+
+namespace
+{
+    class ImGui_ImplQt_WidgetHost :public QOpenGLWidget
+    {
+    public:
+        ImGui_ImplQt_WidgetHost(ImGui_ImplQt_HostCallback init, ImGui_ImplQt_HostCallback frame, void* user_data, QWidget* parent)
+            :QOpenGLWidget(parent), Core(init, frame, user_data)
+        {
+            setFocusPolicy(Qt::StrongFocus);
+            setMouseTracking(true);
+            QObject::connect(this, &QOpenGLWidget::frameSwapped, this, [this]() { Core.Swapped(); });
+            QObject::connect(&Core.Timer, &QTimer::timeout, this, [this]() { update(); });
+            Core.SetInterval(16);
+        }
+        ~ImGui_ImplQt_WidgetHost()
+        {
+            makeCurrent();
+        }
+    protected:
+        void initializeGL() override { Core.Initialize(this); }
+        void paintGL() override { Core.Paint(); }
+        bool event(QEvent* event) override {
+            const bool result = QOpenGLWidget::event(event);
+            if (ImGui_ImplQt_HostCore::IsInput(event))
+                update();
+            return result;
+        }
+    public:
+        ImGui_ImplQt_HostCore Core;
+    };
+
+    //原生子窗口,直接绘制到自己的后台缓冲区,不经过顶层窗口的合成
+    class ImGui_ImplQt_WindowHost :public QOpenGLWindow
+    {
+    public:
+        ImGui_ImplQt_WindowHost(ImGui_ImplQt_HostCallback init, ImGui_ImplQt_HostCallback frame, void* user_data)
+            :Core(init, frame, user_data)
+        {
+            QObject::connect(this, &QOpenGLWindow::frameSwapped, this, [this]() { Core.Swapped(); });
+            QObject::connect(&Core.Timer, &QTimer::timeout, this, [this]() { update(); });
+            Core.SetInterval(16);
+        }
+        ~ImGui_ImplQt_WindowHost()
+        {
+            makeCurrent();
+        }
+    protected:
+        void initializeGL() override { Core.Initialize(this); }
+        void paintGL() override { Core.Paint(); }
+        bool event(QEvent* event) override {
+            //点击子窗口时容器不会自动转交键盘焦点
+            if (event->type() == QEvent::MouseButtonPress && !isActive())
+                requestActivate();
+            const bool result = QOpenGLWindow::event(event);
+            if (ImGui_ImplQt_HostCore::IsInput(event))
+                update();
+            return result;
+        }
+    public:
+        ImGui_ImplQt_HostCore Core;
+    };
+}
+
+QWidget* ImGui_ImplQt_CreateHost(ImGui_ImplQt_HostType type, ImGui_ImplQt_HostCallback init, ImGui_ImplQt_HostCallback frame, void* user_data, QWidget* parent)
+{
+    if (type == ImGui_ImplQt_HostType_OpenGLWindow)
+    {
+        //容器拥有窗口,负责调整大小并把键盘焦点转交给窗口
+        ImGui_ImplQt_WindowHost* window = new ImGui_ImplQt_WindowHost(init, frame, user_data);
+        QWidget* container = QWidget::createWindowContainer(window, parent);
+        container->setFocusPolicy(Qt::StrongFocus);
+        container->setMinimumSize(64, 64);
+        window->Core.Key = container;
+        ImGui_ImplQt_Hosts.insert(container, &window->Core);
+        return container;
+    }
+    ImGui_ImplQt_WidgetHost* widget = new ImGui_ImplQt_WidgetHost(init, frame, user_data, parent);
+    widget->Core.Key = widget;
+    ImGui_ImplQt_Hosts.insert(widget, &widget->Core);
+    return widget;
+}
+
+ImGuiContext* ImGui_ImplQt_GetHostContext(QWidget* host)
+{
+    ImGui_ImplQt_HostCore* core = ImGui_ImplQt_Hosts.value(host, nullptr);
+    return core ? core->Context : nullptr;
+}
+
+void ImGui_ImplQt_SetHostFrameInterval(QWidget* host, int interval_ms)
+{
+    ImGui_ImplQt_HostCore* core = ImGui_ImplQt_Hosts.value(host, nullptr);
+    if (core)
+        core->SetInterval(interval_ms);
+}
+
+bool ImGui_ImplQt_GetHostStats(QWidget* host, ImGui_ImplQt_HostStats* stats)
+{
+    ImGui_ImplQt_HostCore* core = ImGui_ImplQt_Hosts.value(host, nullptr);
+    if (!core)
+        return false;
+    *stats = core->Stats;
+    //输入延迟由平台后端统计,包含GPU栅栏
+    if (ImGui_ImplQt_LatencyTracker* latency = ImGui_ImplQt_LatencyTracker::Find(core->Context))
+    {
+        ImGui_ImplQt_LatencyStats latency_stats;
+        latency->GetStats(&latency_stats);
+        stats->InputLatencyMs = latency_stats.LastMs;
+        stats->InputLatencyAverageMs = latency_stats.AverageMs;
+    }
+    return true;
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include "imgui.h"
+
+class QWidget;
+
+// Hosts: a widget running its own ImGui context, repainted by a timer and right away on input
+enum ImGui_ImplQt_HostType
+{
+    ImGui_ImplQt_HostType_OpenGLWidget,     // Rendered into an FBO Qt composites, one more copy and frame of latency
+    ImGui_ImplQt_HostType_OpenGLWindow,     // Native child window in a container, drawn above sibling widgets
+};
+
+struct ImGui_ImplQt_HostStats
+{
+    int   Frames;
+    float FrameIntervalMs;          // Between two swaps, averaged
+    float PaintMs;                  // CPU time from NewFrame() to RenderDrawData(), averaged
+    float InputLatencyMs;           // From an input event to the display of the first frame that processed it,
+    float InputLatencyAverageMs;    // see ImGui_ImplQt_GetLatencyStats() for percentiles
+};
+
+typedef void (*ImGui_ImplQt_HostCallback)(void* user_data);    // init: once with the context current, frame: between ImGui::NewFrame() and ImGui::Render()
+IMGUI_IMPL_API QWidget* ImGui_ImplQt_CreateHost(ImGui_ImplQt_HostType type, ImGui_ImplQt_HostCallback init, ImGui_ImplQt_HostCallback frame, void* user_data, QWidget* parent = nullptr);
+IMGUI_IMPL_API ImGuiContext* ImGui_ImplQt_GetHostContext(QWidget* host);
+IMGUI_IMPL_API void ImGui_ImplQt_SetHostFrameInterval(QWidget* host, int interval_ms);     // 0 repaints on input only
+IMGUI_IMPL_API bool ImGui_ImplQt_GetHostStats(QWidget* host, ImGui_ImplQt_HostStats* stats);
@@ -0,0 +1,133 @@
+﻿#include "imgui_impl_qt_input.h"
+#include "imgui_impl_qt_latency.h"
+#include "imgui_internal.h"
+
+ImGui_ImplQt_InputQueue::ImGui_ImplQt_InputQueue()
+{
+    for (unsigned int i = 0; i < Capacity; i++)
+        Cells[i].Sequence.store(i, std::memory_order_relaxed);
+}
+
+bool ImGui_ImplQt_InputQueue::Push(const ImGui_ImplQt_InputRecord& record)
+{
+    unsigned int pos = EnqueuePos.load(std::memory_order_relaxed);
+    Cell* cell;
+    for (;;)
+    {
+        cell = &Cells[pos & (Capacity - 1)];
+        const unsigned int sequence = cell->Sequence.load(std::memory_order_acquire);
+        const int diff = (int)(sequence - pos);
+        //序号等于位置说明该单元空闲,抢到位置后独占写入
+        if (diff == 0)
+        {
+            if (EnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (diff < 0)
+        {
+            Dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        else
+        {
+            pos = EnqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+    cell->Record = record;
+    cell->Sequence.store(pos + 1, std::memory_order_release);
+    Queued.fetch_add(1, std::memory_order_relaxed);
+
+    //队列从空闲变为有数据时唤醒GUI线程一次,之后的记录随同一帧处理
+    if (Wake && !WakePending.exchange(true, std::memory_order_acq_rel))
+        Wake(WakeUserData);
+    return true;
+}
+
+bool ImGui_ImplQt_InputQueue::Pop(ImGui_ImplQt_InputRecord* record)
+{
+    Cell& cell = Cells[DequeuePos & (Capacity - 1)];
+    const unsigned int sequence = cell.Sequence.load(std::memory_order_acquire);
+    //生产者已占位但还没发布时停在这里,剩下的留到下一帧
+    if ((int)(sequence - (DequeuePos + 1)) < 0)
+        return false;
+    *record = cell.Record;
+    cell.Sequence.store(DequeuePos + Capacity, std::memory_order_release);
+    DequeuePos++;
+    return true;
+}
+
+int ImGui_ImplQt_InputQueue::Drain(ImGuiIO& io, qint64* first_timestamp_ns)
+{
+    //先清除唤醒标记,之后到达的记录会再请求一次重绘
+    WakePending.store(false, std::memory_order_release);
+    int count = 0;
+    ImGui_ImplQt_InputRecord record;
+    while (Pop(&record))
+    {
+        if (count == 0 && first_timestamp_ns)
+            *first_timestamp_ns = record.TimestampNs;
+        switch (record.Type)
+        {
+        case ImGui_ImplQt_InputRecord::MousePos:    io.AddMousePosEvent(record.X, record.Y); break;
+        case ImGui_ImplQt_InputRecord::MouseButton: io.AddMouseButtonEvent(record.Code, record.Down); break;
+        case ImGui_ImplQt_InputRecord::MouseWheel:  io.AddMouseWheelEvent(record.X, record.Y); break;
+        case ImGui_ImplQt_InputRecord::Key:         io.AddKeyEvent((ImGuiKey)record.Code, record.Down); break;
+        case ImGui_ImplQt_InputRecord::Char:        io.AddInputCharacter((unsigned int)record.Code); break;
+        case ImGui_ImplQt_InputRecord::Focus:       io.AddFocusEvent(record.Down); break;
+        default: break;
+        }
+        count++;
+    }
+    Drained += count;
+    LastBatch = count;
+    return count;
+}
+
+static bool ImGui_ImplQt_QueueInput(ImGui_ImplQt_InputQueue* queue, int type, int code, bool down, float x, float y)
+{
+    if (queue == nullptr)
+        return false;
+    ImGui_ImplQt_InputRecord record;
+    record.Type = type;
+    record.Code = code;
+    record.Down = down;
+    record.X = x;
+    record.Y = y;
+    record.TimestampNs = ImGui_ImplQt_LatencyTracker::Now();
+    return queue->Push(record);
+}
+
+bool ImGui_ImplQt_QueueMousePos(ImGui_ImplQt_InputQueue* queue, float x, float y)
+{
+    return ImGui_ImplQt_QueueInput(queue, ImGui_ImplQt_InputRecord::MousePos, 0, false, x, y);
+}
+
+bool ImGui_ImplQt_QueueMouseButton(ImGui_ImplQt_InputQueue* queue, int button, bool down)
+{
+    //Add*Event()只断言,在GUI线程才会触发;无效的记录在入队前拒绝
+    if (button < 0 || button >= ImGuiMouseButton_COUNT)
+        return false;
+    return ImGui_ImplQt_QueueInput(queue, ImGui_ImplQt_InputRecord::MouseButton, button, down, 0.0f, 0.0f);
+}
+
+bool ImGui_ImplQt_QueueMouseWheel(ImGui_ImplQt_InputQueue* queue, float wheel_x, float wheel_y)
+{
+    return ImGui_ImplQt_QueueInput(queue, ImGui_ImplQt_InputRecord::MouseWheel, 0, false, wheel_x, wheel_y);
+}
+
+bool ImGui_ImplQt_QueueKey(ImGui_ImplQt_InputQueue* queue, ImGuiKey key, bool down)
+{
+    if (!ImGui::IsNamedKeyOrModKey(key))
+        return false;
+    return ImGui_ImplQt_QueueInput(queue, ImGui_ImplQt_InputRecord::Key, (int)key, down, 0.0f, 0.0f);
+}
+
+bool ImGui_ImplQt_QueueChar(ImGui_ImplQt_InputQueue* queue, unsigned int c)
+{
+    return ImGui_ImplQt_QueueInput(queue, ImGui_ImplQt_InputRecord::Char, (int)c, false, 0.0f, 0.0f);
+}
+
+bool ImGui_ImplQt_QueueFocus(ImGui_ImplQt_InputQueue* queue, bool focused)
+{
+    return ImGui_ImplQt_QueueInput(queue, ImGui_ImplQt_InputRecord::Focus, 0, focused, 0.0f, 0.0f);
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <QtCore/QtGlobal>
+#include <atomic>
+
+#include "imgui.h"
+#include "imgui_impl_qt.h"
+
+// Input record translated by the producer, applied with the matching ImGuiIO::Add*Event() call
+struct ImGui_ImplQt_InputRecord
+{
+    enum Type { MousePos, MouseButton, MouseWheel, Key, Char, Focus };
+
+    int    Type;
+    int    Code;                // ImGuiMouseButton, ImGuiKey or character
+    bool   Down;
+    float  X;                   // Position or wheel
+    float  Y;
+    qint64 TimestampNs;         // ImGui_ImplQt_LatencyTracker::Now() at injection
+};
+
+// Bounded multi-producer single-consumer queue (sequence numbered cells). Producers on any thread reserve a cell with one
+// compare-and-swap and publish it with a release store, they never wait for each other or for the GUI thread. A full
+// queue rejects the record. The GUI thread drains it in ImGui_ImplQt_NewFrame().
+struct ImGui_ImplQt_InputQueue
+{
+    enum { Capacity = 4096 };
+
+    ImGui_ImplQt_InputQueue();
+
+    bool Push(const ImGui_ImplQt_InputRecord& record);  // Any thread
+    bool Pop(ImGui_ImplQt_InputRecord* record);         // GUI thread
+    int  Drain(ImGuiIO& io, qint64* first_timestamp_ns);
+
+    void (*Wake)(void* user_data){};    // Called by the producer that finds the queue idle, any thread
+    void* WakeUserData{};
+    std::atomic<bool> WakePending{};
+
+    std::atomic<int> Queued{};
+    std::atomic<int> Dropped{};
+    int Drained{};
+    int LastBatch{};
+private:
+    struct Cell
+    {
+        std::atomic<unsigned int> Sequence;
+        ImGui_ImplQt_InputRecord  Record;
+    };
+    std::atomic<unsigned int> EnqueuePos{};
+    char Padding[64];                   // Keeps the producers' counter off the consumer's cache line
+    unsigned int DequeuePos{};
+    Cell Cells[Capacity];
+};
@@ -0,0 +1,137 @@
+﻿#include "imgui_impl_qt_latency.h"
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <algorithm>
+#include <chrono>
+
+//无头上下文可以各自运行在自己的线程上
+static QHash<ImGuiContext*, ImGui_ImplQt_LatencyTracker*> ImGui_ImplQt_LatencyTrackers;
+static QMutex ImGui_ImplQt_LatencyTrackersMutex;
+
+ImGui_ImplQt_LatencyTracker* ImGui_ImplQt_LatencyTracker::Find(ImGuiContext* context)
+{
+    QMutexLocker lock(&ImGui_ImplQt_LatencyTrackersMutex);
+    return ImGui_ImplQt_LatencyTrackers.value(context, nullptr);
+}
+
+qint64 ImGui_ImplQt_LatencyTracker::Now()
+{
+    using namespace std::chrono;
+    return (qint64)duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+void ImGui_ImplQt_LatencyTracker::Attach(ImGuiContext* context)
+{
+    Context = context;
+    QMutexLocker lock(&ImGui_ImplQt_LatencyTrackersMutex);
+    ImGui_ImplQt_LatencyTrackers.insert(context, this);
+}
+
+void ImGui_ImplQt_LatencyTracker::Detach()
+{
+    QMutexLocker lock(&ImGui_ImplQt_LatencyTrackersMutex);
+    if (Context && ImGui_ImplQt_LatencyTrackers.value(Context, nullptr) == this)
+        ImGui_ImplQt_LatencyTrackers.remove(Context);
+    Context = nullptr;
+}
+
+void ImGui_ImplQt_LatencyTracker::Input(qint64 ns)
+{
+    if (PendingInputNs < 0)
+        PendingInputNs = ns;
+}
+
+void ImGui_ImplQt_LatencyTracker::NewFrame()
+{
+    FrameSerial++;
+    if (PendingInputNs < 0)
+        return;
+    Frame frame;
+    frame.Serial = FrameSerial;
+    frame.InputNs = PendingInputNs;
+    PendingInputNs = -1;
+    //没有交换通知的宿主(光栅、无窗口)不会完成采样,只保留最近几帧
+    if ((int)Frames.size() >= MaxFramesInFlight)
+        Frames.erase(Frames.begin());
+    Frames.push_back(frame);
+}
+
+ImU32 ImGui_ImplQt_LatencyTracker::Rendered(bool fenced)
+{
+    Frame* frame = FindFrame(FrameSerial);
+    if (!frame || frame->RenderNs >= 0)
+        return 0;
+    frame->RenderNs = Now();
+    frame->Fenced = fenced;
+    return frame->Serial;
+}
+
+void ImGui_ImplQt_LatencyTracker::GpuDone(ImU32 serial, qint64 ns)
+{
+    if (Frame* frame = FindFrame(serial))
+        frame->GpuNs = std::max(ns, frame->RenderNs);   //GPU时间戳换算到CPU时钟后可能略早于提交时刻
+    Complete();
+}
+
+void ImGui_ImplQt_LatencyTracker::Swapped()
+{
+    //每次绘制对应一次交换,目前为止构建的帧都已交换
+    const qint64 now = Now();
+    for (Frame& frame : Frames) {
+        if (frame.Serial <= FrameSerial && frame.SwapNs < 0)
+            frame.SwapNs = now;
+    }
+    Complete();
+}
+
+ImGui_ImplQt_LatencyTracker::Frame* ImGui_ImplQt_LatencyTracker::FindFrame(ImU32 serial)
+{
+    for (Frame& frame : Frames) {
+        if (frame.Serial == serial)
+            return &frame;
+    }
+    return nullptr;
+}
+
+void ImGui_ImplQt_LatencyTracker::Complete()
+{
+    //交换之后GPU可能还没画完,以两者中较晚的时间作为显示时间
+    while (!Frames.empty())
+    {
+        const Frame& frame = Frames.front();
+        if (frame.SwapNs < 0 || (frame.Fenced && frame.GpuNs < 0))
+            break;
+        const qint64 displayed = frame.Fenced ? std::max(frame.SwapNs, frame.GpuNs) : frame.SwapNs;
+        LastMs = (float)(displayed - frame.InputNs) / 1000000.0f;
+        AverageMs = SampleTotal == 0 ? LastMs : AverageMs * 0.9f + LastMs * 0.1f;
+        if (frame.Fenced && frame.RenderNs >= 0)
+            GpuMs = (float)(frame.GpuNs - frame.RenderNs) / 1000000.0f;
+        Samples[SampleTotal % SampleCount] = LastMs;
+        SampleTotal++;
+        Frames.erase(Frames.begin());
+    }
+}
+
+void ImGui_ImplQt_LatencyTracker::GetStats(ImGui_ImplQt_LatencyStats* stats) const
+{
+    *stats = ImGui_ImplQt_LatencyStats{};
+    stats->Samples = SampleTotal;
+    stats->LastMs = LastMs;
+    stats->AverageMs = AverageMs;
+    stats->GpuMs = GpuMs;
+    for (const Frame& frame : Frames) {
+        if (frame.Fenced && frame.GpuNs < 0)
+            stats->QueuedFrames++;
+    }
+
+    const int count = std::min(SampleTotal, (int)SampleCount);
+    if (count == 0)
+        return;
+    float sorted[SampleCount];
+    std::copy(Samples, Samples + count, sorted);
+    std::sort(sorted, sorted + count);
+    stats->P50Ms = sorted[(count - 1) * 50 / 100];
+    stats->P90Ms = sorted[(count - 1) * 90 / 100];
+    stats->P99Ms = sorted[(count - 1) * 99 / 100];
+    stats->MaxMs = sorted[count - 1];
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <QtCore/QtGlobal>
+#include <vector>
+
+#include "imgui.h"
+#include "imgui_impl_qt.h"
+
+// Input-to-photon latency of one ImGui context. The platform backend stamps input events, frames and swaps, the
+// renderer fences the frames that carry input. Both find the tracker through the ImGui context. GUI thread only.
+class ImGui_ImplQt_LatencyTracker
+{
+public:
+    enum { SampleCount = 256, MaxFramesInFlight = 8 };
+
+    static ImGui_ImplQt_LatencyTracker* Find(ImGuiContext* context);
+    static qint64 Now();        // Monotonic clock, nanoseconds
+
+    void  Attach(ImGuiContext* context);
+    void  Detach();
+    void  Input(qint64 ns);     // Keeps the earliest input not consumed by a frame
+    void  NewFrame();           // The frame being built consumes the pending input
+    ImU32 Rendered(bool fenced);    // Returns the serial of the rendered frame, 0 when it carries no input
+    void  GpuDone(ImU32 frame, qint64 ns);
+    void  Swapped();
+    void  GetStats(ImGui_ImplQt_LatencyStats* stats) const;
+public:
+    bool  LowLatency{};
+    int   MaxQueuedFrames{ 1 };
+private:
+    struct Frame
+    {
+        ImU32  Serial{};
+        qint64 InputNs{ -1 };
+        qint64 RenderNs{ -1 };
+        qint64 SwapNs{ -1 };
+        qint64 GpuNs{ -1 };
+        bool   Fenced{};
+    };
+    Frame* FindFrame(ImU32 serial);
+    void   Complete();
+private:
+    ImGuiContext* Context{};
+    qint64 PendingInputNs{ -1 };
+    ImU32  FrameSerial{};
+    std::vector<Frame> Frames;  // Frames with input, oldest first
+    float  Samples[SampleCount]{};
+    int    SampleTotal{};
+    float  LastMs{};
+    float  AverageMs{};
+    float  GpuMs{};
+};
@@ -1,5 +1,27 @@
 ﻿#include <QtGui/QOpenGLExtraFunctions>
 #include "imgui_impl_qt_opengl3.h"
+#include "imgui_internal.h"
+#include "imgui_impl_qt_opengl3_texture.h"
+#include "imgui_impl_qt_opengl3_stream.h"
+#include "imgui_impl_qt_opengl3_buffers.h"
+#include "imgui_impl_qt_opengl3_layers.h"
+#include "imgui_impl_qt_opengl3_compact.h"
+#include "imgui_impl_qt_opengl3_commands.h"
+#include "imgui_impl_qt_opengl3_readback.h"
+#include "imgui_impl_qt_opengl3_memory.h"
+#include "imgui_impl_qt_opengl3_features.h"
+#include "imgui_impl_qt_opengl3_plot.h"
+#include "imgui_impl_qt_opengl3_atlas.h"
+#include "imgui_impl_qt_hash.h"
+#include "imgui_impl_qt_fonts.h"
+#include "imgui_impl_qt_latency.h"
+#include "imgui_impl_qt_governor.h"
+#include <QtCore/QHash>
+#include <QtCore/QElapsedTimer>
+#include <QtGui/QOpenGLContext>
+#include <QtGui/QOffscreenSurface>
+#include <math.h>
+#include <limits.h>
 
 // Vertex arrays are not supported on ES2/WebGL1 unless Emscripten which uses an extension
 #ifndef IMGUI_IMPL_OPENGL_ES2
@@ -32,6 +54,11 @@
 #define IMGUI_IMPL_OPENGL_MAY_HAVE_PRIMITIVE_RESTART
 #endif
 
+// Desktop GL has GL_MULTISAMPLE state (always on in GL ES)
+#if !defined(IMGUI_IMPL_OPENGL_ES2) && !defined(IMGUI_IMPL_OPENGL_ES3) && defined(GL_MULTISAMPLE)
+#define IMGUI_IMPL_OPENGL_MAY_HAVE_MULTISAMPLE
+#endif
+
 // Desktop GL use extension detection
 #if !defined(IMGUI_IMPL_OPENGL_ES2) && !defined(IMGUI_IMPL_OPENGL_ES3)
 #define IMGUI_IMPL_OPENGL_MAY_HAVE_EXTENSIONS
@@ -46,11 +73,69 @@
 #define GL_CALL(_CALL)      _CALL   // Call without error check
 #endif
 
+// Layer composition quad: two unit quads, UVs flipped for a lower-left and an upper-left clip origin
+static const size_t ImGui_ImplQtOpenGL3_QuadVertexBytes = 8 * sizeof(ImDrawVert);
+static const size_t ImGui_ImplQtOpenGL3_QuadIndexBytes = 12 * sizeof(ImDrawIdx);
+
+// State of one draw list in the previous frame, used to find what changed
+struct ImGui_ImplQtOpenGL3_DrawListState
+{
+    ImU64  Hash{};
+    int    Index{};
+    ImVec4 Bounds{};    // Union of the clip rectangles, in framebuffer space
+};
+
+// Fence behind a rendered frame, see ImGui_ImplQt_GetLatencyStats()
+struct ImGui_ImplQtOpenGL3_FrameFence
+{
+    GLsync Fence{};
+    ImU32  Frame{};     // Serial of the latency tracker, 0 for frames without input
+    GLuint Query{};     // GL_TIMESTAMP written after the frame, 0 without timer queries
+    qint64 ClockOffsetNs{}; // Latency tracker clock minus GL_TIMESTAMP when the frame was fenced
+};
+
+//上下文即将销毁时未必是当前上下文,借一个离屏表面临时切换过去,结束后恢复原来的上下文
+struct ImGui_ImplQtOpenGL3_ContextScope
+{
+    explicit ImGui_ImplQtOpenGL3_ContextScope(QOpenGLContext* context)
+    {
+        LastContext = QOpenGLContext::currentContext();
+        LastSurface = LastContext ? LastContext->surface() : nullptr;
+        if (context == nullptr || context == LastContext) {
+            Current = context != nullptr;
+            return;
+        }
+        Surface = new QOffscreenSurface();
+        Surface->setFormat(context->format());
+        Surface->create();
+        Current = context->makeCurrent(Surface);
+        Switched = true;
+    }
+    ~ImGui_ImplQtOpenGL3_ContextScope()
+    {
+        if (Switched) {
+            if (LastContext)
+                LastContext->makeCurrent(LastSurface);
+            else if (QOpenGLContext::currentContext())
+                QOpenGLContext::currentContext()->doneCurrent();
+        }
+        delete Surface;
+    }
+
+    QOpenGLContext*    LastContext{};
+    QSurface*          LastSurface{};
+    QOffscreenSurface* Surface{};
+    bool               Current{};
+    bool               Switched{};
+};
 
 struct ImGui_ImplQtOpenGL3 : public QOpenGLExtraFunctions
 {
 public:
     bool Init(ImGuiIO& io, const char* glsl_version);
+    void InitContext(ImGuiIO& io);
+    void LoseContext();
+    void RestoreContext(ImGuiIO& io);
     void RenderDrawData(ImDrawData* draw_data);
     bool CreateFontsTexture(ImGuiIO& io);
     void DestoryFontsTexture(ImGuiIO& io);
@@ -58,12 +143,43 @@ public:
     void DestoryDeviceObjects(ImGuiIO& io);
 
     void RenderWindow(ImGuiViewport* viewport);
+    void SelectFeatureLevel(ImGuiIO& io);
+    void PollFrameFences(ImGui_ImplQt_LatencyTracker* latency, int max_queued);
 private:
-    bool SetupRenderState(ImDrawData* draw_data, int fb_width, int fb_height, GLuint vertex_array_object);
+    template<typename Features, bool BufferSubData> void RenderDrawDataImpl(ImDrawData* draw_data);
+    template<typename Features> bool SetupRenderState(ImDrawData* draw_data, int fb_width, int fb_height, GLuint vertex_array_object);
+    void SetupProjection(const ImVec2& display_pos, const ImVec2& display_size, int fb_width, int fb_height);
+    void SetupVertexTransform(const ImVec2& vtx_origin, const ImVec2& vtx_scale);
+    void SetupVertexTransform(const ImVec2& vtx_origin, float vtx_scale) { SetupVertexTransform(vtx_origin, ImVec2(vtx_scale, vtx_scale)); }
+    void SetupVertexAttribs(bool compact);
+    void UseProgram(GLuint program);
+    void CreateSdfProgram(const GLchar* vertex_shader, const GLchar* fragment_shader);
+    void CreatePlotProgram(const GLchar* vertex_shader, const GLchar* fragment_shader);
+    GLint GetProjMtxLocation(GLuint program) const;
+    void RenderPlot(const ImDrawCmd* pcmd, const ImVec2& clip_off, const ImVec2& clip_scale, const ImVec4& clip_rect, const ImVec2& target_origin, int target_height);
+    void DrawPlotRange(GLenum mode, const ImGui_ImplQtOpenGL3_PlotLevel& level, const ImGui_ImplQtOpenGL3_PlotRange& range);
+    size_t GetProgramBytes(GLuint program);
+    void ShrinkBuffers();
+    void FenceFrame(ImGui_ImplQt_LatencyTracker* latency);
+    void ReleaseFrameFences();
+    void BindDrawListBuffers(GLuint vbo, GLuint ibo, bool compact, const ImVec2& vtx_origin);
+    void CreateQuadBuffers();
+    template<typename Features, bool BufferSubData> void RenderDrawList(ImDrawData* draw_data, int n, const ImVec4& clip_rect, const ImVec2& target_origin, int target_height, int fb_width, int fb_height, GLuint vertex_array_object);
+    ImGui_ImplQtOpenGL3_Layer* AcquireLayer(ImDrawData* draw_data, int n, int fb_width, int fb_height, bool* needs_render);
+    template<typename Features, bool BufferSubData> void RenderLayer(ImDrawData* draw_data, int n, const ImGui_ImplQtOpenGL3_Layer& layer, GLuint target_framebuffer, int fb_width, int fb_height, GLuint vertex_array_object);
+    void CompositeLayer(ImDrawData* draw_data, const ImGui_ImplQtOpenGL3_Layer& layer, const ImVec4& clip_rect, int fb_height);
+    void HashDrawLists(ImDrawData* draw_data);
+    ImVec4 ComputeDamage(ImDrawData* draw_data, int fb_width, int fb_height);
+    void SaveFontsTexture(ImGuiIO& io);
     bool CheckShader(GLuint handle, const char* desc);
     bool CheckProgram(GLuint handle, const char* desc);
 public:
     GLuint GlVersion{};
+    ImGui_ImplQtOpenGL3_FeatureLevel FeatureLevel{};
+    ImGui_ImplQtOpenGL3_FeatureLevel MaxFeatureLevel{};     // Highest level the context supports
+    int    ForcedFeatureLevel{ -1 };
+    bool   HasMultisampleState{};       // Desktop context, GL 2.x contexts run at GL30 and ES 2.0 contexts too
+    void (ImGui_ImplQtOpenGL3::*RenderDrawDataFn)(ImDrawData* draw_data){};    // Instantiation for FeatureLevel and UseBufferSubData
     char   GlslVersionString[32]{};
     GLuint FontTexture{};
     GLuint ShaderHandle{};
@@ -72,12 +188,85 @@ public:
     GLuint AttribLocationVtxPos{};
     GLuint AttribLocationVtxUV{};
     GLuint AttribLocationVtxColor{};
+    GLuint ShaderHandleSdf{};           // Variant for commands drawing from a distance field font texture
+    GLint  AttribLocationSdfProjMtx{};
+    bool   FontTextureSdf{};
+    GLuint ActiveProgram{};
+    float  ProjectionMatrix[4][4]{};    // Last matrix, uploaded again when switching programs
+    int    SdfDrawCalls{};
+    int    ProgramSwitches{};
+    GLuint ShaderHandlePlot{};          // Plot series, see ImGui_ImplQtOpenGL3_AddPlotSeries()
+    GLint  AttribLocationPlotProjMtx{};
+    GLint  AttribLocationPlotTransform{};
+    GLint  AttribLocationPlotSlots{};
+    GLint  AttribLocationPlotColor{};
+    GLuint AttribLocationPlotValue{};
+    int    PlotSeriesDrawn{};
+    int    PlotVertices{};
     unsigned int VboHandle{};
     unsigned int ElementsHandle{};
+    unsigned int QuadVboHandle{};       // Unit quad for layer composition, never resized
+    unsigned int QuadElementsHandle{};
     GLsizeiptr VertexBufferSize{};
     GLsizeiptr IndexBufferSize{};
     bool       HasClipOrigin{};
+    bool       ClipOriginLowerLeft{ true };
+    ImVec2     ProjectionDisplayPos{};
+    ImVec2     ProjectionDisplaySize{};
+    bool       UseCompactVertices{};
+    ImVector<ImGui_ImplQtOpenGL3_CompactVert> CompactVertices;
+    int        CompactLists{};
+    size_t     CompactBytesSaved{};
+    ImVector<ImGui_ImplQtOpenGL3_RenderCmd> RenderCmds;
+    int        DrawCalls{};
+    int        CommandsCulled{};
+    int        CommandsMerged{};
     bool       UseBufferSubData{};
+    ImGui_ImplQtOpenGL3_TextureCache Textures;
+    ImGui_ImplQtOpenGL3_StreamTextures Streams;
+    ImGui_ImplQtOpenGL3_BufferCache Buffers;
+    bool       UseBufferCache{};
+    ImGui_ImplQtOpenGL3_LayerCache Layers;
+    bool       UseLayers{};
+    ImGui_ImplQtOpenGL3_Readback Readback;
+    ImGui_ImplQtOpenGL3_PlotSeriesSet Plots;
+    ImGui_ImplQtOpenGL3_AtlasSet Atlas;
+    ImGui_ImplQtOpenGL3_MemoryTracker Memory;
+    ImGui_ImplQtOpenGL3_BufferUsage VertexBufferUsage;
+    ImGui_ImplQtOpenGL3_BufferUsage IndexBufferUsage;
+    size_t     FontTextureBytes{};
+    size_t     ProgramBytes{};
+    size_t     ProgramSdfBytes{};
+    size_t     ProgramPlotBytes{};
+    bool       HasSync{};
+    bool       HasTimerQuery{};
+    void (QOPENGLF_APIENTRYP QueryCounter)(GLuint id, GLenum target){};
+    void (QOPENGLF_APIENTRYP GetQueryObjectui64v)(GLuint id, GLenum pname, GLuint64* params){};
+    ImVector<ImGui_ImplQtOpenGL3_FrameFence> FrameFences;   // Oldest first
+
+    // Context loss: the renderer follows the context that was current in Init() and rebuilds itself in NewFrame()
+    QOpenGLContext*         Context{};
+    QMetaObject::Connection ContextConnection;
+    ImGuiContext*           ImContext{};
+    bool                    ContextLost{};
+    int                     ContextRestores{};
+    float                   ContextRestoreMs{};
+    bool                    HasProgramBinary{};
+    ImVector<unsigned char> ProgramBinary;      // Linked program saved before the context went away
+    GLenum                  ProgramBinaryFormat{};
+    ImVector<unsigned char> FontPixels;         // Font texture read back when the atlas has no CPU copy
+    int                     FontPixelsWidth{};
+    int                     FontPixelsHeight{};
+
+    bool       PartialRedraw{};
+    ImVec4     ClearColor{};
+    ImVec2     LastFramebufferSize{};
+    ImVec2     LastDisplayPos{};
+    QHash<const ImDrawList*, ImGui_ImplQtOpenGL3_DrawListState> DrawListStates;
+    ImVector<ImVec4>      DrawListRects;
+    ImVector<ImU64>       DrawListHashes;   // Vertex/index content hash of each draw list of the current frame
+    ImVector<ImTextureID> DirtyTextures;    // Textures whose content changed since the last frame
+    ImGui_ImplQtOpenGL3_FrameStats FrameStats{};
 };
 
 static ImGui_ImplQtOpenGL3* ImGui_ImplQtOpenGL3_GetBackendData()
@@ -102,6 +291,28 @@ bool ImGui_ImplQtOpenGL3_Init(const char* glsl_version)
 }
 
 bool ImGui_ImplQtOpenGL3::Init(ImGuiIO& io, const char* glsl_version)
+{
+    auto bd = this;
+    bd->ImContext = ImGui::GetCurrentContext();
+    InitContext(io);
+
+    if (glsl_version == nullptr)
+    {
+        glsl_version = "#version 130";
+    }
+    IM_ASSERT((int)strlen(glsl_version) + 2 < IM_ARRAYSIZE(bd->GlslVersionString));
+    strcpy(bd->GlslVersionString, glsl_version);
+    strcat(bd->GlslVersionString, "\n");
+
+    io.BackendFlags |= ImGuiBackendFlags_RendererHasViewports;  // We can create multi-viewports on the Renderer side (optional)
+    if (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable)
+        ImGui_ImplQtOpenGL3_InitPlatformInterface();
+
+    return true;
+}
+
+// Everything that depends on the GL context: function pointers, version, extensions and the loss notification
+void ImGui_ImplQtOpenGL3::InitContext(ImGuiIO& io)
 {
     initializeOpenGLFunctions();
     auto bd = this;
@@ -120,20 +331,6 @@ bool ImGui_ImplQtOpenGL3::Init(ImGuiIO& io, const char* glsl_version)
 
     bd->UseBufferSubData = false;
 
-#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_VTX_OFFSET
-    if (bd->GlVersion >= 320)
-        io.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset;  // We can honor the ImDrawCmd::VtxOffset field, allowing for large meshes.
-#endif
-    io.BackendFlags |= ImGuiBackendFlags_RendererHasViewports;  // We can create multi-viewports on the Renderer side (optional)
-
-    if (glsl_version == nullptr)
-    {
-        glsl_version = "#version 130";
-    }
-    IM_ASSERT((int)strlen(glsl_version) + 2 < IM_ARRAYSIZE(bd->GlslVersionString));
-    strcpy(bd->GlslVersionString, glsl_version);
-    strcat(bd->GlslVersionString, "\n");
-
     // Make an arbitrary GL call (we don't actually need the result)
     // IF YOU GET A CRASH HERE: it probably means the OpenGL function loader didn't do its job. Let us know!
     GLint current_texture;
@@ -152,12 +349,219 @@ bool ImGui_ImplQtOpenGL3::Init(ImGuiIO& io, const char* glsl_version)
     }
 #endif
 
-    if (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable)
-        ImGui_ImplQtOpenGL3_InitPlatformInterface();
+    //ES 2.0没有采样器对象,与GL 2.x一样按最低级别运行,只是没有GL_MULTISAMPLE状态
+    QOpenGLContext* context = QOpenGLContext::currentContext();
+    const bool is_es = context && context->isOpenGLES();
+    bd->HasMultisampleState = !is_es;
+    if (is_es && bd->GlVersion >= 300)
+        bd->MaxFeatureLevel = ImGui_ImplQtOpenGL3_FeatureLevel_ES3;
+    else if (is_es)
+        bd->MaxFeatureLevel = ImGui_ImplQtOpenGL3_FeatureLevel_GL30;
+    else if (bd->GlVersion >= 330 && bd->HasClipOrigin)
+        bd->MaxFeatureLevel = ImGui_ImplQtOpenGL3_FeatureLevel_GL45;
+    else if (bd->GlVersion >= 330)
+        bd->MaxFeatureLevel = ImGui_ImplQtOpenGL3_FeatureLevel_GL33;
+    else
+        bd->MaxFeatureLevel = ImGui_ImplQtOpenGL3_FeatureLevel_GL30;
+    SelectFeatureLevel(io);
+
+    bd->Textures.Memory = bd->Streams.Memory = bd->Buffers.Memory = bd->Layers.Memory = bd->Readback.Memory = bd->Plots.Memory = bd->Atlas.Memory = &bd->Memory;
+    // Pixel unpack buffers need GL 3.0+/ES 3.0+ for glMapBufferRange()
+    bd->Textures.Init(bd->GlVersion >= 300);
+    bd->Streams.Init(bd->GlVersion >= 300);
+    bd->Buffers.Init();
+    bd->Layers.Init();
+    bd->Plots.Init();
+    bd->Atlas.Init();
+    // Fences need GL 3.2+/ES 3.0+, older contexts read back synchronously
+    bd->HasSync = bd->GlVersion >= (is_es ? 300 : 320);
+    bd->Readback.Init(bd->HasSync, bd->GlVersion >= 300);
+
+    // Timer queries (GL 3.3+ or ARB_timer_query, desktop only) are not part of QOpenGLExtraFunctions
+    bd->HasTimerQuery = false;
+    bd->QueryCounter = nullptr;
+    bd->GetQueryObjectui64v = nullptr;
+#if !defined(IMGUI_IMPL_OPENGL_ES2) && !defined(IMGUI_IMPL_OPENGL_ES3)
+    if (bd->HasSync && !is_es && (bd->GlVersion >= 330 || context->hasExtension("GL_ARB_timer_query")))
+    {
+        bd->QueryCounter = reinterpret_cast<void (QOPENGLF_APIENTRYP)(GLuint, GLenum)>(context->getProcAddress("glQueryCounter"));
+        bd->GetQueryObjectui64v = reinterpret_cast<void (QOPENGLF_APIENTRYP)(GLuint, GLenum, GLuint64*)>(context->getProcAddress("glGetQueryObjectui64v"));
+        bd->HasTimerQuery = bd->QueryCounter && bd->GetQueryObjectui64v;
+    }
+#endif
 
-    return true;
+    // Program binaries let a recreated context skip shader compilation (GL 4.1+, drivers may still report no formats)
+    bd->HasProgramBinary = false;
+#if !defined(IMGUI_IMPL_OPENGL_ES2) && !defined(IMGUI_IMPL_OPENGL_ES3)
+    if (bd->GlVersion >= 410)
+    {
+        GLint num_formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &num_formats);
+        bd->HasProgramBinary = num_formats > 0;
+    }
+#endif
+
+    //上下文销毁信号必须直接连接,才能在GL对象失效前完成保存与释放
+    QObject::disconnect(bd->ContextConnection);
+    bd->Context = QOpenGLContext::currentContext();
+    bd->ContextLost = false;
+    if (bd->Context)
+        bd->ContextConnection = QObject::connect(bd->Context, &QOpenGLContext::aboutToBeDestroyed, bd->Context, [bd]() { bd->LoseContext(); }, Qt::DirectConnection);
+}
+
+static bool ImGui_ImplQtOpenGL3_CanRunFeatureLevel(ImGui_ImplQtOpenGL3_FeatureLevel max_level, ImGui_ImplQtOpenGL3_FeatureLevel level)
+{
+    if (max_level == ImGui_ImplQtOpenGL3_FeatureLevel_ES3 || level == ImGui_ImplQtOpenGL3_FeatureLevel_ES3)
+        return level == max_level;
+    return level <= max_level;
+}
+
+// The instantiation is picked once per context, drawing then goes through RenderDrawDataFn without testing versions
+void ImGui_ImplQtOpenGL3::SelectFeatureLevel(ImGuiIO& io)
+{
+    auto bd = this;
+    typedef void (ImGui_ImplQtOpenGL3::*RenderDrawDataFunc)(ImDrawData* draw_data);
+    static const RenderDrawDataFunc renderers[ImGui_ImplQtOpenGL3_FeatureLevel_COUNT][2] =
+    {
+        { &ImGui_ImplQtOpenGL3::RenderDrawDataImpl<ImGui_ImplQtOpenGL3_FeaturesGL30, false>, &ImGui_ImplQtOpenGL3::RenderDrawDataImpl<ImGui_ImplQtOpenGL3_FeaturesGL30, true> },
+        { &ImGui_ImplQtOpenGL3::RenderDrawDataImpl<ImGui_ImplQtOpenGL3_FeaturesGL33, false>, &ImGui_ImplQtOpenGL3::RenderDrawDataImpl<ImGui_ImplQtOpenGL3_FeaturesGL33, true> },
+        { &ImGui_ImplQtOpenGL3::RenderDrawDataImpl<ImGui_ImplQtOpenGL3_FeaturesGL45, false>, &ImGui_ImplQtOpenGL3::RenderDrawDataImpl<ImGui_ImplQtOpenGL3_FeaturesGL45, true> },
+        { &ImGui_ImplQtOpenGL3::RenderDrawDataImpl<ImGui_ImplQtOpenGL3_FeaturesES3, false>, &ImGui_ImplQtOpenGL3::RenderDrawDataImpl<ImGui_ImplQtOpenGL3_FeaturesES3, true> },
+    };
+    static const bool has_vtx_offset[ImGui_ImplQtOpenGL3_FeatureLevel_COUNT] =
+    {
+        ImGui_ImplQtOpenGL3_FeaturesGL30::VtxOffset, ImGui_ImplQtOpenGL3_FeaturesGL33::VtxOffset,
+        ImGui_ImplQtOpenGL3_FeaturesGL45::VtxOffset, ImGui_ImplQtOpenGL3_FeaturesES3::VtxOffset,
+    };
+
+    //上下文丢失后新的上下文可能不支持之前强制的级别
+    bd->FeatureLevel = bd->MaxFeatureLevel;
+    if (bd->ForcedFeatureLevel >= 0 && ImGui_ImplQtOpenGL3_CanRunFeatureLevel(bd->MaxFeatureLevel, (ImGui_ImplQtOpenGL3_FeatureLevel)bd->ForcedFeatureLevel))
+        bd->FeatureLevel = (ImGui_ImplQtOpenGL3_FeatureLevel)bd->ForcedFeatureLevel;
+    bd->RenderDrawDataFn = renderers[bd->FeatureLevel][bd->UseBufferSubData ? 1 : 0];
+
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_VTX_OFFSET
+    if (has_vtx_offset[bd->FeatureLevel])
+        io.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset;  // We can honor the ImDrawCmd::VtxOffset field, allowing for large meshes.
+    else
+        io.BackendFlags &= ~ImGuiBackendFlags_RendererHasVtxOffset;
+#else
+    (void)io; (void)has_vtx_offset;
+#endif
+}
+
+void ImGui_ImplQtOpenGL3::LoseContext()
+{
+    auto bd = this;
+    if (bd->ContextLost)
+        return;
+
+    //信号可能在别的ImGui上下文正在使用时发出
+    ImGuiContext* last_context = ImGui::GetCurrentContext();
+    ImGui::SetCurrentContext(bd->ImContext);
+    ImGuiIO& io = ImGui::GetIO();
+    {
+        ImGui_ImplQtOpenGL3_ContextScope scope(bd->Context);
+        if (scope.Current)
+        {
+#if !defined(IMGUI_IMPL_OPENGL_ES2) && !defined(IMGUI_IMPL_OPENGL_ES3)
+            if (bd->HasProgramBinary && bd->ShaderHandle)
+            {
+                GLint length = 0;
+                glGetProgramiv(bd->ShaderHandle, GL_PROGRAM_BINARY_LENGTH, &length);
+                bd->ProgramBinary.resize(length);
+                if (length > 0)
+                    glGetProgramBinary(bd->ShaderHandle, length, nullptr, &bd->ProgramBinaryFormat, bd->ProgramBinary.Data);
+            }
+#endif
+            SaveFontsTexture(io);
+
+            //流纹理和纹理缓存保留CPU侧数据,其余GL对象直接释放,恢复时按需重建
+            if (bd->VboHandle) { glDeleteBuffers(1, &bd->VboHandle); bd->VboHandle = 0; }
+            if (bd->ElementsHandle) { glDeleteBuffers(1, &bd->ElementsHandle); bd->ElementsHandle = 0; }
+            if (bd->QuadVboHandle) { glDeleteBuffers(1, &bd->QuadVboHandle); bd->QuadVboHandle = 0; }
+            if (bd->QuadElementsHandle) { glDeleteBuffers(1, &bd->QuadElementsHandle); bd->QuadElementsHandle = 0; }
+            if (bd->ShaderHandle) { glDeleteProgram(bd->ShaderHandle); bd->ShaderHandle = 0; }
+            if (bd->ShaderHandleSdf) { glDeleteProgram(bd->ShaderHandleSdf); bd->ShaderHandleSdf = 0; }
+            if (bd->ShaderHandlePlot) { glDeleteProgram(bd->ShaderHandlePlot); bd->ShaderHandlePlot = 0; }
+            bd->Textures.ReleaseDeviceObjects();
+            bd->Streams.ReleaseDeviceObjects();
+            bd->Plots.ReleaseDeviceObjects();
+            bd->Atlas.ReleaseDeviceObjects();
+            bd->Buffers.DestroyDeviceObjects();
+            bd->Layers.DestroyDeviceObjects();
+            bd->Readback.DestroyDeviceObjects();
+            ReleaseFrameFences();
+            DestoryFontsTexture(io);
+        }
+        else
+        {
+            fprintf(stderr, "ImGui_ImplQtOpenGL3: could not make the lost context current, its GL objects are abandoned.\n");
+        }
+    }
+    bd->FrameFences.clear();
+    bd->DrawListStates.clear();
+    bd->LastFramebufferSize = ImVec2();
+    //对象随上下文一起消失,无论是否成功释放
+    bd->Memory.Clear();
+    bd->VertexBufferSize = bd->IndexBufferSize = 0;
+    bd->FontTextureBytes = bd->ProgramBytes = bd->ProgramSdfBytes = bd->ProgramPlotBytes = 0;
+    QObject::disconnect(bd->ContextConnection);
+    bd->Context = nullptr;
+    bd->ContextLost = true;
+    ImGui::SetCurrentContext(last_context);
+}
+
+void ImGui_ImplQtOpenGL3::RestoreContext(ImGuiIO& io)
+{
+    auto bd = this;
+    QElapsedTimer timer;
+    timer.start();
+
+    InitContext(io);
+    CreateDeviceObjects(io);
+
+    bd->ContextRestores++;
+    bd->ContextRestoreMs = (float)timer.nsecsElapsed() / 1000000.0f;
+}
+
+// Font atlases built with ClearTexData() have no CPU pixels left, keep what the GPU has
+void ImGui_ImplQtOpenGL3::SaveFontsTexture(ImGuiIO& io)
+{
+    auto bd = this;
+    bd->FontPixels.clear();
+    if (!bd->FontTexture || io.Fonts->TexPixelsAlpha8 || io.Fonts->TexPixelsRGBA32)
+        return;
+
+    const int width = io.Fonts->TexWidth;
+    const int height = io.Fonts->TexHeight;
+    GLint last_framebuffer;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &last_framebuffer);
+    GLuint framebuffer = 0;
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, bd->FontTexture, 0);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE)
+    {
+#ifdef GL_PACK_ROW_LENGTH // Not on WebGL/ES
+        glPixelStorei(GL_PACK_ROW_LENGTH, 0);
+#endif
+        glPixelStorei(GL_PACK_ALIGNMENT, 4);
+        bd->FontPixels.resize(width * height * 4);
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, bd->FontPixels.Data);
+        bd->FontPixelsWidth = width;
+        bd->FontPixelsHeight = height;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, (GLuint)last_framebuffer);
+    glDeleteFramebuffers(1, &framebuffer);
 }
 void ImGui_ImplQtOpenGL3::RenderDrawData(ImDrawData* draw_data)
+{
+    (this->*RenderDrawDataFn)(draw_data);
+}
+
+template<typename Features, bool BufferSubData>
+void ImGui_ImplQtOpenGL3::RenderDrawDataImpl(ImDrawData* draw_data)
 {
     // Avoid rendering when minimized, scale coordinates for retina displays (screen coordinates != framebuffer coordinates)
     int fb_width = (int)(draw_data->DisplaySize.x * draw_data->FramebufferScale.x);
@@ -167,13 +571,17 @@ void ImGui_ImplQtOpenGL3::RenderDrawData(ImDrawData* draw_data)
 
     auto bd = this;
 
+    // Upload the newest frame of every streaming texture before they get sampled
+    bd->Streams.Update(&bd->DirtyTextures);
+    bd->Plots.Update();
+
     // Backup GL state
     GLenum last_active_texture; glGetIntegerv(GL_ACTIVE_TEXTURE, (GLint*)&last_active_texture);
     glActiveTexture(GL_TEXTURE0);
     GLuint last_program; glGetIntegerv(GL_CURRENT_PROGRAM, (GLint*)&last_program);
     GLuint last_texture; glGetIntegerv(GL_TEXTURE_BINDING_2D, (GLint*)&last_texture);
 #ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_BIND_SAMPLER
-    GLuint last_sampler; if (bd->GlVersion >= 330) { glGetIntegerv(GL_SAMPLER_BINDING, (GLint*)&last_sampler); }
+    GLuint last_sampler; if (Features::BindSampler) { glGetIntegerv(GL_SAMPLER_BINDING, (GLint*)&last_sampler); }
     else { last_sampler = 0; }
 #endif
     GLuint last_array_buffer; glGetIntegerv(GL_ARRAY_BUFFER_BINDING, (GLint*)&last_array_buffer);
@@ -204,8 +612,12 @@ void ImGui_ImplQtOpenGL3::RenderDrawData(ImDrawData* draw_data)
     GLboolean last_enable_stencil_test = glIsEnabled(GL_STENCIL_TEST);
     GLboolean last_enable_scissor_test = glIsEnabled(GL_SCISSOR_TEST);
 #ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_PRIMITIVE_RESTART
-    GLboolean last_enable_primitive_restart = (bd->GlVersion >= 310) ? glIsEnabled(GL_PRIMITIVE_RESTART) : GL_FALSE;
+    GLboolean last_enable_primitive_restart = Features::PrimitiveRestart ? glIsEnabled(GL_PRIMITIVE_RESTART) : GL_FALSE;
+#endif
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_MULTISAMPLE
+    GLboolean last_enable_multisample = (Features::Multisample && bd->HasMultisampleState) ? glIsEnabled(GL_MULTISAMPLE) : GL_FALSE;
 #endif
+    GLfloat last_clear_color[4]; glGetFloatv(GL_COLOR_CLEAR_VALUE, last_clear_color);
 
     // Setup desired GL state
     // Recreate the VAO every time (this is to easily allow multiple GL contexts to be rendered to. VAO are not shared among GL contexts)
@@ -214,94 +626,137 @@ void ImGui_ImplQtOpenGL3::RenderDrawData(ImDrawData* draw_data)
 #ifdef IMGUI_IMPL_OPENGL_USE_VERTEX_ARRAY
     GL_CALL(glGenVertexArrays(1, &vertex_array_object));
 #endif
-    SetupRenderState(draw_data, fb_width, fb_height, vertex_array_object);
+    SetupRenderState<Features>(draw_data, fb_width, fb_height, vertex_array_object);
+
+    // Partial redraw: only the region covered by changed draw lists is cleared and redrawn,
+    // the rest of the preserved framebuffer is kept from the previous frame.
+    const bool main_viewport = (draw_data->OwnerViewport == nullptr || draw_data->OwnerViewport == ImGui::GetMainViewport());
+    const bool partial_redraw = bd->PartialRedraw && main_viewport;
+    const bool use_layers = bd->UseLayers && main_viewport;
+    ImGui_ImplQt_QualityGovernor* governor = ImGui_ImplQt_QualityGovernor::Find(bd->ImContext);
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_MULTISAMPLE
+    //多重采样的样本数只能在创建上下文时指定,降级时改为关闭多重采样光栅化
+    if (Features::Multisample && last_enable_multisample && governor && !governor->Multisample())
+        glDisable(GL_MULTISAMPLE);
+#endif
+    if (partial_redraw || use_layers || bd->UseBufferCache)
+        HashDrawLists(draw_data);
+    ImVec4 damage(0.0f, 0.0f, (float)fb_width, (float)fb_height);
+    if (partial_redraw)
+    {
+        damage = ComputeDamage(draw_data, fb_width, fb_height);
+        if (damage.z > damage.x && damage.w > damage.y)
+        {
+            GL_CALL(glScissor((int)damage.x, (int)((float)fb_height - damage.w), (int)(damage.z - damage.x), (int)(damage.w - damage.y)));
+            GL_CALL(glClearColor(bd->ClearColor.x, bd->ClearColor.y, bd->ClearColor.z, bd->ClearColor.w));
+            GL_CALL(glClear(GL_COLOR_BUFFER_BIT));
+        }
+    }
+    else if (main_viewport)
+    {
+        bd->FrameStats.DamageRect = damage;
+        bd->FrameStats.DamageRatio = 1.0f;
+        bd->FrameStats.DrawListsChanged = draw_data->CmdListsCount;
+    }
 
-    // Will project scissor/clipping rectangles into framebuffer space
-    ImVec2 clip_off = draw_data->DisplayPos;         // (0,0) unless using multi-viewports
-    ImVec2 clip_scale = draw_data->FramebufferScale; // (1,1) unless using retina display which are often (2,2)
+    // Layers: heavy draw lists are rendered into offscreen textures only when they change,
+    // every frame they cost a single textured quad.
+    GLuint target_framebuffer = 0;
+    if (use_layers)
+        glGetIntegerv(GL_FRAMEBUFFER_BINDING, (GLint*)&target_framebuffer);
 
     // Render command lists
     for (int n = 0; n < draw_data->CmdListsCount; n++)
     {
         const ImDrawList* cmd_list = draw_data->CmdLists[n];
-
-        // Upload vertex/index buffers
-        // - OpenGL drivers are in a very sorry state nowadays....
-        //   During 2021 we attempted to switch from glBufferData() to orphaning+glBufferSubData() following reports
-        //   of leaks on Intel GPU when using multi-viewports on Windows.
-        // - After this we kept hearing of various display corruptions issues. We started disabling on non-Intel GPU, but issues still got reported on Intel.
-        // - We are now back to using exclusively glBufferData(). So bd->UseBufferSubData IS ALWAYS FALSE in this code.
-        //   We are keeping the old code path for a while in case people finding new issues may want to test the bd->UseBufferSubData path.
-        // - See https://github.com/ocornut/imgui/issues/4468 and please report any corruption issues.
-        const GLsizeiptr vtx_buffer_size = (GLsizeiptr)cmd_list->VtxBuffer.Size * (int)sizeof(ImDrawVert);
-        const GLsizeiptr idx_buffer_size = (GLsizeiptr)cmd_list->IdxBuffer.Size * (int)sizeof(ImDrawIdx);
-        if (bd->UseBufferSubData)
+        if (partial_redraw)
         {
-            if (bd->VertexBufferSize < vtx_buffer_size)
-            {
-                bd->VertexBufferSize = vtx_buffer_size;
-                GL_CALL(glBufferData(GL_ARRAY_BUFFER, bd->VertexBufferSize, nullptr, GL_STREAM_DRAW));
-            }
-            if (bd->IndexBufferSize < idx_buffer_size)
+            const ImVec4& rect = bd->DrawListRects[n];
+            if (rect.z <= damage.x || rect.x >= damage.z || rect.w <= damage.y || rect.y >= damage.w)
             {
-                bd->IndexBufferSize = idx_buffer_size;
-                GL_CALL(glBufferData(GL_ELEMENT_ARRAY_BUFFER, bd->IndexBufferSize, nullptr, GL_STREAM_DRAW));
+                if (bd->UseBufferCache)
+                    bd->Buffers.Touch(cmd_list);
+                if (use_layers)
+                    bd->Layers.Touch(cmd_list);
+                continue;
             }
-            GL_CALL(glBufferSubData(GL_ARRAY_BUFFER, 0, vtx_buffer_size, (const GLvoid*)cmd_list->VtxBuffer.Data));
-            GL_CALL(glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, idx_buffer_size, (const GLvoid*)cmd_list->IdxBuffer.Data));
-        }
-        else
-        {
-            GL_CALL(glBufferData(GL_ARRAY_BUFFER, vtx_buffer_size, (const GLvoid*)cmd_list->VtxBuffer.Data, GL_STREAM_DRAW));
-            GL_CALL(glBufferData(GL_ELEMENT_ARRAY_BUFFER, idx_buffer_size, (const GLvoid*)cmd_list->IdxBuffer.Data, GL_STREAM_DRAW));
         }
 
-        for (int cmd_i = 0; cmd_i < cmd_list->CmdBuffer.Size; cmd_i++)
+        if (use_layers)
         {
-            const ImDrawCmd* pcmd = &cmd_list->CmdBuffer[cmd_i];
-            if (pcmd->UserCallback != nullptr)
-            {
-                // User callback, registered via ImDrawList::AddCallback()
-                // (ImDrawCallback_ResetRenderState is a special callback value used by the user to request the renderer to reset render state.)
-                if (pcmd->UserCallback == ImDrawCallback_ResetRenderState)
-                    SetupRenderState(draw_data, fb_width, fb_height, vertex_array_object);
-                else
-                    pcmd->UserCallback(cmd_list, pcmd);
-            }
-            else
+            bool needs_render = false;
+            if (const ImGui_ImplQtOpenGL3_Layer* layer = AcquireLayer(draw_data, n, fb_width, fb_height, &needs_render))
             {
-                // Project scissor/clipping rectangles into framebuffer space
-                ImVec2 clip_min((pcmd->ClipRect.x - clip_off.x) * clip_scale.x, (pcmd->ClipRect.y - clip_off.y) * clip_scale.y);
-                ImVec2 clip_max((pcmd->ClipRect.z - clip_off.x) * clip_scale.x, (pcmd->ClipRect.w - clip_off.y) * clip_scale.y);
-                if (clip_max.x <= clip_min.x || clip_max.y <= clip_min.y)
-                    continue;
-
-                // Apply scissor/clipping rectangle (Y is inverted in OpenGL)
-                GL_CALL(glScissor((int)clip_min.x, (int)((float)fb_height - clip_max.y), (int)(clip_max.x - clip_min.x), (int)(clip_max.y - clip_min.y)));
-
-                // Bind texture, Draw
-                GL_CALL(glBindTexture(GL_TEXTURE_2D, (GLuint)(intptr_t)pcmd->GetTexID()));
-#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_VTX_OFFSET
-                if (bd->GlVersion >= 320)
-                    GL_CALL(glDrawElementsBaseVertex(GL_TRIANGLES, (GLsizei)pcmd->ElemCount, sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, (void*)(intptr_t)(pcmd->IdxOffset * sizeof(ImDrawIdx)), (GLint)pcmd->VtxOffset));
-                else
-#endif
-                    GL_CALL(glDrawElements(GL_TRIANGLES, (GLsizei)pcmd->ElemCount, sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, (void*)(intptr_t)(pcmd->IdxOffset * sizeof(ImDrawIdx))));
+                if (needs_render)
+                    RenderLayer<Features, BufferSubData>(draw_data, n, *layer, target_framebuffer, fb_width, fb_height, vertex_array_object);
+                CompositeLayer(draw_data, *layer, damage, fb_height);
+                continue;
             }
         }
+        RenderDrawList<Features, BufferSubData>(draw_data, n, damage, ImVec2(0.0f, 0.0f), fb_height, fb_width, fb_height, vertex_array_object);
     }
 
+    //在临时VAO仍绑定时调整元素缓冲
+    if (main_viewport)
+        ShrinkBuffers();
+
     // Destroy the temporary VAO
 #ifdef IMGUI_IMPL_OPENGL_USE_VERTEX_ARRAY
     GL_CALL(glDeleteVertexArrays(1, &vertex_array_object));
 #endif
 
+    if (main_viewport)
+    {
+        const int lookups = bd->Buffers.Hits + bd->Buffers.Misses;
+        bd->FrameStats.BufferCacheHits = bd->Buffers.Hits;
+        bd->FrameStats.BufferCacheMisses = bd->Buffers.Misses;
+        bd->FrameStats.BufferCacheHitRate = lookups > 0 ? (float)bd->Buffers.Hits / (float)lookups : 0.0f;
+        bd->FrameStats.BufferBytesUploaded = bd->Buffers.BytesUploaded;
+        bd->FrameStats.BufferBytesSaved = bd->Buffers.BytesSaved;
+        bd->FrameStats.BufferCacheResidentBytes = bd->Buffers.ResidentBytes;
+        bd->FrameStats.LayersComposited = bd->Layers.Composited;
+        bd->FrameStats.LayersRendered = bd->Layers.Rendered;
+        bd->FrameStats.LayersDirect = bd->Layers.Direct;
+        bd->FrameStats.LayerResidentBytes = bd->Layers.ResidentBytes;
+        bd->FrameStats.CompactVertexLists = bd->CompactLists;
+        bd->FrameStats.CompactBytesSaved = bd->CompactBytesSaved;
+        bd->FrameStats.DrawCalls = bd->DrawCalls;
+        bd->FrameStats.CommandsCulled = bd->CommandsCulled;
+        bd->FrameStats.CommandsMerged = bd->CommandsMerged;
+        bd->FrameStats.SdfDrawCalls = bd->SdfDrawCalls;
+        bd->FrameStats.ProgramSwitches = bd->ProgramSwitches;
+        bd->FrameStats.PlotSeriesDrawn = bd->PlotSeriesDrawn;
+        bd->FrameStats.PlotVertices = bd->PlotVertices;
+        if (bd->Readback.Enabled)
+        {
+            bd->Readback.Poll();
+            bd->Readback.Capture(fb_width, fb_height, draw_data->FramebufferScale.x);
+        }
+        bd->FrameStats.ReadbackFramesCaptured = bd->Readback.FramesCaptured;
+        bd->FrameStats.ReadbackFramesDelivered = bd->Readback.FramesDelivered;
+        bd->FrameStats.ReadbackFramesDropped = bd->Readback.FramesDropped;
+        if (ImGui_ImplQt_LatencyTracker* latency = ImGui_ImplQt_LatencyTracker::Find(bd->ImContext))
+            FenceFrame(latency);
+        if (governor)
+            governor->FrameRendered();
+        bd->FrameStats.ContextRestores = bd->ContextRestores;
+        bd->FrameStats.ContextRestoreMs = bd->ContextRestoreMs;
+        bd->CompactLists = 0;
+        bd->CompactBytesSaved = 0;
+        bd->DrawCalls = bd->CommandsCulled = bd->CommandsMerged = 0;
+        bd->SdfDrawCalls = bd->ProgramSwitches = 0;
+        bd->PlotSeriesDrawn = bd->PlotVertices = 0;
+        bd->Buffers.Collect();
+        bd->Layers.Collect();
+        bd->DirtyTextures.resize(0);
+    }
+
     // Restore modified GL state
     // This "glIsProgram()" check is required because if the program is "pending deletion" at the time of binding backup, it will have been deleted by now and will cause an OpenGL error. See #6220.
     if (glIsProgram(last_program)) glUseProgram(last_program);
     glBindTexture(GL_TEXTURE_2D, last_texture);
 #ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_BIND_SAMPLER
-    if (bd->GlVersion >= 330)
+    if (Features::BindSampler)
         glBindSampler(0, last_sampler);
 #endif
     glActiveTexture(last_active_texture);
@@ -323,7 +778,10 @@ void ImGui_ImplQtOpenGL3::RenderDrawData(ImDrawData* draw_data)
     if (last_enable_stencil_test) glEnable(GL_STENCIL_TEST); else glDisable(GL_STENCIL_TEST);
     if (last_enable_scissor_test) glEnable(GL_SCISSOR_TEST); else glDisable(GL_SCISSOR_TEST);
 #ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_PRIMITIVE_RESTART
-    if (bd->GlVersion >= 310) { if (last_enable_primitive_restart) glEnable(GL_PRIMITIVE_RESTART); else glDisable(GL_PRIMITIVE_RESTART); }
+    if (Features::PrimitiveRestart) { if (last_enable_primitive_restart) glEnable(GL_PRIMITIVE_RESTART); else glDisable(GL_PRIMITIVE_RESTART); }
+#endif
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_MULTISAMPLE
+    if (Features::Multisample && last_enable_multisample) glEnable(GL_MULTISAMPLE);
 #endif
 
 #ifdef IMGUI_IMPL_HAS_POLYGON_MODE
@@ -331,86 +789,493 @@ void ImGui_ImplQtOpenGL3::RenderDrawData(ImDrawData* draw_data)
 #endif
     glViewport(last_viewport[0], last_viewport[1], (GLsizei)last_viewport[2], (GLsizei)last_viewport[3]);
     glScissor(last_scissor_box[0], last_scissor_box[1], (GLsizei)last_scissor_box[2], (GLsizei)last_scissor_box[3]);
+    glClearColor(last_clear_color[0], last_clear_color[1], last_clear_color[2], last_clear_color[3]);
     (void)bd; // Not all compilation paths use this
 }
 
-bool ImGui_ImplQtOpenGL3::CreateFontsTexture(ImGuiIO& io)
+static inline ImVec4 ImGui_ImplQtOpenGL3_UnionRect(const ImVec4& a, const ImVec4& b)
+{
+    if (a.z <= a.x || a.w <= a.y) return b;
+    if (b.z <= b.x || b.w <= b.y) return a;
+    return ImVec4(ImMin(a.x, b.x), ImMin(a.y, b.y), ImMax(a.z, b.z), ImMax(a.w, b.w));
+}
+
+// Marks the commands of ImGui_ImplQtOpenGL3_AddPlotSeries(), RenderDrawList() draws them itself
+static void ImGui_ImplQtOpenGL3_PlotCallback(const ImDrawList*, const ImDrawCmd*)
+{
+}
+
+template<typename Features, bool BufferSubData>
+void ImGui_ImplQtOpenGL3::RenderDrawList(ImDrawData* draw_data, int n, const ImVec4& clip_rect, const ImVec2& target_origin, int target_height, int fb_width, int fb_height, GLuint vertex_array_object)
 {
     auto bd = this;
-    // Build texture atlas
-    unsigned char* pixels;
-    int width, height;
-    io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);   // Load as RGBA 32-bit (75% of the memory is wasted, but default font is so small) because it is more likely to be compatible with user's existing shaders. If your ImTextureId represent a higher-level concept than just a GL texture id, consider calling GetTexDataAsAlpha8() instead to save on GPU memory.
+    const ImDrawList* cmd_list = draw_data->CmdLists[n];
 
-    // Upload texture to graphics system
-    // (Bilinear sampling is required by default. Set 'io.Fonts->Flags |= ImFontAtlasFlags_NoBakedLines' or 'style.AntiAliasedLinesUseTex = false' to allow point/nearest sampling)
-    GLint last_texture;
-    GL_CALL(glGetIntegerv(GL_TEXTURE_BINDING_2D, &last_texture));
-    GL_CALL(glGenTextures(1, &bd->FontTexture));
-    GL_CALL(glBindTexture(GL_TEXTURE_2D, bd->FontTexture));
-    GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
-    GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
-#ifdef GL_UNPACK_ROW_LENGTH // Not on WebGL/ES
-    GL_CALL(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
-#endif
-    GL_CALL(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels));
+    // Will project scissor/clipping rectangles into framebuffer space
+    ImVec2 clip_off = draw_data->DisplayPos;         // (0,0) unless using multi-viewports
+    ImVec2 clip_scale = draw_data->FramebufferScale; // (1,1) unless using retina display which are often (2,2)
 
-    // Store our identifier
-    io.Fonts->SetTexID((ImTextureID)(intptr_t)bd->FontTexture);
+    // Buffer cache: every draw list owns its buffers, only lists whose content hash changed are uploaded
+    const ImGui_ImplQtOpenGL3_CachedBuffers* cached = bd->UseBufferCache ? bd->Buffers.Lookup(cmd_list, bd->DrawListHashes[n]) : nullptr;
+    bool compact = cached ? cached->Compact : false;
+    ImVec2 vtx_origin = cached ? cached->VtxOrigin : ImVec2(0.0f, 0.0f);
 
-    // Restore state
-    GL_CALL(glBindTexture(GL_TEXTURE_2D, last_texture));
+    // Compact vertex format: 12 bytes per vertex instead of 20, when the list bounds and UVs fit
+    const GLvoid* vtx_data = (const GLvoid*)cmd_list->VtxBuffer.Data;
+    GLsizeiptr vtx_buffer_size = (GLsizeiptr)cmd_list->VtxBuffer.Size * (int)sizeof(ImDrawVert);
+    if (!cached && bd->UseCompactVertices && ImGui_ImplQtOpenGL3_GetCompactOrigin(cmd_list->VtxBuffer.Data, cmd_list->VtxBuffer.Size, &vtx_origin))
+    {
+        bd->CompactVertices.resize(cmd_list->VtxBuffer.Size);
+        ImGui_ImplQtOpenGL3_ConvertCompact(cmd_list->VtxBuffer.Data, cmd_list->VtxBuffer.Size, vtx_origin, bd->CompactVertices.Data);
+        vtx_data = (const GLvoid*)bd->CompactVertices.Data;
+        vtx_buffer_size = (GLsizeiptr)cmd_list->VtxBuffer.Size * (int)sizeof(ImGui_ImplQtOpenGL3_CompactVert);
+        compact = true;
+        bd->CompactLists++;
+        bd->CompactBytesSaved += (size_t)cmd_list->VtxBuffer.Size * (sizeof(ImDrawVert) - sizeof(ImGui_ImplQtOpenGL3_CompactVert));
+    }
+    if (!cached && bd->UseBufferCache)
+        cached = &bd->Buffers.Upload(cmd_list, bd->DrawListHashes[n], vtx_data, vtx_buffer_size, compact, vtx_origin);
+    const GLuint vbo = cached ? cached->VboHandle : bd->VboHandle;
+    const GLuint ibo = cached ? cached->ElementsHandle : bd->ElementsHandle;
+    BindDrawListBuffers(vbo, ibo, compact, vtx_origin);
+
+    // Upload vertex/index buffers
+    // - OpenGL drivers are in a very sorry state nowadays....
+    //   During 2021 we attempted to switch from glBufferData() to orphaning+glBufferSubData() following reports
+    //   of leaks on Intel GPU when using multi-viewports on Windows.
+    // - After this we kept hearing of various display corruptions issues. We started disabling on non-Intel GPU, but issues still got reported on Intel.
+    // - We are now back to using exclusively glBufferData(). So BufferSubData (bd->UseBufferSubData) IS ALWAYS FALSE in this code.
+    //   We are keeping the old code path for a while in case people finding new issues may want to test the BufferSubData path.
+    // - See https://github.com/ocornut/imgui/issues/4468 and please report any corruption issues.
+    const GLsizeiptr idx_buffer_size = (GLsizeiptr)cmd_list->IdxBuffer.Size * (int)sizeof(ImDrawIdx);
+    if (cached)
+    {
+        // Uploaded by the buffer cache above
+    }
+    else if (BufferSubData)
+    {
+        if (bd->VertexBufferSize < vtx_buffer_size)
+        {
+            bd->Memory.Reallocate(ImGui_ImplQtOpenGL3_MemoryCategory_VertexBuffers, (size_t)bd->VertexBufferSize, (size_t)vtx_buffer_size);
+            bd->VertexBufferSize = vtx_buffer_size;
+            GL_CALL(glBufferData(GL_ARRAY_BUFFER, bd->VertexBufferSize, nullptr, GL_STREAM_DRAW));
+        }
+        if (bd->IndexBufferSize < idx_buffer_size)
+        {
+            bd->Memory.Reallocate(ImGui_ImplQtOpenGL3_MemoryCategory_IndexBuffers, (size_t)bd->IndexBufferSize, (size_t)idx_buffer_size);
+            bd->IndexBufferSize = idx_buffer_size;
+            GL_CALL(glBufferData(GL_ELEMENT_ARRAY_BUFFER, bd->IndexBufferSize, nullptr, GL_STREAM_DRAW));
+        }
+        bd->VertexBufferUsage.Use((size_t)vtx_buffer_size);
+        bd->IndexBufferUsage.Use((size_t)idx_buffer_size);
+        GL_CALL(glBufferSubData(GL_ARRAY_BUFFER, 0, vtx_buffer_size, vtx_data));
+        GL_CALL(glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, idx_buffer_size, (const GLvoid*)cmd_list->IdxBuffer.Data));
+    }
+    else
+    {
+        GL_CALL(glBufferData(GL_ARRAY_BUFFER, vtx_buffer_size, vtx_data, GL_STREAM_DRAW));
+        GL_CALL(glBufferData(GL_ELEMENT_ARRAY_BUFFER, idx_buffer_size, (const GLvoid*)cmd_list->IdxBuffer.Data, GL_STREAM_DRAW));
+        bd->Memory.Reallocate(ImGui_ImplQtOpenGL3_MemoryCategory_VertexBuffers, (size_t)bd->VertexBufferSize, (size_t)vtx_buffer_size);
+        bd->Memory.Reallocate(ImGui_ImplQtOpenGL3_MemoryCategory_IndexBuffers, (size_t)bd->IndexBufferSize, (size_t)idx_buffer_size);
+        bd->VertexBufferSize = vtx_buffer_size;
+        bd->IndexBufferSize = idx_buffer_size;
+    }
 
-    return true;
+    // Project, clamp and cull all commands up front, the submission loop only walks the compiled array
+    ImGui_ImplQtOpenGL3_CommandStats command_stats = {};
+    ImGui_ImplQtOpenGL3_CompileCommands(cmd_list, clip_off, clip_scale, clip_rect, target_origin, target_height, &bd->RenderCmds, &command_stats);
+    bd->CommandsCulled += command_stats.Culled;
+    bd->CommandsMerged += command_stats.Merged;
+
+    for (const ImGui_ImplQtOpenGL3_RenderCmd& cmd : bd->RenderCmds)
+    {
+        if (cmd.Callback != nullptr)
+        {
+            // User callback, registered via ImDrawList::AddCallback()
+            // (ImDrawCallback_ResetRenderState is a special callback value used by the user to request the renderer to reset render state.)
+            if (cmd.Callback->UserCallback == ImDrawCallback_ResetRenderState)
+            {
+                SetupRenderState<Features>(draw_data, fb_width, fb_height, vertex_array_object);
+                BindDrawListBuffers(vbo, ibo, compact, vtx_origin);
+            }
+            else if (cmd.Callback->UserCallback == ImGui_ImplQtOpenGL3_PlotCallback)
+            {
+                //曲线用自己的着色器和顶点缓冲区,画完换回默认着色器和绘制列表的缓冲区
+                RenderPlot(cmd.Callback, clip_off, clip_scale, clip_rect, target_origin, target_height);
+                UseProgram(bd->ShaderHandle);
+                BindDrawListBuffers(vbo, ibo, compact, vtx_origin);
+            }
+            else
+                cmd.Callback->UserCallback(cmd_list, cmd.Callback);
+            continue;
+        }
+
+        // Apply scissor/clipping rectangle and texture only when they changed
+        if (cmd.Flags & ImGui_ImplQtOpenGL3_RenderCmdFlags_SetScissor)
+            GL_CALL(glScissor(cmd.Scissor[0], cmd.Scissor[1], cmd.Scissor[2], cmd.Scissor[3]));
+        if (cmd.Flags & ImGui_ImplQtOpenGL3_RenderCmdFlags_BindTexture)
+        {
+            GL_CALL(glBindTexture(GL_TEXTURE_2D, (GLuint)(intptr_t)cmd.TextureId));
+            //距离场字体纹理使用单独的着色器,其余纹理用默认着色器
+            if (bd->ShaderHandleSdf)
+                UseProgram(bd->FontTextureSdf && cmd.TextureId == (ImTextureID)(intptr_t)bd->FontTexture ? bd->ShaderHandleSdf : bd->ShaderHandle);
+        }
+
+        // Draw
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_VTX_OFFSET
+        if (Features::VtxOffset)
+            GL_CALL(glDrawElementsBaseVertex(GL_TRIANGLES, (GLsizei)cmd.ElemCount, sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, (void*)(intptr_t)(cmd.IdxOffset * sizeof(ImDrawIdx)), (GLint)cmd.VtxOffset));
+        else
+#endif
+            GL_CALL(glDrawElements(GL_TRIANGLES, (GLsizei)cmd.ElemCount, sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, (void*)(intptr_t)(cmd.IdxOffset * sizeof(ImDrawIdx))));
+        bd->DrawCalls++;
+        if (bd->ActiveProgram == bd->ShaderHandleSdf)
+            bd->SdfDrawCalls++;
+    }
 }
 
-void ImGui_ImplQtOpenGL3::DestoryFontsTexture(ImGuiIO& io)
+ImGui_ImplQtOpenGL3_Layer* ImGui_ImplQtOpenGL3::AcquireLayer(ImDrawData* draw_data, int n, int fb_width, int fb_height, bool* needs_render)
 {
     auto bd = this;
-    if (bd->FontTexture)
+    const ImDrawList* cmd_list = draw_data->CmdLists[n];
+    if (cmd_list->VtxBuffer.Size < bd->Layers.MinVertices)
+        return nullptr;
+
+    const ImVec2 clip_off = draw_data->DisplayPos;
+    const ImVec2 clip_scale = draw_data->FramebufferScale;
+    ImVec4 bounds;
+    bool textures_changed = false;
+    for (int cmd_i = 0; cmd_i < cmd_list->CmdBuffer.Size; cmd_i++)
     {
-        glDeleteTextures(1, &bd->FontTexture);
-        io.Fonts->SetTexID(0);
-        bd->FontTexture = 0;
+        //用户回调每帧都可能画出不同内容,不能缓存
+        const ImDrawCmd* pcmd = &cmd_list->CmdBuffer[cmd_i];
+        if (pcmd->UserCallback != nullptr)
+            return nullptr;
+        const ImVec4 clip((pcmd->ClipRect.x - clip_off.x) * clip_scale.x, (pcmd->ClipRect.y - clip_off.y) * clip_scale.y,
+            (pcmd->ClipRect.z - clip_off.x) * clip_scale.x, (pcmd->ClipRect.w - clip_off.y) * clip_scale.y);
+        bounds = ImGui_ImplQtOpenGL3_UnionRect(bounds, clip);
+        if (bd->DirtyTextures.contains(pcmd->GetTexID()))
+            textures_changed = true;
     }
+
+    //对齐到整像素,图层纹理与帧缓冲像素一一对应
+    bounds = ImVec4(ImMax(floorf(bounds.x), 0.0f), ImMax(floorf(bounds.y), 0.0f), ImMin(ceilf(bounds.z), (float)fb_width), ImMin(ceilf(bounds.w), (float)fb_height));
+    if (bounds.z <= bounds.x || bounds.w <= bounds.y)
+        return nullptr;
+
+    // ImDrawCmd is zero-initialized including its padding, so hashing raw commands is stable
+    const ImU64 hash = ImGui_ImplQt_HashData(cmd_list->CmdBuffer.Data, (size_t)cmd_list->CmdBuffer.size_in_bytes(), bd->DrawListHashes[n]);
+    return bd->Layers.Acquire(cmd_list, bounds, hash, textures_changed, needs_render);
 }
 
-bool ImGui_ImplQtOpenGL3::CreateDeviceObjects(ImGuiIO& io)
+template<typename Features, bool BufferSubData>
+void ImGui_ImplQtOpenGL3::RenderLayer(ImDrawData* draw_data, int n, const ImGui_ImplQtOpenGL3_Layer& layer, GLuint target_framebuffer, int fb_width, int fb_height, GLuint vertex_array_object)
 {
-    auto bd = this;
+    const ImVec2 clip_off = draw_data->DisplayPos;
+    const ImVec2 clip_scale = draw_data->FramebufferScale;
+    GL_CALL(glBindFramebuffer(GL_FRAMEBUFFER, layer.Framebuffer));
+    GL_CALL(glScissor(0, 0, layer.Width, layer.Height));
+    GL_CALL(glClearColor(0.0f, 0.0f, 0.0f, 0.0f));
+    GL_CALL(glClear(GL_COLOR_BUFFER_BIT));
+
+    //从透明背景开始按常规混合方式绘制,得到的就是预乘alpha的结果
+    SetupProjection(ImVec2(clip_off.x + layer.Bounds.x / clip_scale.x, clip_off.y + layer.Bounds.y / clip_scale.y),
+        ImVec2((float)layer.Width / clip_scale.x, (float)layer.Height / clip_scale.y), layer.Width, layer.Height);
+    RenderDrawList<Features, BufferSubData>(draw_data, n, layer.Bounds, ImVec2(layer.Bounds.x, layer.Bounds.y), layer.Height, fb_width, fb_height, vertex_array_object);
+
+    GL_CALL(glBindFramebuffer(GL_FRAMEBUFFER, target_framebuffer));
+    SetupProjection(draw_data->DisplayPos, draw_data->DisplaySize, fb_width, fb_height);
+}
 
-    // Backup GL state
-    GLint last_texture, last_array_buffer;
-    glGetIntegerv(GL_TEXTURE_BINDING_2D, &last_texture);
-    glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &last_array_buffer);
-#ifdef IMGUI_IMPL_OPENGL_USE_VERTEX_ARRAY
-    GLint last_vertex_array;
-    glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &last_vertex_array);
-#endif
+void ImGui_ImplQtOpenGL3::CompositeLayer(ImDrawData* draw_data, const ImGui_ImplQtOpenGL3_Layer& layer, const ImVec4& clip_rect, int fb_height)
+{
+    auto bd = this;
+    const ImVec2 clip_min(ImMax(layer.Bounds.x, clip_rect.x), ImMax(layer.Bounds.y, clip_rect.y));
+    const ImVec2 clip_max(ImMin(layer.Bounds.z, clip_rect.z), ImMin(layer.Bounds.w, clip_rect.w));
+    if (clip_max.x <= clip_min.x || clip_max.y <= clip_min.y)
+        return;
 
-    // Parse GLSL version string
-    int glsl_version = 130;
-    sscanf(bd->GlslVersionString, "#version %d", &glsl_version);
+    //纹理的第0行是图层底部,合成时上下翻转
+    const ImVec2 clip_off = draw_data->DisplayPos;
+    const ImVec2 clip_scale = draw_data->FramebufferScale;
+    const ImVec2 p_min(clip_off.x + layer.Bounds.x / clip_scale.x, clip_off.y + layer.Bounds.y / clip_scale.y);
+    const ImVec2 p_max(clip_off.x + layer.Bounds.z / clip_scale.x, clip_off.y + layer.Bounds.w / clip_scale.y);
+    //单位四边形经顶点变换拉伸到图层矩形,不占用流式缓冲区
+    UseProgram(bd->ShaderHandle);
+    BindDrawListBuffers(bd->QuadVboHandle, bd->QuadElementsHandle, false, ImVec2(0.0f, 0.0f));
+    SetupVertexTransform(p_min, ImVec2(1.0f / (p_max.x - p_min.x), 1.0f / (p_max.y - p_min.y)));
+    const size_t first_index = bd->ClipOriginLowerLeft ? 6 : 0;
+
+    GL_CALL(glScissor((int)clip_min.x, (int)((float)fb_height - clip_max.y), (int)(clip_max.x - clip_min.x), (int)(clip_max.y - clip_min.y)));
+    GL_CALL(glBindTexture(GL_TEXTURE_2D, layer.Texture));
+    GL_CALL(glBlendFuncSeparate(GL_ONE, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA));
+    GL_CALL(glDrawElements(GL_TRIANGLES, 6, sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, (void*)(first_index * sizeof(ImDrawIdx))));
+    bd->DrawCalls++;
+    GL_CALL(glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA));
+}
 
-    const GLchar* vertex_shader_glsl_120 =
-        "uniform mat4 ProjMtx;\n"
-        "attribute vec2 Position;\n"
-        "attribute vec2 UV;\n"
-        "attribute vec4 Color;\n"
-        "varying vec2 Frag_UV;\n"
-        "varying vec4 Frag_Color;\n"
-        "void main()\n"
-        "{\n"
-        "    Frag_UV = UV;\n"
-        "    Frag_Color = Color;\n"
-        "    gl_Position = ProjMtx * vec4(Position.xy,0,1);\n"
-        "}\n";
+// Draws the series of one ImGui_ImplQtOpenGL3_AddPlotSeries() command clipped to its clip rectangle and plot area.
+// The vertex count depends on the plot width only: the level is chosen so that there are at most two slots per pixel column.
+void ImGui_ImplQtOpenGL3::RenderPlot(const ImDrawCmd* pcmd, const ImVec2& clip_off, const ImVec2& clip_scale, const ImVec4& clip_rect, const ImVec2& target_origin, int target_height)
+{
+    auto bd = this;
+    const int index = (int)(intptr_t)pcmd->UserCallbackData - 1;
+    if (index < 0 || index >= bd->Plots.Draws.Size || bd->Plots.Draws[index].Series == nullptr)
+        return;
+    const ImGui_ImplQtOpenGL3_PlotDraw& draw = bd->Plots.Draws[index];
 
-    const GLchar* vertex_shader_glsl_130 =
-        "uniform mat4 ProjMtx;\n"
-        "in vec2 Position;\n"
-        "in vec2 UV;\n"
-        "in vec4 Color;\n"
+    const float x0 = ImMax((ImMax(pcmd->ClipRect.x, draw.Rect.x) - clip_off.x) * clip_scale.x, clip_rect.x);
+    const float y0 = ImMax((ImMax(pcmd->ClipRect.y, draw.Rect.y) - clip_off.y) * clip_scale.y, clip_rect.y);
+    const float x1 = ImMin((ImMin(pcmd->ClipRect.z, draw.Rect.z) - clip_off.x) * clip_scale.x, clip_rect.z);
+    const float y1 = ImMin((ImMin(pcmd->ClipRect.w, draw.Rect.w) - clip_off.y) * clip_scale.y, clip_rect.w);
+    if (x1 <= x0 || y1 <= y0)
+    {
+        bd->CommandsCulled++;
+        return;
+    }
+    GL_CALL(glScissor((int)(x0 - target_origin.x), (int)((float)target_height + target_origin.y - y1), (int)(x1 - x0), (int)(y1 - y0)));
+
+    const ImGui_ImplQtOpenGL3_PlotRange range = ImGui_ImplQtOpenGL3_PlotSeriesSet::SelectLevel(draw, (draw.Rect.z - draw.Rect.x) * clip_scale.x);
+    const ImGui_ImplQtOpenGL3_PlotLevel& level = draw.Series->Levels[range.Level];
+    const ImVec2 transform = ImGui_ImplQtOpenGL3_PlotSeriesSet::ValueTransform(draw);
+    const ImVec4 color = ImGui::ColorConvertU32ToFloat4(draw.Color);
+    UseProgram(bd->ShaderHandlePlot);
+    SetupVertexTransform(ImVec2(0.0f, 0.0f), 1.0f);
+    glUniform4f(bd->AttribLocationPlotTransform, range.X0, range.XStep, transform.x, transform.y);
+    glUniform4f(bd->AttribLocationPlotColor, color.x, color.y, color.z, color.w);
+
+    GL_CALL(glDisableVertexAttribArray(bd->AttribLocationVtxPos));
+    GL_CALL(glDisableVertexAttribArray(bd->AttribLocationVtxUV));
+    GL_CALL(glDisableVertexAttribArray(bd->AttribLocationVtxColor));
+    GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, level.Buffer));
+    GL_CALL(glEnableVertexAttribArray(bd->AttribLocationPlotValue));
+    GL_CALL(glVertexAttribPointer(bd->AttribLocationPlotValue, 1, GL_FLOAT, GL_FALSE, 0, (GLvoid*)0));
+    if (level.Stride == 1)
+    {
+        DrawPlotRange(GL_LINE_STRIP, level, range);
+    }
+    else
+    {
+        //包络: 最小/最大值交替排列,三角形带填充区间,折线保证平坦处仍有一个像素宽
+        DrawPlotRange(GL_TRIANGLE_STRIP, level, range);
+        DrawPlotRange(GL_LINE_STRIP, level, range);
+    }
+    GL_CALL(glDisableVertexAttribArray(bd->AttribLocationPlotValue));
+    GL_CALL(glEnableVertexAttribArray(bd->AttribLocationVtxPos));
+    GL_CALL(glEnableVertexAttribArray(bd->AttribLocationVtxUV));
+    GL_CALL(glEnableVertexAttribArray(bd->AttribLocationVtxColor));
+    bd->PlotSeriesDrawn++;
+}
+
+// A range that wraps around the ring is drawn from its first slot to the mirror of slot 0, then from slot 0 on
+void ImGui_ImplQtOpenGL3::DrawPlotRange(GLenum mode, const ImGui_ImplQtOpenGL3_PlotLevel& level, const ImGui_ImplQtOpenGL3_PlotRange& range)
+{
+    auto bd = this;
+    const int stride = level.Stride;
+    const int first = (int)(range.FirstBlock % level.Capacity);
+    const int head = (int)ImMin(range.Blocks, (ImS64)(level.Capacity + 1 - first));
+    glUniform2i(bd->AttribLocationPlotSlots, -stride * first, stride);
+    GL_CALL(glDrawArrays(mode, stride * first, stride * head));
+    bd->DrawCalls++;
+    bd->PlotVertices += stride * head;
+    if (range.Blocks > head)
+    {
+        const int tail = (int)(range.Blocks - head) + 1;
+        glUniform2i(bd->AttribLocationPlotSlots, stride * (level.Capacity - first), stride);
+        GL_CALL(glDrawArrays(mode, 0, stride * tail));
+        bd->DrawCalls++;
+        bd->PlotVertices += stride * tail;
+    }
+}
+
+void ImGui_ImplQtOpenGL3::HashDrawLists(ImDrawData* draw_data)
+{
+    auto bd = this;
+    bd->DrawListHashes.resize(draw_data->CmdListsCount);
+    for (int n = 0; n < draw_data->CmdListsCount; n++)
+    {
+        const ImDrawList* cmd_list = draw_data->CmdLists[n];
+        ImU64 hash = ImGui_ImplQt_HashData(cmd_list->VtxBuffer.Data, (size_t)cmd_list->VtxBuffer.size_in_bytes());
+        bd->DrawListHashes[n] = ImGui_ImplQt_HashData(cmd_list->IdxBuffer.Data, (size_t)cmd_list->IdxBuffer.size_in_bytes(), hash);
+    }
+}
+
+ImVec4 ImGui_ImplQtOpenGL3::ComputeDamage(ImDrawData* draw_data, int fb_width, int fb_height)
+{
+    auto bd = this;
+    const ImVec2 clip_off = draw_data->DisplayPos;
+    const ImVec2 clip_scale = draw_data->FramebufferScale;
+    const ImVec4 full(0.0f, 0.0f, (float)fb_width, (float)fb_height);
+
+    //帧缓冲尺寸或显示原点变化后原有内容不可复用,需要整帧重绘
+    const bool full_redraw = bd->LastFramebufferSize.x != (float)fb_width || bd->LastFramebufferSize.y != (float)fb_height
+        || bd->LastDisplayPos.x != clip_off.x || bd->LastDisplayPos.y != clip_off.y;
+    bd->LastFramebufferSize = ImVec2((float)fb_width, (float)fb_height);
+    bd->LastDisplayPos = clip_off;
+
+    QHash<const ImDrawList*, ImGui_ImplQtOpenGL3_DrawListState> states;
+    states.reserve(draw_data->CmdListsCount);
+    bd->DrawListRects.resize(draw_data->CmdListsCount);
+
+    ImVec4 damage;
+    int changed = 0;
+    for (int n = 0; n < draw_data->CmdListsCount; n++)
+    {
+        const ImDrawList* cmd_list = draw_data->CmdLists[n];
+        ImGui_ImplQtOpenGL3_DrawListState state;
+        // ImDrawCmd is zero-initialized including its padding, so hashing raw commands is stable
+        state.Hash = ImGui_ImplQt_HashData(cmd_list->CmdBuffer.Data, (size_t)cmd_list->CmdBuffer.size_in_bytes(), bd->DrawListHashes[n]);
+        state.Index = n;
+
+        bool has_callback = false;
+        for (int cmd_i = 0; cmd_i < cmd_list->CmdBuffer.Size; cmd_i++)
+        {
+            const ImDrawCmd* pcmd = &cmd_list->CmdBuffer[cmd_i];
+            ImVec4 clip((pcmd->ClipRect.x - clip_off.x) * clip_scale.x, (pcmd->ClipRect.y - clip_off.y) * clip_scale.y,
+                (pcmd->ClipRect.z - clip_off.x) * clip_scale.x, (pcmd->ClipRect.w - clip_off.y) * clip_scale.y);
+            clip = ImVec4(ImMax(clip.x, full.x), ImMax(clip.y, full.y), ImMin(clip.z, full.z), ImMin(clip.w, full.w));
+            state.Bounds = ImGui_ImplQtOpenGL3_UnionRect(state.Bounds, clip);
+            if (pcmd->UserCallback != nullptr)
+                has_callback = true;
+            else if (bd->DirtyTextures.contains(pcmd->GetTexID()))
+                damage = ImGui_ImplQtOpenGL3_UnionRect(damage, clip);   //纹理内容变化,只重绘使用它的区域
+        }
+        bd->DrawListRects[n] = state.Bounds;
+
+        //内容、绘制顺序变化或包含用户回调(每帧都可能画出不同内容)时,新旧区域都需要重绘
+        auto prev = bd->DrawListStates.constFind(cmd_list);
+        if (prev == bd->DrawListStates.constEnd() || prev->Hash != state.Hash || prev->Index != n || has_callback)
+        {
+            damage = ImGui_ImplQtOpenGL3_UnionRect(damage, state.Bounds);
+            if (prev != bd->DrawListStates.constEnd())
+                damage = ImGui_ImplQtOpenGL3_UnionRect(damage, prev->Bounds);
+            changed++;
+        }
+        states.insert(cmd_list, state);
+    }
+
+    //本帧不再出现的绘制列表,原先覆盖的区域同样需要重绘
+    for (auto it = bd->DrawListStates.constBegin(); it != bd->DrawListStates.constEnd(); ++it)
+    {
+        if (!states.contains(it.key()))
+            damage = ImGui_ImplQtOpenGL3_UnionRect(damage, it->Bounds);
+    }
+    bd->DrawListStates = states;
+
+    if (full_redraw)
+        damage = full;
+    if (damage.z > damage.x && damage.w > damage.y)
+        damage = ImVec4(ImMax(floorf(damage.x), 0.0f), ImMax(floorf(damage.y), 0.0f), ImMin(ceilf(damage.z), full.z), ImMin(ceilf(damage.w), full.w));
+    else
+        damage = ImVec4();
+
+    bd->FrameStats.DamageRect = damage;
+    bd->FrameStats.DamageRatio = ((damage.z - damage.x) * (damage.w - damage.y)) / (full.z * full.w);
+    bd->FrameStats.DrawListsChanged = changed;
+    return damage;
+}
+
+bool ImGui_ImplQtOpenGL3::CreateFontsTexture(ImGuiIO& io)
+{
+    auto bd = this;
+    unsigned char* pixels;
+    int width, height;
+    if (!io.Fonts->TexPixelsAlpha8 && !io.Fonts->TexPixelsRGBA32 && !bd->FontPixels.empty()
+        && bd->FontPixelsWidth == io.Fonts->TexWidth && bd->FontPixelsHeight == io.Fonts->TexHeight)
+    {
+        //上下文丢失前读回的字体纹理,图集的字形数据仍然有效,不必重新构建
+        pixels = bd->FontPixels.Data;
+        width = bd->FontPixelsWidth;
+        height = bd->FontPixelsHeight;
+    }
+    else
+    {
+        // Build texture atlas
+        if (!io.Fonts->TexPixelsAlpha8 && !io.Fonts->TexPixelsRGBA32)
+            ImGui_ImplQt_BuildFontAtlas(io.Fonts);
+        io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);   // Load as RGBA 32-bit (75% of the memory is wasted, but default font is so small) because it is more likely to be compatible with user's existing shaders. If your ImTextureId represent a higher-level concept than just a GL texture id, consider calling GetTexDataAsAlpha8() instead to save on GPU memory.
+    }
+
+    // Upload texture to graphics system
+    // (Bilinear sampling is required by default. Set 'io.Fonts->Flags |= ImFontAtlasFlags_NoBakedLines' or 'style.AntiAliasedLinesUseTex = false' to allow point/nearest sampling)
+    GLint last_texture;
+    GL_CALL(glGetIntegerv(GL_TEXTURE_BINDING_2D, &last_texture));
+    GL_CALL(glGenTextures(1, &bd->FontTexture));
+    GL_CALL(glBindTexture(GL_TEXTURE_2D, bd->FontTexture));
+    GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+    GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+#ifdef GL_UNPACK_ROW_LENGTH // Not on WebGL/ES
+    GLint last_unpack_row_length;
+    GL_CALL(glGetIntegerv(GL_UNPACK_ROW_LENGTH, &last_unpack_row_length));
+    GL_CALL(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+#endif
+    GL_CALL(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels));
+#ifdef GL_UNPACK_ROW_LENGTH
+    GL_CALL(glPixelStorei(GL_UNPACK_ROW_LENGTH, last_unpack_row_length));
+#endif
+    bd->FontTextureBytes = (size_t)width * (size_t)height * 4;
+    bd->Memory.Allocate(ImGui_ImplQtOpenGL3_MemoryCategory_Textures, bd->FontTextureBytes);
+
+    // Store our identifier
+    io.Fonts->SetTexID((ImTextureID)(intptr_t)bd->FontTexture);
+    bd->FontTextureSdf = ImGui_ImplQt_IsFontAtlasSdf(io.Fonts);
+
+    // Restore state
+    GL_CALL(glBindTexture(GL_TEXTURE_2D, last_texture));
+    bd->FontPixels.clear();
+
+    return true;
+}
+
+void ImGui_ImplQtOpenGL3::DestoryFontsTexture(ImGuiIO& io)
+{
+    auto bd = this;
+    if (bd->FontTexture)
+    {
+        glDeleteTextures(1, &bd->FontTexture);
+        io.Fonts->SetTexID(0);
+        bd->FontTexture = 0;
+        bd->Memory.Free(ImGui_ImplQtOpenGL3_MemoryCategory_Textures, bd->FontTextureBytes);
+        bd->FontTextureBytes = 0;
+    }
+}
+
+bool ImGui_ImplQtOpenGL3::CreateDeviceObjects(ImGuiIO& io)
+{
+    auto bd = this;
+
+    // Backup GL state
+    GLint last_texture, last_array_buffer;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &last_texture);
+    glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &last_array_buffer);
+#ifdef IMGUI_IMPL_OPENGL_USE_VERTEX_ARRAY
+    GLint last_vertex_array;
+    glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &last_vertex_array);
+#endif
+
+    // Parse GLSL version string
+    int glsl_version = 130;
+    sscanf(bd->GlslVersionString, "#version %d", &glsl_version);
+
+    const GLchar* vertex_shader_glsl_120 =
+        "uniform mat4 ProjMtx;\n"
+        "attribute vec2 Position;\n"
+        "attribute vec2 UV;\n"
+        "attribute vec4 Color;\n"
+        "varying vec2 Frag_UV;\n"
+        "varying vec4 Frag_Color;\n"
+        "void main()\n"
+        "{\n"
+        "    Frag_UV = UV;\n"
+        "    Frag_Color = Color;\n"
+        "    gl_Position = ProjMtx * vec4(Position.xy,0,1);\n"
+        "}\n";
+
+    const GLchar* vertex_shader_glsl_130 =
+        "uniform mat4 ProjMtx;\n"
+        "in vec2 Position;\n"
+        "in vec2 UV;\n"
+        "in vec4 Color;\n"
         "out vec2 Frag_UV;\n"
         "out vec4 Frag_Color;\n"
         "void main()\n"
@@ -492,54 +1357,174 @@ bool ImGui_ImplQtOpenGL3::CreateDeviceObjects(ImGuiIO& io)
         "    Out_Color = Frag_Color * texture(Texture, Frag_UV.st);\n"
         "}\n";
 
+    // Distance field variants: alpha 0.5 is the outline, the edge is smoothed over about one framebuffer pixel at any scale
+    const GLchar* fragment_shader_sdf_glsl_120 =
+        "#ifdef GL_ES\n"
+        "#extension GL_OES_standard_derivatives : enable\n"
+        "    precision mediump float;\n"
+        "#endif\n"
+        "uniform sampler2D Texture;\n"
+        "varying vec2 Frag_UV;\n"
+        "varying vec4 Frag_Color;\n"
+        "void main()\n"
+        "{\n"
+        "    float d = texture2D(Texture, Frag_UV.st).a;\n"
+        "    float w = max(fwidth(d) * 0.5, 0.0001);\n"
+        "    gl_FragColor = vec4(Frag_Color.rgb, Frag_Color.a * smoothstep(0.5 - w, 0.5 + w, d));\n"
+        "}\n";
+
+    const GLchar* fragment_shader_sdf_glsl_130 =
+        "uniform sampler2D Texture;\n"
+        "in vec2 Frag_UV;\n"
+        "in vec4 Frag_Color;\n"
+        "out vec4 Out_Color;\n"
+        "void main()\n"
+        "{\n"
+        "    float d = texture(Texture, Frag_UV.st).a;\n"
+        "    float w = max(fwidth(d) * 0.5, 0.0001);\n"
+        "    Out_Color = vec4(Frag_Color.rgb, Frag_Color.a * smoothstep(0.5 - w, 0.5 + w, d));\n"
+        "}\n";
+
+    const GLchar* fragment_shader_sdf_glsl_300_es =
+        "precision mediump float;\n"
+        "uniform sampler2D Texture;\n"
+        "in vec2 Frag_UV;\n"
+        "in vec4 Frag_Color;\n"
+        "layout (location = 0) out vec4 Out_Color;\n"
+        "void main()\n"
+        "{\n"
+        "    float d = texture(Texture, Frag_UV.st).a;\n"
+        "    float w = max(fwidth(d) * 0.5, 0.0001);\n"
+        "    Out_Color = vec4(Frag_Color.rgb, Frag_Color.a * smoothstep(0.5 - w, 0.5 + w, d));\n"
+        "}\n";
+
+    const GLchar* fragment_shader_sdf_glsl_410_core =
+        "in vec2 Frag_UV;\n"
+        "in vec4 Frag_Color;\n"
+        "uniform sampler2D Texture;\n"
+        "layout (location = 0) out vec4 Out_Color;\n"
+        "void main()\n"
+        "{\n"
+        "    float d = texture(Texture, Frag_UV.st).a;\n"
+        "    float w = max(fwidth(d) * 0.5, 0.0001);\n"
+        "    Out_Color = vec4(Frag_Color.rgb, Frag_Color.a * smoothstep(0.5 - w, 0.5 + w, d));\n"
+        "}\n";
+
+    // Plot series: x follows the vertex index (gl_VertexID, GLSL 1.30+/3.00 ES), y the only attribute.
+    // A level 0 slot is one sample, a slot of the other levels a (min, max) pair drawn as two vertices. GLSL 4.10 core uses the 1.30 variants.
+    const GLchar* vertex_shader_plot_glsl_130 =
+        "uniform mat4 ProjMtx;\n"
+        "uniform vec4 Transform;\n"
+        "uniform ivec2 Slots;\n"
+        "in float Value;\n"
+        "void main()\n"
+        "{\n"
+        "    float slot = float((gl_VertexID + Slots.x) / Slots.y);\n"
+        "    gl_Position = ProjMtx * vec4(Transform.x + slot * Transform.y, Transform.z + Value * Transform.w, 0, 1);\n"
+        "}\n";
+
+    const GLchar* vertex_shader_plot_glsl_300_es =
+        "precision highp float;\n"
+        "precision highp int;\n"
+        "uniform mat4 ProjMtx;\n"
+        "uniform vec4 Transform;\n"
+        "uniform ivec2 Slots;\n"
+        "in float Value;\n"
+        "void main()\n"
+        "{\n"
+        "    float slot = float((gl_VertexID + Slots.x) / Slots.y);\n"
+        "    gl_Position = ProjMtx * vec4(Transform.x + slot * Transform.y, Transform.z + Value * Transform.w, 0, 1);\n"
+        "}\n";
+
+    const GLchar* fragment_shader_plot_glsl_130 =
+        "uniform vec4 Color;\n"
+        "out vec4 Out_Color;\n"
+        "void main()\n"
+        "{\n"
+        "    Out_Color = Color;\n"
+        "}\n";
+
+    const GLchar* fragment_shader_plot_glsl_300_es =
+        "precision mediump float;\n"
+        "uniform vec4 Color;\n"
+        "layout (location = 0) out vec4 Out_Color;\n"
+        "void main()\n"
+        "{\n"
+        "    Out_Color = Color;\n"
+        "}\n";
+
     // Select shaders matching our GLSL versions
     const GLchar* vertex_shader = nullptr;
     const GLchar* fragment_shader = nullptr;
+    const GLchar* fragment_shader_sdf = nullptr;
     if (glsl_version < 130)
     {
         vertex_shader = vertex_shader_glsl_120;
         fragment_shader = fragment_shader_glsl_120;
+        fragment_shader_sdf = fragment_shader_sdf_glsl_120;
     }
     else if (glsl_version >= 410)
     {
         vertex_shader = vertex_shader_glsl_410_core;
         fragment_shader = fragment_shader_glsl_410_core;
+        fragment_shader_sdf = fragment_shader_sdf_glsl_410_core;
     }
     else if (glsl_version == 300)
     {
         vertex_shader = vertex_shader_glsl_300_es;
         fragment_shader = fragment_shader_glsl_300_es;
+        fragment_shader_sdf = fragment_shader_sdf_glsl_300_es;
     }
     else
     {
         vertex_shader = vertex_shader_glsl_130;
         fragment_shader = fragment_shader_glsl_130;
+        fragment_shader_sdf = fragment_shader_sdf_glsl_130;
     }
 
-    // Create shaders
-    const GLchar* vertex_shader_with_version[2] = { bd->GlslVersionString, vertex_shader };
-    GLuint vert_handle = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vert_handle, 2, vertex_shader_with_version, nullptr);
-    glCompileShader(vert_handle);
-    CheckShader(vert_handle, "vertex shader");
-
-    const GLchar* fragment_shader_with_version[2] = { bd->GlslVersionString, fragment_shader };
-    GLuint frag_handle = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(frag_handle, 2, fragment_shader_with_version, nullptr);
-    glCompileShader(frag_handle);
-    CheckShader(frag_handle, "fragment shader");
-
-    // Link
     bd->ShaderHandle = glCreateProgram();
-    glAttachShader(bd->ShaderHandle, vert_handle);
-    glAttachShader(bd->ShaderHandle, frag_handle);
-    glLinkProgram(bd->ShaderHandle);
-    CheckProgram(bd->ShaderHandle, "shader program");
 
-    glDetachShader(bd->ShaderHandle, vert_handle);
-    glDetachShader(bd->ShaderHandle, frag_handle);
-    glDeleteShader(vert_handle);
-    glDeleteShader(frag_handle);
+    // Reuse the program binary saved when the previous context was lost, the driver may reject it
+    bool linked = false;
+#if !defined(IMGUI_IMPL_OPENGL_ES2) && !defined(IMGUI_IMPL_OPENGL_ES3)
+    if (bd->HasProgramBinary && !bd->ProgramBinary.empty())
+    {
+        GLint status = 0;
+        glProgramBinary(bd->ShaderHandle, bd->ProgramBinaryFormat, bd->ProgramBinary.Data, (GLsizei)bd->ProgramBinary.Size);
+        glGetProgramiv(bd->ShaderHandle, GL_LINK_STATUS, &status);
+        linked = (GLboolean)status == GL_TRUE;
+    }
+    if (bd->HasProgramBinary)
+        glProgramParameteri(bd->ShaderHandle, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+#endif
+    bd->ProgramBinary.clear();
+
+    if (!linked)
+    {
+        // Create shaders
+        const GLchar* vertex_shader_with_version[2] = { bd->GlslVersionString, vertex_shader };
+        GLuint vert_handle = glCreateShader(GL_VERTEX_SHADER);
+        glShaderSource(vert_handle, 2, vertex_shader_with_version, nullptr);
+        glCompileShader(vert_handle);
+        CheckShader(vert_handle, "vertex shader");
+
+        const GLchar* fragment_shader_with_version[2] = { bd->GlslVersionString, fragment_shader };
+        GLuint frag_handle = glCreateShader(GL_FRAGMENT_SHADER);
+        glShaderSource(frag_handle, 2, fragment_shader_with_version, nullptr);
+        glCompileShader(frag_handle);
+        CheckShader(frag_handle, "fragment shader");
+
+        // Link
+        glAttachShader(bd->ShaderHandle, vert_handle);
+        glAttachShader(bd->ShaderHandle, frag_handle);
+        glLinkProgram(bd->ShaderHandle);
+        CheckProgram(bd->ShaderHandle, "shader program");
+
+        glDetachShader(bd->ShaderHandle, vert_handle);
+        glDetachShader(bd->ShaderHandle, frag_handle);
+        glDeleteShader(vert_handle);
+        glDeleteShader(frag_handle);
+    }
 
     bd->AttribLocationTex = glGetUniformLocation(bd->ShaderHandle, "Texture");
     bd->AttribLocationProjMtx = glGetUniformLocation(bd->ShaderHandle, "ProjMtx");
@@ -547,11 +1532,27 @@ bool ImGui_ImplQtOpenGL3::CreateDeviceObjects(ImGuiIO& io)
     bd->AttribLocationVtxUV = (GLuint)glGetAttribLocation(bd->ShaderHandle, "UV");
     bd->AttribLocationVtxColor = (GLuint)glGetAttribLocation(bd->ShaderHandle, "Color");
 
+    bd->ProgramBytes = GetProgramBytes(bd->ShaderHandle);
+    bd->Memory.Allocate(ImGui_ImplQtOpenGL3_MemoryCategory_Programs, bd->ProgramBytes);
+
+    //只有距离场字体才需要第二个着色器
+    if (ImGui_ImplQt_IsFontAtlasSdf(io.Fonts))
+        CreateSdfProgram(vertex_shader, fragment_shader_sdf);
+    if (glsl_version >= 130)
+        CreatePlotProgram(glsl_version == 300 ? vertex_shader_plot_glsl_300_es : vertex_shader_plot_glsl_130, glsl_version == 300 ? fragment_shader_plot_glsl_300_es : fragment_shader_plot_glsl_130);
+
     // Create buffers
     glGenBuffers(1, &bd->VboHandle);
     glGenBuffers(1, &bd->ElementsHandle);
+    bd->VertexBufferSize = bd->IndexBufferSize = 0;
+    bd->Memory.Allocate(ImGui_ImplQtOpenGL3_MemoryCategory_VertexBuffers, 0);
+    bd->Memory.Allocate(ImGui_ImplQtOpenGL3_MemoryCategory_IndexBuffers, 0);
+    CreateQuadBuffers();
 
     CreateFontsTexture(io);
+    //应用持有的流纹理等对象在设备对象重建后恢复
+    bd->Streams.RestoreDeviceObjects();
+    bd->Plots.RestoreDeviceObjects();
 
     // Restore modified GL state
     glBindTexture(GL_TEXTURE_2D, last_texture);
@@ -566,9 +1567,23 @@ bool ImGui_ImplQtOpenGL3::CreateDeviceObjects(ImGuiIO& io)
 void ImGui_ImplQtOpenGL3::DestoryDeviceObjects(ImGuiIO& io)
 {
     auto bd = this;
-    if (bd->VboHandle) { glDeleteBuffers(1, &bd->VboHandle); bd->VboHandle = 0; }
-    if (bd->ElementsHandle) { glDeleteBuffers(1, &bd->ElementsHandle); bd->ElementsHandle = 0; }
-    if (bd->ShaderHandle) { glDeleteProgram(bd->ShaderHandle); bd->ShaderHandle = 0; }
+    if (bd->VboHandle) { glDeleteBuffers(1, &bd->VboHandle); bd->VboHandle = 0; bd->Memory.Free(ImGui_ImplQtOpenGL3_MemoryCategory_VertexBuffers, (size_t)bd->VertexBufferSize); }
+    if (bd->ElementsHandle) { glDeleteBuffers(1, &bd->ElementsHandle); bd->ElementsHandle = 0; bd->Memory.Free(ImGui_ImplQtOpenGL3_MemoryCategory_IndexBuffers, (size_t)bd->IndexBufferSize); }
+    if (bd->QuadVboHandle) { glDeleteBuffers(1, &bd->QuadVboHandle); bd->QuadVboHandle = 0; bd->Memory.Free(ImGui_ImplQtOpenGL3_MemoryCategory_VertexBuffers, ImGui_ImplQtOpenGL3_QuadVertexBytes); }
+    if (bd->QuadElementsHandle) { glDeleteBuffers(1, &bd->QuadElementsHandle); bd->QuadElementsHandle = 0; bd->Memory.Free(ImGui_ImplQtOpenGL3_MemoryCategory_IndexBuffers, ImGui_ImplQtOpenGL3_QuadIndexBytes); }
+    if (bd->ShaderHandle) { glDeleteProgram(bd->ShaderHandle); bd->ShaderHandle = 0; bd->Memory.Free(ImGui_ImplQtOpenGL3_MemoryCategory_Programs, bd->ProgramBytes); }
+    if (bd->ShaderHandleSdf) { glDeleteProgram(bd->ShaderHandleSdf); bd->ShaderHandleSdf = 0; bd->Memory.Free(ImGui_ImplQtOpenGL3_MemoryCategory_Programs, bd->ProgramSdfBytes); }
+    if (bd->ShaderHandlePlot) { glDeleteProgram(bd->ShaderHandlePlot); bd->ShaderHandlePlot = 0; bd->Memory.Free(ImGui_ImplQtOpenGL3_MemoryCategory_Programs, bd->ProgramPlotBytes); }
+    bd->VertexBufferSize = bd->IndexBufferSize = 0;
+    bd->ProgramBytes = bd->ProgramSdfBytes = bd->ProgramPlotBytes = 0;
+    bd->Textures.DestroyDeviceObjects();
+    bd->Streams.ReleaseDeviceObjects();
+    bd->Plots.ReleaseDeviceObjects();
+    bd->Atlas.ReleaseDeviceObjects();
+    bd->Buffers.DestroyDeviceObjects();
+    bd->Layers.DestroyDeviceObjects();
+    bd->Readback.DestroyDeviceObjects();
+    ReleaseFrameFences();
     ImGui_ImplQtOpenGL3_DestoryFontsTexture();
 }
 
@@ -581,6 +1596,7 @@ void ImGui_ImplQtOpenGL3::RenderWindow(ImGuiViewport* viewport)
     }
 }
 
+template<typename Features>
 bool ImGui_ImplQtOpenGL3::SetupRenderState(ImDrawData* draw_data, int fb_width, int fb_height, GLuint vertex_array_object)
 {
     auto bd = this;
@@ -594,7 +1610,7 @@ bool ImGui_ImplQtOpenGL3::SetupRenderState(ImDrawData* draw_data, int fb_width,
     glDisable(GL_STENCIL_TEST);
     glEnable(GL_SCISSOR_TEST);
 #ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_PRIMITIVE_RESTART
-    if (bd->GlVersion >= 310)
+    if (Features::PrimitiveRestart)
         glDisable(GL_PRIMITIVE_RESTART);
 #endif
 #ifdef IMGUI_IMPL_HAS_POLYGON_MODE
@@ -602,39 +1618,23 @@ bool ImGui_ImplQtOpenGL3::SetupRenderState(ImDrawData* draw_data, int fb_width,
 #endif
 
     // Support for GL 4.5 rarely used glClipControl(GL_UPPER_LEFT)
+    bd->ClipOriginLowerLeft = true;
 #if defined(GL_CLIP_ORIGIN)
-    bool clip_origin_lower_left = true;
-    if (bd->HasClipOrigin)
+    if (Features::ClipOrigin)
     {
         GLenum current_clip_origin = 0; glGetIntegerv(GL_CLIP_ORIGIN, (GLint*)&current_clip_origin);
         if (current_clip_origin == GL_UPPER_LEFT)
-            clip_origin_lower_left = false;
+            bd->ClipOriginLowerLeft = false;
     }
 #endif
 
-    // Setup viewport, orthographic projection matrix
-    // Our visible imgui space lies from draw_data->DisplayPos (top left) to draw_data->DisplayPos+data_data->DisplaySize (bottom right). DisplayPos is (0,0) for single viewport apps.
-    GL_CALL(glViewport(0, 0, (GLsizei)fb_width, (GLsizei)fb_height));
-    float L = draw_data->DisplayPos.x;
-    float R = draw_data->DisplayPos.x + draw_data->DisplaySize.x;
-    float T = draw_data->DisplayPos.y;
-    float B = draw_data->DisplayPos.y + draw_data->DisplaySize.y;
-#if defined(GL_CLIP_ORIGIN)
-    if (!clip_origin_lower_left) { float tmp = T; T = B; B = tmp; } // Swap top and bottom if origin is upper left
-#endif
-    const float ortho_projection[4][4] =
-    {
-        { 2.0f / (R - L),   0.0f,         0.0f,   0.0f },
-        { 0.0f,         2.0f / (T - B),   0.0f,   0.0f },
-        { 0.0f,         0.0f,        -1.0f,   0.0f },
-        { (R + L) / (L - R),  (T + B) / (B - T),  0.0f,   1.0f },
-    };
     glUseProgram(bd->ShaderHandle);
     glUniform1i(bd->AttribLocationTex, 0);
-    glUniformMatrix4fv(bd->AttribLocationProjMtx, 1, GL_FALSE, &ortho_projection[0][0]);
+    bd->ActiveProgram = bd->ShaderHandle;
+    SetupProjection(draw_data->DisplayPos, draw_data->DisplaySize, fb_width, fb_height);
 
 #ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_BIND_SAMPLER
-    if (bd->GlVersion >= 330)
+    if (Features::BindSampler)
         glBindSampler(0, 0); // We use combined texture/sampler state. Applications using GL 3.3 may set that otherwise.
 #endif
 
@@ -649,11 +1649,324 @@ bool ImGui_ImplQtOpenGL3::SetupRenderState(ImDrawData* draw_data, int fb_width,
     GL_CALL(glEnableVertexAttribArray(bd->AttribLocationVtxPos));
     GL_CALL(glEnableVertexAttribArray(bd->AttribLocationVtxUV));
     GL_CALL(glEnableVertexAttribArray(bd->AttribLocationVtxColor));
+    SetupVertexAttribs(false);
+
+    return true;
+}
+
+// Setup viewport, orthographic projection matrix
+// Our visible imgui space lies from display_pos (top left) to display_pos+display_size (bottom right). The render target may be a layer covering only part of the display.
+void ImGui_ImplQtOpenGL3::SetupProjection(const ImVec2& display_pos, const ImVec2& display_size, int fb_width, int fb_height)
+{
+    auto bd = this;
+    GL_CALL(glViewport(0, 0, (GLsizei)fb_width, (GLsizei)fb_height));
+    bd->ProjectionDisplayPos = display_pos;
+    bd->ProjectionDisplaySize = display_size;
+    SetupVertexTransform(ImVec2(0.0f, 0.0f), 1.0f);
+}
+
+// Vertices stored as (pos - vtx_origin) * vtx_scale are mapped back by scaling the projected rectangle the same way
+void ImGui_ImplQtOpenGL3::SetupVertexTransform(const ImVec2& vtx_origin, const ImVec2& vtx_scale)
+{
+    auto bd = this;
+    float L = (bd->ProjectionDisplayPos.x - vtx_origin.x) * vtx_scale.x;
+    float R = (bd->ProjectionDisplayPos.x + bd->ProjectionDisplaySize.x - vtx_origin.x) * vtx_scale.x;
+    float T = (bd->ProjectionDisplayPos.y - vtx_origin.y) * vtx_scale.y;
+    float B = (bd->ProjectionDisplayPos.y + bd->ProjectionDisplaySize.y - vtx_origin.y) * vtx_scale.y;
+    if (!bd->ClipOriginLowerLeft) { float tmp = T; T = B; B = tmp; } // Swap top and bottom if origin is upper left
+    const float ortho_projection[4][4] =
+    {
+        { 2.0f / (R - L),   0.0f,         0.0f,   0.0f },
+        { 0.0f,         2.0f / (T - B),   0.0f,   0.0f },
+        { 0.0f,         0.0f,        -1.0f,   0.0f },
+        { (R + L) / (L - R),  (T + B) / (B - T),  0.0f,   1.0f },
+    };
+    memcpy(bd->ProjectionMatrix, ortho_projection, sizeof(ortho_projection));
+    glUniformMatrix4fv(GetProjMtxLocation(bd->ActiveProgram), 1, GL_FALSE, &ortho_projection[0][0]);
+}
+
+GLint ImGui_ImplQtOpenGL3::GetProjMtxLocation(GLuint program) const
+{
+    auto bd = this;
+    if (program != 0 && program == bd->ShaderHandleSdf)
+        return bd->AttribLocationSdfProjMtx;
+    if (program != 0 && program == bd->ShaderHandlePlot)
+        return bd->AttribLocationPlotProjMtx;
+    return bd->AttribLocationProjMtx;
+}
+
+// The default and distance field programs share the vertex layout, only the projection has to follow the switch
+void ImGui_ImplQtOpenGL3::UseProgram(GLuint program)
+{
+    auto bd = this;
+    if (bd->ActiveProgram == program)
+        return;
+    GL_CALL(glUseProgram(program));
+    bd->ActiveProgram = program;
+    glUniformMatrix4fv(GetProjMtxLocation(program), 1, GL_FALSE, &bd->ProjectionMatrix[0][0]);
+    bd->ProgramSwitches++;
+}
+
+// Same vertex shader as the default program, attributes are bound to its locations so one vertex setup serves both
+void ImGui_ImplQtOpenGL3::CreateSdfProgram(const GLchar* vertex_shader, const GLchar* fragment_shader)
+{
+    auto bd = this;
+    const GLchar* vertex_shader_with_version[2] = { bd->GlslVersionString, vertex_shader };
+    GLuint vert_handle = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(vert_handle, 2, vertex_shader_with_version, nullptr);
+    glCompileShader(vert_handle);
+    CheckShader(vert_handle, "vertex shader");
+
+    const GLchar* fragment_shader_with_version[2] = { bd->GlslVersionString, fragment_shader };
+    GLuint frag_handle = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(frag_handle, 2, fragment_shader_with_version, nullptr);
+    glCompileShader(frag_handle);
+    const bool compiled = CheckShader(frag_handle, "distance field fragment shader");
+
+    bd->ShaderHandleSdf = glCreateProgram();
+    glAttachShader(bd->ShaderHandleSdf, vert_handle);
+    glAttachShader(bd->ShaderHandleSdf, frag_handle);
+    glBindAttribLocation(bd->ShaderHandleSdf, bd->AttribLocationVtxPos, "Position");
+    glBindAttribLocation(bd->ShaderHandleSdf, bd->AttribLocationVtxUV, "UV");
+    glBindAttribLocation(bd->ShaderHandleSdf, bd->AttribLocationVtxColor, "Color");
+    glLinkProgram(bd->ShaderHandleSdf);
+    const bool linked = CheckProgram(bd->ShaderHandleSdf, "distance field shader program");
+
+    glDetachShader(bd->ShaderHandleSdf, vert_handle);
+    glDetachShader(bd->ShaderHandleSdf, frag_handle);
+    glDeleteShader(vert_handle);
+    glDeleteShader(frag_handle);
+
+    //编译失败时(例如GL ES 2.0没有导数扩展)退回位图着色器,文字会显得偏粗
+    if (!compiled || !linked)
+    {
+        glDeleteProgram(bd->ShaderHandleSdf);
+        bd->ShaderHandleSdf = 0;
+        return;
+    }
+    GLint last_program;
+    glGetIntegerv(GL_CURRENT_PROGRAM, &last_program);
+    glUseProgram(bd->ShaderHandleSdf);
+    glUniform1i(glGetUniformLocation(bd->ShaderHandleSdf, "Texture"), 0);
+    glUseProgram((GLuint)last_program);
+    bd->AttribLocationSdfProjMtx = glGetUniformLocation(bd->ShaderHandleSdf, "ProjMtx");
+    bd->ProgramSdfBytes = GetProgramBytes(bd->ShaderHandleSdf);
+    bd->Memory.Allocate(ImGui_ImplQtOpenGL3_MemoryCategory_Programs, bd->ProgramSdfBytes);
+}
+
+// Plot series program: no vertex layout shared with the others, a single float attribute per vertex
+void ImGui_ImplQtOpenGL3::CreatePlotProgram(const GLchar* vertex_shader, const GLchar* fragment_shader)
+{
+    auto bd = this;
+    const GLchar* vertex_shader_with_version[2] = { bd->GlslVersionString, vertex_shader };
+    GLuint vert_handle = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(vert_handle, 2, vertex_shader_with_version, nullptr);
+    glCompileShader(vert_handle);
+    const bool vert_compiled = CheckShader(vert_handle, "plot vertex shader");
+
+    const GLchar* fragment_shader_with_version[2] = { bd->GlslVersionString, fragment_shader };
+    GLuint frag_handle = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(frag_handle, 2, fragment_shader_with_version, nullptr);
+    glCompileShader(frag_handle);
+    const bool frag_compiled = CheckShader(frag_handle, "plot fragment shader");
+
+    bd->ShaderHandlePlot = glCreateProgram();
+    glAttachShader(bd->ShaderHandlePlot, vert_handle);
+    glAttachShader(bd->ShaderHandlePlot, frag_handle);
+    glLinkProgram(bd->ShaderHandlePlot);
+    const bool linked = CheckProgram(bd->ShaderHandlePlot, "plot shader program");
+
+    glDetachShader(bd->ShaderHandlePlot, vert_handle);
+    glDetachShader(bd->ShaderHandlePlot, frag_handle);
+    glDeleteShader(vert_handle);
+    glDeleteShader(frag_handle);
+
+    const GLint value_location = linked ? glGetAttribLocation(bd->ShaderHandlePlot, "Value") : -1;
+    //失败时曲线退回到绘制列表中的折线
+    if (!vert_compiled || !frag_compiled || !linked || value_location < 0)
+    {
+        glDeleteProgram(bd->ShaderHandlePlot);
+        bd->ShaderHandlePlot = 0;
+        return;
+    }
+    bd->AttribLocationPlotValue = (GLuint)value_location;
+    bd->AttribLocationPlotProjMtx = glGetUniformLocation(bd->ShaderHandlePlot, "ProjMtx");
+    bd->AttribLocationPlotTransform = glGetUniformLocation(bd->ShaderHandlePlot, "Transform");
+    bd->AttribLocationPlotSlots = glGetUniformLocation(bd->ShaderHandlePlot, "Slots");
+    bd->AttribLocationPlotColor = glGetUniformLocation(bd->ShaderHandlePlot, "Color");
+    bd->ProgramPlotBytes = GetProgramBytes(bd->ShaderHandlePlot);
+    bd->Memory.Allocate(ImGui_ImplQtOpenGL3_MemoryCategory_Programs, bd->ProgramPlotBytes);
+}
+
+// Linked programs have no queryable size, the binary length is the closest figure the driver reports
+size_t ImGui_ImplQtOpenGL3::GetProgramBytes(GLuint program)
+{
+    auto bd = this;
+    GLint length = 0;
+#if !defined(IMGUI_IMPL_OPENGL_ES2) && !defined(IMGUI_IMPL_OPENGL_ES3)
+    if (bd->HasProgramBinary && program)
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+#endif
+    (void)bd; (void)program;
+    return (size_t)ImMax(length, 0);
+}
+
+// Shrink policy for the stream vertex/index buffers, only the glBufferSubData() path keeps a grown capacity
+void ImGui_ImplQtOpenGL3::ShrinkBuffers()
+{
+    auto bd = this;
+    const size_t vtx_size = bd->VertexBufferUsage.EndFrame(bd->Memory, (size_t)bd->VertexBufferSize);
+    const size_t idx_size = bd->IndexBufferUsage.EndFrame(bd->Memory, (size_t)bd->IndexBufferSize);
+    if (!bd->UseBufferSubData)
+        return;
+    if (vtx_size < (size_t)bd->VertexBufferSize)
+    {
+        GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, bd->VboHandle));
+        GL_CALL(glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)vtx_size, nullptr, GL_STREAM_DRAW));
+        bd->Memory.Reallocate(ImGui_ImplQtOpenGL3_MemoryCategory_VertexBuffers, (size_t)bd->VertexBufferSize, vtx_size);
+        bd->VertexBufferSize = (GLsizeiptr)vtx_size;
+        bd->Memory.CountShrink();
+    }
+    if (idx_size < (size_t)bd->IndexBufferSize)
+    {
+        GL_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, bd->ElementsHandle));
+        GL_CALL(glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)idx_size, nullptr, GL_STREAM_DRAW));
+        bd->Memory.Reallocate(ImGui_ImplQtOpenGL3_MemoryCategory_IndexBuffers, (size_t)bd->IndexBufferSize, idx_size);
+        bd->IndexBufferSize = (GLsizeiptr)idx_size;
+        bd->Memory.CountShrink();
+    }
+}
+
+// Input latency: frames carrying input (every frame in low latency mode) are fenced, the GPU finishes them in order
+void ImGui_ImplQtOpenGL3::FenceFrame(ImGui_ImplQt_LatencyTracker* latency)
+{
+    auto bd = this;
+    const ImU32 frame = latency->Rendered(bd->HasSync);
+    if (bd->HasSync && (frame != 0 || latency->LowLatency))
+    {
+        ImGui_ImplQtOpenGL3_FrameFence fence;
+        fence.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        fence.Frame = frame;
+#ifdef GL_TIMESTAMP
+        if (bd->HasTimerQuery && frame != 0)
+        {
+            //GPU时钟与CPU时钟起点不同,每帧按当前GL_TIMESTAMP重新对齐,避免长时间运行后漂移
+            GLint64 gpu_now = 0;
+            glGenQueries(1, &fence.Query);
+            bd->QueryCounter(fence.Query, GL_TIMESTAMP);
+            glGetInteger64v(GL_TIMESTAMP, &gpu_now);
+            fence.ClockOffsetNs = ImGui_ImplQt_LatencyTracker::Now() - (qint64)gpu_now;
+        }
+#endif
+        bd->FrameFences.push_back(fence);
+    }
+    PollFrameFences(latency, latency->LowLatency ? latency->MaxQueuedFrames : INT_MAX);
+}
+
+void ImGui_ImplQtOpenGL3::PollFrameFences(ImGui_ImplQt_LatencyTracker* latency, int max_queued)
+{
+    auto bd = this;
+    int done = 0;
+    for (; done < bd->FrameFences.Size; done++)
+    {
+        const ImGui_ImplQtOpenGL3_FrameFence& fence = bd->FrameFences[done];
+        GLenum status = glClientWaitSync(fence.Fence, 0, 0);
+        if (status == GL_TIMEOUT_EXPIRED && bd->FrameFences.Size - done > max_queued)
+        {
+            //队列过深,等待最早的一帧完成再继续提交(最多100ms,避免驱动异常时卡死)
+            status = glClientWaitSync(fence.Fence, GL_SYNC_FLUSH_COMMANDS_BIT, 100000000);
+        }
+        if (status == GL_TIMEOUT_EXPIRED)
+            break;
+        qint64 done_ns = ImGui_ImplQt_LatencyTracker::Now();
+#ifdef GL_TIMESTAMP
+        if (fence.Query)
+        {
+            //栅栏已经通过,查询结果必然可用,不会阻塞
+            GLuint64 gpu_ns = 0;
+            bd->GetQueryObjectui64v(fence.Query, GL_QUERY_RESULT, &gpu_ns);
+            done_ns = ImMin(done_ns, (qint64)gpu_ns + fence.ClockOffsetNs);
+            glDeleteQueries(1, &fence.Query);
+        }
+#endif
+        if (latency && fence.Frame)
+            latency->GpuDone(fence.Frame, done_ns);
+        glDeleteSync(fence.Fence);
+    }
+    bd->FrameFences.erase(bd->FrameFences.begin(), bd->FrameFences.begin() + done);
+}
+
+void ImGui_ImplQtOpenGL3::ReleaseFrameFences()
+{
+    auto bd = this;
+    //未完成的帧按当前时间结束采样,不再等待
+    ImGui_ImplQt_LatencyTracker* latency = ImGui_ImplQt_LatencyTracker::Find(bd->ImContext);
+    for (const ImGui_ImplQtOpenGL3_FrameFence& fence : bd->FrameFences)
+    {
+        if (latency && fence.Frame)
+            latency->GpuDone(fence.Frame, ImGui_ImplQt_LatencyTracker::Now());
+        if (fence.Query)
+            glDeleteQueries(1, &fence.Query);
+        glDeleteSync(fence.Fence);
+    }
+    bd->FrameFences.clear();
+}
+
+// Attribute pointers refer to the buffer bound to GL_ARRAY_BUFFER at the time of the call
+void ImGui_ImplQtOpenGL3::SetupVertexAttribs(bool compact)
+{
+    auto bd = this;
+    if (compact)
+    {
+        // Positions stay integers and are scaled by the projection, UVs are normalized by the vertex fetch
+        const GLsizei stride = (GLsizei)sizeof(ImGui_ImplQtOpenGL3_CompactVert);
+        GL_CALL(glVertexAttribPointer(bd->AttribLocationVtxPos, 2, GL_UNSIGNED_SHORT, GL_FALSE, stride, (GLvoid*)IM_OFFSETOF(ImGui_ImplQtOpenGL3_CompactVert, pos)));
+        GL_CALL(glVertexAttribPointer(bd->AttribLocationVtxUV, 2, GL_UNSIGNED_SHORT, GL_TRUE, stride, (GLvoid*)IM_OFFSETOF(ImGui_ImplQtOpenGL3_CompactVert, uv)));
+        GL_CALL(glVertexAttribPointer(bd->AttribLocationVtxColor, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, (GLvoid*)IM_OFFSETOF(ImGui_ImplQtOpenGL3_CompactVert, col)));
+        return;
+    }
     GL_CALL(glVertexAttribPointer(bd->AttribLocationVtxPos, 2, GL_FLOAT, GL_FALSE, sizeof(ImDrawVert), (GLvoid*)IM_OFFSETOF(ImDrawVert, pos)));
     GL_CALL(glVertexAttribPointer(bd->AttribLocationVtxUV, 2, GL_FLOAT, GL_FALSE, sizeof(ImDrawVert), (GLvoid*)IM_OFFSETOF(ImDrawVert, uv)));
     GL_CALL(glVertexAttribPointer(bd->AttribLocationVtxColor, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(ImDrawVert), (GLvoid*)IM_OFFSETOF(ImDrawVert, col)));
+}
 
-    return true;
+void ImGui_ImplQtOpenGL3::BindDrawListBuffers(GLuint vbo, GLuint ibo, bool compact, const ImVec2& vtx_origin)
+{
+    GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, vbo));
+    GL_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo));
+    SetupVertexAttribs(compact);
+    if (compact)
+        SetupVertexTransform(vtx_origin, ImGui_ImplQtOpenGL3_CompactPosScale);
+    else
+        SetupVertexTransform(ImVec2(0.0f, 0.0f), 1.0f);
+}
+
+void ImGui_ImplQtOpenGL3::CreateQuadBuffers()
+{
+    auto bd = this;
+    //前4个顶点用于原点在左上角的裁剪空间,后4个用于左下角,纹理的第0行是图层底部
+    const ImDrawVert vertices[8] =
+    {
+        { ImVec2(0.0f, 0.0f), ImVec2(0.0f, 0.0f), IM_COL32_WHITE },
+        { ImVec2(1.0f, 0.0f), ImVec2(1.0f, 0.0f), IM_COL32_WHITE },
+        { ImVec2(1.0f, 1.0f), ImVec2(1.0f, 1.0f), IM_COL32_WHITE },
+        { ImVec2(0.0f, 1.0f), ImVec2(0.0f, 1.0f), IM_COL32_WHITE },
+        { ImVec2(0.0f, 0.0f), ImVec2(0.0f, 1.0f), IM_COL32_WHITE },
+        { ImVec2(1.0f, 0.0f), ImVec2(1.0f, 1.0f), IM_COL32_WHITE },
+        { ImVec2(1.0f, 1.0f), ImVec2(1.0f, 0.0f), IM_COL32_WHITE },
+        { ImVec2(0.0f, 1.0f), ImVec2(0.0f, 0.0f), IM_COL32_WHITE },
+    };
+    const ImDrawIdx indices[12] = { 0, 1, 2, 0, 2, 3, 4, 5, 6, 4, 6, 7 };
+
+    //元素缓冲绑定属于VAO,经GL_ARRAY_BUFFER上传以免改动当前VAO
+    glGenBuffers(1, &bd->QuadVboHandle);
+    glGenBuffers(1, &bd->QuadElementsHandle);
+    glBindBuffer(GL_ARRAY_BUFFER, bd->QuadVboHandle);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, bd->QuadElementsHandle);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+    bd->Memory.Allocate(ImGui_ImplQtOpenGL3_MemoryCategory_VertexBuffers, sizeof(vertices));
+    bd->Memory.Allocate(ImGui_ImplQtOpenGL3_MemoryCategory_IndexBuffers, sizeof(indices));
 }
 
 bool ImGui_ImplQtOpenGL3::CheckShader(GLuint handle, const char* desc)
@@ -700,7 +2013,17 @@ void ImGui_ImplQtOpenGL3_Shutdown()
     ImGuiIO& io = ImGui::GetIO();
 
     ImGui_ImplQtOpenGL3_ShutdownPlatformInterface();
-    ImGui_ImplQtOpenGL3_DestoryDeviceObjects();
+    QObject::disconnect(bd->ContextConnection);
+    if (!bd->ContextLost)
+    {
+        //析构窗口时上下文通常已不是当前上下文
+        ImGui_ImplQtOpenGL3_ContextScope scope(bd->Context);
+        ImGui_ImplQtOpenGL3_DestoryDeviceObjects();
+    }
+    //GL对象都已释放,只剩应用没有销毁的CPU侧对象
+    bd->Streams.Shutdown();
+    bd->Plots.Shutdown();
+    bd->Atlas.Shutdown();
     io.BackendRendererName = nullptr;
     io.BackendRendererUserData = nullptr;
     IM_DELETE(bd);
@@ -711,9 +2034,22 @@ void ImGui_ImplQtOpenGL3_NewFrame()
     auto bd = ImGui_ImplQtOpenGL3_GetBackendData();
     IM_ASSERT(bd != nullptr && "Did you call ImGui_ImplQtOpenGL3_Init()?");
 
+    if (bd->ContextLost) {
+        bd->RestoreContext(ImGui::GetIO());
+    }
     if (!bd->ShaderHandle) {
         ImGui_ImplQtOpenGL3_CreateDeviceObjects();
     }
+    else if (ImGui_ImplQt_ApplyFontAtlasScale(ImGui::GetIO())) {
+        //字体图集换成了另一个DPR的版本,在ImGui::NewFrame()之前替换纹理
+        ImGui_ImplQtOpenGL3_DestoryFontsTexture();
+        ImGui_ImplQtOpenGL3_CreateFontsTexture();
+    }
+    bd->Textures.Update(&bd->DirtyTextures);
+    bd->Atlas.Update(&bd->DirtyTextures);
+    bd->Plots.Draws.resize(0);
+    if (!bd->FrameFences.empty())
+        bd->PollFrameFences(ImGui_ImplQt_LatencyTracker::Find(bd->ImContext), INT_MAX);
 }
 
 void ImGui_ImplQtOpenGL3_RenderDrawData(ImDrawData* draw_data)
@@ -762,6 +2098,240 @@ void ImGui_ImplQtOpenGL3_DestoryDeviceObjects()
     }
 }
 
+ImTextureID ImGui_ImplQtOpenGL3_LoadTextureAsync(const char* path)
+{
+    auto bd = ImGui_ImplQtOpenGL3_GetBackendData();
+    IM_ASSERT(bd != nullptr && "Did you call ImGui_ImplQtOpenGL3_Init()?");
+    return bd->Textures.Load(path);
+}
+
+bool ImGui_ImplQtOpenGL3_GetTextureSize(ImTextureID texture, ImVec2* size)
+{
+    auto bd = ImGui_ImplQtOpenGL3_GetBackendData();
+    if (bd) {
+        return bd->Textures.GetSize(texture, size);
+    }
+    return false;
+}
+
+void ImGui_ImplQtOpenGL3_SetTextureCacheBudget(size_t bytes)
+{
+    auto bd = ImGui_ImplQtOpenGL3_GetBackendData();
+    if (bd) {
+        bd->Textures.BudgetBytes = bytes;
+    }
+}
+
+ImGui_ImplQtOpenGL3_StreamTexture* ImGui_ImplQtOpenGL3_CreateStreamTexture(int width, int height)
+{
+    auto bd = ImGui_ImplQtOpenGL3_GetBackendData();
+    IM_ASSERT(bd != nullptr && "Did you call ImGui_ImplQtOpenGL3_Init()?");
+    return bd->Streams.Create(width, height);
+}
+
+void ImGui_ImplQtOpenGL3_DestroyStreamTexture(ImGui_ImplQtOpenGL3_StreamTexture* stream)
+{
+    auto bd = ImGui_ImplQtOpenGL3_GetBackendData();
+    if (bd) {
+        bd->Streams.Destroy(stream);
+    }
+}
+
+ImGui_ImplQtOpenGL3_PlotSeries* ImGui_ImplQtOpenGL3_CreatePlotSeries(int capacity)
+{
+    auto bd = ImGui_ImplQtOpenGL3_GetBackendData();
+    IM_ASSERT(bd != nullptr && "Did you call ImGui_ImplQtOpenGL3_Init()?");
+    return bd->Plots.Create(capacity);
+}
+
+void ImGui_ImplQtOpenGL3_DestroyPlotSeries(ImGui_ImplQtOpenGL3_PlotSeries* series)
+{
+    auto bd = ImGui_ImplQtOpenGL3_GetBackendData();
+    if (bd) {
+        bd->Plots.Destroy(series);
+    }
+}
+
+void ImGui_ImplQtOpenGL3_AddPlotSeries(ImDrawList* draw_list, ImGui_ImplQtOpenGL3_PlotSeries* series, const ImVec2& p_min, const ImVec2& p_max, float v_min, float v_max, ImU32 col, int count)
+{
+    auto bd = ImGui_ImplQtOpenGL3_GetBackendData();
+    if (!bd || !draw_list || !series || series->Count == 0 || v_max == v_min || p_max.x <= p_min.x || p_max.y <= p_min.y)
+        return;
+
+    const ImS64 kept = ImMin(series->Count, (ImS64)series->Capacity);
+    ImGui_ImplQtOpenGL3_PlotDraw draw;
+    draw.Series = series;
+    draw.Rect = ImVec4(p_min.x, p_min.y, p_max.x, p_max.y);
+    draw.ValueMin = v_min;
+    draw.ValueMax = v_max;
+    draw.Color = col;
+    draw.End = series->Count;
+    draw.First = draw.End - (count > 0 ? ImMin((ImS64)count, kept) : kept);
+    if (!bd->ShaderHandlePlot) {
+        bd->Plots.AddFallback(draw_list, draw);
+        return;
+    }
+    //回调的用户数据是本帧绘制记录的序号加1
+    bd->Plots.Draws.push_back(draw);
+    draw_list->AddCallback(ImGui_ImplQtOpenGL3_PlotCallback, (void*)(intptr_t)bd->Plots.Draws.Size);
+}
+
+ImGui_ImplQtOpenGL3_AtlasImage* ImGui_ImplQtOpenGL3_AddAtlasImage(const void* rgba_pixels, int width, int height, int stride)
+{
+    auto bd = ImGui_ImplQtOpenGL3_GetBackendData();
+    IM_ASSERT(bd != nullptr && "Did you call ImGui_ImplQtOpenGL3_Init()?");
+    return bd->Atlas.Add(rgba_pixels, width, height, stride);
+}
+
+void ImGui_ImplQtOpenGL3_RemoveAtlasImage(ImGui_ImplQtOpenGL3_AtlasImage* image)
+{
+    auto bd = ImGui_ImplQtOpenGL3_GetBackendData();
+    if (bd) {
+        bd->Atlas.Remove(image);
+    }
+}
+
+bool ImGui_ImplQtOpenGL3_GetAtlasRegion(ImGui_ImplQtOpenGL3_AtlasImage* image, ImGui_ImplQtOpenGL3_AtlasRegion* region)
+{
+    auto bd = ImGui_ImplQtOpenGL3_GetBackendData();
+    if (!bd || !image || !region || bd->ContextLost)
+        return false;
+    return bd->Atlas.GetRegion(image, region);
+}
+
+void ImGui_ImplQtOpenGL3_SetAtlasBudget(int max_pages)
+{
+    auto bd = ImGui_ImplQtOpenGL3_GetBackendData();
+    if (bd) {
+        bd->Atlas.MaxPages = max_pages > 1 ? max_pages : 1;
+    }
+}
+
+void ImGui_ImplQtOpenGL3_GetAtlasStats(ImGui_ImplQtOpenGL3_AtlasStats* stats)
+{
+    auto bd = ImGui_ImplQtOpenGL3_GetBackendData();
+    if (bd && stats) {
+        bd->Atlas.GetStats(stats);
+    }
+}
+
+void ImGui_ImplQtOpenGL3_SetPartialRedraw(bool enable, const ImVec4& clear_color)
+{
+    auto bd = ImGui_ImplQtOpenGL3_GetBackendData();
+    if (bd) {
+        bd->PartialRedraw = enable;
+        bd->ClearColor = clear_color;
+        bd->LastFramebufferSize = ImVec2();
+        bd->DrawListStates.clear();
+    }
+}
+
+bool ImGui_ImplQtOpenGL3_GetPartialRedraw()
+{
+    auto bd = ImGui_ImplQtOpenGL3_GetBackendData();
+    return bd ? bd->PartialRedraw : false;
+}
+
+void ImGui_ImplQtOpenGL3_SetBufferCache(bool enable)
+{
+    auto bd = ImGui_ImplQtOpenGL3_GetBackendData();
+    if (bd) {
+        bd->UseBufferCache = enable;
+        if (!enable)
+            bd->Buffers.DestroyDeviceObjects();
+    }
+}
+
+void ImGui_ImplQtOpenGL3_SetLayerMode(bool enable, size_t budget_bytes)
+{
+    auto bd = ImGui_ImplQtOpenGL3_GetBackendData();
+    if (bd) {
+        bd->UseLayers = enable;
+        bd->Layers.BudgetBytes = budget_bytes;
+        if (!enable)
+            bd->Layers.DestroyDeviceObjects();
+    }
+}
+
+void ImGui_ImplQtOpenGL3_SetCompactVertices(bool enable)
+{
+    auto bd = ImGui_ImplQtOpenGL3_GetBackendData();
+    if (bd) {
+        bd->UseCompactVertices = enable;
+    }
+}
+
+void ImGui_ImplQtOpenGL3_SetReadback(bool enable, int interval, ImGui_ImplQtOpenGL3_ReadbackCallback callback, void* user_data)
+{
+    auto bd = ImGui_ImplQtOpenGL3_GetBackendData();
+    if (bd) {
+        if (enable && !bd->Readback.Enabled) {
+            bd->Readback.FramesCaptured = bd->Readback.FramesDelivered = bd->Readback.FramesDropped = 0;
+        }
+        bd->Readback.Enabled = enable;
+        bd->Readback.Interval = interval;
+        bd->Readback.Callback = callback;
+        bd->Readback.CallbackUserData = user_data;
+        if (!enable)
+            bd->Readback.DestroyDeviceObjects();
+    }
+}
+
+bool ImGui_ImplQtOpenGL3_PopReadbackFrame(QImage* image)
+{
+    auto bd = ImGui_ImplQtOpenGL3_GetBackendData();
+    IM_ASSERT(bd != nullptr && "Did you call ImGui_ImplQtOpenGL3_Init()?");
+    return image && bd->Readback.Pop(image);
+}
+
+void ImGui_ImplQtOpenGL3_GetFrameStats(ImGui_ImplQtOpenGL3_FrameStats* stats)
+{
+    auto bd = ImGui_ImplQtOpenGL3_GetBackendData();
+    if (bd && stats) {
+        *stats = bd->FrameStats;
+    }
+}
+
+void ImGui_ImplQtOpenGL3_GetMemoryStats(ImGui_ImplQtOpenGL3_MemoryStats* stats)
+{
+    auto bd = ImGui_ImplQtOpenGL3_GetBackendData();
+    if (bd && stats) {
+        bd->Memory.GetStats(stats);
+    }
+}
+
+void ImGui_ImplQtOpenGL3_GetTotalMemoryStats(ImGui_ImplQtOpenGL3_MemoryStats* stats)
+{
+    if (stats)
+        ImGui_ImplQtOpenGL3_MemoryTracker::GetTotalStats(stats);
+}
+
+void ImGui_ImplQtOpenGL3_SetBufferShrink(bool enable, int frames, float usage)
+{
+    auto bd = ImGui_ImplQtOpenGL3_GetBackendData();
+    if (bd) {
+        bd->Memory.ShrinkEnabled = enable;
+        bd->Memory.ShrinkFrames = ImMax(frames, 1);
+        bd->Memory.ShrinkUsage = usage;
+    }
+}
+
+ImGui_ImplQtOpenGL3_FeatureLevel ImGui_ImplQtOpenGL3_GetFeatureLevel()
+{
+    auto bd = ImGui_ImplQtOpenGL3_GetBackendData();
+    return bd ? bd->FeatureLevel : ImGui_ImplQtOpenGL3_FeatureLevel_GL30;
+}
+
+bool ImGui_ImplQtOpenGL3_SetFeatureLevel(ImGui_ImplQtOpenGL3_FeatureLevel level)
+{
+    auto bd = ImGui_ImplQtOpenGL3_GetBackendData();
+    if (!bd || level < 0 || level >= ImGui_ImplQtOpenGL3_FeatureLevel_COUNT || !ImGui_ImplQtOpenGL3_CanRunFeatureLevel(bd->MaxFeatureLevel, level))
+        return false;
+    bd->ForcedFeatureLevel = (int)level;
+    bd->SelectFeatureLevel(ImGui::GetIO());
+    return true;
+}
+
 static void ImGui_ImplQtOpenGL3_RenderWindow(ImGuiViewport* viewport, void*)
 {
     auto bd = ImGui_ImplQtOpenGL3_GetBackendData();
@@ -11,3 +11,149 @@ IMGUI_IMPL_API bool ImGui_ImplQtOpenGL3_CreateFontsTexture();
 IMGUI_IMPL_API void ImGui_ImplQtOpenGL3_DestoryFontsTexture();
 IMGUI_IMPL_API bool ImGui_ImplQtOpenGL3_CreateDeviceObjects();
 IMGUI_IMPL_API void ImGui_ImplQtOpenGL3_DestoryDeviceObjects();
+
+// Textures: decoded on a worker thread, a placeholder until then, least recently used evicted over the budget
+IMGUI_IMPL_API ImTextureID ImGui_ImplQtOpenGL3_LoadTextureAsync(const char* path);
+IMGUI_IMPL_API bool ImGui_ImplQtOpenGL3_GetTextureSize(ImTextureID texture, ImVec2* size);
+IMGUI_IMPL_API void ImGui_ImplQtOpenGL3_SetTextureCacheBudget(size_t bytes);
+
+// Streaming textures: one producer thread per stream, the newest frame is uploaded right before rendering
+struct ImGui_ImplQtOpenGL3_StreamTexture;
+struct ImGui_ImplQtOpenGL3_StreamStats
+{
+    int   FramesPushed;
+    int   FramesUploaded;
+    int   FramesDropped;
+    float UploadLatencyMs;          // From push to upload, last frame
+    float UploadLatencyAverageMs;
+};
+IMGUI_IMPL_API ImGui_ImplQtOpenGL3_StreamTexture* ImGui_ImplQtOpenGL3_CreateStreamTexture(int width, int height);
+IMGUI_IMPL_API void ImGui_ImplQtOpenGL3_DestroyStreamTexture(ImGui_ImplQtOpenGL3_StreamTexture* stream);    // After the producer stopped pushing
+IMGUI_IMPL_API bool ImGui_ImplQtOpenGL3_PushStreamFrame(ImGui_ImplQtOpenGL3_StreamTexture* stream, const void* rgba_pixels, int stride = 0);
+IMGUI_IMPL_API ImTextureID ImGui_ImplQtOpenGL3_GetStreamTextureID(ImGui_ImplQtOpenGL3_StreamTexture* stream);
+IMGUI_IMPL_API void ImGui_ImplQtOpenGL3_GetStreamStats(ImGui_ImplQtOpenGL3_StreamTexture* stream, ImGui_ImplQtOpenGL3_StreamStats* stats);    // Any thread
+
+// Plot series: a sample ring kept on the GPU with a min/max pyramid, drawn from a single draw list callback
+struct ImGui_ImplQtOpenGL3_PlotSeries;
+IMGUI_IMPL_API ImGui_ImplQtOpenGL3_PlotSeries* ImGui_ImplQtOpenGL3_CreatePlotSeries(int capacity);
+IMGUI_IMPL_API void ImGui_ImplQtOpenGL3_DestroyPlotSeries(ImGui_ImplQtOpenGL3_PlotSeries* series);
+IMGUI_IMPL_API void ImGui_ImplQtOpenGL3_AppendPlotSamples(ImGui_ImplQtOpenGL3_PlotSeries* series, const float* values, int count);     // GUI thread
+IMGUI_IMPL_API void ImGui_ImplQtOpenGL3_AddPlotSeries(ImDrawList* draw_list, ImGui_ImplQtOpenGL3_PlotSeries* series, const ImVec2& p_min, const ImVec2& p_max, float v_min, float v_max, ImU32 col, int count = 0);    // Newest count samples, all when count <= 0
+
+// Image atlas: small images share page textures so consecutive ImGui::Image() calls merge into one draw, GUI thread only
+struct ImGui_ImplQtOpenGL3_AtlasImage;
+struct ImGui_ImplQtOpenGL3_AtlasRegion
+{
+    ImTextureID TextureId;          // Page texture
+    ImVec2 Uv0;
+    ImVec2 Uv1;
+    ImVec2 Size;                    // In pixels
+};
+struct ImGui_ImplQtOpenGL3_AtlasStats
+{
+    int   Images;
+    int   ResidentImages;
+    int   Pages;
+    float Occupancy;                // Packed area / page area
+    int   Evictions;                // Totals since Init()
+    int   Defragmentations;
+    int   Misses;                   // GetAtlasRegion() calls that found no room
+};
+IMGUI_IMPL_API ImGui_ImplQtOpenGL3_AtlasImage* ImGui_ImplQtOpenGL3_AddAtlasImage(const void* rgba_pixels, int width, int height, int stride = 0);    // nullptr when larger than 256x256
+IMGUI_IMPL_API void ImGui_ImplQtOpenGL3_RemoveAtlasImage(ImGui_ImplQtOpenGL3_AtlasImage* image);
+IMGUI_IMPL_API bool ImGui_ImplQtOpenGL3_GetAtlasRegion(ImGui_ImplQtOpenGL3_AtlasImage* image, ImGui_ImplQtOpenGL3_AtlasRegion* region);     // Every frame the image is drawn, UVs change after a repack
+IMGUI_IMPL_API void ImGui_ImplQtOpenGL3_SetAtlasBudget(int max_pages = 4);
+IMGUI_IMPL_API void ImGui_ImplQtOpenGL3_GetAtlasStats(ImGui_ImplQtOpenGL3_AtlasStats* stats);
+
+// Partial redraw: only the clip rectangles of changed draw lists are cleared and redrawn, see ImGui_ImplQt_EnablePartialUpdate()
+IMGUI_IMPL_API void ImGui_ImplQtOpenGL3_SetPartialRedraw(bool enable, const ImVec4& clear_color = ImVec4(0.0f, 0.0f, 0.0f, 1.0f));
+IMGUI_IMPL_API bool ImGui_ImplQtOpenGL3_GetPartialRedraw();     // Hosts must not clear the framebuffer themselves then
+
+IMGUI_IMPL_API void ImGui_ImplQtOpenGL3_SetBufferCache(bool enable);     // Buffers per draw list, uploaded only when the content hash changes
+
+IMGUI_IMPL_API void ImGui_ImplQtOpenGL3_SetLayerMode(bool enable, size_t budget_bytes = 64u * 1024u * 1024u);    // Heavy windows cached in textures, composited as one quad
+
+IMGUI_IMPL_API void ImGui_ImplQtOpenGL3_SetCompactVertices(bool enable);     // 12 bytes per vertex instead of 20 for lists that fit
+
+// Readback: the main viewport is read into fenced pixel pack buffers after RenderDrawData(), frames are dropped rather than waited for
+class QImage;
+typedef void (*ImGui_ImplQtOpenGL3_ReadbackCallback)(const QImage& image, int frame, void* user_data);     // RGBA8888 premultiplied, top row first
+IMGUI_IMPL_API void ImGui_ImplQtOpenGL3_SetReadback(bool enable, int interval = 1, ImGui_ImplQtOpenGL3_ReadbackCallback callback = nullptr, void* user_data = nullptr);
+IMGUI_IMPL_API bool ImGui_ImplQtOpenGL3_PopReadbackFrame(QImage* image);
+
+// Context loss: NewFrame() rebuilds the renderer on the current context, texture ids change so query them every frame
+
+// GPU memory: sizes requested from GL per category, per renderer and summed over every live renderer
+enum ImGui_ImplQtOpenGL3_MemoryCategory
+{
+    ImGui_ImplQtOpenGL3_MemoryCategory_Textures,        // Font, async, streaming, atlas and layer textures, readback resolve buffer
+    ImGui_ImplQtOpenGL3_MemoryCategory_VertexBuffers,
+    ImGui_ImplQtOpenGL3_MemoryCategory_IndexBuffers,
+    ImGui_ImplQtOpenGL3_MemoryCategory_PixelBuffers,    // Upload and readback buffers
+    ImGui_ImplQtOpenGL3_MemoryCategory_Programs,        // Program binary length, 0 when the driver has no program binaries
+    ImGui_ImplQtOpenGL3_MemoryCategory_COUNT
+};
+struct ImGui_ImplQtOpenGL3_MemoryStats
+{
+    size_t CurrentBytes[ImGui_ImplQtOpenGL3_MemoryCategory_COUNT];
+    size_t PeakBytes[ImGui_ImplQtOpenGL3_MemoryCategory_COUNT];
+    int    Objects[ImGui_ImplQtOpenGL3_MemoryCategory_COUNT];
+    size_t TotalBytes;
+    size_t TotalPeakBytes;
+    int    Reallocations;           // Size changes of existing objects since Init(), new objects are counted in Objects
+    int    BufferShrinks;
+};
+IMGUI_IMPL_API void ImGui_ImplQtOpenGL3_GetMemoryStats(ImGui_ImplQtOpenGL3_MemoryStats* stats);
+IMGUI_IMPL_API void ImGui_ImplQtOpenGL3_GetTotalMemoryStats(ImGui_ImplQtOpenGL3_MemoryStats* stats);
+IMGUI_IMPL_API void ImGui_ImplQtOpenGL3_SetBufferShrink(bool enable, int frames = 300, float usage = 0.25f);    // Shrink kept buffers used below usage for frames frames
+
+// Feature level: picked from the GL context in Init() and after a context loss, contexts between two levels run the lower one
+enum ImGui_ImplQtOpenGL3_FeatureLevel
+{
+    ImGui_ImplQtOpenGL3_FeatureLevel_GL30,
+    ImGui_ImplQtOpenGL3_FeatureLevel_GL33,      // Base vertex, sampler objects, primitive restart state
+    ImGui_ImplQtOpenGL3_FeatureLevel_GL45,      // GL33 and clip origin
+    ImGui_ImplQtOpenGL3_FeatureLevel_ES3,       // OpenGL ES 3.0+ context, sampler objects
+    ImGui_ImplQtOpenGL3_FeatureLevel_COUNT
+};
+IMGUI_IMPL_API ImGui_ImplQtOpenGL3_FeatureLevel ImGui_ImplQtOpenGL3_GetFeatureLevel();
+IMGUI_IMPL_API bool ImGui_ImplQtOpenGL3_SetFeatureLevel(ImGui_ImplQtOpenGL3_FeatureLevel level);     // Lower level of the same API, false when the context cannot run it
+
+// Statistics of the last rendered frame of the main viewport
+struct ImGui_ImplQtOpenGL3_FrameStats
+{
+    ImVec4 DamageRect;          // Redrawn region in framebuffer pixels (x0, y0, x1, y1), top-left origin
+    float  DamageRatio;         // Redrawn area / framebuffer area
+    int    DrawListsChanged;
+
+    int    BufferCacheHits;         // Draw lists whose buffers were reused without upload
+    int    BufferCacheMisses;
+    float  BufferCacheHitRate;
+    size_t BufferBytesUploaded;
+    size_t BufferBytesSaved;
+    size_t BufferCacheResidentBytes;
+
+    int    LayersComposited;        // Draw lists drawn as one cached quad
+    int    LayersRendered;          // Layers re-rendered because their draw list changed
+    int    LayersDirect;            // Draw lists drawn directly after thrashing or running out of layer budget
+    size_t LayerResidentBytes;
+
+    int    CompactVertexLists;      // Draw lists uploaded in the compact vertex format
+    size_t CompactBytesSaved;
+
+    int    DrawCalls;
+    int    CommandsCulled;          // Empty commands or commands outside of the framebuffer/damage rectangle
+    int    CommandsMerged;          // Commands folded into the previous one after clipping
+    int    SdfDrawCalls;            // Draw calls using the distance field shader, see ImGui_ImplQt_SetFontAtlasSdf()
+    int    ProgramSwitches;         // Between the default, distance field and plot shaders
+    int    PlotSeriesDrawn;         // ImGui_ImplQtOpenGL3_AddPlotSeries() commands rendered on the GPU
+    int    PlotVertices;            // Vertices they submitted, bounded by the plot widths
+
+    int    ReadbackFramesCaptured;  // Totals since readback was enabled
+    int    ReadbackFramesDelivered;
+    int    ReadbackFramesDropped;
+
+    int    ContextRestores;         // Times the renderer was rebuilt after its GL context was destroyed
+    float  ContextRestoreMs;        // Duration of the last rebuild
+};
+IMGUI_IMPL_API void ImGui_ImplQtOpenGL3_GetFrameStats(ImGui_ImplQtOpenGL3_FrameStats* stats);
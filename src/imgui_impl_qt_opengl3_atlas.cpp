@@ -0,0 +1,423 @@
+﻿#include "imgui_impl_qt_opengl3_atlas.h"
+#include "imgui_internal.h"
+#include <algorithm>
+#include <string.h>
+
+namespace
+{
+    const size_t ImGui_ImplQtOpenGL3_AtlasPageBytes = (size_t)ImGui_ImplQtOpenGL3_AtlasSet::PageSize * ImGui_ImplQtOpenGL3_AtlasSet::PageSize * 4;
+
+    int ImGui_ImplQtOpenGL3_AtlasPaddedWidth(const ImGui_ImplQtOpenGL3_AtlasImage& image)
+    {
+        return image.Width + ImGui_ImplQtOpenGL3_AtlasSet::Padding * 2;
+    }
+
+    int ImGui_ImplQtOpenGL3_AtlasPaddedHeight(const ImGui_ImplQtOpenGL3_AtlasImage& image)
+    {
+        return image.Height + ImGui_ImplQtOpenGL3_AtlasSet::Padding * 2;
+    }
+}
+
+void ImGui_ImplQtOpenGL3_AtlasSet::Init()
+{
+    initializeOpenGLFunctions();
+}
+
+ImGui_ImplQtOpenGL3_AtlasImage* ImGui_ImplQtOpenGL3_AtlasSet::Add(const void* rgba_pixels, int width, int height, int stride)
+{
+    if (!rgba_pixels || width <= 0 || height <= 0 || width > MaxImageSize || height > MaxImageSize)
+        return nullptr;
+    if (stride <= 0)
+        stride = width * 4;
+
+    auto image = IM_NEW(ImGui_ImplQtOpenGL3_AtlasImage)();
+    image->Width = width;
+    image->Height = height;
+    //四周各扩出一个像素并重复边缘,双线性采样不会混入相邻图像
+    const int padded_width = ImGui_ImplQtOpenGL3_AtlasPaddedWidth(*image);
+    const int padded_height = ImGui_ImplQtOpenGL3_AtlasPaddedHeight(*image);
+    image->Pixels.resize((size_t)padded_width * padded_height * 4);
+    for (int y = 0; y < padded_height; y++)
+    {
+        const int src_y = ImClamp(y - Padding, 0, height - 1);
+        const unsigned char* src = (const unsigned char*)rgba_pixels + (size_t)src_y * stride;
+        unsigned char* dst = image->Pixels.data() + (size_t)y * padded_width * 4;
+        memcpy(dst + Padding * 4, src, (size_t)width * 4);
+        for (int x = 0; x < Padding; x++) {
+            memcpy(dst + x * 4, src, 4);
+            memcpy(dst + (Padding + width + x) * 4, src + (width - 1) * 4, 4);
+        }
+    }
+    Images.push_back(image);
+    return image;
+}
+
+void ImGui_ImplQtOpenGL3_AtlasSet::Remove(ImGui_ImplQtOpenGL3_AtlasImage* image)
+{
+    auto it = std::find(Images.begin(), Images.end(), image);
+    if (it == Images.end())
+        return;
+    Images.erase(it);
+    if (image->Page >= 0)
+        Unplace(*image);
+    IM_DELETE(image);
+}
+
+bool ImGui_ImplQtOpenGL3_AtlasSet::GetRegion(ImGui_ImplQtOpenGL3_AtlasImage* image, ImGui_ImplQtOpenGL3_AtlasRegion* region)
+{
+    image->LastUsedFrame = ImGui::GetFrameCount();
+    if (image->Page < 0)
+    {
+        if (!Place(*image, Pages, MaxPages) && !EvictAndPlace(*image)) {
+            //剩余空间过于零碎,下一帧开始前整理
+            DefragmentRequested = true;
+            MissedArea += (ImS64)ImGui_ImplQtOpenGL3_AtlasPaddedWidth(*image) * ImGui_ImplQtOpenGL3_AtlasPaddedHeight(*image);
+            Misses++;
+            return false;
+        }
+        ImGui_ImplQtOpenGL3_AtlasPage& page = Pages[image->Page];
+        if (!page.Handle)
+            page.Handle = CreatePage();
+        Upload(*image);
+    }
+
+    const float scale = 1.0f / (float)PageSize;
+    region->TextureId = (ImTextureID)(intptr_t)Pages[image->Page].Handle;
+    region->Uv0 = ImVec2((float)(image->X + Padding) * scale, (float)(image->Y + Padding) * scale);
+    region->Uv1 = ImVec2((float)(image->X + Padding + image->Width) * scale, (float)(image->Y + Padding + image->Height) * scale);
+    region->Size = ImVec2((float)image->Width, (float)image->Height);
+    return true;
+}
+
+void ImGui_ImplQtOpenGL3_AtlasSet::Update(ImVector<ImTextureID>* dirty)
+{
+    //放不下的图像在整理后装得进预算时整理;用量不到少一页的一半时也整理,把图像收拢到更少的页里
+    //预算本身不够或整理后用量没变时不再重复整理,以免每帧重新上传
+    ImS64 used_area = 0;
+    for (const ImGui_ImplQtOpenGL3_AtlasPage& page : Pages)
+        used_area += page.UsedArea;
+    const ImS64 page_area = (ImS64)PageSize * PageSize;
+    const bool fits = used_area + MissedArea <= (ImS64)MaxPages * page_area * 9 / 10;
+    const bool sparse = Pages.size() > 1 && used_area * 2 < (ImS64)(Pages.size() - 1) * page_area && used_area != LastDefragmentArea;
+    if ((DefragmentRequested && fits) || sparse || (int)Pages.size() > MaxPages)
+        Defragment(dirty);
+    DefragmentRequested = false;
+    MissedArea = 0;
+
+    //释放空页,后面页的序号前移
+    for (int i = (int)Pages.size() - 1; i >= 0; i--)
+    {
+        if (Pages[i].UsedArea > 0)
+            continue;
+        DeletePage(Pages[i]);
+        Pages.erase(Pages.begin() + i);
+        for (auto image : Images) {
+            if (image->Page > i)
+                image->Page--;
+        }
+    }
+}
+
+void ImGui_ImplQtOpenGL3_AtlasSet::GetStats(ImGui_ImplQtOpenGL3_AtlasStats* stats) const
+{
+    stats->Images = (int)Images.size();
+    stats->ResidentImages = 0;
+    for (auto image : Images) {
+        if (image->Page >= 0)
+            stats->ResidentImages++;
+    }
+    stats->Pages = (int)Pages.size();
+    int used_area = 0;
+    for (const ImGui_ImplQtOpenGL3_AtlasPage& page : Pages)
+        used_area += page.UsedArea;
+    stats->Occupancy = Pages.empty() ? 0.0f : (float)used_area / ((float)Pages.size() * PageSize * PageSize);
+    stats->Evictions = Evictions;
+    stats->Defragmentations = Defragmentations;
+    stats->Misses = Misses;
+}
+
+void ImGui_ImplQtOpenGL3_AtlasSet::Shutdown()
+{
+    for (auto image : Images)
+        IM_DELETE(image);
+    Images.clear();
+    Pages.clear();
+}
+
+void ImGui_ImplQtOpenGL3_AtlasSet::ReleaseDeviceObjects()
+{
+    //CPU侧的图像保留,下次使用时重新装箱
+    for (ImGui_ImplQtOpenGL3_AtlasPage& page : Pages)
+        DeletePage(page);
+    Pages.clear();
+    for (auto image : Images)
+        image->Page = -1;
+}
+
+bool ImGui_ImplQtOpenGL3_AtlasSet::Place(ImGui_ImplQtOpenGL3_AtlasImage& image, std::vector<ImGui_ImplQtOpenGL3_AtlasPage>& pages, int max_pages)
+{
+    const int width = ImGui_ImplQtOpenGL3_AtlasPaddedWidth(image);
+    const int height = ImGui_ImplQtOpenGL3_AtlasPaddedHeight(image);
+
+    //在已有的行里找高度最接近的空闲段
+    int best_page = -1, best_shelf = -1, best_span = -1;
+    for (int p = 0; p < (int)pages.size(); p++)
+    {
+        for (int s = 0; s < (int)pages[p].Shelves.size(); s++)
+        {
+            const ImGui_ImplQtOpenGL3_AtlasShelf& shelf = pages[p].Shelves[s];
+            if (shelf.Height < height || (best_shelf >= 0 && shelf.Height >= pages[best_page].Shelves[best_shelf].Height))
+                continue;
+            for (int i = 0; i < (int)shelf.Free.size(); i++) {
+                if (shelf.Free[i].Width >= width) {
+                    best_page = p; best_shelf = s; best_span = i;
+                    break;
+                }
+            }
+        }
+    }
+    //行高超出图像太多时宁可开新行,避免矮图标占满高行
+    if (best_shelf >= 0 && pages[best_page].Shelves[best_shelf].Height > height + height / 2)
+    {
+        for (int p = 0; p < (int)pages.size(); p++) {
+            if (pages[p].Top + height <= PageSize) {
+                best_page = p; best_shelf = -1;
+                break;
+            }
+        }
+    }
+    if (best_shelf < 0)
+    {
+        if (best_page < 0 || pages[best_page].Top + height > PageSize)
+        {
+            best_page = -1;
+            for (int p = 0; p < (int)pages.size() && best_page < 0; p++) {
+                if (pages[p].Top + height <= PageSize)
+                    best_page = p;
+            }
+            if (best_page < 0) {
+                if ((int)pages.size() >= max_pages)
+                    return false;
+                pages.emplace_back();
+                best_page = (int)pages.size() - 1;
+            }
+        }
+        ImGui_ImplQtOpenGL3_AtlasPage& page = pages[best_page];
+        ImGui_ImplQtOpenGL3_AtlasShelf shelf;
+        shelf.Y = page.Top;
+        shelf.Height = height;
+        shelf.Free.push_back({ 0, PageSize });
+        page.Shelves.push_back(shelf);
+        page.Top += height;
+        best_shelf = (int)page.Shelves.size() - 1;
+        best_span = 0;
+    }
+
+    ImGui_ImplQtOpenGL3_AtlasPage& page = pages[best_page];
+    ImGui_ImplQtOpenGL3_AtlasShelf& shelf = page.Shelves[best_shelf];
+    ImGui_ImplQtOpenGL3_AtlasSpan& span = shelf.Free[best_span];
+    image.Page = best_page;
+    image.X = span.X;
+    image.Y = shelf.Y;
+    span.X += width;
+    span.Width -= width;
+    if (span.Width == 0)
+        shelf.Free.erase(shelf.Free.begin() + best_span);
+    page.UsedArea += width * height;
+    return true;
+}
+
+void ImGui_ImplQtOpenGL3_AtlasSet::Unplace(ImGui_ImplQtOpenGL3_AtlasImage& image)
+{
+    ImGui_ImplQtOpenGL3_AtlasPage& page = Pages[image.Page];
+    const int width = ImGui_ImplQtOpenGL3_AtlasPaddedWidth(image);
+    page.UsedArea -= width * ImGui_ImplQtOpenGL3_AtlasPaddedHeight(image);
+    image.Page = -1;
+
+    auto shelf = std::find_if(page.Shelves.begin(), page.Shelves.end(),
+        [&](const ImGui_ImplQtOpenGL3_AtlasShelf& s) { return s.Y == image.Y; });
+    if (shelf == page.Shelves.end())
+        return;
+    //归还空闲段并与相邻段合并
+    auto it = std::lower_bound(shelf->Free.begin(), shelf->Free.end(), image.X,
+        [](const ImGui_ImplQtOpenGL3_AtlasSpan& span, int x) { return span.X < x; });
+    it = shelf->Free.insert(it, { image.X, width });
+    if (it + 1 != shelf->Free.end() && it->X + it->Width == (it + 1)->X) {
+        it->Width += (it + 1)->Width;
+        shelf->Free.erase(it + 1);
+    }
+    if (it != shelf->Free.begin() && (it - 1)->X + (it - 1)->Width == it->X) {
+        (it - 1)->Width += it->Width;
+        shelf->Free.erase(it);
+    }
+
+    //页底部的整行空出时收回高度
+    while (!page.Shelves.empty())
+    {
+        const ImGui_ImplQtOpenGL3_AtlasShelf& last = page.Shelves.back();
+        if (last.Free.size() != 1 || last.Free[0].Width != PageSize)
+            break;
+        page.Top = last.Y;
+        page.Shelves.pop_back();
+    }
+}
+
+bool ImGui_ImplQtOpenGL3_AtlasSet::EvictAndPlace(ImGui_ImplQtOpenGL3_AtlasImage& image)
+{
+    //页面已满时从最久未用的图像开始淘汰,直到腾出位置;当前帧和上一帧用到的图像不淘汰
+    const int frame = ImGui::GetFrameCount();
+    std::vector<ImGui_ImplQtOpenGL3_AtlasImage*> candidates;
+    for (auto other : Images) {
+        if (other->Page >= 0 && other->LastUsedFrame < frame - 1)
+            candidates.push_back(other);
+    }
+    std::sort(candidates.begin(), candidates.end(),
+        [](const ImGui_ImplQtOpenGL3_AtlasImage* lhs, const ImGui_ImplQtOpenGL3_AtlasImage* rhs) {
+            return lhs->LastUsedFrame < rhs->LastUsedFrame;
+        });
+    const int height = ImGui_ImplQtOpenGL3_AtlasPaddedHeight(image);
+    for (auto other : candidates)
+    {
+        //只有所在行放得下新图像的才值得淘汰
+        const std::vector<ImGui_ImplQtOpenGL3_AtlasShelf>& shelves = Pages[other->Page].Shelves;
+        auto shelf = std::find_if(shelves.begin(), shelves.end(),
+            [&](const ImGui_ImplQtOpenGL3_AtlasShelf& s) { return s.Y == other->Y; });
+        if (shelf == shelves.end() || shelf->Height < height)
+            continue;
+        Unplace(*other);
+        Evictions++;
+        if (Place(image, Pages, MaxPages))
+            return true;
+    }
+    return false;
+}
+
+void ImGui_ImplQtOpenGL3_AtlasSet::Defragment(ImVector<ImTextureID>* dirty)
+{
+    //最近用过的图像优先,总面积不超过预算的九成,其余淘汰
+    const int frame = ImGui::GetFrameCount();
+    std::vector<ImGui_ImplQtOpenGL3_AtlasImage*> candidates;
+    for (auto image : Images) {
+        if (image->Page >= 0 || image->LastUsedFrame >= frame - 1)
+            candidates.push_back(image);
+    }
+    std::sort(candidates.begin(), candidates.end(),
+        [](const ImGui_ImplQtOpenGL3_AtlasImage* lhs, const ImGui_ImplQtOpenGL3_AtlasImage* rhs) {
+            return lhs->LastUsedFrame > rhs->LastUsedFrame;
+        });
+    const ImS64 budget_area = (ImS64)MaxPages * PageSize * PageSize * 9 / 10;
+    ImS64 area = 0;
+    size_t selected = 0;
+    for (; selected < candidates.size(); selected++)
+    {
+        const ImGui_ImplQtOpenGL3_AtlasImage& image = *candidates[selected];
+        area += (ImS64)ImGui_ImplQtOpenGL3_AtlasPaddedWidth(image) * ImGui_ImplQtOpenGL3_AtlasPaddedHeight(image);
+        if (area > budget_area)
+            break;
+    }
+    for (size_t i = selected; i < candidates.size(); i++) {
+        if (candidates[i]->Page >= 0)
+            Evictions++;
+        candidates[i]->Page = -1;
+    }
+    candidates.resize(selected);
+
+    //从高到矮重新装箱,行内浪费最少
+    std::sort(candidates.begin(), candidates.end(),
+        [](const ImGui_ImplQtOpenGL3_AtlasImage* lhs, const ImGui_ImplQtOpenGL3_AtlasImage* rhs) {
+            return lhs->Height != rhs->Height ? lhs->Height > rhs->Height : lhs->Width > rhs->Width;
+        });
+    std::vector<ImGui_ImplQtOpenGL3_AtlasPage> pages;
+    for (auto image : Images)
+        image->Page = -1;
+    for (auto image : candidates) {
+        if (!Place(*image, pages, MaxPages))
+            Evictions++;
+    }
+
+    //沿用已有的页纹理,每页在CPU上拼好后整页上传一次
+    for (size_t i = pages.size(); i < Pages.size(); i++)
+        DeletePage(Pages[i]);
+    for (size_t i = 0; i < pages.size(); i++)
+        pages[i].Handle = i < Pages.size() ? Pages[i].Handle : CreatePage();
+    Pages.swap(pages);
+
+    std::vector<unsigned char> buffer;
+    GLint last_texture;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &last_texture);
+#ifdef GL_UNPACK_ROW_LENGTH // Not on WebGL/ES
+    GLint last_unpack_row_length;
+    glGetIntegerv(GL_UNPACK_ROW_LENGTH, &last_unpack_row_length);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+#endif
+    for (int p = 0; p < (int)Pages.size(); p++)
+    {
+        buffer.assign(ImGui_ImplQtOpenGL3_AtlasPageBytes, 0);
+        for (auto image : candidates)
+        {
+            if (image->Page != p)
+                continue;
+            const int width = ImGui_ImplQtOpenGL3_AtlasPaddedWidth(*image);
+            const int height = ImGui_ImplQtOpenGL3_AtlasPaddedHeight(*image);
+            for (int y = 0; y < height; y++)
+                memcpy(buffer.data() + ((size_t)(image->Y + y) * PageSize + image->X) * 4, image->Pixels.data() + (size_t)y * width * 4, (size_t)width * 4);
+        }
+        glBindTexture(GL_TEXTURE_2D, Pages[p].Handle);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, PageSize, PageSize, GL_RGBA, GL_UNSIGNED_BYTE, buffer.data());
+        if (dirty)
+            dirty->push_back((ImTextureID)(intptr_t)Pages[p].Handle);
+    }
+#ifdef GL_UNPACK_ROW_LENGTH
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, last_unpack_row_length);
+#endif
+    glBindTexture(GL_TEXTURE_2D, last_texture);
+    LastDefragmentArea = 0;
+    for (const ImGui_ImplQtOpenGL3_AtlasPage& page : Pages)
+        LastDefragmentArea += page.UsedArea;
+    Defragmentations++;
+}
+
+GLuint ImGui_ImplQtOpenGL3_AtlasSet::CreatePage()
+{
+    GLint last_texture;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &last_texture);
+    GLuint handle = 0;
+    glGenTextures(1, &handle);
+    glBindTexture(GL_TEXTURE_2D, handle);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    //未使用的区域不会被采样,无需清零
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, PageSize, PageSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindTexture(GL_TEXTURE_2D, last_texture);
+    Memory->Allocate(ImGui_ImplQtOpenGL3_MemoryCategory_Textures, ImGui_ImplQtOpenGL3_AtlasPageBytes);
+    return handle;
+}
+
+void ImGui_ImplQtOpenGL3_AtlasSet::DeletePage(ImGui_ImplQtOpenGL3_AtlasPage& page)
+{
+    if (page.Handle) {
+        glDeleteTextures(1, &page.Handle);
+        page.Handle = 0;
+        Memory->Free(ImGui_ImplQtOpenGL3_MemoryCategory_Textures, ImGui_ImplQtOpenGL3_AtlasPageBytes);
+    }
+}
+
+void ImGui_ImplQtOpenGL3_AtlasSet::Upload(const ImGui_ImplQtOpenGL3_AtlasImage& image)
+{
+    GLint last_texture;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &last_texture);
+    glBindTexture(GL_TEXTURE_2D, Pages[image.Page].Handle);
+#ifdef GL_UNPACK_ROW_LENGTH // Not on WebGL/ES
+    GLint last_unpack_row_length;
+    glGetIntegerv(GL_UNPACK_ROW_LENGTH, &last_unpack_row_length);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+#endif
+    glTexSubImage2D(GL_TEXTURE_2D, 0, image.X, image.Y, ImGui_ImplQtOpenGL3_AtlasPaddedWidth(image), ImGui_ImplQtOpenGL3_AtlasPaddedHeight(image),
+        GL_RGBA, GL_UNSIGNED_BYTE, image.Pixels.data());
+#ifdef GL_UNPACK_ROW_LENGTH
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, last_unpack_row_length);
+#endif
+    glBindTexture(GL_TEXTURE_2D, last_texture);
+}
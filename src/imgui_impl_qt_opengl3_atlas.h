@@ -0,0 +1,80 @@
+#pragma once
+
+#include <QtGui/QOpenGLExtraFunctions>
+#include <vector>
+
+#include "imgui.h"
+#include "imgui_impl_qt_opengl3.h"
+#include "imgui_impl_qt_opengl3_memory.h"
+
+// Small user image, kept on the CPU with a one pixel border that repeats its edges so bilinear filtering never reads a
+// neighbour. Page is -1 while the image is not packed (new, evicted, or the context was lost).
+struct ImGui_ImplQtOpenGL3_AtlasImage
+{
+    int    Width{};
+    int    Height{};
+    std::vector<unsigned char> Pixels;  // (Width + 2) x (Height + 2) RGBA
+    int    Page{ -1 };
+    int    X{};                     // Padded rectangle in the page
+    int    Y{};
+    int    LastUsedFrame{ -1 };
+};
+
+// Free span of a shelf
+struct ImGui_ImplQtOpenGL3_AtlasSpan
+{
+    int    X;
+    int    Width;
+};
+
+// Row of a page. Images of at most its height are placed side by side into its free spans, removed images give
+// their span back.
+struct ImGui_ImplQtOpenGL3_AtlasShelf
+{
+    int    Y{};
+    int    Height{};
+    std::vector<ImGui_ImplQtOpenGL3_AtlasSpan> Free;   // Sorted by X, adjacent spans merged
+};
+
+struct ImGui_ImplQtOpenGL3_AtlasPage
+{
+    GLuint Handle{};
+    int    Top{};                   // Shelves end here
+    int    UsedArea{};              // Padded images
+    std::vector<ImGui_ImplQtOpenGL3_AtlasShelf> Shelves;
+};
+
+class ImGui_ImplQtOpenGL3_AtlasSet :public QOpenGLExtraFunctions
+{
+public:
+    enum { PageSize = 1024, MaxImageSize = 256, Padding = 1 };
+
+    void Init();
+    ImGui_ImplQtOpenGL3_AtlasImage* Add(const void* rgba_pixels, int width, int height, int stride);  // No GL calls
+    void Remove(ImGui_ImplQtOpenGL3_AtlasImage* image);
+    bool GetRegion(ImGui_ImplQtOpenGL3_AtlasImage* image, ImGui_ImplQtOpenGL3_AtlasRegion* region);
+    void Update(ImVector<ImTextureID>* dirty);     // Between frames: repacks when needed, frees empty pages
+    void GetStats(ImGui_ImplQtOpenGL3_AtlasStats* stats) const;
+    void ReleaseDeviceObjects();    // Device objects destroyed or context lost: pages are released, images are packed again on next use
+    void Shutdown();                // Frees the images the application did not remove, pages are released already
+public:
+    int MaxPages{ 4 };
+    ImGui_ImplQtOpenGL3_MemoryTracker* Memory{};
+private:
+    static bool Place(ImGui_ImplQtOpenGL3_AtlasImage& image, std::vector<ImGui_ImplQtOpenGL3_AtlasPage>& pages, int max_pages);
+    void Unplace(ImGui_ImplQtOpenGL3_AtlasImage& image);
+    bool EvictAndPlace(ImGui_ImplQtOpenGL3_AtlasImage& image);
+    void Defragment(ImVector<ImTextureID>* dirty);
+    GLuint CreatePage();
+    void DeletePage(ImGui_ImplQtOpenGL3_AtlasPage& page);
+    void Upload(const ImGui_ImplQtOpenGL3_AtlasImage& image);
+private:
+    std::vector<ImGui_ImplQtOpenGL3_AtlasImage*> Images;
+    std::vector<ImGui_ImplQtOpenGL3_AtlasPage> Pages;
+    bool DefragmentRequested{};
+    ImS64 MissedArea{};             // Of the images that could not be placed this frame
+    ImS64 LastDefragmentArea{ -1 };
+    int  Evictions{};
+    int  Defragmentations{};
+    int  Misses{};
+};
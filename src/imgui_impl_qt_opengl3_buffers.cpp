@@ -0,0 +1,93 @@
+﻿#include "imgui_impl_qt_opengl3_buffers.h"
+
+void ImGui_ImplQtOpenGL3_BufferCache::Init()
+{
+    initializeOpenGLFunctions();
+}
+
+const ImGui_ImplQtOpenGL3_CachedBuffers* ImGui_ImplQtOpenGL3_BufferCache::Lookup(const ImDrawList* cmd_list, ImU64 hash)
+{
+    //哈希已包含数据长度,相同即可直接复用
+    auto it = Buffers.find(cmd_list);
+    if (it == Buffers.end() || !it->VboHandle || it->Hash != hash)
+        return nullptr;
+    it->LastUsedFrame = ImGui::GetFrameCount();
+    Hits++;
+    BytesSaved += (size_t)cmd_list->VtxBuffer.size_in_bytes() + (size_t)cmd_list->IdxBuffer.size_in_bytes();
+    return &it.value();
+}
+
+const ImGui_ImplQtOpenGL3_CachedBuffers& ImGui_ImplQtOpenGL3_BufferCache::Upload(const ImDrawList* cmd_list, ImU64 hash, const void* vtx_data, GLsizeiptr vtx_buffer_size, bool compact, const ImVec2& vtx_origin)
+{
+    ImGui_ImplQtOpenGL3_CachedBuffers& buffers = Buffers[cmd_list];
+    const GLsizeiptr idx_buffer_size = (GLsizeiptr)cmd_list->IdxBuffer.Size * (int)sizeof(ImDrawIdx);
+    buffers.LastUsedFrame = ImGui::GetFrameCount();
+    if (!buffers.VboHandle)
+    {
+        glGenBuffers(1, &buffers.VboHandle);
+        glGenBuffers(1, &buffers.ElementsHandle);
+        Memory->Allocate(ImGui_ImplQtOpenGL3_MemoryCategory_VertexBuffers, 0);
+        Memory->Allocate(ImGui_ImplQtOpenGL3_MemoryCategory_IndexBuffers, 0);
+    }
+    ResidentBytes -= (size_t)(buffers.VertexBufferSize + buffers.IndexBufferSize);
+    Memory->Reallocate(ImGui_ImplQtOpenGL3_MemoryCategory_VertexBuffers, (size_t)buffers.VertexBufferSize, (size_t)vtx_buffer_size);
+    Memory->Reallocate(ImGui_ImplQtOpenGL3_MemoryCategory_IndexBuffers, (size_t)buffers.IndexBufferSize, (size_t)idx_buffer_size);
+
+    //内容会在多帧内保持不变,使用GL_DYNAMIC_DRAW提示驱动放在显存中
+    //元素缓冲的绑定会记录在当前VAO中,调用方需在绑定VAO后使用
+    glBindBuffer(GL_ARRAY_BUFFER, buffers.VboHandle);
+    glBufferData(GL_ARRAY_BUFFER, vtx_buffer_size, vtx_data, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers.ElementsHandle);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, idx_buffer_size, (const GLvoid*)cmd_list->IdxBuffer.Data, GL_DYNAMIC_DRAW);
+    buffers.VertexBufferSize = vtx_buffer_size;
+    buffers.IndexBufferSize = idx_buffer_size;
+    buffers.Hash = hash;
+    buffers.Compact = compact;
+    buffers.VtxOrigin = vtx_origin;
+
+    ResidentBytes += (size_t)(vtx_buffer_size + idx_buffer_size);
+    Misses++;
+    BytesUploaded += (size_t)(vtx_buffer_size + idx_buffer_size);
+    return buffers;
+}
+
+void ImGui_ImplQtOpenGL3_BufferCache::Touch(const ImDrawList* cmd_list)
+{
+    auto it = Buffers.find(cmd_list);
+    if (it != Buffers.end())
+        it->LastUsedFrame = ImGui::GetFrameCount();
+}
+
+void ImGui_ImplQtOpenGL3_BufferCache::Collect()
+{
+    //窗口关闭或折叠后其绘制列表不再提交,超过空闲帧数后释放对应缓冲
+    const int frame = ImGui::GetFrameCount();
+    for (auto it = Buffers.begin(); it != Buffers.end();)
+    {
+        if (frame - it->LastUsedFrame > MaxIdleFrames)
+        {
+            glDeleteBuffers(1, &it->VboHandle);
+            glDeleteBuffers(1, &it->ElementsHandle);
+            ResidentBytes -= (size_t)(it->VertexBufferSize + it->IndexBufferSize);
+            Memory->Free(ImGui_ImplQtOpenGL3_MemoryCategory_VertexBuffers, (size_t)it->VertexBufferSize);
+            Memory->Free(ImGui_ImplQtOpenGL3_MemoryCategory_IndexBuffers, (size_t)it->IndexBufferSize);
+            it = Buffers.erase(it);
+        }
+        else
+            ++it;
+    }
+    Hits = Misses = 0;
+    BytesUploaded = BytesSaved = 0;
+}
+
+void ImGui_ImplQtOpenGL3_BufferCache::DestroyDeviceObjects()
+{
+    for (auto& buffers : Buffers) {
+        glDeleteBuffers(1, &buffers.VboHandle);
+        glDeleteBuffers(1, &buffers.ElementsHandle);
+        Memory->Free(ImGui_ImplQtOpenGL3_MemoryCategory_VertexBuffers, (size_t)buffers.VertexBufferSize);
+        Memory->Free(ImGui_ImplQtOpenGL3_MemoryCategory_IndexBuffers, (size_t)buffers.IndexBufferSize);
+    }
+    Buffers.clear();
+    ResidentBytes = 0;
+}
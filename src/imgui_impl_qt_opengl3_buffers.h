@@ -0,0 +1,44 @@
+#pragma once
+
+#include <QtGui/QOpenGLExtraFunctions>
+#include <QtCore/QHash>
+
+#include "imgui.h"
+#include "imgui_impl_qt_opengl3_memory.h"
+
+// Vertex/index buffers kept on the GPU for one draw list, re-uploaded only when the content hash changes
+struct ImGui_ImplQtOpenGL3_CachedBuffers
+{
+    GLuint     VboHandle{};
+    GLuint     ElementsHandle{};
+    GLsizeiptr VertexBufferSize{};
+    GLsizeiptr IndexBufferSize{};
+    ImU64      Hash{};
+    int        LastUsedFrame{};
+    bool       Compact{};           // Vertices are ImGui_ImplQtOpenGL3_CompactVert relative to VtxOrigin
+    ImVec2     VtxOrigin{};
+};
+
+class ImGui_ImplQtOpenGL3_BufferCache :public QOpenGLExtraFunctions
+{
+public:
+    void Init();
+    // Returns nullptr when the list must be uploaded again
+    const ImGui_ImplQtOpenGL3_CachedBuffers* Lookup(const ImDrawList* cmd_list, ImU64 hash);
+    const ImGui_ImplQtOpenGL3_CachedBuffers& Upload(const ImDrawList* cmd_list, ImU64 hash, const void* vtx_data, GLsizeiptr vtx_buffer_size, bool compact, const ImVec2& vtx_origin);
+    void Touch(const ImDrawList* cmd_list);     // Keeps the buffers of a list that was skipped this frame
+    void Collect();
+    void DestroyDeviceObjects();
+public:
+    int    MaxIdleFrames{ 60 };     // Buffers of draw lists not rendered for this many frames are released
+    ImGui_ImplQtOpenGL3_MemoryTracker* Memory{};
+
+    // Counters of the current frame, reset by Collect()
+    int    Hits{};
+    int    Misses{};
+    size_t BytesUploaded{};
+    size_t BytesSaved{};
+    size_t ResidentBytes{};
+private:
+    QHash<const ImDrawList*, ImGui_ImplQtOpenGL3_CachedBuffers> Buffers;
+};
@@ -0,0 +1,105 @@
+﻿#include "imgui_impl_qt_opengl3_commands.h"
+#include "imgui_internal.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define IMGUI_IMPL_QT_COMMANDS_SSE2
+#endif
+
+void ImGui_ImplQtOpenGL3_CompileCommands(const ImDrawList* cmd_list, const ImVec2& clip_off, const ImVec2& clip_scale,
+    const ImVec4& clip_rect, const ImVec2& target_origin, int target_height,
+    ImVector<ImGui_ImplQtOpenGL3_RenderCmd>* out, ImGui_ImplQtOpenGL3_CommandStats* stats)
+{
+    out->resize(0);
+    out->reserve(cmd_list->CmdBuffer.Size);
+
+    //裁剪矩形 (x0,y0,x1,y1) 作为一个4通道向量整体投影、夹取并换算为glScissor参数:
+    //(x0 - ox, h + oy - y1, x1 - x0, y1 - y0)
+#ifdef IMGUI_IMPL_QT_COMMANDS_SSE2
+    const __m128 v_off = _mm_setr_ps(clip_off.x, clip_off.y, clip_off.x, clip_off.y);
+    const __m128 v_scale = _mm_setr_ps(clip_scale.x, clip_scale.y, clip_scale.x, clip_scale.y);
+    const __m128 v_clip_min = _mm_setr_ps(clip_rect.x, clip_rect.y, clip_rect.x, clip_rect.y);
+    const __m128 v_clip_max = _mm_setr_ps(clip_rect.z, clip_rect.w, clip_rect.z, clip_rect.w);
+    const __m128 v_a_mul = _mm_setr_ps(1.0f, 0.0f, 1.0f, 1.0f);
+    const __m128 v_a_add = _mm_setr_ps(0.0f, (float)target_height + target_origin.y, 0.0f, 0.0f);
+    const __m128 v_b_mul = _mm_setr_ps(0.0f, 1.0f, 1.0f, 1.0f);
+    const __m128 v_b_add = _mm_setr_ps(target_origin.x, 0.0f, 0.0f, 0.0f);
+#endif
+
+    int last_scissor[4] = { -1, -1, -1, -1 };
+    ImTextureID last_texture = (ImTextureID)0;
+    bool state_known = false;
+    for (int cmd_i = 0; cmd_i < cmd_list->CmdBuffer.Size; cmd_i++)
+    {
+        const ImDrawCmd* pcmd = &cmd_list->CmdBuffer[cmd_i];
+        if (pcmd->UserCallback != nullptr)
+        {
+            //回调可能改动任意GL状态,其后的命令需要重新设置
+            ImGui_ImplQtOpenGL3_RenderCmd cmd = {};
+            cmd.Callback = pcmd;
+            out->push_back(cmd);
+            state_known = false;
+            continue;
+        }
+
+        int scissor[4];
+#ifdef IMGUI_IMPL_QT_COMMANDS_SSE2
+        const __m128 rect = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&pcmd->ClipRect.x), v_off), v_scale);
+        const __m128 lo = _mm_max_ps(rect, v_clip_min);
+        const __m128 hi = _mm_min_ps(rect, v_clip_max);
+        const __m128 c = _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 2, 1, 0));                   // (x0, y0, x1, y1)
+        const __m128 empty = _mm_cmple_ps(_mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 2, 3, 2)), c); // x1 <= x0, y1 <= y0 in lanes 0, 1
+        if ((_mm_movemask_ps(empty) & 3) != 0 || pcmd->ElemCount == 0)
+        {
+            stats->Culled++;
+            continue;
+        }
+        const __m128 a = _mm_add_ps(_mm_mul_ps(c, v_a_mul), v_a_add);                                           // (x0, h + oy, x1, y1)
+        const __m128 b = _mm_add_ps(_mm_mul_ps(_mm_shuffle_ps(c, c, _MM_SHUFFLE(1, 0, 3, 0)), v_b_mul), v_b_add); // (ox, y1, x0, y0)
+        _mm_storeu_si128((__m128i*)scissor, _mm_cvttps_epi32(_mm_sub_ps(a, b)));
+#else
+        const float x0 = ImMax((pcmd->ClipRect.x - clip_off.x) * clip_scale.x, clip_rect.x);
+        const float y0 = ImMax((pcmd->ClipRect.y - clip_off.y) * clip_scale.y, clip_rect.y);
+        const float x1 = ImMin((pcmd->ClipRect.z - clip_off.x) * clip_scale.x, clip_rect.z);
+        const float y1 = ImMin((pcmd->ClipRect.w - clip_off.y) * clip_scale.y, clip_rect.w);
+        if (x1 <= x0 || y1 <= y0 || pcmd->ElemCount == 0)
+        {
+            stats->Culled++;
+            continue;
+        }
+        scissor[0] = (int)(x0 - target_origin.x);
+        scissor[1] = (int)((float)target_height + target_origin.y - y1);
+        scissor[2] = (int)(x1 - x0);
+        scissor[3] = (int)(y1 - y0);
+#endif
+
+        const ImTextureID texture = pcmd->GetTexID();
+        const bool same_scissor = state_known && scissor[0] == last_scissor[0] && scissor[1] == last_scissor[1]
+            && scissor[2] == last_scissor[2] && scissor[3] == last_scissor[3];
+        const bool same_texture = state_known && texture == last_texture;
+
+        //状态相同且索引连续的命令合并为一次绘制
+        if (same_scissor && same_texture && out->Size > 0)
+        {
+            ImGui_ImplQtOpenGL3_RenderCmd& prev = out->back();
+            if (prev.Callback == nullptr && prev.VtxOffset == pcmd->VtxOffset && prev.IdxOffset + prev.ElemCount == pcmd->IdxOffset)
+            {
+                prev.ElemCount += pcmd->ElemCount;
+                stats->Merged++;
+                continue;
+            }
+        }
+
+        ImGui_ImplQtOpenGL3_RenderCmd cmd;
+        for (int i = 0; i < 4; i++)
+            cmd.Scissor[i] = last_scissor[i] = scissor[i];
+        cmd.TextureId = last_texture = texture;
+        cmd.ElemCount = pcmd->ElemCount;
+        cmd.IdxOffset = pcmd->IdxOffset;
+        cmd.VtxOffset = pcmd->VtxOffset;
+        cmd.Callback = nullptr;
+        cmd.Flags = (same_scissor ? 0 : ImGui_ImplQtOpenGL3_RenderCmdFlags_SetScissor) | (same_texture ? 0 : ImGui_ImplQtOpenGL3_RenderCmdFlags_BindTexture);
+        out->push_back(cmd);
+        state_known = true;
+    }
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "imgui.h"
+
+enum ImGui_ImplQtOpenGL3_RenderCmdFlags_
+{
+    ImGui_ImplQtOpenGL3_RenderCmdFlags_None         = 0,
+    ImGui_ImplQtOpenGL3_RenderCmdFlags_SetScissor   = 1 << 0,   // Scissor differs from the previous command
+    ImGui_ImplQtOpenGL3_RenderCmdFlags_BindTexture  = 1 << 1,   // Texture differs from the previous command
+};
+
+// Draw command ready for submission, produced by ImGui_ImplQtOpenGL3_CompileCommands()
+struct ImGui_ImplQtOpenGL3_RenderCmd
+{
+    int          Scissor[4];    // x, y, width, height in the render target, lower-left origin
+    ImTextureID  TextureId;
+    unsigned int ElemCount;
+    unsigned int IdxOffset;
+    unsigned int VtxOffset;
+    const ImDrawCmd* Callback;  // User callback command, the other fields are unused
+    int          Flags;         // ImGui_ImplQtOpenGL3_RenderCmdFlags_
+};
+
+struct ImGui_ImplQtOpenGL3_CommandStats
+{
+    int Culled;     // Empty or outside of clip_rect
+    int Merged;     // Folded into the previous command (same state, contiguous indices)
+};
+
+// Projects the clip rectangles of a draw list into the render target, clamps them to clip_rect (framebuffer space),
+// drops empty commands, merges commands that ended up with identical state and flags redundant state changes.
+// Commands keep their submission order since blending depends on it.
+void ImGui_ImplQtOpenGL3_CompileCommands(const ImDrawList* cmd_list, const ImVec2& clip_off, const ImVec2& clip_scale,
+    const ImVec4& clip_rect, const ImVec2& target_origin, int target_height,
+    ImVector<ImGui_ImplQtOpenGL3_RenderCmd>* out, ImGui_ImplQtOpenGL3_CommandStats* stats);
@@ -0,0 +1,106 @@
+﻿#include "imgui_impl_qt_opengl3_compact.h"
+#include <string.h>
+#include <stddef.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define IMGUI_IMPL_QT_COMPACT_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define IMGUI_IMPL_QT_COMPACT_NEON
+#endif
+
+//SIMD路径把pos和uv当作连续的4个float一次读取
+static_assert(sizeof(ImDrawVert) == 20 && offsetof(ImDrawVert, pos) == 0 && offsetof(ImDrawVert, uv) == 8 && offsetof(ImDrawVert, col) == 16,
+    "Compact vertices require the default ImDrawVert layout");
+static_assert(sizeof(ImGui_ImplQtOpenGL3_CompactVert) == 12, "");
+
+bool ImGui_ImplQtOpenGL3_GetCompactOrigin(const ImDrawVert* vtx, int count, ImVec2* origin)
+{
+    if (count <= 0)
+        return false;
+
+    //一次求出 (pos.x, pos.y, uv.x, uv.y) 四个分量的最小值和最大值
+    float min[4], max[4];
+#if defined(IMGUI_IMPL_QT_COMPACT_SSE2)
+    __m128 vmin = _mm_loadu_ps(&vtx[0].pos.x);
+    __m128 vmax = vmin;
+    for (int i = 1; i < count; i++)
+    {
+        const __m128 v = _mm_loadu_ps(&vtx[i].pos.x);
+        vmin = _mm_min_ps(vmin, v);
+        vmax = _mm_max_ps(vmax, v);
+    }
+    _mm_storeu_ps(min, vmin);
+    _mm_storeu_ps(max, vmax);
+#elif defined(IMGUI_IMPL_QT_COMPACT_NEON)
+    float32x4_t vmin = vld1q_f32(&vtx[0].pos.x);
+    float32x4_t vmax = vmin;
+    for (int i = 1; i < count; i++)
+    {
+        const float32x4_t v = vld1q_f32(&vtx[i].pos.x);
+        vmin = vminq_f32(vmin, v);
+        vmax = vmaxq_f32(vmax, v);
+    }
+    vst1q_f32(min, vmin);
+    vst1q_f32(max, vmax);
+#else
+    memcpy(min, &vtx[0].pos.x, sizeof(min));
+    memcpy(max, &vtx[0].pos.x, sizeof(max));
+    for (int i = 1; i < count; i++)
+    {
+        const float v[4] = { vtx[i].pos.x, vtx[i].pos.y, vtx[i].uv.x, vtx[i].uv.y };
+        for (int c = 0; c < 4; c++)
+        {
+            min[c] = v[c] < min[c] ? v[c] : min[c];
+            max[c] = v[c] > max[c] ? v[c] : max[c];
+        }
+    }
+#endif
+
+    const float range = 65535.0f / ImGui_ImplQtOpenGL3_CompactPosScale;
+    if (!(max[0] - min[0] <= range && max[1] - min[1] <= range))
+        return false;
+    if (!(min[2] >= 0.0f && min[3] >= 0.0f && max[2] <= 1.0f && max[3] <= 1.0f))
+        return false;
+    *origin = ImVec2(min[0], min[1]);
+    return true;
+}
+
+void ImGui_ImplQtOpenGL3_ConvertCompact(const ImDrawVert* vtx, int count, const ImVec2& origin, ImGui_ImplQtOpenGL3_CompactVert* out)
+{
+    const float s = ImGui_ImplQtOpenGL3_CompactPosScale;
+#if defined(IMGUI_IMPL_QT_COMPACT_SSE2)
+    //SSE2没有无符号饱和打包,先偏移到有符号范围再打包,最后翻转符号位
+    const __m128 offset = _mm_setr_ps(origin.x, origin.y, 0.0f, 0.0f);
+    const __m128 scale = _mm_setr_ps(s, s, 65535.0f, 65535.0f);
+    const __m128i bias = _mm_set1_epi32(32768);
+    const __m128i sign = _mm_set1_epi16((short)0x8000);
+    for (int i = 0; i < count; i++)
+    {
+        const __m128 v = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&vtx[i].pos.x), offset), scale);
+        const __m128i q = _mm_sub_epi32(_mm_cvtps_epi32(v), bias);
+        const __m128i packed = _mm_xor_si128(_mm_packs_epi32(q, q), sign);
+        _mm_storel_epi64((__m128i*)&out[i], packed);
+        out[i].col = vtx[i].col;
+    }
+#elif defined(IMGUI_IMPL_QT_COMPACT_NEON)
+    const float32x4_t offset = { origin.x, origin.y, 0.0f, 0.0f };
+    const float32x4_t scale = { s, s, 65535.0f, 65535.0f };
+    for (int i = 0; i < count; i++)
+    {
+        const float32x4_t v = vmulq_f32(vsubq_f32(vld1q_f32(&vtx[i].pos.x), offset), scale);
+        vst1_u16((ImU16*)&out[i], vqmovn_u32(vcvtnq_u32_f32(v)));
+        out[i].col = vtx[i].col;
+    }
+#else
+    for (int i = 0; i < count; i++)
+    {
+        out[i].pos[0] = (ImU16)((vtx[i].pos.x - origin.x) * s + 0.5f);
+        out[i].pos[1] = (ImU16)((vtx[i].pos.y - origin.y) * s + 0.5f);
+        out[i].uv[0] = (ImU16)(vtx[i].uv.x * 65535.0f + 0.5f);
+        out[i].uv[1] = (ImU16)(vtx[i].uv.y * 65535.0f + 0.5f);
+        out[i].col = vtx[i].col;
+    }
+#endif
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "imgui.h"
+
+// Compact vertex uploaded instead of ImDrawVert (12 bytes instead of 20):
+// position in 1/CompactPosScale pixel units relative to the origin of the draw list, UV as unorm16, RGBA8 color.
+struct ImGui_ImplQtOpenGL3_CompactVert
+{
+    ImU16 pos[2];
+    ImU16 uv[2];
+    ImU32 col;
+};
+
+static const float ImGui_ImplQtOpenGL3_CompactPosScale = 8.0f;
+
+// Returns false when the vertices do not fit: positions spanning more than 65535/CompactPosScale
+// units or UVs outside [0,1] (e.g. repeated textures).
+bool ImGui_ImplQtOpenGL3_GetCompactOrigin(const ImDrawVert* vtx, int count, ImVec2* origin);
+void ImGui_ImplQtOpenGL3_ConvertCompact(const ImDrawVert* vtx, int count, const ImVec2& origin, ImGui_ImplQtOpenGL3_CompactVert* out);
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "imgui_impl_qt_opengl3.h"
+
+// Feature level traits the renderer is instantiated with. Every member is a compile-time constant: tests on them in
+// the render loop fold away and an instantiation does not contain the GL calls of features its level lacks.
+// Features missing from the GL headers the renderer is built with (IMGUI_IMPL_OPENGL_MAY_HAVE_*) stay compiled out.
+struct ImGui_ImplQtOpenGL3_FeaturesGL30
+{
+    static const bool VtxOffset = false;            // glDrawElementsBaseVertex(), GL 3.2+
+    static const bool BindSampler = false;          // glBindSampler(), GL 3.3+/ES 3.0+
+    static const bool PrimitiveRestart = false;     // GL_PRIMITIVE_RESTART state, GL 3.1+ (ES only has the fixed index variant)
+    static const bool ClipOrigin = false;           // glClipControl(), GL 4.5+ or GL_ARB_clip_control
+    static const bool Multisample = true;           // GL_MULTISAMPLE state, desktop GL
+};
+
+struct ImGui_ImplQtOpenGL3_FeaturesGL33
+{
+    static const bool VtxOffset = true;
+    static const bool BindSampler = true;
+    static const bool PrimitiveRestart = true;
+    static const bool ClipOrigin = false;
+    static const bool Multisample = true;
+};
+
+struct ImGui_ImplQtOpenGL3_FeaturesGL45
+{
+    static const bool VtxOffset = true;
+    static const bool BindSampler = true;
+    static const bool PrimitiveRestart = true;
+    static const bool ClipOrigin = true;
+    static const bool Multisample = true;
+};
+
+struct ImGui_ImplQtOpenGL3_FeaturesES3
+{
+    static const bool VtxOffset = false;
+    static const bool BindSampler = true;
+    static const bool PrimitiveRestart = false;
+    static const bool ClipOrigin = false;
+    static const bool Multisample = false;
+};
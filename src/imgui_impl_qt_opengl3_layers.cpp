@@ -0,0 +1,173 @@
+﻿#include "imgui_impl_qt_opengl3_layers.h"
+#include <vector>
+#include <algorithm>
+
+static int ImGui_ImplQtOpenGL3_CountBits(ImU32 bits)
+{
+    int count = 0;
+    for (; bits; bits &= bits - 1)
+        count++;
+    return count;
+}
+
+void ImGui_ImplQtOpenGL3_LayerCache::Init()
+{
+    initializeOpenGLFunctions();
+}
+
+ImGui_ImplQtOpenGL3_Layer* ImGui_ImplQtOpenGL3_LayerCache::Acquire(const ImDrawList* cmd_list, const ImVec4& bounds, ImU64 hash, bool textures_changed, bool* needs_render)
+{
+    ImGui_ImplQtOpenGL3_Layer& layer = Layers[cmd_list];
+    const int frame = ImGui::GetFrameCount();
+    layer.LastUsedFrame = frame;
+    *needs_render = false;
+    if (frame < layer.DirectUntilFrame)
+    {
+        Direct++;
+        return nullptr;
+    }
+
+    const int width = (int)(bounds.z - bounds.x);
+    const int height = (int)(bounds.w - bounds.y);
+    const bool resized = (width != layer.Width || height != layer.Height);
+    if (layer.Texture && !resized && !textures_changed && layer.Hash == hash
+        && layer.Bounds.x == bounds.x && layer.Bounds.y == bounds.y)
+    {
+        Composited++;
+        return &layer;
+    }
+
+    //最近8帧内重绘次数过多说明内容在持续变化,缓存只会多一次合成开销
+    if (ImGui_ImplQtOpenGL3_CountBits(layer.RenderHistory & 0xFF) >= ThrashThreshold)
+    {
+        Release(layer);
+        layer.RenderHistory = 0;
+        layer.DirectUntilFrame = frame + CooldownFrames;
+        Direct++;
+        return nullptr;
+    }
+
+    if ((!layer.Texture || resized) && !Allocate(layer, width, height))
+    {
+        layer.DirectUntilFrame = frame + CooldownFrames;
+        Direct++;
+        return nullptr;
+    }
+
+    layer.Bounds = bounds;
+    layer.Hash = hash;
+    layer.RenderHistory |= 1;
+    *needs_render = true;
+    Rendered++;
+    Composited++;
+    return &layer;
+}
+
+void ImGui_ImplQtOpenGL3_LayerCache::Touch(const ImDrawList* cmd_list)
+{
+    auto it = Layers.find(cmd_list);
+    if (it != Layers.end())
+        it->LastUsedFrame = ImGui::GetFrameCount();
+}
+
+bool ImGui_ImplQtOpenGL3_LayerCache::Allocate(ImGui_ImplQtOpenGL3_Layer& layer, int width, int height)
+{
+    Release(layer);
+    if (width <= 0 || height <= 0)
+        return false;
+    const size_t bytes = (size_t)width * (size_t)height * 4;
+    if (ResidentBytes + bytes > BudgetBytes)
+        EvictIdle(bytes);
+    if (ResidentBytes + bytes > BudgetBytes)
+        return false;
+
+    GLint last_texture, last_framebuffer;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &last_texture);
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &last_framebuffer);
+
+    glGenTextures(1, &layer.Texture);
+    glBindTexture(GL_TEXTURE_2D, layer.Texture);
+    //图层与帧缓冲像素一一对应,使用最近点采样避免合成时模糊
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+    glGenFramebuffers(1, &layer.Framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, layer.Framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, layer.Texture, 0);
+    const bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, (GLuint)last_framebuffer);
+    glBindTexture(GL_TEXTURE_2D, (GLuint)last_texture);
+
+    layer.Width = width;
+    layer.Height = height;
+    ResidentBytes += bytes;
+    Memory->Allocate(ImGui_ImplQtOpenGL3_MemoryCategory_Textures, bytes);
+    if (!complete)
+        Release(layer);
+    return complete;
+}
+
+void ImGui_ImplQtOpenGL3_LayerCache::Release(ImGui_ImplQtOpenGL3_Layer& layer)
+{
+    if (layer.Framebuffer) { glDeleteFramebuffers(1, &layer.Framebuffer); layer.Framebuffer = 0; }
+    if (layer.Texture)
+    {
+        glDeleteTextures(1, &layer.Texture);
+        layer.Texture = 0;
+        ResidentBytes -= (size_t)layer.Width * (size_t)layer.Height * 4;
+        Memory->Free(ImGui_ImplQtOpenGL3_MemoryCategory_Textures, (size_t)layer.Width * (size_t)layer.Height * 4);
+    }
+    layer.Width = layer.Height = 0;
+}
+
+void ImGui_ImplQtOpenGL3_LayerCache::EvictIdle(size_t required_bytes)
+{
+    //只淘汰上一帧之前的图层,本帧和上一帧用到的图层即将被合成
+    const int frame = ImGui::GetFrameCount();
+    std::vector<ImGui_ImplQtOpenGL3_Layer*> candidates;
+    for (auto& layer : Layers) {
+        if (layer.Texture && layer.LastUsedFrame < frame - 1)
+            candidates.push_back(&layer);
+    }
+    std::sort(candidates.begin(), candidates.end(),
+        [](const ImGui_ImplQtOpenGL3_Layer* lhs, const ImGui_ImplQtOpenGL3_Layer* rhs) {
+            return lhs->LastUsedFrame < rhs->LastUsedFrame;
+        });
+    for (auto layer : candidates)
+    {
+        if (ResidentBytes + required_bytes <= BudgetBytes)
+            break;
+        Release(*layer);
+    }
+}
+
+void ImGui_ImplQtOpenGL3_LayerCache::Collect()
+{
+    const int frame = ImGui::GetFrameCount();
+    for (auto it = Layers.begin(); it != Layers.end();)
+    {
+        if (frame - it->LastUsedFrame > MaxIdleFrames)
+        {
+            Release(*it);
+            it = Layers.erase(it);
+        }
+        else
+        {
+            it->RenderHistory <<= 1;
+            ++it;
+        }
+    }
+    Composited = Rendered = Direct = 0;
+}
+
+void ImGui_ImplQtOpenGL3_LayerCache::DestroyDeviceObjects()
+{
+    for (auto& layer : Layers)
+        Release(layer);
+    Layers.clear();
+    ResidentBytes = 0;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <QtGui/QOpenGLExtraFunctions>
+#include <QtCore/QHash>
+
+#include "imgui.h"
+#include "imgui_impl_qt_opengl3_memory.h"
+
+// Offscreen copy of one draw list, rendered only when the list changed and composited as a single quad.
+// The texture holds premultiplied alpha and covers Bounds (framebuffer pixels, top-left origin).
+struct ImGui_ImplQtOpenGL3_Layer
+{
+    GLuint Framebuffer{};
+    GLuint Texture{};
+    int    Width{};
+    int    Height{};
+    ImVec4 Bounds{};
+    ImU64  Hash{};
+    int    LastUsedFrame{};
+    ImU32  RenderHistory{};     // One bit per frame, set when the layer was re-rendered
+    int    DirectUntilFrame{};  // Drawn directly until this frame after thrashing or running out of budget
+};
+
+class ImGui_ImplQtOpenGL3_LayerCache :public QOpenGLExtraFunctions
+{
+public:
+    void Init();
+    // Returns nullptr when the draw list should be rendered directly
+    ImGui_ImplQtOpenGL3_Layer* Acquire(const ImDrawList* cmd_list, const ImVec4& bounds, ImU64 hash, bool textures_changed, bool* needs_render);
+    void Touch(const ImDrawList* cmd_list);     // Keeps a layer whose list was skipped this frame
+    void Collect();
+    void DestroyDeviceObjects();
+public:
+    size_t BudgetBytes{ 64u * 1024u * 1024u };
+    int    MinVertices{ 512 };      // Smaller lists are cheaper to draw than to composite
+    int    ThrashThreshold{ 4 };    // Re-renders within the last 8 frames before falling back to direct rendering
+    int    CooldownFrames{ 120 };
+    int    MaxIdleFrames{ 60 };
+    ImGui_ImplQtOpenGL3_MemoryTracker* Memory{};
+
+    // Counters of the current frame, reset by Collect()
+    int    Composited{};
+    int    Rendered{};
+    int    Direct{};
+    size_t ResidentBytes{};
+private:
+    bool Allocate(ImGui_ImplQtOpenGL3_Layer& layer, int width, int height);
+    void Release(ImGui_ImplQtOpenGL3_Layer& layer);
+    void EvictIdle(size_t required_bytes);
+private:
+    QHash<const ImDrawList*, ImGui_ImplQtOpenGL3_Layer> Layers;
+};
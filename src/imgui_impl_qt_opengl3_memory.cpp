@@ -0,0 +1,161 @@
+﻿#include "imgui_impl_qt_opengl3_memory.h"
+#include "imgui_internal.h"
+#include <QtCore/QMutex>
+#include <string.h>
+
+//无头渲染器可以各自运行在自己的线程上,锁只保护登记表;各渲染器只写自己的计数,跨渲染器的当前总量与峰值用原子量维护
+static ImVector<ImGui_ImplQtOpenGL3_MemoryTracker*> ImGui_ImplQtOpenGL3_MemoryTrackers;
+static QMutex ImGui_ImplQtOpenGL3_MemoryTrackersMutex;
+static std::atomic<size_t> ImGui_ImplQtOpenGL3_MemoryTotalCurrent[ImGui_ImplQtOpenGL3_MemoryCategory_COUNT];
+static std::atomic<size_t> ImGui_ImplQtOpenGL3_MemoryTotalCurrentBytes;
+static std::atomic<size_t> ImGui_ImplQtOpenGL3_MemoryTotalPeak[ImGui_ImplQtOpenGL3_MemoryCategory_COUNT];
+static std::atomic<size_t> ImGui_ImplQtOpenGL3_MemoryTotalPeakBytes;
+
+static size_t ImGui_ImplQtOpenGL3_Load(const std::atomic<size_t>& value) { return value.load(std::memory_order_relaxed); }
+static int    ImGui_ImplQtOpenGL3_Load(const std::atomic<int>& value) { return value.load(std::memory_order_relaxed); }
+
+static void ImGui_ImplQtOpenGL3_StoreMax(std::atomic<size_t>& peak, size_t value)
+{
+    size_t prev = peak.load(std::memory_order_relaxed);
+    while (prev < value && !peak.compare_exchange_weak(prev, value, std::memory_order_relaxed))
+        ;
+}
+
+//全局当前总量:先加后减,减法不会越过零
+static void ImGui_ImplQtOpenGL3_AccountTotal(ImGui_ImplQtOpenGL3_MemoryCategory category, size_t old_bytes, size_t new_bytes)
+{
+    if (new_bytes > old_bytes)
+    {
+        const size_t grow = new_bytes - old_bytes;
+        const size_t current = ImGui_ImplQtOpenGL3_MemoryTotalCurrent[category].fetch_add(grow, std::memory_order_relaxed) + grow;
+        const size_t total = ImGui_ImplQtOpenGL3_MemoryTotalCurrentBytes.fetch_add(grow, std::memory_order_relaxed) + grow;
+        ImGui_ImplQtOpenGL3_StoreMax(ImGui_ImplQtOpenGL3_MemoryTotalPeak[category], current);
+        ImGui_ImplQtOpenGL3_StoreMax(ImGui_ImplQtOpenGL3_MemoryTotalPeakBytes, total);
+    }
+    else if (old_bytes > new_bytes)
+    {
+        ImGui_ImplQtOpenGL3_MemoryTotalCurrent[category].fetch_sub(old_bytes - new_bytes, std::memory_order_relaxed);
+        ImGui_ImplQtOpenGL3_MemoryTotalCurrentBytes.fetch_sub(old_bytes - new_bytes, std::memory_order_relaxed);
+    }
+}
+
+ImGui_ImplQtOpenGL3_MemoryTracker::ImGui_ImplQtOpenGL3_MemoryTracker()
+{
+    QMutexLocker lock(&ImGui_ImplQtOpenGL3_MemoryTrackersMutex);
+    ImGui_ImplQtOpenGL3_MemoryTrackers.push_back(this);
+}
+
+ImGui_ImplQtOpenGL3_MemoryTracker::~ImGui_ImplQtOpenGL3_MemoryTracker()
+{
+    Clear();
+    QMutexLocker lock(&ImGui_ImplQtOpenGL3_MemoryTrackersMutex);
+    ImGui_ImplQtOpenGL3_MemoryTrackers.find_erase_unsorted(this);
+}
+
+void ImGui_ImplQtOpenGL3_MemoryTracker::Allocate(ImGui_ImplQtOpenGL3_MemoryCategory category, size_t bytes)
+{
+    Objects[category].store(ImGui_ImplQtOpenGL3_Load(Objects[category]) + 1, std::memory_order_relaxed);
+    Account(category, 0, bytes);
+}
+
+void ImGui_ImplQtOpenGL3_MemoryTracker::Reallocate(ImGui_ImplQtOpenGL3_MemoryCategory category, size_t old_bytes, size_t new_bytes)
+{
+    //重复指定相同大小(孤立缓冲)不计为重新分配
+    if (old_bytes == new_bytes)
+        return;
+    Reallocations.store(ImGui_ImplQtOpenGL3_Load(Reallocations) + 1, std::memory_order_relaxed);
+    Account(category, old_bytes, new_bytes);
+}
+
+//只有所属渲染器写入,读改写不需要原子指令
+void ImGui_ImplQtOpenGL3_MemoryTracker::Account(ImGui_ImplQtOpenGL3_MemoryCategory category, size_t old_bytes, size_t new_bytes)
+{
+    const size_t prev = ImGui_ImplQtOpenGL3_Load(CurrentBytes[category]);
+    old_bytes = ImMin(old_bytes, prev);
+    const size_t current = prev - old_bytes + new_bytes;
+    const size_t total = ImGui_ImplQtOpenGL3_Load(TotalBytes) - old_bytes + new_bytes;
+    CurrentBytes[category].store(current, std::memory_order_relaxed);
+    TotalBytes.store(total, std::memory_order_relaxed);
+    if (current > ImGui_ImplQtOpenGL3_Load(PeakBytes[category]))
+        PeakBytes[category].store(current, std::memory_order_relaxed);
+    if (total > ImGui_ImplQtOpenGL3_Load(TotalPeakBytes))
+        TotalPeakBytes.store(total, std::memory_order_relaxed);
+    ImGui_ImplQtOpenGL3_AccountTotal(category, old_bytes, new_bytes);
+}
+
+void ImGui_ImplQtOpenGL3_MemoryTracker::Free(ImGui_ImplQtOpenGL3_MemoryCategory category, size_t bytes)
+{
+    const int objects = ImGui_ImplQtOpenGL3_Load(Objects[category]);
+    if (objects > 0)
+        Objects[category].store(objects - 1, std::memory_order_relaxed);
+    Account(category, bytes, 0);
+}
+
+void ImGui_ImplQtOpenGL3_MemoryTracker::CountShrink()
+{
+    BufferShrinks.store(ImGui_ImplQtOpenGL3_Load(BufferShrinks) + 1, std::memory_order_relaxed);
+}
+
+void ImGui_ImplQtOpenGL3_MemoryTracker::Clear()
+{
+    for (int i = 0; i < ImGui_ImplQtOpenGL3_MemoryCategory_COUNT; i++)
+    {
+        Account((ImGui_ImplQtOpenGL3_MemoryCategory)i, ImGui_ImplQtOpenGL3_Load(CurrentBytes[i]), 0);
+        Objects[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void ImGui_ImplQtOpenGL3_MemoryTracker::GetStats(ImGui_ImplQtOpenGL3_MemoryStats* stats) const
+{
+    for (int i = 0; i < ImGui_ImplQtOpenGL3_MemoryCategory_COUNT; i++)
+    {
+        stats->CurrentBytes[i] = ImGui_ImplQtOpenGL3_Load(CurrentBytes[i]);
+        stats->PeakBytes[i] = ImGui_ImplQtOpenGL3_Load(PeakBytes[i]);
+        stats->Objects[i] = ImGui_ImplQtOpenGL3_Load(Objects[i]);
+    }
+    stats->TotalBytes = ImGui_ImplQtOpenGL3_Load(TotalBytes);
+    stats->TotalPeakBytes = ImGui_ImplQtOpenGL3_Load(TotalPeakBytes);
+    stats->Reallocations = ImGui_ImplQtOpenGL3_Load(Reallocations);
+    stats->BufferShrinks = ImGui_ImplQtOpenGL3_Load(BufferShrinks);
+}
+
+void ImGui_ImplQtOpenGL3_MemoryTracker::GetTotalStats(ImGui_ImplQtOpenGL3_MemoryStats* stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    QMutexLocker lock(&ImGui_ImplQtOpenGL3_MemoryTrackersMutex);
+    for (const ImGui_ImplQtOpenGL3_MemoryTracker* tracker : ImGui_ImplQtOpenGL3_MemoryTrackers)
+    {
+        ImGui_ImplQtOpenGL3_MemoryStats tracker_stats;
+        tracker->GetStats(&tracker_stats);
+        for (int i = 0; i < ImGui_ImplQtOpenGL3_MemoryCategory_COUNT; i++)
+        {
+            stats->CurrentBytes[i] += tracker_stats.CurrentBytes[i];
+            stats->Objects[i] += tracker_stats.Objects[i];
+        }
+        stats->TotalBytes += tracker_stats.TotalBytes;
+        stats->Reallocations += tracker_stats.Reallocations;
+        stats->BufferShrinks += tracker_stats.BufferShrinks;
+    }
+    for (int i = 0; i < ImGui_ImplQtOpenGL3_MemoryCategory_COUNT; i++)
+        stats->PeakBytes[i] = ImMax(ImGui_ImplQtOpenGL3_Load(ImGui_ImplQtOpenGL3_MemoryTotalPeak[i]), stats->CurrentBytes[i]);
+    stats->TotalPeakBytes = ImMax(ImGui_ImplQtOpenGL3_Load(ImGui_ImplQtOpenGL3_MemoryTotalPeakBytes), stats->TotalBytes);
+}
+
+size_t ImGui_ImplQtOpenGL3_BufferUsage::EndFrame(const ImGui_ImplQtOpenGL3_MemoryTracker& memory, size_t capacity)
+{
+    const size_t used = Used;
+    Used = 0;
+    if (!memory.ShrinkEnabled || capacity == 0 || (float)used > (float)capacity * memory.ShrinkUsage)
+    {
+        LowFrames = 0;
+        WindowPeak = 0;
+        return capacity;
+    }
+    WindowPeak = ImMax(WindowPeak, used);
+    if (++LowFrames < memory.ShrinkFrames)
+        return capacity;
+    const size_t size = WindowPeak;
+    LowFrames = 0;
+    WindowPeak = 0;
+    return size;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "imgui.h"
+#include "imgui_impl_qt_opengl3.h"
+#include <atomic>
+
+// GPU memory of one renderer, updated wherever a component creates, resizes or deletes a GL object.
+// Only the owning renderer writes the counters, the registry lock is taken to register and to sum all renderers.
+class ImGui_ImplQtOpenGL3_MemoryTracker
+{
+public:
+    ImGui_ImplQtOpenGL3_MemoryTracker();
+    ~ImGui_ImplQtOpenGL3_MemoryTracker();
+
+    void Allocate(ImGui_ImplQtOpenGL3_MemoryCategory category, size_t bytes);      // New object
+    void Reallocate(ImGui_ImplQtOpenGL3_MemoryCategory category, size_t old_bytes, size_t new_bytes);
+    void Free(ImGui_ImplQtOpenGL3_MemoryCategory category, size_t bytes);
+    void CountShrink();
+    void Clear();       // The context went away with every object, peaks are kept
+    void GetStats(ImGui_ImplQtOpenGL3_MemoryStats* stats) const;
+    static void GetTotalStats(ImGui_ImplQtOpenGL3_MemoryStats* stats);
+private:
+    void Account(ImGui_ImplQtOpenGL3_MemoryCategory category, size_t old_bytes, size_t new_bytes);
+
+    // Relaxed atomics: written by the owning renderer only, read by GetTotalStats() from any thread
+    std::atomic<size_t> CurrentBytes[ImGui_ImplQtOpenGL3_MemoryCategory_COUNT]{};
+    std::atomic<size_t> PeakBytes[ImGui_ImplQtOpenGL3_MemoryCategory_COUNT]{};
+    std::atomic<int>    Objects[ImGui_ImplQtOpenGL3_MemoryCategory_COUNT]{};
+    std::atomic<size_t> TotalBytes{};
+    std::atomic<size_t> TotalPeakBytes{};
+    std::atomic<int>    Reallocations{};
+    std::atomic<int>    BufferShrinks{};
+public:
+
+    // Shrink policy of buffers kept between frames
+    bool   ShrinkEnabled{};
+    int    ShrinkFrames{ 300 };
+    float  ShrinkUsage{ 0.25f };
+};
+
+// Usage of a buffer kept between frames. Once the largest size needed stayed below ShrinkUsage of its capacity for
+// ShrinkFrames frames, EndFrame() returns the largest size needed over that time, the capacity otherwise.
+struct ImGui_ImplQtOpenGL3_BufferUsage
+{
+    size_t Used{};          // Largest size needed this frame
+    size_t WindowPeak{};    // Largest size needed since usage went low
+    int    LowFrames{};
+
+    void   Use(size_t bytes) { if (bytes > Used) Used = bytes; }
+    size_t EndFrame(const ImGui_ImplQtOpenGL3_MemoryTracker& memory, size_t capacity);
+};
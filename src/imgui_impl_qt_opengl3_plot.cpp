@@ -0,0 +1,277 @@
+﻿#include "imgui_impl_qt_opengl3_plot.h"
+#include "imgui_internal.h"
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+
+void ImGui_ImplQtOpenGL3_PlotSeriesSet::Init()
+{
+    initializeOpenGLFunctions();
+}
+
+ImGui_ImplQtOpenGL3_PlotSeries* ImGui_ImplQtOpenGL3_PlotSeriesSet::Create(int capacity)
+{
+    if (capacity <= 0)
+        return nullptr;
+
+    auto series = IM_NEW(ImGui_ImplQtOpenGL3_PlotSeries)();
+    series->Capacity = capacity;
+    //每级的块是上一级的LevelFactor倍,最高一级只剩几十个槽
+    ImS64 block_size = 1;
+    do
+    {
+        ImGui_ImplQtOpenGL3_PlotLevel& level = series->Levels[series->LevelCount++];
+        level.BlockSize = block_size;
+        level.Stride = block_size == 1 ? 1 : 2;
+        //区间首尾的块可能只有部分样本在范围内,多留一个槽
+        level.Capacity = (int)((capacity + block_size - 1) / block_size) + 1;
+        level.Values.assign((size_t)(level.Capacity + 1) * level.Stride, 0.0f);
+        block_size *= ImGui_ImplQtOpenGL3_PlotSeries::LevelFactor;
+    } while (series->LevelCount < ImGui_ImplQtOpenGL3_PlotSeries::MaxLevels && capacity / block_size >= ImGui_ImplQtOpenGL3_PlotSeries::MinTopSlots);
+    CreateDeviceObjects(*series);
+
+    Series.push_back(series);
+    return series;
+}
+
+void ImGui_ImplQtOpenGL3_PlotSeriesSet::Destroy(ImGui_ImplQtOpenGL3_PlotSeries* series)
+{
+    auto it = std::find(Series.begin(), Series.end(), series);
+    if (it == Series.end())
+        return;
+    Series.erase(it);
+
+    //本帧已记录的绘制不再引用它
+    for (ImGui_ImplQtOpenGL3_PlotDraw& draw : Draws) {
+        if (draw.Series == series)
+            draw.Series = nullptr;
+    }
+    DeleteDeviceObjects(*series);
+    IM_DELETE(series);
+}
+
+static inline void ImGui_ImplQtOpenGL3_MarkDirty(ImGui_ImplQtOpenGL3_PlotLevel& level, ImS64 block)
+{
+    if (level.DirtyBegin < 0 || block < level.DirtyBegin)
+        level.DirtyBegin = block;
+    if (block + 1 > level.DirtyEnd)
+        level.DirtyEnd = block + 1;
+}
+
+void ImGui_ImplQtOpenGL3_PlotSeriesSet::Append(ImGui_ImplQtOpenGL3_PlotSeries* series, const float* values, int count)
+{
+    //只保留最新的Capacity个样本,跳过的样本所在的块从头统计
+    const bool skipped = count > series->Capacity;
+    if (skipped) {
+        series->Count += count - series->Capacity;
+        values += count - series->Capacity;
+        count = series->Capacity;
+    }
+    const ImS64 begin = series->Count;
+    const ImS64 end = begin + count;
+
+    // Level 0: plain copy into the ring
+    ImGui_ImplQtOpenGL3_PlotLevel& samples = series->Levels[0];
+    for (ImS64 s = begin; s < end;)
+    {
+        const int slot = (int)(s % samples.Capacity);
+        const int n = (int)ImMin(end - s, (ImS64)(samples.Capacity - slot));
+        memcpy(samples.Values.data() + slot, values + (s - begin), (size_t)n * sizeof(float));
+        if (slot == 0)
+            samples.Values[samples.Capacity] = samples.Values[0];
+        s += n;
+    }
+    ImGui_ImplQtOpenGL3_MarkDirty(samples, begin);
+    ImGui_ImplQtOpenGL3_MarkDirty(samples, end - 1);
+
+    // Other levels: min/max of every block touched, the last block keeps growing until it is full
+    for (int l = 1; l < series->LevelCount; l++)
+    {
+        ImGui_ImplQtOpenGL3_PlotLevel& level = series->Levels[l];
+        for (ImS64 s = begin; s < end;)
+        {
+            const ImS64 block = s / level.BlockSize;
+            const ImS64 block_end = ImMin((block + 1) * level.BlockSize, end);
+            const float* p = values + (s - begin);
+            float v_min = p[0], v_max = p[0];
+            for (ImS64 i = 1; i < block_end - s; i++)
+            {
+                v_min = ImMin(v_min, p[i]);
+                v_max = ImMax(v_max, p[i]);
+            }
+            const int slot = (int)(block % level.Capacity);
+            float* pair = level.Values.data() + (size_t)slot * 2;
+            if (s % level.BlockSize != 0 && !(skipped && s == begin))
+            {
+                v_min = ImMin(v_min, pair[0]);
+                v_max = ImMax(v_max, pair[1]);
+            }
+            pair[0] = v_min;
+            pair[1] = v_max;
+            if (slot == 0)
+            {
+                level.Values[(size_t)level.Capacity * 2] = v_min;
+                level.Values[(size_t)level.Capacity * 2 + 1] = v_max;
+            }
+            ImGui_ImplQtOpenGL3_MarkDirty(level, block);
+            s = block_end;
+        }
+    }
+    series->Count = end;
+}
+
+void ImGui_ImplQtOpenGL3_PlotSeriesSet::Update()
+{
+    GLint last_array_buffer = -1;
+    for (auto series : Series)
+    {
+        for (int l = 0; l < series->LevelCount; l++)
+        {
+            ImGui_ImplQtOpenGL3_PlotLevel& level = series->Levels[l];
+            if (level.DirtyBegin < 0 || !level.Buffer)
+                continue;
+            if (last_array_buffer < 0)
+                glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &last_array_buffer);
+            glBindBuffer(GL_ARRAY_BUFFER, level.Buffer);
+
+            //环形缓冲区中的脏区间最多分成两段,写到第0个槽时同时更新末尾的镜像槽
+            const GLsizeiptr slot_bytes = (GLsizeiptr)level.Stride * (GLsizeiptr)sizeof(float);
+            const ImS64 dirty = level.DirtyEnd - level.DirtyBegin;
+            if (dirty >= level.Capacity)
+            {
+                glBufferSubData(GL_ARRAY_BUFFER, 0, slot_bytes * (level.Capacity + 1), level.Values.data());
+            }
+            else
+            {
+                const int first = (int)(level.DirtyBegin % level.Capacity);
+                const int head = (int)ImMin(dirty, (ImS64)(level.Capacity - first));
+                glBufferSubData(GL_ARRAY_BUFFER, slot_bytes * first, slot_bytes * head, level.Values.data() + (size_t)first * level.Stride);
+                if (dirty > head)
+                    glBufferSubData(GL_ARRAY_BUFFER, 0, slot_bytes * (dirty - head), level.Values.data());
+                if (first == 0 || dirty > head)
+                    glBufferSubData(GL_ARRAY_BUFFER, slot_bytes * level.Capacity, slot_bytes, level.Values.data() + (size_t)level.Capacity * level.Stride);
+            }
+            level.DirtyBegin = level.DirtyEnd = -1;
+        }
+    }
+    if (last_array_buffer >= 0)
+        glBindBuffer(GL_ARRAY_BUFFER, (GLuint)last_array_buffer);
+}
+
+// Picks the lowest level that needs at most two slots per framebuffer pixel column
+ImGui_ImplQtOpenGL3_PlotRange ImGui_ImplQtOpenGL3_PlotSeriesSet::SelectLevel(const ImGui_ImplQtOpenGL3_PlotDraw& draw, float width_pixels)
+{
+    const ImGui_ImplQtOpenGL3_PlotSeries& series = *draw.Series;
+    const ImS64 samples = draw.End - draw.First;
+    const ImS64 limit = ImMax((ImS64)(width_pixels * 2.0f), (ImS64)2);
+
+    ImGui_ImplQtOpenGL3_PlotRange range;
+    range.Level = 0;
+    for (; range.Level + 1 < series.LevelCount; range.Level++)
+    {
+        const ImS64 block_size = series.Levels[range.Level].BlockSize;
+        if ((draw.End + block_size - 1) / block_size - draw.First / block_size <= limit)
+            break;
+    }
+    const ImS64 block_size = series.Levels[range.Level].BlockSize;
+    range.FirstBlock = draw.First / block_size;
+    range.Blocks = (draw.End + block_size - 1) / block_size - range.FirstBlock;
+
+    //样本均匀分布在绘图区宽度上,块画在它所覆盖样本的中间
+    const float step = (draw.Rect.z - draw.Rect.x) / (float)ImMax(samples - 1, (ImS64)1);
+    range.X0 = draw.Rect.x + ((float)(range.FirstBlock * block_size - draw.First) + (float)(block_size - 1) * 0.5f) * step;
+    range.XStep = (float)block_size * step;
+    return range;
+}
+
+ImVec2 ImGui_ImplQtOpenGL3_PlotSeriesSet::ValueTransform(const ImGui_ImplQtOpenGL3_PlotDraw& draw)
+{
+    //值域为空或不是有限数时画在中线上,不做除法
+    const float value_range = draw.ValueMax - draw.ValueMin;
+    if (value_range == 0.0f || !isfinite(value_range) || !isfinite(draw.ValueMin))
+        return ImVec2((draw.Rect.y + draw.Rect.w) * 0.5f, 0.0f);
+    const float y_scale = (draw.Rect.y - draw.Rect.w) / value_range;
+    return ImVec2(draw.Rect.w - draw.ValueMin * y_scale, y_scale);
+}
+
+// Without gl_VertexID (GLSL 1.20) the selected level is drawn as an ordinary polyline, still bounded by the plot width
+void ImGui_ImplQtOpenGL3_PlotSeriesSet::AddFallback(ImDrawList* draw_list, const ImGui_ImplQtOpenGL3_PlotDraw& draw) const
+{
+    const ImGui_ImplQtOpenGL3_PlotRange range = SelectLevel(draw, (draw.Rect.z - draw.Rect.x) * ImGui::GetIO().DisplayFramebufferScale.x);
+    const ImGui_ImplQtOpenGL3_PlotLevel& level = draw.Series->Levels[range.Level];
+    const ImVec2 transform = ValueTransform(draw);
+
+    ImVector<ImVec2> points;
+    points.reserve((int)range.Blocks * level.Stride);
+    for (ImS64 b = 0; b < range.Blocks; b++)
+    {
+        const float* slot = level.Values.data() + (size_t)((range.FirstBlock + b) % level.Capacity) * level.Stride;
+        const float x = range.X0 + (float)b * range.XStep;
+        for (int i = 0; i < level.Stride; i++)
+            points.push_back(ImVec2(x, transform.x + slot[i] * transform.y));
+    }
+    draw_list->PushClipRect(ImVec2(draw.Rect.x, draw.Rect.y), ImVec2(draw.Rect.z, draw.Rect.w), true);
+    draw_list->AddPolyline(points.Data, points.Size, draw.Color, ImDrawFlags_None, 1.0f);
+    draw_list->PopClipRect();
+}
+
+void ImGui_ImplQtOpenGL3_PlotSeriesSet::CreateDeviceObjects(ImGui_ImplQtOpenGL3_PlotSeries& series)
+{
+    GLint last_array_buffer;
+    glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &last_array_buffer);
+    for (int l = 0; l < series.LevelCount; l++)
+    {
+        ImGui_ImplQtOpenGL3_PlotLevel& level = series.Levels[l];
+        const size_t bytes = level.Values.size() * sizeof(float);
+        glGenBuffers(1, &level.Buffer);
+        glBindBuffer(GL_ARRAY_BUFFER, level.Buffer);
+        glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)bytes, level.Values.data(), GL_DYNAMIC_DRAW);
+        Memory->Allocate(ImGui_ImplQtOpenGL3_MemoryCategory_VertexBuffers, bytes);
+        level.DirtyBegin = level.DirtyEnd = -1;
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, (GLuint)last_array_buffer);
+}
+
+void ImGui_ImplQtOpenGL3_PlotSeriesSet::DeleteDeviceObjects(ImGui_ImplQtOpenGL3_PlotSeries& series)
+{
+    for (int l = 0; l < series.LevelCount; l++)
+    {
+        ImGui_ImplQtOpenGL3_PlotLevel& level = series.Levels[l];
+        if (!level.Buffer)
+            continue;
+        glDeleteBuffers(1, &level.Buffer);
+        level.Buffer = 0;
+        Memory->Free(ImGui_ImplQtOpenGL3_MemoryCategory_VertexBuffers, level.Values.size() * sizeof(float));
+    }
+}
+
+void ImGui_ImplQtOpenGL3_PlotSeriesSet::Shutdown()
+{
+    for (auto series : Series)
+        IM_DELETE(series);
+    Series.clear();
+    Draws.clear();
+}
+
+void ImGui_ImplQtOpenGL3_PlotSeriesSet::ReleaseDeviceObjects()
+{
+    for (auto series : Series)
+        DeleteDeviceObjects(*series);
+}
+
+void ImGui_ImplQtOpenGL3_PlotSeriesSet::RestoreDeviceObjects()
+{
+    //CPU侧的环形缓冲区完整保留,整体重新上传
+    for (auto series : Series) {
+        if (!series->Levels[0].Buffer)
+            CreateDeviceObjects(*series);
+    }
+}
+
+void ImGui_ImplQtOpenGL3_AppendPlotSamples(ImGui_ImplQtOpenGL3_PlotSeries* series, const float* values, int count)
+{
+    if (series == nullptr || values == nullptr || count <= 0)
+        return;
+    //只改动CPU侧数据,渲染前统一上传
+    ImGui_ImplQtOpenGL3_PlotSeriesSet::Append(series, values, count);
+}
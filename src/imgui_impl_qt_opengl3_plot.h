@@ -0,0 +1,78 @@
+#pragma once
+
+#include <QtGui/QOpenGLExtraFunctions>
+#include <vector>
+
+#include "imgui.h"
+#include "imgui_impl_qt_opengl3.h"
+#include "imgui_impl_qt_opengl3_memory.h"
+
+// One level of the min/max pyramid of a series. Level 0 holds one sample per slot, level k one (min, max) pair per
+// LevelFactor^k samples. The slots form a ring on the CPU and in a GL buffer; slot Capacity mirrors slot 0 so a range
+// that wraps is drawn as two strips sharing a vertex.
+struct ImGui_ImplQtOpenGL3_PlotLevel
+{
+    int    Capacity{};              // Slots in the ring
+    int    Stride{};                // Floats per slot, 1 or 2
+    ImS64  BlockSize{};             // Samples per slot
+    std::vector<float> Values;      // (Capacity + 1) * Stride
+    GLuint Buffer{};
+    ImS64  DirtyBegin{ -1 };        // Blocks written since the last upload
+    ImS64  DirtyEnd{ -1 };
+};
+
+struct ImGui_ImplQtOpenGL3_PlotSeries
+{
+    enum { LevelFactor = 4, MaxLevels = 12, MinTopSlots = 64 };
+
+    int    Capacity{};              // Samples kept
+    ImS64  Count{};                 // Samples appended since creation
+    int    LevelCount{};
+    ImGui_ImplQtOpenGL3_PlotLevel Levels[MaxLevels];
+};
+
+// One ImGui_ImplQtOpenGL3_AddPlotSeries() call, referenced by index from the user data of its callback command
+struct ImGui_ImplQtOpenGL3_PlotDraw
+{
+    ImGui_ImplQtOpenGL3_PlotSeries* Series;
+    ImVec4 Rect;                    // Plot area in ImGui coordinates (x0, y0, x1, y1)
+    float  ValueMin;
+    float  ValueMax;
+    ImU32  Color;
+    ImS64  First;                   // Sample range [First, End)
+    ImS64  End;
+};
+
+// Range of one level covering a draw, see ImGui_ImplQtOpenGL3_PlotSeriesSet::SelectLevel()
+struct ImGui_ImplQtOpenGL3_PlotRange
+{
+    int    Level;
+    ImS64  FirstBlock;
+    ImS64  Blocks;
+    float  X0;                      // Position of the first slot and distance between slots, in ImGui coordinates
+    float  XStep;
+};
+
+class ImGui_ImplQtOpenGL3_PlotSeriesSet :public QOpenGLExtraFunctions
+{
+public:
+    void Init();
+    ImGui_ImplQtOpenGL3_PlotSeries* Create(int capacity);
+    void Destroy(ImGui_ImplQtOpenGL3_PlotSeries* series);
+    static void Append(ImGui_ImplQtOpenGL3_PlotSeries* series, const float* values, int count);   // No GL calls, any time on the GUI thread
+    void Update();                  // Uploads the slots written since the last frame
+    void AddFallback(ImDrawList* draw_list, const ImGui_ImplQtOpenGL3_PlotDraw& draw) const;
+    static ImGui_ImplQtOpenGL3_PlotRange SelectLevel(const ImGui_ImplQtOpenGL3_PlotDraw& draw, float width_pixels);
+    static ImVec2 ValueTransform(const ImGui_ImplQtOpenGL3_PlotDraw& draw);     // y = x + value * y, flat at mid height for an empty or non-finite range
+    void ReleaseDeviceObjects();    // Device objects destroyed or context lost: GL buffers are released, the CPU rings stay
+    void RestoreDeviceObjects();
+    void Shutdown();                // Frees the series the application did not destroy, GL buffers are released already
+public:
+    ImGui_ImplQtOpenGL3_MemoryTracker* Memory{};
+    ImVector<ImGui_ImplQtOpenGL3_PlotDraw> Draws;   // Of the current frame, cleared in NewFrame()
+private:
+    void CreateDeviceObjects(ImGui_ImplQtOpenGL3_PlotSeries& series);
+    void DeleteDeviceObjects(ImGui_ImplQtOpenGL3_PlotSeries& series);
+private:
+    std::vector<ImGui_ImplQtOpenGL3_PlotSeries*> Series;
+};
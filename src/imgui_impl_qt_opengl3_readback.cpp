@@ -0,0 +1,205 @@
+﻿#include "imgui_impl_qt_opengl3_readback.h"
+#include <algorithm>
+#include <string.h>
+
+void ImGui_ImplQtOpenGL3_Readback::Init(bool use_pixel_buffer, bool has_framebuffer_blit)
+{
+    initializeOpenGLFunctions();
+    UsePixelBuffer = use_pixel_buffer;
+    HasFramebufferBlit = has_framebuffer_blit;
+}
+
+void ImGui_ImplQtOpenGL3_Readback::Poll()
+{
+    //按提交顺序交付,遇到未完成的栅栏即停止,不等待GPU
+    while (Pending > 0)
+    {
+        const int index = (NextSlot + SlotCount - Pending) % SlotCount;
+        ImGui_ImplQtOpenGL3_ReadbackSlot& slot = Slots[index];
+        const GLenum status = glClientWaitSync(slot.Fence, 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+            break;
+        glDeleteSync(slot.Fence);
+        slot.Fence = nullptr;
+        Pending--;
+
+        const GLsizeiptr size = (GLsizeiptr)slot.Width * slot.Height * 4;
+        GLint last_pixel_buffer;
+        glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &last_pixel_buffer);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.Buffer);
+        if (const unsigned char* src = (const unsigned char*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT))
+        {
+            //GL的第一行在底部,复制时翻转
+            QImage image(slot.Width, slot.Height, QImage::Format_RGBA8888_Premultiplied);
+            const size_t row_size = (size_t)slot.Width * 4;
+            for (int y = 0; y < slot.Height; y++)
+                memcpy(image.scanLine(y), src + (size_t)(slot.Height - 1 - y) * row_size, row_size);
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            image.setDevicePixelRatio(slot.DevicePixelRatio);
+            Deliver(image, slot.Frame);
+        }
+        else
+        {
+            FramesDropped++;
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, (GLuint)last_pixel_buffer);
+    }
+}
+
+void ImGui_ImplQtOpenGL3_Readback::Capture(int fb_width, int fb_height, float device_pixel_ratio)
+{
+    if ((FrameCounter++ % std::max(Interval, 1)) != 0)
+        return;
+
+    //读取当前绘制的帧缓冲。GL 2.x/ES 2.0只有一个绑定点,读写同一个帧缓冲
+    GLint last_read_framebuffer = 0;
+    if (HasFramebufferBlit)
+    {
+        GLint draw_framebuffer, samples = 0;
+        glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &last_read_framebuffer);
+        glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &draw_framebuffer);
+        glGetIntegerv(GL_SAMPLES, &samples);
+        if (samples > 0)
+            Resolve((GLuint)draw_framebuffer, fb_width, fb_height);
+        else
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, (GLuint)draw_framebuffer);
+    }
+    GLint last_pack_alignment;
+    glGetIntegerv(GL_PACK_ALIGNMENT, &last_pack_alignment);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+    if (!UsePixelBuffer)
+    {
+        //GL 2.x/ES 2.0没有PBO和栅栏,只能同步读取
+        QImage image(fb_width, fb_height, QImage::Format_RGBA8888_Premultiplied);
+        glReadPixels(0, 0, fb_width, fb_height, GL_RGBA, GL_UNSIGNED_BYTE, image.bits());
+        image = image.mirrored();
+        image.setDevicePixelRatio(device_pixel_ratio);
+        FramesCaptured++;
+        Deliver(image, ImGui::GetFrameCount());
+    }
+    else if (Pending == SlotCount)
+    {
+        //所有缓冲区仍在等待GPU,丢弃本帧而不是阻塞
+        FramesDropped++;
+    }
+    else
+    {
+        ImGui_ImplQtOpenGL3_ReadbackSlot& slot = Slots[NextSlot];
+        NextSlot = (NextSlot + 1) % SlotCount;
+        Pending++;
+
+        GLint last_pixel_buffer;
+        glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &last_pixel_buffer);
+        if (!slot.Buffer)
+        {
+            glGenBuffers(1, &slot.Buffer);
+            Memory->Allocate(ImGui_ImplQtOpenGL3_MemoryCategory_PixelBuffers, 0);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.Buffer);
+        if (slot.Width != fb_width || slot.Height != fb_height)
+        {
+            glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)fb_width * fb_height * 4, nullptr, GL_STREAM_READ);
+            Memory->Reallocate(ImGui_ImplQtOpenGL3_MemoryCategory_PixelBuffers, (size_t)slot.Width * slot.Height * 4, (size_t)fb_width * fb_height * 4);
+            slot.Width = fb_width;
+            slot.Height = fb_height;
+        }
+        glReadPixels(0, 0, fb_width, fb_height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        slot.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        slot.DevicePixelRatio = device_pixel_ratio;
+        slot.Frame = ImGui::GetFrameCount();
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, (GLuint)last_pixel_buffer);
+        FramesCaptured++;
+    }
+
+    glPixelStorei(GL_PACK_ALIGNMENT, last_pack_alignment);
+    if (HasFramebufferBlit)
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, (GLuint)last_read_framebuffer);
+}
+
+// Leaves the single-sample copy bound as the read framebuffer
+void ImGui_ImplQtOpenGL3_Readback::Resolve(GLuint draw_framebuffer, int fb_width, int fb_height)
+{
+    //多重采样的帧缓冲不能直接glReadPixels,先blit到单采样的渲染缓冲
+    if (!ResolveFramebuffer)
+        glGenFramebuffers(1, &ResolveFramebuffer);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, ResolveFramebuffer);
+    if (ResolveWidth != fb_width || ResolveHeight != fb_height)
+    {
+        GLint last_renderbuffer;
+        glGetIntegerv(GL_RENDERBUFFER_BINDING, &last_renderbuffer);
+        if (!ResolveRenderbuffer)
+        {
+            glGenRenderbuffers(1, &ResolveRenderbuffer);
+            Memory->Allocate(ImGui_ImplQtOpenGL3_MemoryCategory_Textures, 0);
+        }
+        glBindRenderbuffer(GL_RENDERBUFFER, ResolveRenderbuffer);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, fb_width, fb_height);
+        Memory->Reallocate(ImGui_ImplQtOpenGL3_MemoryCategory_Textures, (size_t)ResolveWidth * ResolveHeight * 4, (size_t)fb_width * fb_height * 4);
+        ResolveWidth = fb_width;
+        ResolveHeight = fb_height;
+        glFramebufferRenderbuffer(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, ResolveRenderbuffer);
+        glBindRenderbuffer(GL_RENDERBUFFER, (GLuint)last_renderbuffer);
+    }
+
+    //blit受裁剪测试影响
+    const GLboolean last_enable_scissor_test = glIsEnabled(GL_SCISSOR_TEST);
+    glDisable(GL_SCISSOR_TEST);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, draw_framebuffer);
+    glBlitFramebuffer(0, 0, fb_width, fb_height, 0, 0, fb_width, fb_height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    if (last_enable_scissor_test) glEnable(GL_SCISSOR_TEST);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, draw_framebuffer);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, ResolveFramebuffer);
+}
+
+bool ImGui_ImplQtOpenGL3_Readback::Pop(QImage* image)
+{
+    if (Queue.isEmpty())
+        return false;
+    *image = Queue.takeFirst();
+    return true;
+}
+
+void ImGui_ImplQtOpenGL3_Readback::Deliver(const QImage& image, int frame)
+{
+    FramesDelivered++;
+    if (Callback)
+    {
+        Callback(image, frame, CallbackUserData);
+        return;
+    }
+    //消费者跟不上时丢弃最旧的帧
+    while (Queue.size() >= std::max(QueueCapacity, 1))
+    {
+        Queue.removeFirst();
+        FramesDropped++;
+    }
+    Queue.append(image);
+}
+
+void ImGui_ImplQtOpenGL3_Readback::DestroyDeviceObjects()
+{
+    for (auto& slot : Slots)
+    {
+        if (slot.Fence) glDeleteSync(slot.Fence);
+        if (slot.Buffer)
+        {
+            glDeleteBuffers(1, &slot.Buffer);
+            Memory->Free(ImGui_ImplQtOpenGL3_MemoryCategory_PixelBuffers, (size_t)slot.Width * slot.Height * 4);
+        }
+        slot = ImGui_ImplQtOpenGL3_ReadbackSlot();
+    }
+    if (ResolveFramebuffer)
+        glDeleteFramebuffers(1, &ResolveFramebuffer);
+    if (ResolveRenderbuffer)
+    {
+        glDeleteRenderbuffers(1, &ResolveRenderbuffer);
+        Memory->Free(ImGui_ImplQtOpenGL3_MemoryCategory_Textures, (size_t)ResolveWidth * ResolveHeight * 4);
+    }
+    ResolveFramebuffer = ResolveRenderbuffer = 0;
+    ResolveWidth = ResolveHeight = 0;
+    NextSlot = 0;
+    Pending = 0;
+    FrameCounter = 0;
+    Queue.clear();
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <QtGui/QOpenGLExtraFunctions>
+#include <QtGui/QImage>
+#include <QtCore/QList>
+
+#include "imgui.h"
+#include "imgui_impl_qt_opengl3.h"
+#include "imgui_impl_qt_opengl3_memory.h"
+
+// One pending glReadPixels() into a pixel pack buffer, complete once Fence is signaled
+struct ImGui_ImplQtOpenGL3_ReadbackSlot
+{
+    GLuint Buffer{};
+    GLsync Fence{};
+    int    Width{};
+    int    Height{};
+    float  DevicePixelRatio{ 1.0f };
+    int    Frame{};
+};
+
+class ImGui_ImplQtOpenGL3_Readback :public QOpenGLExtraFunctions
+{
+public:
+    enum { SlotCount = 3 };
+
+    void Init(bool use_pixel_buffer, bool has_framebuffer_blit);
+    void Poll();    // Delivers the finished slots without waiting
+    void Capture(int fb_width, int fb_height, float device_pixel_ratio);
+    bool Pop(QImage* image);
+    void DestroyDeviceObjects();
+private:
+    void Resolve(GLuint draw_framebuffer, int fb_width, int fb_height);
+    void Deliver(const QImage& image, int frame);
+public:
+    bool   Enabled{};
+    int    Interval{ 1 };           // Capture every Interval frames
+    int    QueueCapacity{ 4 };      // Queued frames when no callback is set, the oldest is dropped
+    ImGui_ImplQtOpenGL3_ReadbackCallback Callback{};
+    void*  CallbackUserData{};
+    ImGui_ImplQtOpenGL3_MemoryTracker* Memory{};
+
+    // Totals since enabled
+    int    FramesCaptured{};
+    int    FramesDelivered{};
+    int    FramesDropped{};
+private:
+    bool   UsePixelBuffer{};
+    bool   HasFramebufferBlit{};    // Separate read/draw framebuffers and glBlitFramebuffer(), GL 3.0+/ES 3.0+
+    GLuint ResolveFramebuffer{};    // Single-sample copy of a multisampled framebuffer
+    GLuint ResolveRenderbuffer{};
+    int    ResolveWidth{};
+    int    ResolveHeight{};
+    ImGui_ImplQtOpenGL3_ReadbackSlot Slots[SlotCount];
+    int    NextSlot{};              // Oldest pending slot is delivered first
+    int    Pending{};
+    int    FrameCounter{};
+    QList<QImage> Queue;
+};
@@ -0,0 +1,224 @@
+﻿#include "imgui_impl_qt_opengl3_stream.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+static qint64 ImGui_ImplQtOpenGL3_StreamClock()
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+void ImGui_ImplQtOpenGL3_StreamTextures::Init(bool use_pixel_buffer)
+{
+    initializeOpenGLFunctions();
+    UsePixelBuffer = use_pixel_buffer;
+}
+
+ImGui_ImplQtOpenGL3_StreamTexture* ImGui_ImplQtOpenGL3_StreamTextures::Create(int width, int height)
+{
+    if (width <= 0 || height <= 0)
+        return nullptr;
+
+    auto stream = IM_NEW(ImGui_ImplQtOpenGL3_StreamTexture)();
+    stream->Width = width;
+    stream->Height = height;
+    const size_t size = (size_t)width * (size_t)height * 4;
+    for (auto& frame : stream->Frames) {
+        frame.reset(new unsigned char[size]);
+        memset(frame.get(), 0, size);
+    }
+    CreateDeviceObjects(*stream);
+
+    Streams.push_back(stream);
+    return stream;
+}
+
+void ImGui_ImplQtOpenGL3_StreamTextures::CreateDeviceObjects(ImGui_ImplQtOpenGL3_StreamTexture& stream)
+{
+    GLint last_texture;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &last_texture);
+    glGenTextures(1, &stream.Handle);
+    glBindTexture(GL_TEXTURE_2D, stream.Handle);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+#ifdef GL_UNPACK_ROW_LENGTH // Not on WebGL/ES
+    GLint last_unpack_row_length;
+    glGetIntegerv(GL_UNPACK_ROW_LENGTH, &last_unpack_row_length);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+#endif
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, stream.Width, stream.Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, stream.Frames[stream.Front].get());
+#ifdef GL_UNPACK_ROW_LENGTH
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, last_unpack_row_length);
+#endif
+    glBindTexture(GL_TEXTURE_2D, last_texture);
+    Memory->Allocate(ImGui_ImplQtOpenGL3_MemoryCategory_Textures, (size_t)stream.Width * stream.Height * 4);
+
+    if (UsePixelBuffer)
+    {
+        GLint last_pixel_buffer;
+        glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &last_pixel_buffer);
+        stream.PixelBufferBytes = (size_t)stream.Width * stream.Height * 4;
+        glGenBuffers(1, &stream.PixelBuffer);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, stream.PixelBuffer);
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr)stream.PixelBufferBytes, nullptr, GL_STREAM_DRAW);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, (GLuint)last_pixel_buffer);
+        Memory->Allocate(ImGui_ImplQtOpenGL3_MemoryCategory_PixelBuffers, stream.PixelBufferBytes);
+    }
+}
+
+void ImGui_ImplQtOpenGL3_StreamTextures::DeleteDeviceObjects(ImGui_ImplQtOpenGL3_StreamTexture& stream)
+{
+    if (stream.Handle)
+    {
+        glDeleteTextures(1, &stream.Handle);
+        stream.Handle = 0;
+        Memory->Free(ImGui_ImplQtOpenGL3_MemoryCategory_Textures, (size_t)stream.Width * stream.Height * 4);
+    }
+    if (stream.PixelBuffer)
+    {
+        glDeleteBuffers(1, &stream.PixelBuffer);
+        stream.PixelBuffer = 0;
+        Memory->Free(ImGui_ImplQtOpenGL3_MemoryCategory_PixelBuffers, stream.PixelBufferBytes);
+        stream.PixelBufferBytes = 0;
+    }
+}
+
+void ImGui_ImplQtOpenGL3_StreamTextures::Destroy(ImGui_ImplQtOpenGL3_StreamTexture* stream)
+{
+    auto it = std::find(Streams.begin(), Streams.end(), stream);
+    if (it == Streams.end())
+        return;
+    Streams.erase(it);
+
+    DeleteDeviceObjects(*stream);
+    IM_DELETE(stream);
+}
+
+void ImGui_ImplQtOpenGL3_StreamTextures::Update(ImVector<ImTextureID>* dirty)
+{
+    for (auto stream : Streams)
+    {
+        //只取最新的一帧,中间被覆盖的帧已在生产者一侧计为丢弃
+        if (!(stream->Shared.load(std::memory_order_acquire) & ImGui_ImplQtOpenGL3_StreamTexture::DirtyBit))
+            continue;
+        const int prev = stream->Shared.exchange(stream->Front, std::memory_order_acq_rel);
+        stream->Front = prev & ~ImGui_ImplQtOpenGL3_StreamTexture::DirtyBit;
+        Upload(*stream, stream->Front);
+        if (dirty)
+            dirty->push_back((ImTextureID)(intptr_t)stream->Handle);
+    }
+}
+
+void ImGui_ImplQtOpenGL3_StreamTextures::Shutdown()
+{
+    //生产者线程此时必须已经停止推送
+    for (auto stream : Streams)
+        IM_DELETE(stream);
+    Streams.clear();
+}
+
+void ImGui_ImplQtOpenGL3_StreamTextures::ReleaseDeviceObjects()
+{
+    for (auto stream : Streams)
+        DeleteDeviceObjects(*stream);
+}
+
+void ImGui_ImplQtOpenGL3_StreamTextures::RestoreDeviceObjects()
+{
+    //用最后一次上传的帧重建纹理,生产者一侧的缓冲区不受影响
+    for (auto stream : Streams) {
+        if (!stream->Handle)
+            CreateDeviceObjects(*stream);
+    }
+}
+
+void ImGui_ImplQtOpenGL3_StreamTextures::Upload(ImGui_ImplQtOpenGL3_StreamTexture& stream, int frame)
+{
+    const GLsizeiptr size = (GLsizeiptr)stream.Width * stream.Height * 4;
+
+    GLint last_texture;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &last_texture);
+    glBindTexture(GL_TEXTURE_2D, stream.Handle);
+#ifdef GL_UNPACK_ROW_LENGTH // Not on WebGL/ES
+    GLint last_unpack_row_length;
+    glGetIntegerv(GL_UNPACK_ROW_LENGTH, &last_unpack_row_length);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+#endif
+
+    bool uploaded = false;
+    if (UsePixelBuffer)
+    {
+        //孤立单个PBO:上一次传输仍在使用的存储由驱动保留,映射拿到的是新存储,不需要轮换多个缓冲区
+        GLint last_pixel_buffer;
+        glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &last_pixel_buffer);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, stream.PixelBuffer);
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+        if (void* dst = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT))
+        {
+            memcpy(dst, stream.Frames[frame].get(), (size_t)size);
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, stream.Width, stream.Height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            uploaded = true;
+        }
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, (GLuint)last_pixel_buffer);
+    }
+    if (!uploaded)
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, stream.Width, stream.Height, GL_RGBA, GL_UNSIGNED_BYTE, stream.Frames[frame].get());
+#ifdef GL_UNPACK_ROW_LENGTH
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, last_unpack_row_length);
+#endif
+    glBindTexture(GL_TEXTURE_2D, last_texture);
+
+    const float latency = (float)(ImGui_ImplQtOpenGL3_StreamClock() - stream.Timestamps[frame]) / 1000000.0f;
+    const int uploaded_frames = stream.FramesUploaded.load(std::memory_order_relaxed);
+    stream.UploadLatencyMs.store(latency, std::memory_order_relaxed);
+    stream.UploadLatencyAverageMs.store(uploaded_frames == 0 ? latency : stream.UploadLatencyAverageMs.load(std::memory_order_relaxed) * 0.9f + latency * 0.1f, std::memory_order_relaxed);
+    stream.FramesUploaded.store(uploaded_frames + 1, std::memory_order_relaxed);
+}
+
+bool ImGui_ImplQtOpenGL3_PushStreamFrame(ImGui_ImplQtOpenGL3_StreamTexture* stream, const void* pixels, int stride)
+{
+    if (stream == nullptr || pixels == nullptr)
+        return false;
+
+    const int row_size = stream->Width * 4;
+    if (stride <= 0)
+        stride = row_size;
+    unsigned char* dst = stream->Frames[stream->Back].get();
+    const unsigned char* src = (const unsigned char*)pixels;
+    if (stride == row_size) {
+        memcpy(dst, src, (size_t)row_size * stream->Height);
+    }
+    else {
+        for (int y = 0; y < stream->Height; y++)
+            memcpy(dst + (size_t)y * row_size, src + (size_t)y * stride, (size_t)row_size);
+    }
+    stream->Timestamps[stream->Back] = ImGui_ImplQtOpenGL3_StreamClock();
+
+    //发布新帧并取回一个空闲缓冲区,若上一帧还未被取走则视为丢帧
+    const int prev = stream->Shared.exchange(stream->Back | ImGui_ImplQtOpenGL3_StreamTexture::DirtyBit, std::memory_order_acq_rel);
+    stream->Back = prev & ~ImGui_ImplQtOpenGL3_StreamTexture::DirtyBit;
+    stream->FramesPushed.fetch_add(1, std::memory_order_relaxed);
+    if (prev & ImGui_ImplQtOpenGL3_StreamTexture::DirtyBit)
+        stream->FramesDropped.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+ImTextureID ImGui_ImplQtOpenGL3_GetStreamTextureID(ImGui_ImplQtOpenGL3_StreamTexture* stream)
+{
+    return stream ? (ImTextureID)(intptr_t)stream->Handle : (ImTextureID)0;
+}
+
+void ImGui_ImplQtOpenGL3_GetStreamStats(ImGui_ImplQtOpenGL3_StreamTexture* stream, ImGui_ImplQtOpenGL3_StreamStats* stats)
+{
+    if (stream == nullptr || stats == nullptr)
+        return;
+    stats->FramesPushed = stream->FramesPushed.load(std::memory_order_relaxed);
+    stats->FramesDropped = stream->FramesDropped.load(std::memory_order_relaxed);
+    stats->FramesUploaded = stream->FramesUploaded.load(std::memory_order_relaxed);
+    stats->UploadLatencyMs = stream->UploadLatencyMs.load(std::memory_order_relaxed);
+    stats->UploadLatencyAverageMs = stream->UploadLatencyAverageMs.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <QtGui/QOpenGLExtraFunctions>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "imgui.h"
+#include "imgui_impl_qt_opengl3.h"
+#include "imgui_impl_qt_opengl3_memory.h"
+
+// Triple buffered frame slot: the producer never waits for the GUI thread and the
+// GUI thread always picks the newest complete frame. Frames replaced before they
+// were uploaded are counted as dropped.
+struct ImGui_ImplQtOpenGL3_StreamTexture
+{
+    enum { FrameCount = 3, DirtyBit = 0x4 };
+
+    int    Width{};
+    int    Height{};
+    GLuint Handle{};
+    GLuint PixelBuffer{};       // Orphaned before every upload, the driver renames the storage still in transfer
+    size_t PixelBufferBytes{};
+
+    std::unique_ptr<unsigned char[]> Frames[FrameCount];
+    qint64 Timestamps[FrameCount]{};
+    std::atomic<int> Shared{ 1 };
+    int    Back{ 0 };   // Owned by the producer
+    int    Front{ 2 };  // Owned by the GUI thread
+
+    std::atomic<int> FramesPushed{};
+    std::atomic<int> FramesDropped{};
+    std::atomic<int>   FramesUploaded{};    // Written by the GUI thread, read by the stats from any thread
+    std::atomic<float> UploadLatencyMs{};
+    std::atomic<float> UploadLatencyAverageMs{};
+};
+
+class ImGui_ImplQtOpenGL3_StreamTextures :public QOpenGLExtraFunctions
+{
+public:
+    void Init(bool use_pixel_buffer);
+    ImGui_ImplQtOpenGL3_StreamTexture* Create(int width, int height);
+    void Destroy(ImGui_ImplQtOpenGL3_StreamTexture* stream);
+    void Update(ImVector<ImTextureID>* dirty);
+    void ReleaseDeviceObjects();    // Device objects destroyed or context lost: GL objects are released, the CPU frames stay
+    void RestoreDeviceObjects();
+    void Shutdown();                // Frees the streams the application did not destroy, GL objects are released already
+public:
+    ImGui_ImplQtOpenGL3_MemoryTracker* Memory{};
+private:
+    void CreateDeviceObjects(ImGui_ImplQtOpenGL3_StreamTexture& stream);
+    void DeleteDeviceObjects(ImGui_ImplQtOpenGL3_StreamTexture& stream);
+    void Upload(ImGui_ImplQtOpenGL3_StreamTexture& stream, int frame);
+private:
+    bool UsePixelBuffer{};
+    std::vector<ImGui_ImplQtOpenGL3_StreamTexture*> Streams;
+};
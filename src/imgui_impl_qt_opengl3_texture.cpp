@@ -0,0 +1,303 @@
+﻿#include "imgui_impl_qt_opengl3_texture.h"
+#include <QtCore/QRunnable>
+#include <QtCore/QThreadPool>
+#include <QtCore/QMutexLocker>
+#include <QtGui/QImageReader>
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    //占位和被淘汰的纹理为1x1
+    size_t ImGui_ImplQtOpenGL3_TextureGpuBytes(const ImGui_ImplQtOpenGL3_Texture& texture)
+    {
+        return texture.State == ImGui_ImplQtOpenGL3_TextureState::Resident ? texture.Bytes : 4;
+    }
+
+    //在全局线程池中解码图像,统一转换为RGBA8888以便直接上传;纹理缓存销毁后的任务不再解码
+    class ImGui_ImplQtOpenGL3_DecodeTask :public QRunnable
+    {
+    public:
+        ImGui_ImplQtOpenGL3_DecodeTask(const std::shared_ptr<ImGui_ImplQtOpenGL3_DecodeQueue>& queue, const QString& path)
+            :m_queue(queue), m_path(path) {};
+
+        void run() override {
+            if (m_queue->Cancelled.load(std::memory_order_acquire))
+                return;
+            QImageReader reader(m_path);
+            reader.setAutoTransform(true);
+            QImage image = reader.read();
+            if (!image.isNull() && image.format() != QImage::Format_RGBA8888)
+                image = image.convertToFormat(QImage::Format_RGBA8888);
+
+            QMutexLocker lock(&m_queue->Mutex);
+            m_queue->Done.push_back({ m_path, std::move(image) });
+        }
+    private:
+        std::shared_ptr<ImGui_ImplQtOpenGL3_DecodeQueue> m_queue;
+        QString m_path;
+    };
+}
+
+ImGui_ImplQtOpenGL3_TextureCache::ImGui_ImplQtOpenGL3_TextureCache()
+    :Queue(std::make_shared<ImGui_ImplQtOpenGL3_DecodeQueue>())
+{
+}
+
+ImGui_ImplQtOpenGL3_TextureCache::~ImGui_ImplQtOpenGL3_TextureCache()
+{
+    //全局线程池上的任务不能清除也不等待,未开始的任务直接返回,正在解码的结果随队列一起释放
+    Queue->Cancelled.store(true, std::memory_order_release);
+}
+
+void ImGui_ImplQtOpenGL3_TextureCache::Init(bool use_pixel_buffer)
+{
+    initializeOpenGLFunctions();
+    UsePixelBuffer = use_pixel_buffer;
+}
+
+ImTextureID ImGui_ImplQtOpenGL3_TextureCache::Load(const char* path)
+{
+    const QString key = QString::fromUtf8(path);
+    auto it = Textures.find(key);
+    if (it == Textures.end())
+    {
+        auto texture = std::make_shared<ImGui_ImplQtOpenGL3_Texture>();
+        texture->Path = key;
+        CreatePlaceholder(*texture);
+        it = Textures.insert(key, texture);
+        Request(*texture);
+    }
+
+    ImGui_ImplQtOpenGL3_Texture& texture = *it.value();
+    texture.LastUsedFrame = ImGui::GetFrameCount();
+    if (!texture.Handle)
+        CreatePlaceholder(texture);    //上下文丢失后首次使用,已上传过的纹理处于淘汰状态,下面重新解码
+    if (texture.State == ImGui_ImplQtOpenGL3_TextureState::Evicted)
+        Request(texture);
+    return (ImTextureID)(intptr_t)texture.Handle;
+}
+
+bool ImGui_ImplQtOpenGL3_TextureCache::GetSize(ImTextureID id, ImVec2* size) const
+{
+    auto it = Handles.find((GLuint)(intptr_t)id);
+    if (it == Handles.end() || it.value()->Width == 0)
+        return false;
+    if (size)
+        *size = ImVec2((float)it.value()->Width, (float)it.value()->Height);
+    return true;
+}
+
+void ImGui_ImplQtOpenGL3_TextureCache::Update(ImVector<ImTextureID>* dirty)
+{
+    {
+        QMutexLocker lock(&Queue->Mutex);
+        for (auto& item : Queue->Done)
+            Uploads.push_back(std::move(item));
+        Queue->Done.clear();
+    }
+
+    //每帧限制上传量,避免大量缩略图同时完成时卡住一帧
+    size_t uploaded = 0;
+    size_t i = 0;
+    for (; i < Uploads.size() && uploaded < UploadBytesPerFrame; i++)
+    {
+        auto it = Textures.find(Uploads[i].Path);
+        if (it == Textures.end())
+            continue;
+        ImGui_ImplQtOpenGL3_Texture& texture = *it.value();
+        if (!texture.Handle) {
+            texture.State = ImGui_ImplQtOpenGL3_TextureState::Evicted;
+            continue;
+        }
+        if (Uploads[i].Image.isNull()) {
+            texture.State = ImGui_ImplQtOpenGL3_TextureState::Failed;
+            continue;
+        }
+        Upload(texture, Uploads[i].Image);
+        uploaded += texture.Bytes;
+        if (dirty)
+            dirty->push_back((ImTextureID)(intptr_t)texture.Handle);
+    }
+    Uploads.erase(Uploads.begin(), Uploads.begin() + i);
+
+    Enforce(dirty);
+    ShrinkPixelBuffer();
+}
+
+void ImGui_ImplQtOpenGL3_TextureCache::DestroyDeviceObjects()
+{
+    for (auto& texture : Textures) {
+        if (texture->Handle) {
+            glDeleteTextures(1, &texture->Handle);
+            Memory->Free(ImGui_ImplQtOpenGL3_MemoryCategory_Textures, ImGui_ImplQtOpenGL3_TextureGpuBytes(*texture));
+        }
+    }
+    if (PixelBuffer) {
+        glDeleteBuffers(1, &PixelBuffer);
+        Memory->Free(ImGui_ImplQtOpenGL3_MemoryCategory_PixelBuffers, PixelBufferBytes);
+        PixelBuffer = 0;
+        PixelBufferBytes = 0;
+    }
+    Textures.clear();
+    Handles.clear();
+    Uploads.clear();
+    ResidentBytes = 0;
+}
+
+void ImGui_ImplQtOpenGL3_TextureCache::ReleaseDeviceObjects()
+{
+    for (auto& texture : Textures)
+    {
+        if (texture->Handle) {
+            glDeleteTextures(1, &texture->Handle);
+            texture->Handle = 0;
+            Memory->Free(ImGui_ImplQtOpenGL3_MemoryCategory_Textures, ImGui_ImplQtOpenGL3_TextureGpuBytes(*texture));
+        }
+        if (texture->State == ImGui_ImplQtOpenGL3_TextureState::Resident)
+            texture->State = ImGui_ImplQtOpenGL3_TextureState::Evicted;
+        texture->Bytes = 0;
+    }
+    if (PixelBuffer) {
+        glDeleteBuffers(1, &PixelBuffer);
+        Memory->Free(ImGui_ImplQtOpenGL3_MemoryCategory_PixelBuffers, PixelBufferBytes);
+        PixelBuffer = 0;
+        PixelBufferBytes = 0;
+    }
+    Handles.clear();
+    ResidentBytes = 0;
+}
+
+void ImGui_ImplQtOpenGL3_TextureCache::CreatePlaceholder(ImGui_ImplQtOpenGL3_Texture& texture)
+{
+    //先创建1x1透明纹理作为占位,纹理ID在上下文的整个生命周期内保持不变
+    GLint last_texture;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &last_texture);
+    glGenTextures(1, &texture.Handle);
+    glBindTexture(GL_TEXTURE_2D, texture.Handle);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    const ImU32 transparent = 0;
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, &transparent);
+    glBindTexture(GL_TEXTURE_2D, last_texture);
+    Handles.insert(texture.Handle, &texture);
+    Memory->Allocate(ImGui_ImplQtOpenGL3_MemoryCategory_Textures, 4);
+}
+
+void ImGui_ImplQtOpenGL3_TextureCache::Request(ImGui_ImplQtOpenGL3_Texture& texture)
+{
+    texture.State = ImGui_ImplQtOpenGL3_TextureState::Pending;
+    QThreadPool::globalInstance()->start(new ImGui_ImplQtOpenGL3_DecodeTask(Queue, texture.Path));
+}
+
+void ImGui_ImplQtOpenGL3_TextureCache::Upload(ImGui_ImplQtOpenGL3_Texture& texture, const QImage& image)
+{
+    const size_t last_bytes = ImGui_ImplQtOpenGL3_TextureGpuBytes(texture);
+    if (texture.State == ImGui_ImplQtOpenGL3_TextureState::Resident)
+        ResidentBytes -= texture.Bytes;
+
+    texture.Width = image.width();
+    texture.Height = image.height();
+    texture.Bytes = (size_t)image.bytesPerLine() * (size_t)image.height();
+
+    GLint last_texture;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &last_texture);
+    glBindTexture(GL_TEXTURE_2D, texture.Handle);
+#ifdef GL_UNPACK_ROW_LENGTH // Not on WebGL/ES
+    GLint last_unpack_row_length;
+    glGetIntegerv(GL_UNPACK_ROW_LENGTH, &last_unpack_row_length);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+#endif
+
+    bool uploaded = false;
+    if (UsePixelBuffer)
+    {
+        //经由PBO中转,驱动可以异步完成到显存的拷贝
+        GLint last_pixel_buffer;
+        glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &last_pixel_buffer);
+        if (!PixelBuffer) {
+            glGenBuffers(1, &PixelBuffer);
+            Memory->Allocate(ImGui_ImplQtOpenGL3_MemoryCategory_PixelBuffers, 0);
+        }
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, PixelBuffer);
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr)texture.Bytes, nullptr, GL_STREAM_DRAW);
+        Memory->Reallocate(ImGui_ImplQtOpenGL3_MemoryCategory_PixelBuffers, PixelBufferBytes, texture.Bytes);
+        PixelBufferBytes = texture.Bytes;
+        PixelBufferUsage.Use(texture.Bytes);
+        if (void* dst = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr)texture.Bytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT))
+        {
+            memcpy(dst, image.constBits(), texture.Bytes);
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, texture.Width, texture.Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            uploaded = true;
+        }
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, (GLuint)last_pixel_buffer);
+    }
+    if (!uploaded)
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, texture.Width, texture.Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image.constBits());
+#ifdef GL_UNPACK_ROW_LENGTH
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, last_unpack_row_length);
+#endif
+    glBindTexture(GL_TEXTURE_2D, last_texture);
+
+    texture.State = ImGui_ImplQtOpenGL3_TextureState::Resident;
+    ResidentBytes += texture.Bytes;
+    Memory->Reallocate(ImGui_ImplQtOpenGL3_MemoryCategory_Textures, last_bytes, texture.Bytes);
+}
+
+void ImGui_ImplQtOpenGL3_TextureCache::Evict(ImGui_ImplQtOpenGL3_Texture& texture)
+{
+    GLint last_texture;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &last_texture);
+    glBindTexture(GL_TEXTURE_2D, texture.Handle);
+    const ImU32 transparent = 0;
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, &transparent);
+    glBindTexture(GL_TEXTURE_2D, last_texture);
+
+    ResidentBytes -= texture.Bytes;
+    Memory->Reallocate(ImGui_ImplQtOpenGL3_MemoryCategory_Textures, texture.Bytes, 4);
+    texture.Bytes = 0;
+    texture.State = ImGui_ImplQtOpenGL3_TextureState::Evicted;
+}
+
+void ImGui_ImplQtOpenGL3_TextureCache::Enforce(ImVector<ImTextureID>* dirty)
+{
+    if (ResidentBytes <= BudgetBytes)
+        return;
+
+    //按最近使用时间淘汰,当前帧和上一帧用到的纹理不参与淘汰以免反复加载
+    //淘汰只把纹理换成1x1占位,句柄保持不变,绘制列表里已有的纹理ID始终有效
+    //NewFrame在ImGui::NewFrame()之前调用时帧号还是上一帧,两种调用顺序下最近两帧都受保护
+    const int frame = ImGui::GetFrameCount();
+    std::vector<ImGui_ImplQtOpenGL3_Texture*> candidates;
+    for (auto& texture : Textures) {
+        if (texture->State == ImGui_ImplQtOpenGL3_TextureState::Resident && texture->LastUsedFrame < frame - 1)
+            candidates.push_back(texture.get());
+    }
+    std::sort(candidates.begin(), candidates.end(),
+        [](const ImGui_ImplQtOpenGL3_Texture* lhs, const ImGui_ImplQtOpenGL3_Texture* rhs) {
+            return lhs->LastUsedFrame < rhs->LastUsedFrame;
+        });
+    for (auto texture : candidates)
+    {
+        if (ResidentBytes <= BudgetBytes)
+            break;
+        Evict(*texture);
+        if (dirty)
+            dirty->push_back((ImTextureID)(intptr_t)texture->Handle);
+    }
+}
+
+void ImGui_ImplQtOpenGL3_TextureCache::ShrinkPixelBuffer()
+{
+    //PBO保持最后一次上传的大小,长时间没有大的上传时释放,下次上传时按需重建
+    if (!PixelBuffer || PixelBufferUsage.EndFrame(*Memory, PixelBufferBytes) >= PixelBufferBytes)
+        return;
+    glDeleteBuffers(1, &PixelBuffer);
+    Memory->Free(ImGui_ImplQtOpenGL3_MemoryCategory_PixelBuffers, PixelBufferBytes);
+    Memory->CountShrink();
+    PixelBuffer = 0;
+    PixelBufferBytes = 0;
+}
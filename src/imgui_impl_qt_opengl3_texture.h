@@ -0,0 +1,82 @@
+#pragma once
+
+#include <QtGui/QOpenGLExtraFunctions>
+#include <QtGui/QImage>
+#include <QtCore/QString>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <atomic>
+#include <vector>
+#include <memory>
+
+#include "imgui.h"
+#include "imgui_impl_qt_opengl3_memory.h"
+
+// Decoded images, pushed by worker threads and collected by the GUI thread in NewFrame()
+struct ImGui_ImplQtOpenGL3_DecodedImage
+{
+    QString Path;
+    QImage  Image;
+};
+
+// Shared with the decode tasks, which may still run on the global pool after the cache is gone
+struct ImGui_ImplQtOpenGL3_DecodeQueue
+{
+    QMutex Mutex;
+    std::vector<ImGui_ImplQtOpenGL3_DecodedImage> Done;
+    std::atomic<bool> Cancelled{};
+};
+
+enum class ImGui_ImplQtOpenGL3_TextureState
+{
+    Pending,    // Submitted to the decoder
+    Resident,   // Uploaded to the GPU
+    Evicted,    // Evicted by the budget, reloaded on next use
+    Failed,     // Could not be read
+};
+
+struct ImGui_ImplQtOpenGL3_Texture
+{
+    QString Path;
+    GLuint  Handle{};
+    int     Width{};
+    int     Height{};
+    size_t  Bytes{};
+    int     LastUsedFrame{};
+    ImGui_ImplQtOpenGL3_TextureState State{ ImGui_ImplQtOpenGL3_TextureState::Pending };
+};
+
+class ImGui_ImplQtOpenGL3_TextureCache :public QOpenGLExtraFunctions
+{
+public:
+    ImGui_ImplQtOpenGL3_TextureCache();
+    ~ImGui_ImplQtOpenGL3_TextureCache();
+
+    void        Init(bool use_pixel_buffer);
+    ImTextureID Load(const char* path);
+    bool        GetSize(ImTextureID texture, ImVec2* size) const;
+    void        Update(ImVector<ImTextureID>* dirty);
+    void        DestroyDeviceObjects();
+    void        ReleaseDeviceObjects();     // Context loss: textures are kept by path and reloaded on next use
+public:
+    size_t BudgetBytes{ 256u * 1024u * 1024u };
+    size_t UploadBytesPerFrame{ 16u * 1024u * 1024u };
+    size_t ResidentBytes{};
+    ImGui_ImplQtOpenGL3_MemoryTracker* Memory{};
+private:
+    void CreatePlaceholder(ImGui_ImplQtOpenGL3_Texture& texture);
+    void Request(ImGui_ImplQtOpenGL3_Texture& texture);
+    void Upload(ImGui_ImplQtOpenGL3_Texture& texture, const QImage& image);
+    void Evict(ImGui_ImplQtOpenGL3_Texture& texture);
+    void Enforce(ImVector<ImTextureID>* dirty);
+    void ShrinkPixelBuffer();
+private:
+    bool  UsePixelBuffer{};
+    GLuint PixelBuffer{};
+    size_t PixelBufferBytes{};
+    ImGui_ImplQtOpenGL3_BufferUsage PixelBufferUsage;
+    std::shared_ptr<ImGui_ImplQtOpenGL3_DecodeQueue> Queue;
+    QHash<QString, std::shared_ptr<ImGui_ImplQtOpenGL3_Texture>> Textures;
+    QHash<GLuint, ImGui_ImplQtOpenGL3_Texture*> Handles;
+    std::vector<ImGui_ImplQtOpenGL3_DecodedImage> Uploads;
+};
@@ -0,0 +1,823 @@
+﻿#include "imgui_impl_qt_remote.h"
+#include "imgui_impl_qt.h"
+#include "imgui_impl_qt_opengl3.h"
+#include "imgui_internal.h"
+#include <QtCore/QIODevice>
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtGui/QMouseEvent>
+#include <QtGui/QWheelEvent>
+#include <QtGui/QKeyEvent>
+#include <QtGui/QInputMethodEvent>
+#include <QtGui/QFocusEvent>
+#include <chrono>
+#include <vector>
+#include <math.h>
+#include <string.h>
+
+enum ImGui_ImplQtRemote_MessageType
+{
+    ImGui_ImplQtRemote_MessageType_Hello = 1,   // Player -> sender, resets the delta state and starts a new generation
+    ImGui_ImplQtRemote_MessageType_Frame,       // Sender -> player
+    ImGui_ImplQtRemote_MessageType_Texture,     // Sender -> player
+    ImGui_ImplQtRemote_MessageType_Ack,         // Player -> sender, frame is about to be displayed
+    ImGui_ImplQtRemote_MessageType_Resize,      // Player -> sender
+    ImGui_ImplQtRemote_MessageType_Input,       // Player -> sender
+};
+
+// Encoding of one buffer against its content in the previous frame
+enum ImGui_ImplQtRemote_Delta
+{
+    ImGui_ImplQtRemote_Delta_Same = 0,
+    ImGui_ImplQtRemote_Delta_Xor,
+    ImGui_ImplQtRemote_Delta_Raw,
+};
+
+// ImDrawCmd on the wire, callbacks other than ImDrawCallback_ResetRenderState are not transferred
+struct ImGui_ImplQtRemote_Cmd
+{
+    float ClipRect[4];
+    ImU64 TextureId;
+    ImU32 VtxOffset;
+    ImU32 IdxOffset;
+    ImU32 ElemCount;
+    ImU32 ResetRenderState;
+};
+
+// Content of one draw list in the previous frame
+struct ImGui_ImplQtRemote_ListState
+{
+    QByteArray Vtx;
+    QByteArray Idx;
+    QByteArray Cmd;
+};
+
+struct ImGui_ImplQtRemote_Texture
+{
+    int        Width{};
+    int        Height{};
+    QByteArray Pixels;      // RGBA32, pending upload
+    ImGui_ImplQtOpenGL3_StreamTexture* Stream{};
+};
+
+static qint64 ImGui_ImplQtRemote_Clock()
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+template<typename T>
+static void ImGui_ImplQtRemote_Write(QByteArray& out, const T& value)
+{
+    out.append((const char*)&value, (int)sizeof(T));
+}
+
+struct ImGui_ImplQtRemote_Reader
+{
+    const char* Ptr;
+    const char* End;
+    bool        Ok{ true };
+
+    ImGui_ImplQtRemote_Reader(const char* data, int size)
+        :Ptr(data), End(data + size) {}
+
+    template<typename T>
+    T Read()
+    {
+        T value{};
+        if (End - Ptr < (ptrdiff_t)sizeof(T)) { Ok = false; return value; }
+        memcpy(&value, Ptr, sizeof(T));
+        Ptr += sizeof(T);
+        return value;
+    }
+
+    const char* ReadBytes(int size)
+    {
+        if (size < 0 || End - Ptr < size) { Ok = false; return nullptr; }
+        const char* data = Ptr;
+        Ptr += size;
+        return data;
+    }
+};
+
+//消息格式: [u32 长度][u8 类型][内容]
+static void ImGui_ImplQtRemote_SendMessage(QIODevice* device, int type, const QByteArray& payload)
+{
+    QByteArray message;
+    message.reserve(payload.size() + 5);
+    ImGui_ImplQtRemote_Write(message, (ImU32)(payload.size() + 1));
+    ImGui_ImplQtRemote_Write(message, (ImU8)type);
+    message.append(payload);
+    device->write(message);
+}
+
+//从缓冲中取出所有完整的消息
+template<typename F>
+static void ImGui_ImplQtRemote_ReadMessages(QIODevice* device, QByteArray& incoming, F&& handler)
+{
+    incoming.append(device->readAll());
+    int offset = 0;
+    while (incoming.size() - offset >= 4)
+    {
+        ImU32 size;
+        memcpy(&size, incoming.constData() + offset, sizeof(size));
+        if (size == 0 || (ImU32)(incoming.size() - offset - 4) < size)
+            break;
+        const char* data = incoming.constData() + offset + 4;
+        handler((int)(ImU8)data[0], data + 1, (int)size - 1);
+        offset += 4 + (int)size;
+    }
+    if (offset > 0)
+        incoming.remove(0, offset);
+}
+
+static void ImGui_ImplQtRemote_EncodeBuffer(QByteArray& out, const void* data, int size, QByteArray& previous)
+{
+    if (previous.size() == size && memcmp(previous.constData(), data, (size_t)size) == 0)
+    {
+        ImGui_ImplQtRemote_Write(out, (ImU8)ImGui_ImplQtRemote_Delta_Same);
+        return;
+    }
+    if (previous.size() == size)
+    {
+        //大小不变时与上一帧异或,未变化的字节为0,压缩后几乎不占空间
+        ImGui_ImplQtRemote_Write(out, (ImU8)ImGui_ImplQtRemote_Delta_Xor);
+        const int offset = out.size();
+        out.resize(offset + size);
+        char* dst = out.data() + offset;
+        const char* src = (const char*)data;
+        const char* prev = previous.constData();
+        for (int i = 0; i < size; i++)
+            dst[i] = src[i] ^ prev[i];
+        memcpy(previous.data(), data, (size_t)size);
+        return;
+    }
+    ImGui_ImplQtRemote_Write(out, (ImU8)ImGui_ImplQtRemote_Delta_Raw);
+    ImGui_ImplQtRemote_Write(out, (ImU32)size);
+    out.append((const char*)data, size);
+    previous = QByteArray((const char*)data, size);
+}
+
+static bool ImGui_ImplQtRemote_DecodeBuffer(ImGui_ImplQtRemote_Reader& in, QByteArray& state)
+{
+    const int mode = in.Read<ImU8>();
+    if (mode == ImGui_ImplQtRemote_Delta_Same)
+        return in.Ok;
+    if (mode == ImGui_ImplQtRemote_Delta_Xor)
+    {
+        const char* src = in.ReadBytes(state.size());
+        if (!src)
+            return false;
+        char* dst = state.data();
+        for (int i = 0; i < state.size(); i++)
+            dst[i] ^= src[i];
+        return true;
+    }
+    if (mode == ImGui_ImplQtRemote_Delta_Raw)
+    {
+        const int size = (int)in.Read<ImU32>();
+        const char* src = in.ReadBytes(size);
+        if (!src)
+            return false;
+        state = QByteArray(src, size);
+        return true;
+    }
+    return false;
+}
+
+static void ImGui_ImplQtRemote_UpdateLatency(ImGui_ImplQtRemote_Stats& stats, qint64 timestamp)
+{
+    const float latency = (float)(ImGui_ImplQtRemote_Clock() - timestamp) / 1000000.0f;
+    stats.LatencyAverageMs = stats.LatencyMs == 0.0f ? latency : stats.LatencyAverageMs * 0.9f + latency * 0.1f;
+    stats.LatencyMs = latency;
+}
+
+static void ImGui_ImplQtRemote_UpdateBandwidth(ImGui_ImplQtRemote_Stats& stats, int bytes, int raw_bytes)
+{
+    stats.BytesPerFrameAverage = stats.FramesSent == 0 ? (float)bytes : stats.BytesPerFrameAverage * 0.9f + (float)bytes * 0.1f;
+    stats.FrameBytes = bytes;
+    stats.FrameRawBytes = raw_bytes;
+    stats.FramesSent++;
+}
+
+//-----------------------------------------------------------------------------
+// Sender
+//-----------------------------------------------------------------------------
+
+struct ImGui_ImplQtRemote_Sender
+{
+    QIODevice*    Device{};
+    ImGuiContext* Context{};
+    QMetaObject::Connection ReadyRead;
+    QByteArray    Incoming;
+    std::vector<ImGui_ImplQtRemote_ListState> Lists;
+    QByteArray    Payload;
+    QByteArray    Cmds;
+    ImU32         FrameId{};
+    ImU32         Generation{};         // Of the last Hello, frames are encoded against the state it reset
+    bool          FontSent{};
+    ImU64         FontTexId{};
+    int           FontWidth{};
+    int           FontHeight{};
+    qint64        MaxPendingBytes{ 8 * 1024 * 1024 };     // Frames are skipped while more than this is waiting to be written
+    ImGui_ImplQtRemote_Stats Stats{};
+
+    void HandleMessage(int type, const char* data, int size);
+    void HandleInput(ImGui_ImplQtRemote_Reader& in);
+};
+
+void ImGui_ImplQtRemote_Sender::HandleMessage(int type, const char* data, int size)
+{
+    ImGui_ImplQtRemote_Reader in(data, size);
+    switch (type)
+    {
+    case ImGui_ImplQtRemote_MessageType_Hello:
+    {
+        //新的播放端没有任何历史状态,下一帧全量发送
+        const ImU32 generation = in.Read<ImU32>();
+        if (!in.Ok)
+            break;
+        Generation = generation;
+        Lists.clear();
+        FontSent = false;
+        break;
+    }
+    case ImGui_ImplQtRemote_MessageType_Ack:
+    {
+        in.Read<ImU32>();
+        const qint64 timestamp = in.Read<qint64>();
+        if (in.Ok)
+            ImGui_ImplQtRemote_UpdateLatency(Stats, timestamp);
+        break;
+    }
+    case ImGui_ImplQtRemote_MessageType_Resize:
+    {
+        const float width = in.Read<float>();
+        const float height = in.Read<float>();
+        const float device_pixel_ratio = in.Read<float>();
+        //来自网络的值先检查再转换,避免未定义的转换和过大的帧缓冲
+        if (in.Ok && isfinite(width) && isfinite(height) && isfinite(device_pixel_ratio) && device_pixel_ratio > 0.0f)
+            ImGui_ImplQt_SetHeadlessSize((int)ImClamp(width, 1.0f, 16384.0f), (int)ImClamp(height, 1.0f, 16384.0f), ImMin(device_pixel_ratio, 8.0f));
+        break;
+    }
+    case ImGui_ImplQtRemote_MessageType_Input:
+        HandleInput(in);
+        break;
+    default:
+        break;
+    }
+}
+
+//还原为Qt事件,交给ImGui_ImplQt按本地输入处理
+void ImGui_ImplQtRemote_Sender::HandleInput(ImGui_ImplQtRemote_Reader& in)
+{
+    const QEvent::Type type = (QEvent::Type)in.Read<ImU16>();
+    const Qt::KeyboardModifiers modifiers = Qt::KeyboardModifiers((Qt::KeyboardModifier)in.Read<ImU32>());
+    switch (type)
+    {
+    case QEvent::MouseButtonPress:
+    case QEvent::MouseButtonRelease:
+    case QEvent::MouseButtonDblClick:
+    case QEvent::MouseMove:
+    {
+        const float x = in.Read<float>();
+        const float y = in.Read<float>();
+        const Qt::MouseButton button = (Qt::MouseButton)in.Read<ImU32>();
+        const Qt::MouseButtons buttons = Qt::MouseButtons((Qt::MouseButton)in.Read<ImU32>());
+        if (!in.Ok) return;
+        QMouseEvent event(type, QPointF(x, y), button, buttons, modifiers);
+        ImGui_ImplQt_ProcessEvent(&event);
+        break;
+    }
+    case QEvent::Wheel:
+    {
+        const int pixel_x = in.Read<ImS32>(), pixel_y = in.Read<ImS32>();
+        const int angle_x = in.Read<ImS32>(), angle_y = in.Read<ImS32>();
+        const Qt::MouseButtons buttons = Qt::MouseButtons((Qt::MouseButton)in.Read<ImU32>());
+        if (!in.Ok) return;
+        QWheelEvent event(QPointF(), QPointF(), QPoint(pixel_x, pixel_y), QPoint(angle_x, angle_y), buttons, modifiers, Qt::NoScrollPhase, false);
+        ImGui_ImplQt_ProcessEvent(&event);
+        break;
+    }
+    case QEvent::KeyPress:
+    case QEvent::KeyRelease:
+    {
+        const int key = in.Read<ImS32>();
+        const int length = (int)in.Read<ImU16>();
+        const char* text = in.ReadBytes(length);
+        if (!in.Ok) return;
+        QKeyEvent event(type, key, modifiers, QString::fromUtf8(text, length));
+        ImGui_ImplQt_ProcessEvent(&event);
+        break;
+    }
+    case QEvent::InputMethod:
+    {
+        const int length = (int)in.Read<ImU16>();
+        const char* text = in.ReadBytes(length);
+        if (!in.Ok) return;
+        QInputMethodEvent event;
+        event.setCommitString(QString::fromUtf8(text, length));
+        ImGui_ImplQt_ProcessEvent(&event);
+        break;
+    }
+    case QEvent::FocusIn:
+    case QEvent::FocusOut:
+    {
+        QFocusEvent event(type);
+        ImGui_ImplQt_ProcessEvent(&event);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+ImGui_ImplQtRemote_Sender* ImGui_ImplQtRemote_CreateSender(QIODevice* device)
+{
+    IM_ASSERT(device != nullptr);
+    auto sender = IM_NEW(ImGui_ImplQtRemote_Sender)();
+    sender->Device = device;
+    sender->Context = ImGui::GetCurrentContext();
+    sender->ReadyRead = QObject::connect(device, &QIODevice::readyRead, device, [sender]() {
+        ImGuiContext* last_context = ImGui::GetCurrentContext();
+        ImGui::SetCurrentContext(sender->Context);
+        ImGui_ImplQtRemote_ReadMessages(sender->Device, sender->Incoming, [sender](int type, const char* data, int size) {
+            sender->HandleMessage(type, data, size);
+        });
+        ImGui::SetCurrentContext(last_context);
+    });
+    return sender;
+}
+
+void ImGui_ImplQtRemote_DestroySender(ImGui_ImplQtRemote_Sender* sender)
+{
+    if (!sender)
+        return;
+    QObject::disconnect(sender->ReadyRead);
+    IM_DELETE(sender);
+}
+
+void ImGui_ImplQtRemote_SendDrawData(ImGui_ImplQtRemote_Sender* sender, ImDrawData* draw_data)
+{
+    if (!sender || !draw_data || !sender->Device->isOpen())
+        return;
+
+    //字体纹理只在首次或重建后发送
+    ImGuiIO& io = ImGui::GetIO();
+    if (!sender->FontSent || sender->FontTexId != (ImU64)(intptr_t)io.Fonts->TexID
+        || sender->FontWidth != io.Fonts->TexWidth || sender->FontHeight != io.Fonts->TexHeight)
+    {
+        unsigned char* pixels;
+        int width, height;
+        io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+        QByteArray payload;
+        ImGui_ImplQtRemote_Write(payload, (ImU64)(intptr_t)io.Fonts->TexID);
+        ImGui_ImplQtRemote_Write(payload, (ImS32)width);
+        ImGui_ImplQtRemote_Write(payload, (ImS32)height);
+        payload.append(qCompress(pixels, width * height * 4, 1));
+        ImGui_ImplQtRemote_SendMessage(sender->Device, ImGui_ImplQtRemote_MessageType_Texture, payload);
+        sender->FontSent = true;
+        sender->FontTexId = (ImU64)(intptr_t)io.Fonts->TexID;
+        sender->FontWidth = width;
+        sender->FontHeight = height;
+    }
+
+    //对端处理不过来时丢弃本帧,增量状态保持为上一次实际发送的内容
+    if (sender->Device->bytesToWrite() > sender->MaxPendingBytes)
+    {
+        sender->Stats.FramesDropped++;
+        return;
+    }
+
+    QByteArray& payload = sender->Payload;
+    payload.resize(0);
+    ImGui_ImplQtRemote_Write(payload, sender->Generation);
+    ImGui_ImplQtRemote_Write(payload, ++sender->FrameId);
+    ImGui_ImplQtRemote_Write(payload, ImGui_ImplQtRemote_Clock());
+    ImGui_ImplQtRemote_Write(payload, draw_data->DisplayPos);
+    ImGui_ImplQtRemote_Write(payload, draw_data->DisplaySize);
+    ImGui_ImplQtRemote_Write(payload, draw_data->FramebufferScale);
+    ImGui_ImplQtRemote_Write(payload, (ImS32)draw_data->CmdListsCount);
+
+    int raw_bytes = payload.size();
+    int unchanged = 0;
+    if ((int)sender->Lists.size() < draw_data->CmdListsCount)
+        sender->Lists.resize(draw_data->CmdListsCount);
+    for (int n = 0; n < draw_data->CmdListsCount; n++)
+    {
+        const ImDrawList* cmd_list = draw_data->CmdLists[n];
+        QByteArray& cmds = sender->Cmds;
+        cmds.resize(0);
+        for (const ImDrawCmd& cmd : cmd_list->CmdBuffer)
+        {
+            if (cmd.UserCallback != nullptr && cmd.UserCallback != ImDrawCallback_ResetRenderState)
+                continue;
+            ImGui_ImplQtRemote_Cmd remote_cmd;
+            memcpy(remote_cmd.ClipRect, &cmd.ClipRect, sizeof(remote_cmd.ClipRect));
+            remote_cmd.TextureId = (ImU64)(intptr_t)cmd.GetTexID();
+            remote_cmd.VtxOffset = cmd.VtxOffset;
+            remote_cmd.IdxOffset = cmd.IdxOffset;
+            remote_cmd.ElemCount = cmd.UserCallback ? 0 : cmd.ElemCount;
+            remote_cmd.ResetRenderState = cmd.UserCallback ? 1 : 0;
+            ImGui_ImplQtRemote_Write(cmds, remote_cmd);
+        }
+
+        ImGui_ImplQtRemote_ListState& state = sender->Lists[n];
+        const int list_offset = payload.size();
+        ImGui_ImplQtRemote_EncodeBuffer(payload, cmd_list->VtxBuffer.Data, cmd_list->VtxBuffer.size_in_bytes(), state.Vtx);
+        ImGui_ImplQtRemote_EncodeBuffer(payload, cmd_list->IdxBuffer.Data, cmd_list->IdxBuffer.size_in_bytes(), state.Idx);
+        ImGui_ImplQtRemote_EncodeBuffer(payload, cmds.constData(), cmds.size(), state.Cmd);
+        if (payload.size() - list_offset == 3)
+            unchanged++;
+        raw_bytes += cmd_list->VtxBuffer.size_in_bytes() + cmd_list->IdxBuffer.size_in_bytes() + cmds.size();
+    }
+    sender->Lists.resize(draw_data->CmdListsCount);
+
+    const QByteArray compressed = qCompress(payload, 1);
+    ImGui_ImplQtRemote_SendMessage(sender->Device, ImGui_ImplQtRemote_MessageType_Frame, compressed);
+    sender->Stats.ListsUnchanged = unchanged;
+    ImGui_ImplQtRemote_UpdateBandwidth(sender->Stats, compressed.size() + 5, raw_bytes);
+}
+
+void ImGui_ImplQtRemote_GetSenderStats(ImGui_ImplQtRemote_Sender* sender, ImGui_ImplQtRemote_Stats* stats)
+{
+    if (sender && stats) {
+        *stats = sender->Stats;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Player
+//-----------------------------------------------------------------------------
+
+class ImGui_ImplQtRemote_InputFilter :public QObject
+{
+public:
+    explicit ImGui_ImplQtRemote_InputFilter(ImGui_ImplQtRemote_Player* player)
+        :Player(player) {}
+    bool eventFilter(QObject* watched, QEvent* event) override;
+private:
+    ImGui_ImplQtRemote_Player* Player{};
+};
+
+struct ImGui_ImplQtRemote_Player
+{
+    QIODevice*    Device{};
+    QObject*      InputSource{};
+    QMetaObject::Connection ReadyRead;
+    std::unique_ptr<ImGui_ImplQtRemote_InputFilter> InputFilter;
+    QByteArray    Incoming;
+
+    std::vector<ImGui_ImplQtRemote_ListState> Lists;
+    ImVector<ImDrawList*> DrawLists;
+    ImDrawData    DrawData;
+    QHash<ImU64, ImGui_ImplQtRemote_Texture> Textures;
+    ImU32         FrameId{};
+    ImU32         Generation{};         // Of the last Hello, older frames were encoded against a state that is gone
+    qint64        FrameTimestamp{};
+    int           FramesPending{};      // Decoded since the last ImGui_ImplQtRemote_UpdatePlayer()
+    bool          Valid{};
+    ImVec2        DisplaySize{};
+    float         DevicePixelRatio{};
+    ImGui_ImplQtRemote_Stats Stats{};
+
+    void HandleMessage(int type, const char* data, int size);
+    bool DecodeFrame(const QByteArray& payload);
+    void Resync();
+    void BuildDrawData();
+};
+
+bool ImGui_ImplQtRemote_InputFilter::eventFilter(QObject* watched, QEvent* event)
+{
+    QByteArray payload;
+    ImGui_ImplQtRemote_Write(payload, (ImU16)event->type());
+    switch (event->type())
+    {
+    case QEvent::MouseButtonPress:
+    case QEvent::MouseButtonRelease:
+    case QEvent::MouseButtonDblClick:
+    case QEvent::MouseMove:
+    {
+        auto e = static_cast<QMouseEvent*>(event);
+        ImGui_ImplQtRemote_Write(payload, (ImU32)e->modifiers());
+        ImGui_ImplQtRemote_Write(payload, (float)e->localPos().x());
+        ImGui_ImplQtRemote_Write(payload, (float)e->localPos().y());
+        ImGui_ImplQtRemote_Write(payload, (ImU32)e->button());
+        ImGui_ImplQtRemote_Write(payload, (ImU32)e->buttons());
+        break;
+    }
+    case QEvent::Wheel:
+    {
+        auto e = static_cast<QWheelEvent*>(event);
+        ImGui_ImplQtRemote_Write(payload, (ImU32)e->modifiers());
+        ImGui_ImplQtRemote_Write(payload, (ImS32)e->pixelDelta().x());
+        ImGui_ImplQtRemote_Write(payload, (ImS32)e->pixelDelta().y());
+        ImGui_ImplQtRemote_Write(payload, (ImS32)e->angleDelta().x());
+        ImGui_ImplQtRemote_Write(payload, (ImS32)e->angleDelta().y());
+        ImGui_ImplQtRemote_Write(payload, (ImU32)e->buttons());
+        break;
+    }
+    case QEvent::KeyPress:
+    case QEvent::KeyRelease:
+    {
+        auto e = static_cast<QKeyEvent*>(event);
+        const QByteArray text = e->text().toUtf8();
+        ImGui_ImplQtRemote_Write(payload, (ImU32)e->modifiers());
+        ImGui_ImplQtRemote_Write(payload, (ImS32)e->key());
+        ImGui_ImplQtRemote_Write(payload, (ImU16)text.size());
+        payload.append(text);
+        break;
+    }
+    case QEvent::InputMethod:
+    {
+        auto e = static_cast<QInputMethodEvent*>(event);
+        const QByteArray text = e->commitString().toUtf8();
+        ImGui_ImplQtRemote_Write(payload, (ImU32)0);
+        ImGui_ImplQtRemote_Write(payload, (ImU16)text.size());
+        payload.append(text);
+        break;
+    }
+    case QEvent::FocusIn:
+    case QEvent::FocusOut:
+        ImGui_ImplQtRemote_Write(payload, (ImU32)0);
+        break;
+    default:
+        return QObject::eventFilter(watched, event);
+    }
+    ImGui_ImplQtRemote_SendMessage(Player->Device, ImGui_ImplQtRemote_MessageType_Input, payload);
+    return QObject::eventFilter(watched, event);
+}
+
+void ImGui_ImplQtRemote_Player::HandleMessage(int type, const char* data, int size)
+{
+    ImGui_ImplQtRemote_Reader in(data, size);
+    switch (type)
+    {
+    case ImGui_ImplQtRemote_MessageType_Frame:
+    {
+        const QByteArray payload = qUncompress((const uchar*)data, size);
+        const int compressed_size = size + 5;
+        if (DecodeFrame(payload))
+        {
+            FramesPending++;
+            ImGui_ImplQtRemote_UpdateLatency(Stats, FrameTimestamp);
+            ImGui_ImplQtRemote_UpdateBandwidth(Stats, compressed_size, payload.size());
+        }
+        break;
+    }
+    case ImGui_ImplQtRemote_MessageType_Texture:
+    {
+        const ImU64 id = in.Read<ImU64>();
+        const int width = in.Read<ImS32>();
+        const int height = in.Read<ImS32>();
+        if (!in.Ok)
+            break;
+        const QByteArray pixels = qUncompress((const uchar*)in.Ptr, (int)(in.End - in.Ptr));
+        if (width <= 0 || height <= 0 || pixels.size() != width * height * 4)
+            break;
+        ImGui_ImplQtRemote_Texture& texture = Textures[id];
+        texture.Width = width;
+        texture.Height = height;
+        texture.Pixels = pixels;
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+//检查命令引用的索引和顶点都在缓冲区内,损坏或错位的数据流不能让渲染器越界读取
+static bool ImGui_ImplQtRemote_ValidateList(const ImGui_ImplQtRemote_ListState& state)
+{
+    if (state.Vtx.size() % (int)sizeof(ImDrawVert) != 0 || state.Idx.size() % (int)sizeof(ImDrawIdx) != 0
+        || state.Cmd.size() % (int)sizeof(ImGui_ImplQtRemote_Cmd) != 0)
+        return false;
+    const ImU64 vtx_count = (ImU64)(state.Vtx.size() / (int)sizeof(ImDrawVert));
+    const ImU64 idx_count = (ImU64)(state.Idx.size() / (int)sizeof(ImDrawIdx));
+    const ImDrawIdx* indices = (const ImDrawIdx*)state.Idx.constData();
+    const int cmd_count = state.Cmd.size() / (int)sizeof(ImGui_ImplQtRemote_Cmd);
+    for (int i = 0; i < cmd_count; i++)
+    {
+        ImGui_ImplQtRemote_Cmd cmd;
+        memcpy(&cmd, state.Cmd.constData() + (size_t)i * sizeof(cmd), sizeof(cmd));
+        if (cmd.ResetRenderState || cmd.ElemCount == 0)
+            continue;
+        if ((ImU64)cmd.IdxOffset + cmd.ElemCount > idx_count || (ImU64)cmd.VtxOffset >= vtx_count)
+            return false;
+        const ImU64 vtx_limit = vtx_count - cmd.VtxOffset;
+        for (ImU32 j = 0; j < cmd.ElemCount; j++)
+            if ((ImU64)indices[cmd.IdxOffset + j] >= vtx_limit)
+                return false;
+    }
+    return true;
+}
+
+//状态已不一致: 丢弃全部历史并开始新的一代,已在途中的旧增量帧不再解码
+void ImGui_ImplQtRemote_Player::Resync()
+{
+    Lists.clear();
+    Valid = false;
+    FramesPending = 0;
+    Generation++;
+    QByteArray payload;
+    ImGui_ImplQtRemote_Write(payload, Generation);
+    ImGui_ImplQtRemote_SendMessage(Device, ImGui_ImplQtRemote_MessageType_Hello, payload);
+}
+
+bool ImGui_ImplQtRemote_Player::DecodeFrame(const QByteArray& payload)
+{
+    ImGui_ImplQtRemote_Reader in(payload.constData(), payload.size());
+    const ImU32 generation = in.Read<ImU32>();
+    if (!in.Ok || generation != Generation)
+        return false;
+    const ImU32 frame_id = in.Read<ImU32>();
+    const qint64 timestamp = in.Read<qint64>();
+    const ImVec2 display_pos = in.Read<ImVec2>();
+    const ImVec2 display_size = in.Read<ImVec2>();
+    const ImVec2 framebuffer_scale = in.Read<ImVec2>();
+    const int count = in.Read<ImS32>();
+    //每个列表至少有三个缓冲区的模式字节,超出剩余长度的数量不可能有效,不按它分配
+    if (!in.Ok || count < 0 || count > (in.End - in.Ptr) / 3)
+    {
+        Resync();
+        return false;
+    }
+
+    Lists.resize(count);
+    int unchanged = 0;
+    for (int n = 0; n < count; n++)
+    {
+        const char* list_start = in.Ptr;
+        ImGui_ImplQtRemote_ListState& state = Lists[n];
+        if (!ImGui_ImplQtRemote_DecodeBuffer(in, state.Vtx) || !ImGui_ImplQtRemote_DecodeBuffer(in, state.Idx) || !ImGui_ImplQtRemote_DecodeBuffer(in, state.Cmd))
+        {
+            Resync();
+            return false;
+        }
+        //未变化的列表上一帧已检查过
+        if (in.Ptr - list_start == 3)
+            unchanged++;
+        else if (!ImGui_ImplQtRemote_ValidateList(state))
+        {
+            Resync();
+            return false;
+        }
+    }
+
+    FrameId = frame_id;
+    FrameTimestamp = timestamp;
+    DrawData.DisplayPos = display_pos;
+    DrawData.DisplaySize = display_size;
+    DrawData.FramebufferScale = framebuffer_scale;
+    Stats.ListsUnchanged = unchanged;
+    Valid = true;
+    return true;
+}
+
+void ImGui_ImplQtRemote_Player::BuildDrawData()
+{
+    const int count = (int)Lists.size();
+    while (DrawLists.Size > count)
+    {
+        IM_DELETE(DrawLists.back());
+        DrawLists.pop_back();
+    }
+    while (DrawLists.Size < count)
+        DrawLists.push_back(IM_NEW(ImDrawList)(nullptr));
+
+    DrawData.TotalVtxCount = DrawData.TotalIdxCount = 0;
+    for (int n = 0; n < count; n++)
+    {
+        const ImGui_ImplQtRemote_ListState& state = Lists[n];
+        ImDrawList* cmd_list = DrawLists[n];
+        cmd_list->VtxBuffer.resize(state.Vtx.size() / (int)sizeof(ImDrawVert));
+        memcpy(cmd_list->VtxBuffer.Data, state.Vtx.constData(), (size_t)cmd_list->VtxBuffer.size_in_bytes());
+        cmd_list->IdxBuffer.resize(state.Idx.size() / (int)sizeof(ImDrawIdx));
+        memcpy(cmd_list->IdxBuffer.Data, state.Idx.constData(), (size_t)cmd_list->IdxBuffer.size_in_bytes());
+
+        const int cmd_count = state.Cmd.size() / (int)sizeof(ImGui_ImplQtRemote_Cmd);
+        const ImGui_ImplQtRemote_Cmd* remote_cmds = (const ImGui_ImplQtRemote_Cmd*)state.Cmd.constData();
+        cmd_list->CmdBuffer.resize(0);
+        for (int i = 0; i < cmd_count; i++)
+        {
+            ImGui_ImplQtRemote_Cmd remote_cmd;
+            memcpy(&remote_cmd, remote_cmds + i, sizeof(remote_cmd));
+            ImDrawCmd cmd;
+            memcpy(&cmd.ClipRect, remote_cmd.ClipRect, sizeof(remote_cmd.ClipRect));
+            //发送端的纹理ID映射为本地的流纹理
+            auto it = Textures.find(remote_cmd.TextureId);
+            cmd.TextureId = (it != Textures.end() && it->Stream) ? ImGui_ImplQtOpenGL3_GetStreamTextureID(it->Stream) : (ImTextureID)(intptr_t)remote_cmd.TextureId;
+            cmd.VtxOffset = remote_cmd.VtxOffset;
+            cmd.IdxOffset = remote_cmd.IdxOffset;
+            cmd.ElemCount = remote_cmd.ElemCount;
+            cmd.UserCallback = remote_cmd.ResetRenderState ? ImDrawCallback_ResetRenderState : nullptr;
+            cmd_list->CmdBuffer.push_back(cmd);
+        }
+        DrawData.TotalVtxCount += cmd_list->VtxBuffer.Size;
+        DrawData.TotalIdxCount += cmd_list->IdxBuffer.Size;
+    }
+    DrawData.Valid = true;
+    DrawData.CmdListsCount = count;
+    DrawData.CmdLists = DrawLists.Data;
+    DrawData.OwnerViewport = nullptr;
+}
+
+ImGui_ImplQtRemote_Player* ImGui_ImplQtRemote_CreatePlayer(QIODevice* device, QObject* input_source)
+{
+    IM_ASSERT(device != nullptr);
+    auto player = IM_NEW(ImGui_ImplQtRemote_Player)();
+    player->Device = device;
+    player->InputSource = input_source;
+    player->ReadyRead = QObject::connect(device, &QIODevice::readyRead, device, [player]() {
+        ImGui_ImplQtRemote_ReadMessages(player->Device, player->Incoming, [player](int type, const char* data, int size) {
+            player->HandleMessage(type, data, size);
+        });
+    });
+    if (input_source)
+    {
+        player->InputFilter.reset(new ImGui_ImplQtRemote_InputFilter(player));
+        input_source->installEventFilter(player->InputFilter.get());
+    }
+    player->Resync();
+    return player;
+}
+
+void ImGui_ImplQtRemote_DestroyPlayer(ImGui_ImplQtRemote_Player* player)
+{
+    if (!player)
+        return;
+    QObject::disconnect(player->ReadyRead);
+    if (player->InputSource && player->InputFilter)
+        player->InputSource->removeEventFilter(player->InputFilter.get());
+    //流纹理属于当前GL上下文的渲染器
+    for (auto& texture : player->Textures)
+        if (texture.Stream)
+            ImGui_ImplQtOpenGL3_DestroyStreamTexture(texture.Stream);
+    for (ImDrawList* cmd_list : player->DrawLists)
+        IM_DELETE(cmd_list);
+    IM_DELETE(player);
+}
+
+ImDrawData* ImGui_ImplQtRemote_UpdatePlayer(ImGui_ImplQtRemote_Player* player, const ImVec2& display_size, float device_pixel_ratio)
+{
+    if (!player)
+        return nullptr;
+
+    if (player->DisplaySize.x != display_size.x || player->DisplaySize.y != display_size.y || player->DevicePixelRatio != device_pixel_ratio)
+    {
+        QByteArray payload;
+        ImGui_ImplQtRemote_Write(payload, display_size.x);
+        ImGui_ImplQtRemote_Write(payload, display_size.y);
+        ImGui_ImplQtRemote_Write(payload, device_pixel_ratio);
+        ImGui_ImplQtRemote_SendMessage(player->Device, ImGui_ImplQtRemote_MessageType_Resize, payload);
+        player->DisplaySize = display_size;
+        player->DevicePixelRatio = device_pixel_ratio;
+    }
+
+    //新收到的纹理在GL上下文当前时上传
+    bool textures_changed = false;
+    for (auto& texture : player->Textures)
+    {
+        if (texture.Pixels.isEmpty())
+            continue;
+        if (texture.Stream)
+        {
+            ImVec2 size;
+            ImGui_ImplQtOpenGL3_GetTextureSize(ImGui_ImplQtOpenGL3_GetStreamTextureID(texture.Stream), &size);
+            if ((int)size.x != texture.Width || (int)size.y != texture.Height)
+            {
+                ImGui_ImplQtOpenGL3_DestroyStreamTexture(texture.Stream);
+                texture.Stream = nullptr;
+            }
+        }
+        if (!texture.Stream)
+            texture.Stream = ImGui_ImplQtOpenGL3_CreateStreamTexture(texture.Width, texture.Height);
+        ImGui_ImplQtOpenGL3_PushStreamFrame(texture.Stream, texture.Pixels.constData());
+        texture.Pixels.clear();
+        textures_changed = true;
+    }
+
+    if (!player->Valid)
+        return nullptr;
+    if (player->FramesPending > 0 || textures_changed)
+    {
+        player->BuildDrawData();
+        //两次更新之间收到的多帧只显示最新的一帧
+        if (player->FramesPending > 1)
+            player->Stats.FramesDropped += player->FramesPending - 1;
+        player->FramesPending = 0;
+
+        QByteArray payload;
+        ImGui_ImplQtRemote_Write(payload, player->FrameId);
+        ImGui_ImplQtRemote_Write(payload, player->FrameTimestamp);
+        ImGui_ImplQtRemote_SendMessage(player->Device, ImGui_ImplQtRemote_MessageType_Ack, payload);
+    }
+    return &player->DrawData;
+}
+
+void ImGui_ImplQtRemote_GetPlayerStats(ImGui_ImplQtRemote_Player* player, ImGui_ImplQtRemote_Stats* stats)
+{
+    if (player && stats) {
+        *stats = player->Stats;
+    }
+}
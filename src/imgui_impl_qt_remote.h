@@ -0,0 +1,34 @@
+#pragma once
+
+#include "imgui.h"
+
+class QIODevice;
+class QObject;
+
+// Remote rendering: delta encoded ImDrawData over any QIODevice, both ends need the same byte order and ImDrawIdx
+struct ImGui_ImplQtRemote_Sender;
+struct ImGui_ImplQtRemote_Player;
+
+struct ImGui_ImplQtRemote_Stats
+{
+    int   FramesSent;           // Sender: frames written / Player: frames received
+    int   FramesDropped;        // Sender: skipped while the socket was backed up / Player: replaced before being rendered
+    int   FrameBytes;           // Last frame on the wire, after compression
+    int   FrameRawBytes;        // Last frame before delta encoding and compression
+    float BytesPerFrameAverage;
+    int   ListsUnchanged;       // Draw lists of the last frame sent as "same as before"
+    float LatencyMs;            // Sender: send to displayed and acknowledged / Player: send to received (same host clock)
+    float LatencyAverageMs;
+};
+
+// Application process, on the thread owning the device with the UI context (ImGui_ImplQt_InitHeadless()) current
+IMGUI_IMPL_API ImGui_ImplQtRemote_Sender* ImGui_ImplQtRemote_CreateSender(QIODevice* device);
+IMGUI_IMPL_API void ImGui_ImplQtRemote_DestroySender(ImGui_ImplQtRemote_Sender* sender);
+IMGUI_IMPL_API void ImGui_ImplQtRemote_SendDrawData(ImGui_ImplQtRemote_Sender* sender, ImDrawData* draw_data);
+IMGUI_IMPL_API void ImGui_ImplQtRemote_GetSenderStats(ImGui_ImplQtRemote_Sender* sender, ImGui_ImplQtRemote_Stats* stats);
+
+// Display process, input events of input_source are forwarded to the sender
+IMGUI_IMPL_API ImGui_ImplQtRemote_Player* ImGui_ImplQtRemote_CreatePlayer(QIODevice* device, QObject* input_source);
+IMGUI_IMPL_API void ImGui_ImplQtRemote_DestroyPlayer(ImGui_ImplQtRemote_Player* player);
+IMGUI_IMPL_API ImDrawData* ImGui_ImplQtRemote_UpdatePlayer(ImGui_ImplQtRemote_Player* player, const ImVec2& display_size, float device_pixel_ratio);     // GL context current, nullptr until the first frame
+IMGUI_IMPL_API void ImGui_ImplQtRemote_GetPlayerStats(ImGui_ImplQtRemote_Player* player, ImGui_ImplQtRemote_Stats* stats);
@@ -0,0 +1,803 @@
+﻿#include "imgui_impl_qt_software.h"
+#include "imgui_internal.h"
+#include "imgui_impl_qt_fonts.h"
+#include "imgui_impl_qt_governor.h"
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+#include <QtCore/QRunnable>
+#include <QtGui/QImage>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <float.h>
+#include <math.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define IMGUI_IMPL_QT_SOFTWARE_SSE2
+#endif
+
+// Pixels are premultiplied ARGB, the native layout of QImage::Format_ARGB32_Premultiplied
+struct ImGui_ImplQtSoftware_Texture
+{
+    int Width{};
+    int Height{};
+    std::vector<ImU32> Pixels;
+};
+
+enum ImGui_ImplQtSoftware_PrimKind
+{
+    ImGui_ImplQtSoftware_PrimKind_Fill,         // Axis-aligned rectangle of a single color
+    ImGui_ImplQtSoftware_PrimKind_Rect,         // Axis-aligned textured rectangle (glyphs, images)
+    ImGui_ImplQtSoftware_PrimKind_TriangleFill, // Triangle of a single color
+    ImGui_ImplQtSoftware_PrimKind_Triangle,     // Triangle with interpolated color and uv
+};
+
+struct ImGui_ImplQtSoftware_Prim
+{
+    int        Kind;
+    int        Rect[4];     // Bounding box clipped to the scissor rectangle, in framebuffer pixels [x0,y0,x1,y1)
+    const ImGui_ImplQtSoftware_Texture* Texture;
+    ImU32      Color;       // Premultiplied ARGB, Fill/Rect/TriangleFill
+    ImDrawVert Vtx[3];      // Framebuffer space. Rect uses Vtx[0]/Vtx[1] as min/max corner
+};
+
+struct ImGui_ImplQtSoftware;
+
+class ImGui_ImplQtSoftware_Worker :public QRunnable
+{
+public:
+    explicit ImGui_ImplQtSoftware_Worker(ImGui_ImplQtSoftware* bd)
+        :Backend(bd) {
+        setAutoDelete(false);
+    }
+    void run() override;
+private:
+    ImGui_ImplQtSoftware* Backend{};
+};
+
+struct ImGui_ImplQtSoftware
+{
+public:
+    enum { TileSize = 64 };
+
+    bool Init(ImGuiIO& io, int thread_count);
+    void Shutdown();
+    void RenderDrawData(ImDrawData* draw_data);
+    bool CreateFontsTexture(ImGuiIO& io);
+    void DestoryFontsTexture(ImGuiIO& io);
+
+    ImGui_ImplQtSoftware_Texture* CreateTexture(const QImage& image);
+    void DestroyTexture(ImGui_ImplQtSoftware_Texture* texture);
+
+    void RenderTiles();
+private:
+    void BinDrawList(const ImDrawList* cmd_list, const ImVec2& clip_off, const ImVec2& clip_scale);
+    void BinTriangle(const ImDrawVert& v0, const ImDrawVert& v1, const ImDrawVert& v2, const ImVec2& clip_off, const ImVec2& clip_scale, const int clip[4], const ImGui_ImplQtSoftware_Texture* texture);
+    void BinPrim(const ImGui_ImplQtSoftware_Prim& prim);
+    void RenderTile(int tile);
+public:
+    ImGui_ImplQtSoftware_Texture* FontTexture{};
+    ImVector<ImGui_ImplQtSoftware_Texture*> Textures;
+    QImage     Image;
+    ImU32      ClearColor{ 0xFF000000 };
+    bool       LastAntiAliasedLinesUseTex{};   // Style value restored by Shutdown()
+
+    QThreadPool Pool;
+    std::vector<std::unique_ptr<ImGui_ImplQtSoftware_Worker>> Workers;
+
+    ImVector<ImGui_ImplQtSoftware_Prim> Prims;
+    std::vector<ImVector<int>> Bins;    // Prim indices of each tile, in submission order
+    int        TilesX{};
+    int        TilesY{};
+    std::atomic<int> NextTile{};
+    ImU32*     Pixels{};
+    int        Stride{};            // In pixels
+    int        Width{};
+    int        Height{};
+};
+
+static ImGui_ImplQtSoftware* ImGui_ImplQtSoftware_GetBackendData()
+{
+    return ImGui::GetCurrentContext() ?
+        (ImGui_ImplQtSoftware*)ImGui::GetIO().BackendRendererUserData : nullptr;
+}
+
+void ImGui_ImplQtSoftware_Worker::run()
+{
+    Backend->RenderTiles();
+}
+
+//ImGui顶点颜色(ABGR)转为预乘ARGB
+static inline ImU32 ImGui_ImplQtSoftware_Premultiply(ImU32 col)
+{
+    const ImU32 a = (col >> IM_COL32_A_SHIFT) & 0xFF;
+    const ImU32 r = (col >> IM_COL32_R_SHIFT) & 0xFF;
+    const ImU32 g = (col >> IM_COL32_G_SHIFT) & 0xFF;
+    const ImU32 b = (col >> IM_COL32_B_SHIFT) & 0xFF;
+    return (a << 24) | (((r * a + 127) / 255) << 16) | (((g * a + 127) / 255) << 8) | ((b * a + 127) / 255);
+}
+
+//逐通道相乘 x*y/255
+static inline ImU32 ImGui_ImplQtSoftware_Modulate(ImU32 x, ImU32 y)
+{
+    ImU32 result = 0;
+    for (int shift = 0; shift < 32; shift += 8)
+    {
+        ImU32 t = ((x >> shift) & 0xFF) * ((y >> shift) & 0xFF) + 0x80;
+        result |= (((t + (t >> 8)) >> 8) & 0xFF) << shift;
+    }
+    return result;
+}
+
+//dst = src + dst * (255 - src.a) / 255
+static inline ImU32 ImGui_ImplQtSoftware_Blend(ImU32 src, ImU32 dst)
+{
+    const ImU32 inv = 255 - (src >> 24);
+    ImU32 rb = (dst & 0x00FF00FF) * inv + 0x00800080;
+    rb = ((rb + ((rb >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+    ImU32 ag = ((dst >> 8) & 0x00FF00FF) * inv + 0x00800080;
+    ag = (ag + ((ag >> 8) & 0x00FF00FF)) & 0xFF00FF00;
+    return src + (rb | ag);
+}
+
+#ifdef IMGUI_IMPL_QT_SOFTWARE_SSE2
+//8个16位通道 x*y/255
+static inline __m128i ImGui_ImplQtSoftware_MulDiv255(__m128i x, __m128i y)
+{
+    __m128i t = _mm_add_epi16(_mm_mullo_epi16(x, y), _mm_set1_epi16(0x80));
+    return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+
+//4个像素的alpha扩展到16位通道: 低两个像素与高两个像素
+static inline void ImGui_ImplQtSoftware_ExpandAlpha(__m128i src, __m128i* lo, __m128i* hi)
+{
+    __m128i alpha = _mm_srli_epi32(src, 24);
+    alpha = _mm_or_si128(alpha, _mm_slli_epi32(alpha, 16));
+    *lo = _mm_unpacklo_epi32(alpha, alpha);
+    *hi = _mm_unpackhi_epi32(alpha, alpha);
+}
+
+static inline __m128i ImGui_ImplQtSoftware_Blend4(__m128i src, __m128i dst)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ff = _mm_set1_epi16(0xFF);
+    __m128i alpha_lo, alpha_hi;
+    ImGui_ImplQtSoftware_ExpandAlpha(src, &alpha_lo, &alpha_hi);
+    const __m128i lo = ImGui_ImplQtSoftware_MulDiv255(_mm_unpacklo_epi8(dst, zero), _mm_sub_epi16(ff, alpha_lo));
+    const __m128i hi = ImGui_ImplQtSoftware_MulDiv255(_mm_unpackhi_epi8(dst, zero), _mm_sub_epi16(ff, alpha_hi));
+    return _mm_adds_epu8(src, _mm_packus_epi16(lo, hi));
+}
+#endif
+
+//以单一颜色填充/混合一段像素
+static void ImGui_ImplQtSoftware_FillSpan(ImU32* dst, ImU32 color, int count)
+{
+    if ((color >> 24) == 0xFF)
+    {
+        for (int i = 0; i < count; i++)
+            dst[i] = color;
+        return;
+    }
+    if (color == 0)
+        return;
+    int i = 0;
+#ifdef IMGUI_IMPL_QT_SOFTWARE_SSE2
+    const __m128i src = _mm_set1_epi32((int)color);
+    for (; i + 4 <= count; i += 4)
+        _mm_storeu_si128((__m128i*)(dst + i), ImGui_ImplQtSoftware_Blend4(src, _mm_loadu_si128((const __m128i*)(dst + i))));
+#endif
+    for (; i < count; i++)
+        dst[i] = ImGui_ImplQtSoftware_Blend(color, dst[i]);
+}
+
+//将src混合到dst
+static void ImGui_ImplQtSoftware_BlendSpan(ImU32* dst, const ImU32* src, int count)
+{
+    int i = 0;
+#ifdef IMGUI_IMPL_QT_SOFTWARE_SSE2
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+        const int alpha_mask = _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_srli_epi32(s, 24), _mm_setzero_si128()));
+        if (alpha_mask == 0xFFFF)
+            continue;   //全透明(字形的空白区域)
+        _mm_storeu_si128((__m128i*)(dst + i), ImGui_ImplQtSoftware_Blend4(s, _mm_loadu_si128((const __m128i*)(dst + i))));
+    }
+#endif
+    for (; i < count; i++)
+        if (src[i] != 0)
+            dst[i] = ImGui_ImplQtSoftware_Blend(src[i], dst[i]);
+}
+
+//src逐通道乘以color
+static void ImGui_ImplQtSoftware_ModulateSpan(ImU32* src, ImU32 color, int count)
+{
+    if (color == 0xFFFFFFFF)
+        return;
+    int i = 0;
+#ifdef IMGUI_IMPL_QT_SOFTWARE_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i c = _mm_unpacklo_epi8(_mm_set1_epi32((int)color), zero);
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+        const __m128i lo = ImGui_ImplQtSoftware_MulDiv255(_mm_unpacklo_epi8(s, zero), c);
+        const __m128i hi = ImGui_ImplQtSoftware_MulDiv255(_mm_unpackhi_epi8(s, zero), c);
+        _mm_storeu_si128((__m128i*)(src + i), _mm_packus_epi16(lo, hi));
+    }
+#endif
+    for (; i < count; i++)
+        src[i] = ImGui_ImplQtSoftware_Modulate(src[i], color);
+}
+
+static inline ImU32 ImGui_ImplQtSoftware_Sample(const ImGui_ImplQtSoftware_Texture* texture, float u, float v)
+{
+    if (!texture)
+        return 0xFFFFFFFF;
+    const int x = ImClamp((int)floorf(u * texture->Width), 0, texture->Width - 1);
+    const int y = ImClamp((int)floorf(v * texture->Height), 0, texture->Height - 1);
+    return texture->Pixels[(size_t)y * texture->Width + x];
+}
+
+bool ImGui_ImplQtSoftware_Init(int thread_count)
+{
+    ImGuiIO& io = ImGui::GetIO();
+    IM_ASSERT(io.BackendRendererUserData == nullptr && "Already initialized a renderer backend!");
+
+    ImGui_ImplQtSoftware* bd = IM_NEW(ImGui_ImplQtSoftware)();
+    io.BackendRendererUserData = (void*)bd;
+    io.BackendRendererName = "imgui_impl_qt_software";
+
+    return bd->Init(io, thread_count);
+}
+
+bool ImGui_ImplQtSoftware::Init(ImGuiIO& io, int thread_count)
+{
+    auto bd = this;
+    io.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset;
+
+    //最近邻采样无法还原烘焙的抗锯齿线条,改用几何体生成。字体图集可能与其他上下文共用,只改本上下文的样式
+    bd->LastAntiAliasedLinesUseTex = ImGui::GetStyle().AntiAliasedLinesUseTex;
+
+    if (thread_count <= 0)
+        thread_count = QThread::idealThreadCount();
+    thread_count = ImMax(thread_count, 1);
+    //调用线程也参与光栅化
+    bd->Pool.setMaxThreadCount(ImMax(thread_count - 1, 1));
+    for (int i = 1; i < thread_count; i++)
+        bd->Workers.emplace_back(new ImGui_ImplQtSoftware_Worker(bd));
+    return true;
+}
+
+void ImGui_ImplQtSoftware::Shutdown()
+{
+    auto bd = this;
+    bd->Pool.waitForDone();
+    for (ImGui_ImplQtSoftware_Texture* texture : bd->Textures)
+        IM_DELETE(texture);
+    bd->Textures.clear();
+    bd->FontTexture = nullptr;
+}
+
+bool ImGui_ImplQtSoftware::CreateFontsTexture(ImGuiIO& io)
+{
+    auto bd = this;
+
+    if (!io.Fonts->TexPixelsAlpha8 && !io.Fonts->TexPixelsRGBA32)
+        ImGui_ImplQt_BuildFontAtlas(io.Fonts);
+    unsigned char* pixels;
+    int width, height;
+    io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+
+    ImGui_ImplQtSoftware_Texture* texture = IM_NEW(ImGui_ImplQtSoftware_Texture)();
+    texture->Width = width;
+    texture->Height = height;
+    texture->Pixels.resize((size_t)width * height);
+    const ImU32* src = (const ImU32*)pixels;
+    //距离场图集按原始大小阈值化,轮廓两侧各半个像素过渡,缩放时不再锐利
+    const bool sdf = ImGui_ImplQt_IsFontAtlasSdf(io.Fonts);
+    for (size_t i = 0; i < texture->Pixels.size(); i++)
+    {
+        ImU32 col = src[i];
+        if (sdf)
+        {
+            const int alpha = ImClamp(((int)(col >> IM_COL32_A_SHIFT) - 112) * 8, 0, 255);
+            col = (col & ~IM_COL32_A_MASK) | ((ImU32)alpha << IM_COL32_A_SHIFT);
+        }
+        texture->Pixels[i] = ImGui_ImplQtSoftware_Premultiply(col);
+    }
+    bd->Textures.push_back(texture);
+    bd->FontTexture = texture;
+
+    io.Fonts->SetTexID((ImTextureID)bd->FontTexture);
+    return true;
+}
+
+void ImGui_ImplQtSoftware::DestoryFontsTexture(ImGuiIO& io)
+{
+    auto bd = this;
+    if (bd->FontTexture)
+    {
+        DestroyTexture(bd->FontTexture);
+        io.Fonts->SetTexID(0);
+        bd->FontTexture = nullptr;
+    }
+}
+
+ImGui_ImplQtSoftware_Texture* ImGui_ImplQtSoftware::CreateTexture(const QImage& image)
+{
+    auto bd = this;
+    const QImage source = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    ImGui_ImplQtSoftware_Texture* texture = IM_NEW(ImGui_ImplQtSoftware_Texture)();
+    texture->Width = source.width();
+    texture->Height = source.height();
+    texture->Pixels.resize((size_t)texture->Width * texture->Height);
+    for (int y = 0; y < texture->Height; y++)
+        memcpy(&texture->Pixels[(size_t)y * texture->Width], source.constScanLine(y), (size_t)texture->Width * sizeof(ImU32));
+    bd->Textures.push_back(texture);
+    return texture;
+}
+
+void ImGui_ImplQtSoftware::DestroyTexture(ImGui_ImplQtSoftware_Texture* texture)
+{
+    auto bd = this;
+    ImGui_ImplQtSoftware_Texture** it = bd->Textures.find(texture);
+    if (it == bd->Textures.end())
+        return;
+    bd->Textures.erase(it);
+    IM_DELETE(texture);
+}
+
+void ImGui_ImplQtSoftware::RenderDrawData(ImDrawData* draw_data)
+{
+    auto bd = this;
+    const int fb_width = (int)(draw_data->DisplaySize.x * draw_data->FramebufferScale.x);
+    const int fb_height = (int)(draw_data->DisplaySize.y * draw_data->FramebufferScale.y);
+    if (fb_width <= 0 || fb_height <= 0)
+        return;
+
+    if (bd->Image.width() != fb_width || bd->Image.height() != fb_height)
+        bd->Image = QImage(fb_width, fb_height, QImage::Format_ARGB32_Premultiplied);
+    bd->Image.setDevicePixelRatio(draw_data->FramebufferScale.x);
+    //在主线程上分离QImage的共享数据,工作线程只写像素
+    bd->Pixels = (ImU32*)bd->Image.bits();
+    bd->Stride = bd->Image.bytesPerLine() / (int)sizeof(ImU32);
+    bd->Width = fb_width;
+    bd->Height = fb_height;
+
+    bd->TilesX = (fb_width + TileSize - 1) / TileSize;
+    bd->TilesY = (fb_height + TileSize - 1) / TileSize;
+    const int tile_count = bd->TilesX * bd->TilesY;
+    if ((int)bd->Bins.size() < tile_count)
+        bd->Bins.resize(tile_count);
+    for (int i = 0; i < tile_count; i++)
+        bd->Bins[i].resize(0);
+    bd->Prims.resize(0);
+
+    // Will project scissor/clipping rectangles into framebuffer space
+    ImVec2 clip_off = draw_data->DisplayPos;         // (0,0) unless using multi-viewports
+    ImVec2 clip_scale = draw_data->FramebufferScale; // (1,1) unless using retina display which are often (2,2)
+    for (int n = 0; n < draw_data->CmdListsCount; n++)
+        BinDrawList(draw_data->CmdLists[n], clip_off, clip_scale);
+
+    bd->NextTile = 0;
+    for (auto& worker : bd->Workers)
+        bd->Pool.start(worker.get());
+    RenderTiles();
+    bd->Pool.waitForDone();
+}
+
+void ImGui_ImplQtSoftware::BinDrawList(const ImDrawList* cmd_list, const ImVec2& clip_off, const ImVec2& clip_scale)
+{
+    auto bd = this;
+    const ImDrawVert* vtx_buffer = cmd_list->VtxBuffer.Data;
+    const ImDrawIdx* idx_buffer = cmd_list->IdxBuffer.Data;
+    for (int cmd_i = 0; cmd_i < cmd_list->CmdBuffer.Size; cmd_i++)
+    {
+        const ImDrawCmd* pcmd = &cmd_list->CmdBuffer[cmd_i];
+        if (pcmd->UserCallback != nullptr)
+        {
+            //回调在分箱时执行,只能修改后续命令的状态,无法直接写入图像
+            if (pcmd->UserCallback != ImDrawCallback_ResetRenderState)
+                pcmd->UserCallback(cmd_list, pcmd);
+            continue;
+        }
+
+        // Project scissor/clipping rectangles into framebuffer space
+        ImVec2 clip_min((pcmd->ClipRect.x - clip_off.x) * clip_scale.x, (pcmd->ClipRect.y - clip_off.y) * clip_scale.y);
+        ImVec2 clip_max((pcmd->ClipRect.z - clip_off.x) * clip_scale.x, (pcmd->ClipRect.w - clip_off.y) * clip_scale.y);
+        int clip[4] = {
+            ImMax((int)clip_min.x, 0), ImMax((int)clip_min.y, 0),
+            ImMin((int)ceilf(clip_max.x), bd->Width), ImMin((int)ceilf(clip_max.y), bd->Height) };
+        if (clip[2] <= clip[0] || clip[3] <= clip[1])
+            continue;
+
+        const ImGui_ImplQtSoftware_Texture* texture = (const ImGui_ImplQtSoftware_Texture*)pcmd->GetTexID();
+        const ImDrawIdx* idx = idx_buffer + pcmd->IdxOffset;
+        const ImDrawVert* vtx = vtx_buffer + pcmd->VtxOffset;
+        const unsigned int idx_count = pcmd->ElemCount;
+        ImDrawVert v[4];
+        for (unsigned int i = 0; i + 3 <= idx_count; )
+        {
+            //识别PrimRect/PrimRectUV生成的轴对齐四边形 (a,b,c,a,c,d)
+            if (i + 6 <= idx_count && idx[i + 3] == idx[i] && idx[i + 4] == idx[i + 2])
+            {
+                v[0] = vtx[idx[i]];
+                v[1] = vtx[idx[i + 1]];
+                v[2] = vtx[idx[i + 2]];
+                v[3] = vtx[idx[i + 5]];
+                const bool axis_aligned =
+                    v[0].pos.y == v[1].pos.y && v[1].pos.x == v[2].pos.x && v[2].pos.y == v[3].pos.y && v[3].pos.x == v[0].pos.x &&
+                    v[0].uv.y == v[1].uv.y && v[1].uv.x == v[2].uv.x && v[2].uv.y == v[3].uv.y && v[3].uv.x == v[0].uv.x &&
+                    v[0].pos.x < v[2].pos.x && v[0].pos.y < v[2].pos.y &&
+                    v[0].col == v[1].col && v[0].col == v[2].col && v[0].col == v[3].col;
+                if (axis_aligned)
+                {
+                    ImGui_ImplQtSoftware_Prim prim;
+                    prim.Vtx[0] = v[0];
+                    prim.Vtx[1] = v[2];
+                    for (int k = 0; k < 2; k++)
+                    {
+                        prim.Vtx[k].pos.x = (prim.Vtx[k].pos.x - clip_off.x) * clip_scale.x;
+                        prim.Vtx[k].pos.y = (prim.Vtx[k].pos.y - clip_off.y) * clip_scale.y;
+                    }
+                    //像素中心落在[min,max)内
+                    prim.Rect[0] = ImMax((int)ceilf(prim.Vtx[0].pos.x - 0.5f), clip[0]);
+                    prim.Rect[1] = ImMax((int)ceilf(prim.Vtx[0].pos.y - 0.5f), clip[1]);
+                    prim.Rect[2] = ImMin((int)ceilf(prim.Vtx[1].pos.x - 0.5f), clip[2]);
+                    prim.Rect[3] = ImMin((int)ceilf(prim.Vtx[1].pos.y - 0.5f), clip[3]);
+                    prim.Texture = texture;
+                    prim.Color = ImGui_ImplQtSoftware_Premultiply(v[0].col);
+                    if (!texture || (v[0].uv.x == v[2].uv.x && v[0].uv.y == v[2].uv.y))
+                    {
+                        //纹理坐标退化为一点(白色像素),等同纯色填充
+                        prim.Kind = ImGui_ImplQtSoftware_PrimKind_Fill;
+                        prim.Color = ImGui_ImplQtSoftware_Modulate(prim.Color, ImGui_ImplQtSoftware_Sample(texture, v[0].uv.x, v[0].uv.y));
+                    }
+                    else
+                    {
+                        prim.Kind = ImGui_ImplQtSoftware_PrimKind_Rect;
+                    }
+                    BinPrim(prim);
+                    i += 6;
+                    continue;
+                }
+            }
+            BinTriangle(vtx[idx[i]], vtx[idx[i + 1]], vtx[idx[i + 2]], clip_off, clip_scale, clip, texture);
+            i += 3;
+        }
+    }
+}
+
+void ImGui_ImplQtSoftware::BinTriangle(const ImDrawVert& v0, const ImDrawVert& v1, const ImDrawVert& v2, const ImVec2& clip_off, const ImVec2& clip_scale, const int clip[4], const ImGui_ImplQtSoftware_Texture* texture)
+{
+    ImGui_ImplQtSoftware_Prim prim;
+    prim.Vtx[0] = v0;
+    prim.Vtx[1] = v1;
+    prim.Vtx[2] = v2;
+    float min_x = FLT_MAX, min_y = FLT_MAX, max_x = -FLT_MAX, max_y = -FLT_MAX;
+    for (int k = 0; k < 3; k++)
+    {
+        ImVec2& pos = prim.Vtx[k].pos;
+        pos.x = (pos.x - clip_off.x) * clip_scale.x;
+        pos.y = (pos.y - clip_off.y) * clip_scale.y;
+        min_x = ImMin(min_x, pos.x); max_x = ImMax(max_x, pos.x);
+        min_y = ImMin(min_y, pos.y); max_y = ImMax(max_y, pos.y);
+    }
+    //统一为顺时针(屏幕坐标系下面积为正)
+    const ImVec2& a = prim.Vtx[0].pos;
+    const float area = (prim.Vtx[1].pos.x - a.x) * (prim.Vtx[2].pos.y - a.y) - (prim.Vtx[1].pos.y - a.y) * (prim.Vtx[2].pos.x - a.x);
+    if (area == 0.0f)
+        return;
+    if (area < 0.0f)
+        ImSwap(prim.Vtx[1], prim.Vtx[2]);
+
+    prim.Rect[0] = ImMax((int)ceilf(min_x - 0.5f), clip[0]);
+    prim.Rect[1] = ImMax((int)ceilf(min_y - 0.5f), clip[1]);
+    prim.Rect[2] = ImMin((int)floorf(max_x - 0.5f) + 1, clip[2]);
+    prim.Rect[3] = ImMin((int)floorf(max_y - 0.5f) + 1, clip[3]);
+    prim.Texture = texture;
+    prim.Color = 0;
+
+    const bool uniform =
+        v0.col == v1.col && v0.col == v2.col &&
+        v0.uv.x == v1.uv.x && v0.uv.x == v2.uv.x && v0.uv.y == v1.uv.y && v0.uv.y == v2.uv.y;
+    if (uniform)
+    {
+        prim.Kind = ImGui_ImplQtSoftware_PrimKind_TriangleFill;
+        prim.Color = ImGui_ImplQtSoftware_Modulate(ImGui_ImplQtSoftware_Premultiply(v0.col), ImGui_ImplQtSoftware_Sample(texture, v0.uv.x, v0.uv.y));
+        if (prim.Color == 0)
+            return;
+    }
+    else
+    {
+        prim.Kind = ImGui_ImplQtSoftware_PrimKind_Triangle;
+    }
+    BinPrim(prim);
+}
+
+void ImGui_ImplQtSoftware::BinPrim(const ImGui_ImplQtSoftware_Prim& prim)
+{
+    auto bd = this;
+    if (prim.Rect[2] <= prim.Rect[0] || prim.Rect[3] <= prim.Rect[1])
+        return;
+    if (prim.Kind == ImGui_ImplQtSoftware_PrimKind_Fill && prim.Color == 0)
+        return;
+
+    const int index = bd->Prims.Size;
+    bd->Prims.push_back(prim);
+    const int tx0 = prim.Rect[0] / TileSize, tx1 = (prim.Rect[2] - 1) / TileSize;
+    const int ty0 = prim.Rect[1] / TileSize, ty1 = (prim.Rect[3] - 1) / TileSize;
+    for (int ty = ty0; ty <= ty1; ty++)
+        for (int tx = tx0; tx <= tx1; tx++)
+            bd->Bins[ty * bd->TilesX + tx].push_back(index);
+}
+
+void ImGui_ImplQtSoftware::RenderTiles()
+{
+    auto bd = this;
+    const int tile_count = bd->TilesX * bd->TilesY;
+    for (int tile = bd->NextTile++; tile < tile_count; tile = bd->NextTile++)
+        RenderTile(tile);
+}
+
+void ImGui_ImplQtSoftware::RenderTile(int tile)
+{
+    auto bd = this;
+    const int tile_x0 = (tile % bd->TilesX) * TileSize;
+    const int tile_y0 = (tile / bd->TilesX) * TileSize;
+    const int tile_x1 = ImMin(tile_x0 + (int)TileSize, bd->Width);
+    const int tile_y1 = ImMin(tile_y0 + (int)TileSize, bd->Height);
+
+    for (int y = tile_y0; y < tile_y1; y++)
+    {
+        ImU32* row = bd->Pixels + (size_t)y * bd->Stride;
+        for (int x = tile_x0; x < tile_x1; x++)
+            row[x] = bd->ClearColor;
+    }
+
+    ImU32 span[TileSize];
+    const ImVector<int>& bin = bd->Bins[tile];
+    for (int index : bin)
+    {
+        const ImGui_ImplQtSoftware_Prim& prim = bd->Prims[index];
+        const int x0 = ImMax(prim.Rect[0], tile_x0);
+        const int y0 = ImMax(prim.Rect[1], tile_y0);
+        const int x1 = ImMin(prim.Rect[2], tile_x1);
+        const int y1 = ImMin(prim.Rect[3], tile_y1);
+        if (x1 <= x0 || y1 <= y0)
+            continue;
+
+        switch (prim.Kind)
+        {
+        case ImGui_ImplQtSoftware_PrimKind_Fill:
+        {
+            for (int y = y0; y < y1; y++)
+                ImGui_ImplQtSoftware_FillSpan(bd->Pixels + (size_t)y * bd->Stride + x0, prim.Color, x1 - x0);
+            break;
+        }
+        case ImGui_ImplQtSoftware_PrimKind_Rect:
+        {
+            //最近邻采样,纹理坐标按16.16定点步进
+            const ImGui_ImplQtSoftware_Texture* texture = prim.Texture;
+            const ImDrawVert& p0 = prim.Vtx[0];
+            const ImDrawVert& p1 = prim.Vtx[1];
+            const float tu = (p1.uv.x - p0.uv.x) * texture->Width / (p1.pos.x - p0.pos.x);
+            const float tv = (p1.uv.y - p0.uv.y) * texture->Height / (p1.pos.y - p0.pos.y);
+            const int u_step = (int)(tu * 65536.0f);
+            const int u_start = (int)((p0.uv.x * texture->Width + (x0 + 0.5f - p0.pos.x) * tu) * 65536.0f);
+            for (int y = y0; y < y1; y++)
+            {
+                const int ty = ImClamp((int)floorf(p0.uv.y * texture->Height + (y + 0.5f - p0.pos.y) * tv), 0, texture->Height - 1);
+                const ImU32* texels = &texture->Pixels[(size_t)ty * texture->Width];
+                int u = u_start;
+                for (int x = 0; x < x1 - x0; x++, u += u_step)
+                    span[x] = texels[ImClamp(u >> 16, 0, texture->Width - 1)];
+                ImGui_ImplQtSoftware_ModulateSpan(span, prim.Color, x1 - x0);
+                ImGui_ImplQtSoftware_BlendSpan(bd->Pixels + (size_t)y * bd->Stride + x0, span, x1 - x0);
+            }
+            break;
+        }
+        case ImGui_ImplQtSoftware_PrimKind_TriangleFill:
+        case ImGui_ImplQtSoftware_PrimKind_Triangle:
+        {
+            const ImVec2& a = prim.Vtx[0].pos;
+            const ImVec2& b = prim.Vtx[1].pos;
+            const ImVec2& c = prim.Vtx[2].pos;
+            //边函数 e(p) = A*px + B*py + C, 三角形内部e>=0
+            float A[3] = { a.y - b.y, b.y - c.y, c.y - a.y };
+            float B[3] = { b.x - a.x, c.x - b.x, a.x - c.x };
+            float C[3] = { a.x * b.y - a.y * b.x, b.x * c.y - b.y * c.x, c.x * a.y - c.y * a.x };
+            //左上规则: 只有上边和左边包含边上的像素
+            bool inclusive[3];
+            for (int k = 0; k < 3; k++)
+                inclusive[k] = (A[k] == 0.0f && B[k] < 0.0f) || A[k] > 0.0f;
+            auto inside = [&](float px, float py) {
+                for (int k = 0; k < 3; k++)
+                {
+                    const float e = A[k] * px + B[k] * py + C[k];
+                    if (e < 0.0f || (e == 0.0f && !inclusive[k]))
+                        return false;
+                }
+                return true;
+            };
+
+            //颜色(未预乘)与纹理坐标的平面方程 attr = dx*px + dy*py + c
+            const float area = C[0] + C[1] + C[2];
+            float attr_dx[6], attr_dy[6], attr_c[6];
+            const bool interpolate = prim.Kind == ImGui_ImplQtSoftware_PrimKind_Triangle;
+            if (interpolate)
+            {
+                float values[3][6];
+                for (int k = 0; k < 3; k++)
+                {
+                    const ImDrawVert& v = prim.Vtx[k];
+                    values[k][0] = (float)((v.col >> IM_COL32_R_SHIFT) & 0xFF);
+                    values[k][1] = (float)((v.col >> IM_COL32_G_SHIFT) & 0xFF);
+                    values[k][2] = (float)((v.col >> IM_COL32_B_SHIFT) & 0xFF);
+                    values[k][3] = (float)((v.col >> IM_COL32_A_SHIFT) & 0xFF);
+                    values[k][4] = v.uv.x;
+                    values[k][5] = v.uv.y;
+                }
+                //顶点k的权重为对边的边函数: w0=e1, w1=e2, w2=e0
+                for (int j = 0; j < 6; j++)
+                {
+                    attr_dx[j] = (values[0][j] * A[1] + values[1][j] * A[2] + values[2][j] * A[0]) / area;
+                    attr_dy[j] = (values[0][j] * B[1] + values[1][j] * B[2] + values[2][j] * B[0]) / area;
+                    attr_c[j] = (values[0][j] * C[1] + values[1][j] * C[2] + values[2][j] * C[0]) / area;
+                }
+            }
+
+            for (int y = y0; y < y1; y++)
+            {
+                const float py = y + 0.5f;
+                //解出本行覆盖的区间[lo,hi],再用精确测试修正端点的舍入误差
+                float lo = (float)x0, hi = (float)(x1 - 1);
+                for (int k = 0; k < 3; k++)
+                {
+                    const float row_c = B[k] * py + C[k];
+                    if (A[k] > 0.0f)
+                        lo = ImMax(lo, -row_c / A[k] - 0.5f);
+                    else if (A[k] < 0.0f)
+                        hi = ImMin(hi, -row_c / A[k] - 0.5f);
+                    else if (row_c < 0.0f)
+                        hi = -1.0f;
+                }
+                if (hi < lo - 1.0f)
+                    continue;
+                int xs = ImClamp((int)ceilf(lo), x0, x1);
+                int xe = ImClamp((int)floorf(hi) + 1, xs, x1);
+                while (xs > x0 && inside(xs - 0.5f, py)) xs--;
+                while (xs < xe && !inside(xs + 0.5f, py)) xs++;
+                while (xe < x1 && inside(xe + 0.5f, py)) xe++;
+                while (xe > xs && !inside(xe - 0.5f, py)) xe--;
+                if (xe <= xs)
+                    continue;
+
+                ImU32* dst = bd->Pixels + (size_t)y * bd->Stride + xs;
+                if (!interpolate)
+                {
+                    ImGui_ImplQtSoftware_FillSpan(dst, prim.Color, xe - xs);
+                    continue;
+                }
+                float attr[6];
+                for (int j = 0; j < 6; j++)
+                    attr[j] = attr_dx[j] * (xs + 0.5f) + attr_dy[j] * py + attr_c[j];
+                for (int x = 0; x < xe - xs; x++)
+                {
+                    const ImU32 alpha = (ImU32)ImClamp(attr[3] + 0.5f, 0.0f, 255.0f);
+                    const float scale = alpha / 255.0f;
+                    const ImU32 r = (ImU32)ImClamp(attr[0] * scale + 0.5f, 0.0f, 255.0f);
+                    const ImU32 g = (ImU32)ImClamp(attr[1] * scale + 0.5f, 0.0f, 255.0f);
+                    const ImU32 b = (ImU32)ImClamp(attr[2] * scale + 0.5f, 0.0f, 255.0f);
+                    const ImU32 color = (alpha << 24) | (r << 16) | (g << 8) | b;
+                    span[x] = ImGui_ImplQtSoftware_Modulate(color, ImGui_ImplQtSoftware_Sample(prim.Texture, attr[4], attr[5]));
+                    for (int j = 0; j < 6; j++)
+                        attr[j] += attr_dx[j];
+                }
+                ImGui_ImplQtSoftware_BlendSpan(dst, span, xe - xs);
+            }
+            break;
+        }
+        }
+    }
+}
+
+void ImGui_ImplQtSoftware_Shutdown()
+{
+    ImGui_ImplQtSoftware* bd = ImGui_ImplQtSoftware_GetBackendData();
+    IM_ASSERT(bd != nullptr && "No renderer backend to shutdown, or already shutdown?");
+    ImGuiIO& io = ImGui::GetIO();
+
+    bd->DestoryFontsTexture(io);
+    bd->Shutdown();
+    ImGui::GetStyle().AntiAliasedLinesUseTex = bd->LastAntiAliasedLinesUseTex;
+    io.BackendRendererName = nullptr;
+    io.BackendRendererUserData = nullptr;
+    IM_DELETE(bd);
+}
+
+void ImGui_ImplQtSoftware_NewFrame()
+{
+    auto bd = ImGui_ImplQtSoftware_GetBackendData();
+    IM_ASSERT(bd != nullptr && "Did you call ImGui_ImplQtSoftware_Init()?");
+    ImGui::GetStyle().AntiAliasedLinesUseTex = false;
+    if (!bd->FontTexture)
+        ImGui_ImplQtSoftware_CreateDeviceObjects();
+    else if (ImGui_ImplQt_ApplyFontAtlasScale(ImGui::GetIO())) {
+        bd->DestoryFontsTexture(ImGui::GetIO());
+        bd->CreateFontsTexture(ImGui::GetIO());
+    }
+}
+
+void ImGui_ImplQtSoftware_RenderDrawData(ImDrawData* draw_data)
+{
+    auto bd = ImGui_ImplQtSoftware_GetBackendData();
+    if (bd) {
+        bd->RenderDrawData(draw_data);
+        if (ImGui_ImplQt_QualityGovernor* governor = ImGui_ImplQt_QualityGovernor::Find(ImGui::GetCurrentContext()))
+            governor->FrameRendered();
+    }
+}
+
+bool ImGui_ImplQtSoftware_CreateFontsTexture()
+{
+    auto bd = ImGui_ImplQtSoftware_GetBackendData();
+    if (bd) {
+        return bd->CreateFontsTexture(ImGui::GetIO());
+    }
+    return false;
+}
+
+void ImGui_ImplQtSoftware_DestoryFontsTexture()
+{
+    auto bd = ImGui_ImplQtSoftware_GetBackendData();
+    if (bd) {
+        bd->DestoryFontsTexture(ImGui::GetIO());
+    }
+}
+
+bool ImGui_ImplQtSoftware_CreateDeviceObjects()
+{
+    return ImGui_ImplQtSoftware_CreateFontsTexture();
+}
+
+void ImGui_ImplQtSoftware_DestoryDeviceObjects()
+{
+    ImGui_ImplQtSoftware_DestoryFontsTexture();
+}
+
+const QImage& ImGui_ImplQtSoftware_GetImage()
+{
+    auto bd = ImGui_ImplQtSoftware_GetBackendData();
+    IM_ASSERT(bd != nullptr && "Did you call ImGui_ImplQtSoftware_Init()?");
+    return bd->Image;
+}
+
+void ImGui_ImplQtSoftware_SetClearColor(const ImVec4& clear_color)
+{
+    auto bd = ImGui_ImplQtSoftware_GetBackendData();
+    if (bd) {
+        const ImVec4 premultiplied(clear_color.x * clear_color.w, clear_color.y * clear_color.w, clear_color.z * clear_color.w, clear_color.w);
+        const ImU32 col = ImGui::ColorConvertFloat4ToU32(premultiplied);
+        bd->ClearColor = (((col >> IM_COL32_A_SHIFT) & 0xFF) << 24) | (((col >> IM_COL32_R_SHIFT) & 0xFF) << 16)
+            | (((col >> IM_COL32_G_SHIFT) & 0xFF) << 8) | ((col >> IM_COL32_B_SHIFT) & 0xFF);
+    }
+}
+
+ImTextureID ImGui_ImplQtSoftware_CreateTexture(const QImage& image)
+{
+    auto bd = ImGui_ImplQtSoftware_GetBackendData();
+    IM_ASSERT(bd != nullptr && "Did you call ImGui_ImplQtSoftware_Init()?");
+    return (ImTextureID)bd->CreateTexture(image);
+}
+
+void ImGui_ImplQtSoftware_DestroyTexture(ImTextureID texture)
+{
+    auto bd = ImGui_ImplQtSoftware_GetBackendData();
+    if (bd) {
+        bd->DestroyTexture((ImGui_ImplQtSoftware_Texture*)texture);
+    }
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "imgui.h"
+
+class QImage;
+
+// Software renderer: rasterizes into a QImage on worker threads, pair it with ImGui_ImplQt_Init(QWidget*)
+IMGUI_IMPL_API bool ImGui_ImplQtSoftware_Init(int thread_count = 0);   // 0: QThread::idealThreadCount()
+IMGUI_IMPL_API void ImGui_ImplQtSoftware_Shutdown();
+IMGUI_IMPL_API void ImGui_ImplQtSoftware_NewFrame();
+IMGUI_IMPL_API void ImGui_ImplQtSoftware_RenderDrawData(ImDrawData* draw_data);
+
+IMGUI_IMPL_API bool ImGui_ImplQtSoftware_CreateFontsTexture();
+IMGUI_IMPL_API void ImGui_ImplQtSoftware_DestoryFontsTexture();
+IMGUI_IMPL_API bool ImGui_ImplQtSoftware_CreateDeviceObjects();
+IMGUI_IMPL_API void ImGui_ImplQtSoftware_DestoryDeviceObjects();
+
+// Result of the last ImGui_ImplQtSoftware_RenderDrawData(), its device pixel ratio matches the framebuffer scale
+IMGUI_IMPL_API const QImage& ImGui_ImplQtSoftware_GetImage();
+IMGUI_IMPL_API void ImGui_ImplQtSoftware_SetClearColor(const ImVec4& clear_color);
+
+// User textures, sampled from a copy of the image
+IMGUI_IMPL_API ImTextureID ImGui_ImplQtSoftware_CreateTexture(const QImage& image);
+IMGUI_IMPL_API void ImGui_ImplQtSoftware_DestroyTexture(ImTextureID texture);
@@ -0,0 +1,34 @@
+#pragma once
+#include <QtCore/QtGlobal>
+#include <stdio.h>
+
+#include "headless.h"
+
+// Minimal checks for the test programs run by CTest. A failed check prints its location and the test continues,
+// main() returns ImGui_ImplQtTest_Result() so any failure makes the program exit with 1.
+// IMGUI_QT_TEST_SKIP is returned when the machine lacks what the test needs (OpenGL driver, font file).
+
+#define IMGUI_QT_TEST_SKIP 77
+
+static int ImGui_ImplQtTest_Failures = 0;
+
+#define IMGUI_QT_CHECK(expr) \
+    do { if (!(expr)) { printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #expr); fflush(stdout); ImGui_ImplQtTest_Failures++; } } while (0)
+
+inline int ImGui_ImplQtTest_Result()
+{
+    if (ImGui_ImplQtTest_Failures)
+        printf("%d check(s) failed\n", ImGui_ImplQtTest_Failures);
+    else
+        printf("all checks passed\n");
+    return ImGui_ImplQtTest_Failures ? 1 : 0;
+}
+
+// Tests needing OpenGL run on machines without a display through the offscreen platform
+inline void ImGui_ImplQtTest_UseOffscreenWithoutDisplay()
+{
+#ifdef Q_OS_LINUX
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM") && qEnvironmentVariableIsEmpty("DISPLAY") && qEnvironmentVariableIsEmpty("WAYLAND_DISPLAY"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+#endif
+}
@@ -0,0 +1,94 @@
+﻿#include <QtGui/QImage>
+
+#include "test.h"
+
+//缓冲缓存按内容哈希复用:只改写顶点颜色而不改变顶点/索引数量时,必须重新上传而不是画出上一帧的颜色
+
+static const ImVec2 RectMin(200.0f, 150.0f);
+static const ImVec2 RectMax(260.0f, 200.0f);
+
+static void cached_ui()
+{
+    ImGui::SetNextWindowPos(ImVec2(10.0f, 10.0f));
+    ImGui::SetNextWindowSize(ImVec2(150.0f, 100.0f));
+    ImGui::Begin("Unchanged", nullptr, ImGuiWindowFlags_NoSavedSettings);
+    ImGui::Text("Reused every frame");
+    ImGui::End();
+    ImGui::GetForegroundDrawList()->AddRectFilled(RectMin, RectMax, IM_COL32(255, 0, 0, 255));
+}
+
+//ImGui::Render()之后、渲染之前可以改写绘制数据
+template<typename F>
+static void frame_with(ImGui_ImplQtFixture_Headless& headless, F&& mutate)
+{
+    ImGui_ImplQtOpenGL3_NewFrame();
+    ImGui_ImplQt_NewFrame();
+    ImGui::NewFrame();
+    cached_ui();
+    ImGui::Render();
+    mutate(ImGui::GetDrawData());
+    headless.render(ImGui::GetDrawData());
+}
+
+static QRgb rect_center(ImGui_ImplQtFixture_Headless& headless)
+{
+    const QImage image = headless.framebuffer()->toImage();
+    return image.pixel((int)((RectMin.x + RectMax.x) * 0.5f), (int)((RectMin.y + RectMax.y) * 0.5f));
+}
+
+int main(int argc, char* argv[])
+{
+    ImGui_ImplQtTest_UseOffscreenWithoutDisplay();
+    QGuiApplication app(argc, argv);
+    ImGui_ImplQtFixture_Headless headless;
+    if (!headless.create(320, 240))
+    {
+        printf("no OpenGL context on this machine\n");
+        return IMGUI_QT_TEST_SKIP;
+    }
+    ImGui_ImplQtOpenGL3_SetBufferCache(true);
+    auto unchanged = [](ImDrawData*) {};
+
+    for (int i = 0; i < 3; i++)
+        frame_with(headless, unchanged);
+    ImGui_ImplQtOpenGL3_FrameStats stats;
+
+    //内容不变:全部命中
+    frame_with(headless, unchanged);
+    ImGui_ImplQtOpenGL3_GetFrameStats(&stats);
+    const int lists = ImGui::GetDrawData()->CmdListsCount;
+    IMGUI_QT_CHECK(lists >= 2);
+    IMGUI_QT_CHECK(stats.BufferCacheHits == lists);
+    IMGUI_QT_CHECK(stats.BufferCacheMisses == 0);
+    IMGUI_QT_CHECK(qRed(rect_center(headless)) == 255 && qGreen(rect_center(headless)) == 0);
+
+    //同一个绘制列表、同样的大小,只改顶点颜色
+    int mutated_vertices = 0;
+    frame_with(headless, [&](ImDrawData* draw_data) {
+        for (int n = 0; n < draw_data->CmdListsCount; n++)
+        {
+            ImDrawList* cmd_list = draw_data->CmdLists[n];
+            if (cmd_list != ImGui::GetForegroundDrawList())
+                continue;
+            for (ImDrawVert& vertex : cmd_list->VtxBuffer)
+                vertex.col = IM_COL32(0, 255, 0, 255);
+            mutated_vertices += cmd_list->VtxBuffer.Size;
+        }
+    });
+    ImGui_ImplQtOpenGL3_GetFrameStats(&stats);
+    printf("%d vertices recolored, %d hit(s), %d miss(es)\n", mutated_vertices, stats.BufferCacheHits, stats.BufferCacheMisses);
+    IMGUI_QT_CHECK(mutated_vertices > 0);
+    IMGUI_QT_CHECK(stats.BufferCacheMisses == 1);
+    IMGUI_QT_CHECK(stats.BufferCacheHits == lists - 1);
+    const QRgb pixel = rect_center(headless);
+    IMGUI_QT_CHECK(qRed(pixel) == 0 && qGreen(pixel) == 255);
+
+    //恢复原来的颜色同样要重新上传
+    frame_with(headless, unchanged);
+    ImGui_ImplQtOpenGL3_GetFrameStats(&stats);
+    IMGUI_QT_CHECK(stats.BufferCacheMisses == 1);
+    IMGUI_QT_CHECK(qRed(rect_center(headless)) == 255 && qGreen(rect_center(headless)) == 0);
+
+    IMGUI_QT_CHECK(headless.context()->functions()->glGetError() == GL_NO_ERROR);
+    return ImGui_ImplQtTest_Result();
+}
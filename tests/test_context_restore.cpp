@@ -0,0 +1,291 @@
+﻿#include <QtWidgets/QApplication>
+#include <QtWidgets/QOpenGLWidget>
+#include <QtGui/QImage>
+#include <vector>
+
+#include "test.h"
+
+//设备对象重建、GL上下文反复销毁重建(无头)与QOpenGLWidget反复换顶层窗口后,字体、着色器、流纹理、图集与折线图都要恢复,
+//显存统计回到重建前的水平
+
+static const int Cycles = 50;
+static const int Reparents = 20;
+
+struct Resources
+{
+    ImGui_ImplQtOpenGL3_StreamTexture* stream{};
+    ImGui_ImplQtOpenGL3_AtlasImage* image{};
+    ImGui_ImplQtOpenGL3_PlotSeries* plot{};
+
+    void create()
+    {
+        std::vector<ImU32> green(16 * 16, IM_COL32(0, 255, 0, 255));
+        stream = ImGui_ImplQtOpenGL3_CreateStreamTexture(16, 16);
+        ImGui_ImplQtOpenGL3_PushStreamFrame(stream, green.data());
+        std::vector<ImU32> blue(16 * 16, IM_COL32(0, 0, 255, 255));
+        image = ImGui_ImplQtOpenGL3_AddAtlasImage(blue.data(), 16, 16);
+        plot = ImGui_ImplQtOpenGL3_CreatePlotSeries(1024);
+        std::vector<float> values(1024);
+        for (int i = 0; i < 1024; i++)
+            values[(size_t)i] = (float)(i % 64) / 64.0f;
+        ImGui_ImplQtOpenGL3_AppendPlotSamples(plot, values.data(), 1024);
+    }
+
+    void destroy()
+    {
+        ImGui_ImplQtOpenGL3_DestroyStreamTexture(stream);
+        ImGui_ImplQtOpenGL3_RemoveAtlasImage(image);
+        ImGui_ImplQtOpenGL3_DestroyPlotSeries(plot);
+    }
+
+    //固定位置的纯色块,读回后逐个检查
+    void draw()
+    {
+        ImGui::ShowDemoWindow();
+        ImDrawList* draw_list = ImGui::GetForegroundDrawList();
+        draw_list->AddRectFilled(ImVec2(10, 10), ImVec2(30, 30), IM_COL32(255, 0, 0, 255));
+        draw_list->AddImage(ImGui_ImplQtOpenGL3_GetStreamTextureID(stream), ImVec2(40, 10), ImVec2(60, 30));
+        ImGui_ImplQtOpenGL3_AtlasRegion region;
+        if (ImGui_ImplQtOpenGL3_GetAtlasRegion(image, &region))
+            draw_list->AddImage(region.TextureId, ImVec2(70, 10), ImVec2(90, 30), region.Uv0, region.Uv1);
+        ImGui_ImplQtOpenGL3_AddPlotSeries(draw_list, plot, ImVec2(10, 40), ImVec2(200, 80), 0.0f, 1.0f, IM_COL32(255, 255, 0, 255));
+        draw_list->AddText(ImVec2(10, 90), IM_COL32_WHITE, "restored");
+    }
+};
+
+static ImU32 pixel(const QImage& image, int x, int y)
+{
+    const uchar* p = image.constScanLine(y) + x * 4;
+    return IM_COL32(p[0], p[1], p[2], p[3]);
+}
+
+//帧内容:三个色块在位、文字区域有非黑像素(字体纹理与着色器可用)
+static void check_frame(const QImage& rendered)
+{
+    const QImage image = rendered.convertToFormat(QImage::Format_RGBA8888);
+    IMGUI_QT_CHECK(pixel(image, 20, 20) == IM_COL32(255, 0, 0, 255));
+    IMGUI_QT_CHECK(pixel(image, 50, 20) == IM_COL32(0, 255, 0, 255));
+    IMGUI_QT_CHECK(pixel(image, 80, 20) == IM_COL32(0, 0, 255, 255));
+    int lit = 0;
+    for (int y = 90; y < 103; y++)
+        for (int x = 10; x < 60; x++)
+            lit += (pixel(image, x, y) & 0x00FFFFFF) != 0;
+    IMGUI_QT_CHECK(lit > 0);
+}
+
+static void check_frame_stats(int restores)
+{
+    ImGui_ImplQtOpenGL3_FrameStats stats;
+    ImGui_ImplQtOpenGL3_GetFrameStats(&stats);
+    IMGUI_QT_CHECK(stats.ContextRestores == restores);
+    IMGUI_QT_CHECK(stats.PlotSeriesDrawn == 1);
+    IMGUI_QT_CHECK(stats.DrawCalls > 0);
+}
+
+static void check_memory(const ImGui_ImplQtOpenGL3_MemoryStats& before)
+{
+    ImGui_ImplQtOpenGL3_MemoryStats after;
+    ImGui_ImplQtOpenGL3_GetMemoryStats(&after);
+    IMGUI_QT_CHECK(after.CurrentBytes[ImGui_ImplQtOpenGL3_MemoryCategory_Textures] == before.CurrentBytes[ImGui_ImplQtOpenGL3_MemoryCategory_Textures]);
+    IMGUI_QT_CHECK(after.Objects[ImGui_ImplQtOpenGL3_MemoryCategory_Textures] == before.Objects[ImGui_ImplQtOpenGL3_MemoryCategory_Textures]);
+    IMGUI_QT_CHECK(after.Objects[ImGui_ImplQtOpenGL3_MemoryCategory_Programs] == before.Objects[ImGui_ImplQtOpenGL3_MemoryCategory_Programs]);
+    IMGUI_QT_CHECK(after.TotalBytes <= before.TotalBytes);
+}
+
+//同一个离屏表面上反复创建新的GL上下文,旧上下文销毁时渲染器保存并释放,下一帧在新上下文上恢复
+static bool context_recreation()
+{
+    std::unique_ptr<QOpenGLContext> context(new QOpenGLContext());
+    if (!context->create())
+        return false;
+    QOffscreenSurface surface;
+    surface.setFormat(context->format());
+    surface.create();
+    if (!context->makeCurrent(&surface))
+        return false;
+    std::unique_ptr<QOpenGLFramebufferObject> fbo(new QOpenGLFramebufferObject(320, 240, QOpenGLFramebufferObject::CombinedDepthStencil));
+
+    ImGuiContext* imgui = ImGui::CreateContext();
+    ImGui::SetCurrentContext(imgui);
+    ImGui::GetIO().IniFilename = nullptr;
+    ImGui_ImplQt_Init(&surface, fbo.get());
+    ImGui_ImplQtOpenGL3_Init();
+    Resources resources;
+    resources.create();
+
+    auto frame = [&]() {
+        ImGui_ImplQtOpenGL3_NewFrame();
+        ImGui_ImplQt_NewFrame();
+        ImGui::NewFrame();
+        resources.draw();
+        ImGui::Render();
+        fbo->bind();
+        QOpenGLFunctions* f = context->functions();
+        f->glViewport(0, 0, fbo->width(), fbo->height());
+        f->glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+        f->glClear(GL_COLOR_BUFFER_BIT);
+        ImGui_ImplQtOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        f->glFinish();
+    };
+
+    //前几帧让缓冲区长到稳定大小
+    for (int i = 0; i < 3; i++)
+        frame();
+    check_frame(fbo->toImage());
+    check_frame_stats(0);
+    ImGui_ImplQtOpenGL3_MemoryStats baseline;
+    ImGui_ImplQtOpenGL3_GetMemoryStats(&baseline);
+
+    //只重建设备对象:应用持有的流纹理、图集图像与折线图都不能被释放
+    ImGui_ImplQtOpenGL3_DestoryDeviceObjects();
+    ImGui_ImplQtOpenGL3_CreateDeviceObjects();
+    for (int i = 0; i < 3; i++)
+        frame();
+    check_frame(fbo->toImage());
+    check_frame_stats(0);
+    check_memory(baseline);
+
+    for (int cycle = 1; cycle <= Cycles; cycle++)
+    {
+        fbo.reset();
+        context.reset();
+
+        context.reset(new QOpenGLContext());
+        IMGUI_QT_CHECK(context->create());
+        IMGUI_QT_CHECK(context->makeCurrent(&surface));
+        fbo.reset(new QOpenGLFramebufferObject(320, 240, QOpenGLFramebufferObject::CombinedDepthStencil));
+        ImGui_ImplQt_SetHeadlessTarget(fbo.get());
+
+        for (int i = 0; i < 3; i++)
+            frame();
+        check_frame(fbo->toImage());
+        check_frame_stats(cycle);
+        check_memory(baseline);
+
+        ImGui_ImplQtOpenGL3_StreamStats stream_stats;
+        ImGui_ImplQtOpenGL3_GetStreamStats(resources.stream, &stream_stats);
+        IMGUI_QT_CHECK(stream_stats.FramesPushed == 1);
+    }
+
+    resources.destroy();
+    ImGui_ImplQtOpenGL3_Shutdown();
+    ImGui_ImplQt_Shutdown();
+    ImGui::DestroyContext(imgui);
+    fbo.reset();
+    context->doneCurrent();
+    return true;
+}
+
+//与示例相同的写法:换顶层窗口时Qt会销毁并重建控件的GL上下文,initializeGL()再次调用时不重新初始化
+class View :public QOpenGLWidget
+{
+public:
+    ~View()
+    {
+        if (!imgui)
+            return;
+        makeCurrent();
+        ImGui::SetCurrentContext(imgui);
+        resources.destroy();
+        ImGui_ImplQtOpenGL3_Shutdown();
+        ImGui_ImplQt_Shutdown();
+        ImGui::DestroyContext(imgui);
+    }
+
+    ImGuiContext* imgui{};
+    Resources resources;
+protected:
+    void initializeGL() override
+    {
+        if (imgui)
+            return;
+        imgui = ImGui::CreateContext();
+        ImGui::SetCurrentContext(imgui);
+        ImGui::GetIO().IniFilename = nullptr;
+        ImGui_ImplQt_Init(this);
+        ImGui_ImplQtOpenGL3_Init();
+        resources.create();
+    }
+
+    void paintGL() override
+    {
+        ImGui::SetCurrentContext(imgui);
+        ImGui_ImplQtOpenGL3_NewFrame();
+        ImGui_ImplQt_NewFrame();
+        ImGui::NewFrame();
+        resources.draw();
+        ImGui::Render();
+        QOpenGLFunctions* f = context()->functions();
+        f->glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+        f->glClear(GL_COLOR_BUFFER_BIT);
+        ImGui_ImplQtOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    }
+};
+
+static bool widget_reparenting()
+{
+    QWidget first, second;
+    first.resize(320, 240);
+    second.resize(320, 240);
+    first.show();
+    second.show();
+
+    View* view = new View();
+    view->setParent(&first);
+    view->resize(320, 240);
+    view->show();
+    QApplication::processEvents();
+    QImage image = view->grabFramebuffer();
+    if (!view->isValid() || !view->imgui)
+        return false;
+    check_frame(image);
+
+    ImGui::SetCurrentContext(view->imgui);
+    ImGui_ImplQtOpenGL3_MemoryStats baseline;
+    ImGui_ImplQtOpenGL3_GetMemoryStats(&baseline);
+    ImGui_ImplQtOpenGL3_FrameStats stats;
+    ImGui_ImplQtOpenGL3_GetFrameStats(&stats);
+    int restores = stats.ContextRestores;
+
+    for (int i = 0; i < Reparents; i++)
+    {
+        QWidget* target = (i & 1) ? &first : &second;
+        view->setParent(target);
+        view->show();
+        QApplication::processEvents();
+        for (int frame = 0; frame < 3; frame++)
+            image = view->grabFramebuffer();
+        check_frame(image);
+
+        //上下文每次换窗口都重建,至少恢复一次
+        ImGui::SetCurrentContext(view->imgui);
+        ImGui_ImplQtOpenGL3_GetFrameStats(&stats);
+        IMGUI_QT_CHECK(stats.ContextRestores > restores);
+        restores = stats.ContextRestores;
+        IMGUI_QT_CHECK(stats.PlotSeriesDrawn == 1);
+        check_memory(baseline);
+    }
+
+    delete view;
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    ImGui_ImplQtTest_UseOffscreenWithoutDisplay();
+    QApplication app(argc, argv);
+
+    if (!context_recreation())
+    {
+        printf("no OpenGL context on this machine\n");
+        return IMGUI_QT_TEST_SKIP;
+    }
+    printf("%d context recreations done\n", Cycles);
+
+    if (widget_reparenting())
+        printf("%d reparents done\n", Reparents);
+    else
+        printf("QOpenGLWidget unavailable on this platform, reparenting skipped\n");
+
+    return ImGui_ImplQtTest_Result();
+}
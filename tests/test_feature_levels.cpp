@@ -0,0 +1,110 @@
+﻿#include <QtGui/QImage>
+#include <stdlib.h>
+
+#include "test.h"
+
+//每个特性级别的实例化在同一个无头上下文上渲染同样的内容,结果与最高级别逐像素比较(允许每个通道差1)。
+//支持VtxOffset的级别另外渲染超过65536个顶点的网格
+
+static const char* const LevelNames[ImGui_ImplQtOpenGL3_FeatureLevel_COUNT] = { "GL30", "GL33", "GL45", "ES3" };
+
+static void reference_ui()
+{
+    ImGui::SetNextWindowPos(ImVec2(10.0f, 10.0f));
+    ImGui::SetNextWindowSize(ImVec2(300.0f, 220.0f));
+    ImGui::Begin("Levels", nullptr, ImGuiWindowFlags_NoSavedSettings);
+    for (int i = 0; i < 8; i++)
+        ImGui::Text("Row %d: feature level check", i);
+    ImGui::Button("Button");
+    ImGui::End();
+
+    //裁剪矩形边缘、半透明与抗锯齿线条
+    ImDrawList* draw_list = ImGui::GetForegroundDrawList();
+    draw_list->PushClipRect(ImVec2(320.0f, 10.0f), ImVec2(400.0f, 90.0f));
+    draw_list->AddRectFilled(ImVec2(300.0f, 0.0f), ImVec2(420.0f, 120.0f), IM_COL32(255, 0, 0, 128));
+    draw_list->AddLine(ImVec2(320.0f, 10.0f), ImVec2(400.0f, 90.0f), IM_COL32_WHITE, 3.0f);
+    draw_list->PopClipRect();
+}
+
+//16位索引时超过65536个顶点要靠ImDrawCmd::VtxOffset
+static void large_mesh_ui()
+{
+    ImDrawList* draw_list = ImGui::GetForegroundDrawList();
+    for (int i = 0; i < 20000; i++)
+    {
+        const float x = (float)(i % 200) * 2.0f;
+        const float y = 240.0f + (float)(i / 200) * 2.0f;
+        draw_list->AddRectFilled(ImVec2(x, y), ImVec2(x + 1.0f, y + 1.0f), IM_COL32(0, 255, 0, 255));
+    }
+}
+
+static bool same_image(const QImage& a, const QImage& b)
+{
+    if (a.size() != b.size())
+        return false;
+    const QImage x = a.convertToFormat(QImage::Format_RGBA8888);
+    const QImage y = b.convertToFormat(QImage::Format_RGBA8888);
+    for (int row = 0; row < x.height(); row++)
+    {
+        const uchar* p = x.constScanLine(row);
+        const uchar* q = y.constScanLine(row);
+        for (int i = 0; i < x.width() * 4; i++)
+            if (abs((int)p[i] - (int)q[i]) > 1)
+                return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    ImGui_ImplQtTest_UseOffscreenWithoutDisplay();
+    QGuiApplication app(argc, argv);
+    ImGui_ImplQtFixture_Headless headless;
+    if (!headless.create(640, 480))
+    {
+        printf("no OpenGL context on this machine\n");
+        return IMGUI_QT_TEST_SKIP;
+    }
+    const ImGui_ImplQtOpenGL3_FeatureLevel max_level = ImGui_ImplQtOpenGL3_GetFeatureLevel();
+    printf("%s, max level %s\n", (const char*)headless.context()->functions()->glGetString(GL_VERSION), LevelNames[max_level]);
+
+    //前几帧让窗口布局稳定
+    for (int i = 0; i < 3; i++)
+        headless.frame(reference_ui);
+    const QImage reference = headless.framebuffer()->toImage();
+
+    int levels_run = 0;
+    for (int level = 0; level < ImGui_ImplQtOpenGL3_FeatureLevel_COUNT; level++)
+    {
+        if (!ImGui_ImplQtOpenGL3_SetFeatureLevel((ImGui_ImplQtOpenGL3_FeatureLevel)level))
+        {
+            //不支持的级别保持原级别
+            IMGUI_QT_CHECK(ImGui_ImplQtOpenGL3_GetFeatureLevel() != (ImGui_ImplQtOpenGL3_FeatureLevel)level);
+            printf("%s not supported by this context\n", LevelNames[level]);
+            continue;
+        }
+        IMGUI_QT_CHECK(ImGui_ImplQtOpenGL3_GetFeatureLevel() == (ImGui_ImplQtOpenGL3_FeatureLevel)level);
+        levels_run++;
+
+        headless.frame(reference_ui);
+        const bool same = same_image(reference, headless.framebuffer()->toImage());
+        IMGUI_QT_CHECK(same);
+        IMGUI_QT_CHECK(headless.context()->functions()->glGetError() == GL_NO_ERROR);
+
+        const bool vtx_offset = (ImGui::GetIO().BackendFlags & ImGuiBackendFlags_RendererHasVtxOffset) != 0;
+        IMGUI_QT_CHECK(vtx_offset == (level == ImGui_ImplQtOpenGL3_FeatureLevel_GL33 || level == ImGui_ImplQtOpenGL3_FeatureLevel_GL45));
+        if (vtx_offset && sizeof(ImDrawIdx) == 2)
+        {
+            headless.frame(large_mesh_ui);
+            IMGUI_QT_CHECK(ImGui::GetDrawData()->TotalVtxCount > 65536);
+            const QImage image = headless.framebuffer()->toImage().convertToFormat(QImage::Format_RGBA8888);
+            //最后一个方块在第二段顶点里
+            const uchar* pixel = image.constScanLine(240 + 99 * 2) + (199 * 2) * 4;
+            IMGUI_QT_CHECK(pixel[0] == 0 && pixel[1] == 255 && pixel[2] == 0);
+        }
+        printf("%s %s\n", LevelNames[level], same ? "matches" : "differs");
+    }
+    IMGUI_QT_CHECK(levels_run > 0);
+    IMGUI_QT_CHECK(ImGui_ImplQtOpenGL3_SetFeatureLevel(max_level));
+    return ImGui_ImplQtTest_Result();
+}
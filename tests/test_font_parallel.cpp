@@ -0,0 +1,114 @@
+﻿#include <QtCore/QCoreApplication>
+#include <QtCore/QFile>
+#include <QtCore/QThread>
+#include <string.h>
+
+#include "test.h"
+#include "imgui_impl_qt_fonts.h"
+
+//并行构建与imgui自带的串行ImFontAtlas::Build()逐像素比较:纹理尺寸、alpha8像素、每个字体的字形表与自定义矩形
+
+static QByteArray cjk_font;
+
+static void add_fonts(ImFontAtlas* atlas)
+{
+    atlas->AddFontDefault();
+
+    //不同过采样与尺寸,合并进同一字体
+    ImFontConfig config;
+    config.SizePixels = 20.0f;
+    config.OversampleH = 3;
+    config.OversampleV = 2;
+    config.GlyphExtraSpacing = ImVec2(1.0f, 0.0f);
+    atlas->AddFontDefault(&config);
+    config.MergeMode = true;
+    config.SizePixels = 20.0f;
+    config.OversampleH = 1;
+    config.OversampleV = 1;
+    atlas->AddFontDefault(&config);
+
+    //自定义矩形参与打包
+    atlas->AddCustomRectRegular(24, 24);
+    atlas->AddCustomRectFontGlyph(atlas->Fonts[0], 0xE000, 13, 13, 14.0f);
+
+    if (!cjk_font.isEmpty())
+    {
+        ImFontConfig cjk;
+        cjk.FontDataOwnedByAtlas = false;
+        atlas->AddFontFromMemoryTTF(cjk_font.data(), cjk_font.size(), 18.0f, &cjk, atlas->GetGlyphRangesChineseFull());
+    }
+}
+
+static void compare(ImFontAtlas* serial, ImFontAtlas* parallel)
+{
+    unsigned char* serial_pixels = nullptr;
+    unsigned char* parallel_pixels = nullptr;
+    int serial_width = 0, serial_height = 0, parallel_width = 0, parallel_height = 0;
+    serial->GetTexDataAsAlpha8(&serial_pixels, &serial_width, &serial_height);
+    parallel->GetTexDataAsAlpha8(&parallel_pixels, &parallel_width, &parallel_height);
+    IMGUI_QT_CHECK(serial_width == parallel_width && serial_height == parallel_height);
+    if (serial_width == parallel_width && serial_height == parallel_height)
+        IMGUI_QT_CHECK(memcmp(serial_pixels, parallel_pixels, (size_t)serial_width * (size_t)serial_height) == 0);
+
+    IMGUI_QT_CHECK(serial->TexUvWhitePixel.x == parallel->TexUvWhitePixel.x && serial->TexUvWhitePixel.y == parallel->TexUvWhitePixel.y);
+    IMGUI_QT_CHECK(memcmp(serial->TexUvLines, parallel->TexUvLines, sizeof(serial->TexUvLines)) == 0);
+
+    IMGUI_QT_CHECK(serial->Fonts.Size == parallel->Fonts.Size);
+    for (int i = 0; i < serial->Fonts.Size && i < parallel->Fonts.Size; i++)
+    {
+        const ImFont* a = serial->Fonts[i];
+        const ImFont* b = parallel->Fonts[i];
+        IMGUI_QT_CHECK(a->FontSize == b->FontSize && a->Ascent == b->Ascent && a->Descent == b->Descent);
+        IMGUI_QT_CHECK(a->FallbackChar == b->FallbackChar && a->EllipsisChar == b->EllipsisChar);
+        IMGUI_QT_CHECK(a->Glyphs.Size == b->Glyphs.Size);
+        if (a->Glyphs.Size == b->Glyphs.Size)
+            IMGUI_QT_CHECK(memcmp(a->Glyphs.Data, b->Glyphs.Data, (size_t)a->Glyphs.size_in_bytes()) == 0);
+        IMGUI_QT_CHECK(a->IndexAdvanceX.Size == b->IndexAdvanceX.Size);
+        if (a->IndexAdvanceX.Size == b->IndexAdvanceX.Size)
+            IMGUI_QT_CHECK(memcmp(a->IndexAdvanceX.Data, b->IndexAdvanceX.Data, (size_t)a->IndexAdvanceX.size_in_bytes()) == 0);
+    }
+
+    IMGUI_QT_CHECK(serial->CustomRects.Size == parallel->CustomRects.Size);
+    for (int i = 0; i < serial->CustomRects.Size && i < parallel->CustomRects.Size; i++)
+        IMGUI_QT_CHECK(serial->CustomRects[i].X == parallel->CustomRects[i].X && serial->CustomRects[i].Y == parallel->CustomRects[i].Y);
+}
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    const QString cjk_path = ImGui_ImplQtFixture_FindCjkFont();
+    QFile file(cjk_path);
+    if (!cjk_path.isEmpty() && file.open(QIODevice::ReadOnly))
+        cjk_font = file.readAll();
+    printf("ChineseFull font: %s\n", cjk_font.isEmpty() ? "not found, CJK case skipped (set IMGUI_QT_CJK_FONT)" : qPrintable(cjk_path));
+
+    ImFontAtlas serial;
+    add_fonts(&serial);
+    IMGUI_QT_CHECK(serial.FontBuilderIO == nullptr);
+    IMGUI_QT_CHECK(serial.Build());
+
+    const int thread_counts[] = { 2, 3, 4, 0 };
+    for (int thread_count : thread_counts)
+    {
+        printf("parallel build with %d thread(s)\n", thread_count ? thread_count : QThread::idealThreadCount());
+        ImFontAtlas parallel;
+        add_fonts(&parallel);
+        ImGui_ImplQt_SetParallelFontBuild(&parallel, thread_count);
+        IMGUI_QT_CHECK(parallel.FontBuilderIO == ImGui_ImplQt_GetParallelFontBuilderIO());
+        IMGUI_QT_CHECK(parallel.Build());
+        compare(&serial, &parallel);
+    }
+
+    //线程数按图集保存,设置一个图集不影响另一个
+    ImFontAtlas first, second;
+    ImGui_ImplQt_SetParallelFontBuild(&first, 2);
+    ImGui_ImplQt_SetParallelFontBuild(&second, 4);
+    IMGUI_QT_CHECK(((first.FontBuilderFlags & ImGui_ImplQt_FontBuilderFlags_ThreadsMask) >> ImGui_ImplQt_FontBuilderFlags_ThreadsShift) == 2);
+    IMGUI_QT_CHECK(((second.FontBuilderFlags & ImGui_ImplQt_FontBuilderFlags_ThreadsMask) >> ImGui_ImplQt_FontBuilderFlags_ThreadsShift) == 4);
+    ImGui_ImplQt_SetParallelFontBuild(&first, 1);
+    IMGUI_QT_CHECK(first.FontBuilderIO == nullptr);
+    IMGUI_QT_CHECK(second.FontBuilderIO == ImGui_ImplQt_GetParallelFontBuilderIO());
+
+    return ImGui_ImplQtTest_Result();
+}
@@ -0,0 +1,144 @@
+﻿#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "test.h"
+#include "imgui_impl_qt_input.h"
+
+//多个生产者线程同时写入输入队列,GUI线程边写边取:每个生产者的记录必须按发送顺序、不丢不重地取出,
+//队列满时被拒绝的次数与Dropped一致。第二部分经由公开接口与ImGui_ImplQt_NewFrame()验证总数
+
+static const int ProducerCount = 4;
+static const int RecordsPerProducer = 100000;
+
+namespace
+{
+    struct Producers
+    {
+        std::vector<std::thread> Threads;
+        std::atomic<int> Rejected{};
+
+        template<typename F>
+        void start(F&& push)
+        {
+            for (int t = 0; t < ProducerCount; t++)
+            {
+                Threads.emplace_back([this, t, push]() {
+                    int rejected = 0;
+                    for (int i = 0; i < RecordsPerProducer; i++)
+                    {
+                        while (!push(t, i))
+                        {
+                            rejected++;
+                            std::this_thread::yield();
+                        }
+                    }
+                    Rejected.fetch_add(rejected);
+                });
+            }
+        }
+
+        void join()
+        {
+            for (std::thread& thread : Threads)
+                thread.join();
+        }
+    };
+}
+
+static void test_queue_order()
+{
+    std::unique_ptr<ImGui_ImplQt_InputQueue> queue(new ImGui_ImplQt_InputQueue());
+    Producers producers;
+    producers.start([&queue](int t, int i) {
+        ImGui_ImplQt_InputRecord record = {};
+        record.Type = ImGui_ImplQt_InputRecord::MousePos;
+        record.Code = t;
+        record.TimestampNs = i;
+        return queue->Push(record);
+    });
+
+    //GUI线程与生产者同时运行,取空后让出时间片
+    int next[ProducerCount] = {};
+    int received = 0, out_of_order = 0, bad_producer = 0;
+    ImGui_ImplQt_InputRecord record;
+    while (received < ProducerCount * RecordsPerProducer)
+    {
+        if (!queue->Pop(&record))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        received++;
+        if (record.Code < 0 || record.Code >= ProducerCount)
+        {
+            bad_producer++;
+            continue;
+        }
+        if (record.TimestampNs != next[record.Code])
+            out_of_order++;
+        next[record.Code] = (int)record.TimestampNs + 1;
+    }
+    producers.join();
+
+    printf("queue: %d records, %d rejected while full, %d out of order\n", received, producers.Rejected.load(), out_of_order);
+    IMGUI_QT_CHECK(bad_producer == 0);
+    IMGUI_QT_CHECK(out_of_order == 0);
+    for (int t = 0; t < ProducerCount; t++)
+        IMGUI_QT_CHECK(next[t] == RecordsPerProducer);
+    IMGUI_QT_CHECK(!queue->Pop(&record));
+    IMGUI_QT_CHECK(queue->Queued.load() == ProducerCount * RecordsPerProducer);
+    IMGUI_QT_CHECK(queue->Dropped.load() == producers.Rejected.load());
+}
+
+static void test_public_api()
+{
+    ImGuiContext* context = ImGui::CreateContext();
+    ImGuiIO& io = ImGui::GetIO();
+    io.IniFilename = nullptr;
+    io.Fonts->Build();
+    IMGUI_QT_CHECK(ImGui_ImplQt_InitHeadless(640, 480));
+    ImGui_ImplQt_InputQueue* queue = ImGui_ImplQt_GetInputQueue();
+    IMGUI_QT_CHECK(queue != nullptr);
+
+    Producers producers;
+    producers.start([queue](int t, int i) {
+        return ImGui_ImplQt_QueueMousePos(queue, (float)(i % 640), (float)(t * 100 + i % 100));
+    });
+
+    ImGui_ImplQt_InputQueueStats stats = {};
+    int frames = 0;
+    do
+    {
+        ImGui_ImplQt_NewFrame();
+        ImGui::NewFrame();
+        ImGui::Render();
+        frames++;
+        ImGui_ImplQt_GetInputQueueStats(&stats);
+    } while (stats.Drained < ProducerCount * RecordsPerProducer);
+    producers.join();
+
+    printf("public queue: %d records in %d frames, %d rejected while full\n", stats.Drained, frames, stats.Dropped);
+    IMGUI_QT_CHECK(stats.Queued == ProducerCount * RecordsPerProducer);
+    IMGUI_QT_CHECK(stats.Drained == stats.Queued);
+    IMGUI_QT_CHECK(stats.Dropped == producers.Rejected.load());
+    //无效的按键与鼠标键不入队也不计入Dropped
+    IMGUI_QT_CHECK(!ImGui_ImplQt_QueueMouseButton(queue, ImGuiMouseButton_COUNT, true));
+    IMGUI_QT_CHECK(!ImGui_ImplQt_QueueKey(queue, ImGuiKey_None, true));
+    ImGui_ImplQt_GetInputQueueStats(&stats);
+    IMGUI_QT_CHECK(stats.Queued == ProducerCount * RecordsPerProducer);
+    IMGUI_QT_CHECK(stats.Dropped == producers.Rejected.load());
+
+    ImGui_ImplQt_Shutdown();
+    ImGui::DestroyContext(context);
+}
+
+int main(int argc, char* argv[])
+{
+    ImGui_ImplQtTest_UseOffscreenWithoutDisplay();
+    QGuiApplication app(argc, argv);
+    test_queue_order();
+    test_public_api();
+    return ImGui_ImplQtTest_Result();
+}
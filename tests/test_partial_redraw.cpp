@@ -0,0 +1,103 @@
+﻿#include <QtGui/QImage>
+#include <stdlib.h>
+
+#include "test.h"
+
+//局部重绘后的帧缓冲必须与整帧重绘逐像素一致(允许每个通道差1)。
+//后面的窗口内容变化,与它重叠的前面窗口同样要重绘,否则会被清除色覆盖
+
+static int Value = 0;
+
+static void overlapping_ui()
+{
+    ImGui::SetNextWindowPos(ImVec2(10.0f, 10.0f));
+    ImGui::SetNextWindowSize(ImVec2(200.0f, 150.0f));
+    ImGui::Begin("Back", nullptr, ImGuiWindowFlags_NoSavedSettings);
+    ImGui::Text("Value %d", Value);
+    ImGui::ProgressBar((float)Value / 10.0f);
+    ImGui::End();
+
+    ImGui::SetNextWindowPos(ImVec2(120.0f, 90.0f));
+    ImGui::SetNextWindowSize(ImVec2(180.0f, 120.0f));
+    ImGui::Begin("Front", nullptr, ImGuiWindowFlags_NoSavedSettings);
+    for (int i = 0; i < 4; i++)
+        ImGui::Text("Static row %d", i);
+    ImGui::End();
+}
+
+//宿主保留帧缓冲内容,渲染前不清除
+static void frame_preserved(ImGui_ImplQtFixture_Headless& headless)
+{
+    ImGui_ImplQtOpenGL3_NewFrame();
+    ImGui_ImplQt_NewFrame();
+    ImGui::NewFrame();
+    overlapping_ui();
+    ImGui::Render();
+    QOpenGLFramebufferObject* fbo = headless.framebuffer();
+    fbo->bind();
+    QOpenGLFunctions* f = headless.context()->functions();
+    f->glViewport(0, 0, fbo->width(), fbo->height());
+    ImGui_ImplQtOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    f->glFinish();
+}
+
+static bool same_image(const QImage& a, const QImage& b)
+{
+    if (a.size() != b.size())
+        return false;
+    const QImage x = a.convertToFormat(QImage::Format_RGBA8888);
+    const QImage y = b.convertToFormat(QImage::Format_RGBA8888);
+    for (int row = 0; row < x.height(); row++)
+    {
+        const uchar* p = x.constScanLine(row);
+        const uchar* q = y.constScanLine(row);
+        for (int i = 0; i < x.width() * 4; i++)
+            if (abs((int)p[i] - (int)q[i]) > 1)
+                return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    ImGui_ImplQtTest_UseOffscreenWithoutDisplay();
+    QGuiApplication app(argc, argv);
+    ImGui_ImplQtFixture_Headless headless;
+    if (!headless.create(320, 240))
+    {
+        printf("no OpenGL context on this machine\n");
+        return IMGUI_QT_TEST_SKIP;
+    }
+
+    //第一帧整帧重绘,之后几帧让窗口布局稳定
+    ImGui_ImplQtOpenGL3_SetPartialRedraw(true, ImVec4(0.0f, 0.0f, 0.0f, 1.0f));
+    for (int i = 0; i < 3; i++)
+        frame_preserved(headless);
+    ImGui_ImplQtOpenGL3_FrameStats stats;
+
+    //内容不变的一帧什么都不重绘
+    frame_preserved(headless);
+    ImGui_ImplQtOpenGL3_GetFrameStats(&stats);
+    IMGUI_QT_CHECK(stats.DrawListsChanged == 0);
+    IMGUI_QT_CHECK(stats.DamageRatio == 0.0f);
+
+    Value = 7;
+    frame_preserved(headless);
+    ImGui_ImplQtOpenGL3_GetFrameStats(&stats);
+    printf("damage (%.0f, %.0f)-(%.0f, %.0f), ratio %.3f, %d list(s) changed\n",
+        stats.DamageRect.x, stats.DamageRect.y, stats.DamageRect.z, stats.DamageRect.w, stats.DamageRatio, stats.DrawListsChanged);
+    IMGUI_QT_CHECK(stats.DrawListsChanged == 1);
+    IMGUI_QT_CHECK(stats.DamageRatio > 0.0f && stats.DamageRatio < 1.0f);
+    const QImage partial = headless.framebuffer()->toImage();
+
+    //同样的内容清除后整帧重绘作为参照
+    ImGui_ImplQtOpenGL3_SetPartialRedraw(false);
+    headless.frame(overlapping_ui);
+    ImGui_ImplQtOpenGL3_GetFrameStats(&stats);
+    IMGUI_QT_CHECK(stats.DamageRatio == 1.0f);
+    const QImage full = headless.framebuffer()->toImage();
+
+    IMGUI_QT_CHECK(same_image(partial, full));
+    IMGUI_QT_CHECK(headless.context()->functions()->glGetError() == GL_NO_ERROR);
+    return ImGui_ImplQtTest_Result();
+}
@@ -0,0 +1,192 @@
+﻿#include <QtNetwork/QLocalServer>
+#include <QtNetwork/QLocalSocket>
+#include <limits.h>
+#include <math.h>
+#include <string.h>
+#include <vector>
+
+#include "test.h"
+#include "imgui_impl_qt_remote.h"
+
+//远程协议的两端都要拒绝损坏或恶意的数据:播放端收到列表数量超过帧长度的帧时不分配内存、请求重新同步,
+//之后的正常帧照常显示;发送端收到非有限或超出范围的显示尺寸时不转换、不应用或夹到合理范围
+
+enum { Hello = 1, Frame = 2, Resize = 5 };
+
+struct Message
+{
+    int Type;
+    QByteArray Payload;
+};
+
+template<typename T>
+static void append(QByteArray& out, const T& value)
+{
+    out.append((const char*)&value, (int)sizeof(T));
+}
+
+static void send(QIODevice* device, int type, const QByteArray& payload)
+{
+    QByteArray message;
+    append(message, (ImU32)(payload.size() + 1));
+    append(message, (ImU8)type);
+    message.append(payload);
+    device->write(message);
+}
+
+//等待并取出对端发来的完整消息
+static std::vector<Message> receive(QLocalSocket* socket, QByteArray& incoming)
+{
+    std::vector<Message> messages;
+    socket->flush();
+    if (socket->bytesAvailable() == 0)
+        socket->waitForReadyRead(1000);
+    incoming.append(socket->readAll());
+    int offset = 0;
+    while (incoming.size() - offset >= 5)
+    {
+        ImU32 size;
+        memcpy(&size, incoming.constData() + offset, sizeof(size));
+        if ((ImU32)(incoming.size() - offset - 4) < size)
+            break;
+        messages.push_back({ (int)(ImU8)incoming[offset + 4], incoming.mid(offset + 5, (int)size - 1) });
+        offset += 4 + (int)size;
+    }
+    incoming.remove(0, offset);
+    return messages;
+}
+
+static ImU32 last_hello(const std::vector<Message>& messages, ImU32 fallback)
+{
+    ImU32 generation = fallback;
+    for (const Message& message : messages)
+        if (message.Type == Hello && message.Payload.size() == (int)sizeof(ImU32))
+            memcpy(&generation, message.Payload.constData(), sizeof(generation));
+    return generation;
+}
+
+//帧头之后只有列表数量和给定的额外字节
+static QByteArray frame(ImU32 generation, int count, int extra_bytes)
+{
+    QByteArray payload;
+    append(payload, generation);
+    append(payload, (ImU32)1);
+    append(payload, (qint64)0);
+    append(payload, ImVec2(0.0f, 0.0f));
+    append(payload, ImVec2(320.0f, 240.0f));
+    append(payload, ImVec2(1.0f, 1.0f));
+    append(payload, (ImS32)count);
+    payload.append(QByteArray(extra_bytes, '\0'));
+    return qCompress(payload);
+}
+
+struct Loopback
+{
+    QLocalServer server;
+    QLocalSocket client;
+    QLocalSocket* peer{};
+
+    bool connect(const QString& name)
+    {
+        QLocalServer::removeServer(name);
+        if (!server.listen(name))
+            return false;
+        client.connectToServer(name);
+        server.waitForNewConnection(5000);
+        peer = server.nextPendingConnection();
+        return peer && client.waitForConnected(5000);
+    }
+};
+
+static bool player_rejects_oversized_count()
+{
+    Loopback loopback;
+    if (!loopback.connect("imgui_qt_test_remote_player"))
+        return false;
+    QByteArray incoming;
+    ImGui_ImplQtRemote_Player* player = ImGui_ImplQtRemote_CreatePlayer(&loopback.client, nullptr);
+    ImU32 generation = last_hello(receive(loopback.peer, incoming), 0);
+    IMGUI_QT_CHECK(generation != 0);
+
+    //数量接近INT_MAX、负数、以及比剩余字节能容纳的多一个:都要重新同步
+    const int counts[] = { INT_MAX, -1, 4 };
+    for (int count : counts)
+    {
+        send(loopback.peer, Frame, frame(generation, count, 3 * 4 - 1));
+        loopback.peer->flush();
+        loopback.client.waitForReadyRead(1000);
+        IMGUI_QT_CHECK(ImGui_ImplQtRemote_UpdatePlayer(player, ImVec2(320.0f, 240.0f), 1.0f) == nullptr);
+        const ImU32 next = last_hello(receive(loopback.peer, incoming), generation);
+        IMGUI_QT_CHECK(next == generation + 1);
+        generation = next;
+    }
+    ImGui_ImplQtRemote_Stats stats;
+    ImGui_ImplQtRemote_GetPlayerStats(player, &stats);
+    IMGUI_QT_CHECK(stats.FramesSent == 0);
+
+    //重新同步之后的正常帧照常显示
+    send(loopback.peer, Frame, frame(generation, 0, 0));
+    loopback.peer->flush();
+    loopback.client.waitForReadyRead(1000);
+    ImDrawData* draw_data = ImGui_ImplQtRemote_UpdatePlayer(player, ImVec2(320.0f, 240.0f), 1.0f);
+    IMGUI_QT_CHECK(draw_data != nullptr && draw_data->CmdListsCount == 0);
+    ImGui_ImplQtRemote_GetPlayerStats(player, &stats);
+    IMGUI_QT_CHECK(stats.FramesSent == 1);
+
+    ImGui_ImplQtRemote_DestroyPlayer(player);
+    return true;
+}
+
+static ImVec2 resize(Loopback& loopback, float width, float height, float device_pixel_ratio)
+{
+    QByteArray payload;
+    append(payload, width);
+    append(payload, height);
+    append(payload, device_pixel_ratio);
+    send(&loopback.client, Resize, payload);
+    loopback.client.flush();
+    loopback.peer->waitForReadyRead(1000);
+    ImGui_ImplQt_NewFrame();
+    return ImGui::GetIO().DisplaySize;
+}
+
+static bool sender_validates_resize()
+{
+    Loopback loopback;
+    if (!loopback.connect("imgui_qt_test_remote_sender"))
+        return false;
+    ImGuiContext* context = ImGui::CreateContext();
+    ImGui::SetCurrentContext(context);
+    ImGui::GetIO().IniFilename = nullptr;
+    ImGui_ImplQt_InitHeadless(640, 480);
+    ImGui_ImplQtRemote_Sender* sender = ImGui_ImplQtRemote_CreateSender(loopback.peer);
+
+    ImVec2 size = resize(loopback, NAN, 480.0f, 1.0f);
+    IMGUI_QT_CHECK(size.x == 640.0f && size.y == 480.0f);
+    size = resize(loopback, 800.0f, INFINITY, 1.0f);
+    IMGUI_QT_CHECK(size.x == 640.0f && size.y == 480.0f);
+    size = resize(loopback, 800.0f, 600.0f, NAN);
+    IMGUI_QT_CHECK(size.x == 640.0f && size.y == 480.0f);
+    size = resize(loopback, 1e12f, -5.0f, 100.0f);
+    IMGUI_QT_CHECK(size.x == 16384.0f && size.y == 1.0f);
+    IMGUI_QT_CHECK(ImGui::GetIO().DisplayFramebufferScale.x <= 8.0f);
+    size = resize(loopback, 800.0f, 600.0f, 2.0f);
+    IMGUI_QT_CHECK(size.x == 800.0f && size.y == 600.0f);
+
+    ImGui_ImplQtRemote_DestroySender(sender);
+    ImGui_ImplQt_Shutdown();
+    ImGui::DestroyContext(context);
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    ImGui_ImplQtTest_UseOffscreenWithoutDisplay();
+    QGuiApplication app(argc, argv);
+    if (!player_rejects_oversized_count() || !sender_validates_resize())
+    {
+        printf("Loopback connection failed, test skipped\n");
+        return IMGUI_QT_TEST_SKIP;
+    }
+    return ImGui_ImplQtTest_Result();
+}